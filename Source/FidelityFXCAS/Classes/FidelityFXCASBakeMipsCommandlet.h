@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "FidelityFXCASBakeMipsCommandlet.generated.h"
+
+// Measures the cook-time CAS bake (FidelityFXCASTextureBake.h) of UTexture2D assets, to fit it in the cook budget. The cook itself bakes the textures
+// with UFidelityFXCASTextureBakeSettings into their cooked platform data; this runs the same bake in memory, all the mips of all the textures in parallel,
+// and logs the CAS throughput. Nothing is saved, the source assets are never modified.
+// Usage: -run=FidelityFXCASBakeMips [-Path=<package path>] [-Textures=<object path>+<object path>...] [options]
+//   -Path=<package path>                        Textures with UFidelityFXCASTextureBakeSettings under the path (default: /Game)
+//   -Textures=<object paths separated by +>    Textures to bake, with the default settings if they have none
+//   -Sharpness=<0..1>                          Sharpness of the textures without settings (default: 0.5)
+//   -BatchMemory=<MB>                          Memory of the mips held at once, textures are baked in batches (default: 1024)
+//   -RebuildPlatformData                       Also rebuilds the platform data from the baked chains in memory, as the cook does, and times it
+UCLASS()
+class UFidelityFXCASBakeMipsCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "FidelityFXCASBatchCommandlet.generated.h"
+
+// Runs CAS on the CPU over raw or PFM frames on disk. Frames are memory mapped and processed in place.
+// Usage: -run=FidelityFXCASBatch -Input=<file or wildcard> -Output=<file or directory> [options]
+//   -Sharpness=<0..1>                          CAS sharpness (default: 0.5)
+//   -Scale=<factor> or -OutputWidth=<w> -OutputHeight=<h>   Output size (default: same as input)
+//   -RawWidth=<w> -RawHeight=<h> -RawFormat=<RGBA32F|RGB32F|RGBA8|RGBA16F|RGBA8_SRGB> [-RawPitch=<bytes>] [-RawHeader=<bytes>] [-RawBGRA]   Raw input layout
+//   -Streaming                                 Sequential access hints for long frame sequences
+//   -ReportError                               Logs the difference of every frame to the scalar FP32 reference
+//   -AutoTune                                  Times the CPU engine configurations on the first frame's workload if the tuning profile has no entry for it
+//   -TuningProfile=<file>                      Tuning profile, applied automatically when it has an entry (default: Saved/FidelityFXCAS/CPUTuning.ini)
+UCLASS()
+class UFidelityFXCASBatchCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+	virtual int32 Main(const FString& Params) override;
+};
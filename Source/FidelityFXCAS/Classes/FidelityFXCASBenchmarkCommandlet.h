@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "FidelityFXCASBenchmarkCommandlet.generated.h"
+
+// Cost / quality frontier of the upscale methods on a corpus of reference frames (raw or PFM, see FidelityFXCASBatch).
+// Every frame is bilinearly downscaled by each ratio and rebuilt to its size with a bilinear upscale, a bilinear upscale followed by
+// CAS sharpen only and a CAS upscale. PSNR / SSIM to the reference and the ns per output pixel of the rebuild are reported per configuration.
+// Usage: -run=FidelityFXCASBenchmark -Input=<file or wildcard> [options]
+//   -Ratios=<r>+<r>...                         Upscale ratios in (1, 2] (default: 1.25+1.5+1.75+2)
+//   -Sharpness=<s>+<s>...                      CAS sharpness values (default: 0+0.25+0.5+0.75+1)
+//   -Format=<RGBA32F|RGBA16F|RGBA8|RGBA8_SRGB> Working format of the rebuild (default: format of the frame)
+//   -Repeat=<n>                                Timed runs per configuration, the fastest counts (default: 3)
+//   -SingleThreaded                            Times the CPU engine on one thread
+//   -GPU                                       Also runs the CAS configurations on the GPU for each quality tier, timed with GPU timestamps
+//                                              (needs -AllowCommandletRendering, fails without a GPU instead of running them on the CPU)
+//   -Output=<file.csv or file.json>            Writes all configurations with their frontier flag (default: Saved/FidelityFXCAS/Benchmark.csv)
+//   -MinPSNR=<dB> / -MinSSIM=<0..1>            Quality bar, logs the cheapest configuration meeting it for every ratio
+//   -RawWidth=<w> -RawHeight=<h> -RawFormat=<...> [-RawPitch=<bytes>] [-RawHeader=<bytes>] [-RawBGRA]   Raw input layout
+UCLASS()
+class UFidelityFXCASBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+	virtual int32 Main(const FString& Params) override;
+};
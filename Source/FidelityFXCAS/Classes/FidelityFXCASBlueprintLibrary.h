@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "UObject/ObjectMacros.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "FidelityFXCASTypes.h"
 #include "FidelityFXCASBlueprintLibrary.generated.h"
 
 
@@ -43,12 +44,34 @@ class UFidelityFXCASBlueprintLibrary : public UBlueprintFunctionLibrary
 	UFUNCTION(BlueprintCallable, Category = "FidelityFX | CAS")
 	static void SetSSCASSharpness(float Sharpness);
 
+	UFUNCTION(BlueprintCallable, Category = "FidelityFX | CAS")
+	static EFidelityFXCASQuality GetSSCASQuality();
+
+	UFUNCTION(BlueprintCallable, Category = "FidelityFX | CAS")
+	static void SetSSCASQuality(EFidelityFXCASQuality Quality);
+
+	// GPU time of a quality tier measured by the auto-tuner (r.fxcas.AutoTune) in milliseconds, 0 if not measured
+	UFUNCTION(BlueprintCallable, Category = "FidelityFX | CAS")
+	static float GetQualityTierMilliseconds(EFidelityFXCASQuality Quality, bool bUseFP16);
+
+	// Dynamic resolution: drives r.ScreenPercentage from the GPU frame time and the SS CAS sharpness from the upscale ratio
+	UFUNCTION(BlueprintCallable, Category = "FidelityFX | CAS")
+	static bool GetIsDRSEnabled();
+
+	UFUNCTION(BlueprintCallable, Category = "FidelityFX | CAS")
+	static void SetIsDRSEnabled(bool bEnabled);
+
 	UFUNCTION(BlueprintCallable, Category = "FidelityFX | CAS")
 	static bool GetUseFP16();
 
 	UFUNCTION(BlueprintCallable, Category = "FidelityFX | CAS")
 	static void SetUseFP16(bool UseFP16);
 
+	// Per pixel scale of the SS CAS sharpness (red channel in [0, 1], stretched over the screen), i.e. 0 under UI overlays, text or
+	// depth of field. None sharpens the whole screen. Set it again after the texture was recreated or resized.
+	UFUNCTION(BlueprintCallable, Category = "FidelityFX | CAS")
+	static void SetSSCASSharpnessMask(class UTexture* Mask);
+
 	// Allows early initialization of compute shader outputs for screen space CAS (i.e. during loading)
 	// If not called the outputs will be lazy-loaded during the first render
 	UFUNCTION(BlueprintCallable, Category = "FidelityFX | CAS")
@@ -64,5 +87,31 @@ class UFidelityFXCASBlueprintLibrary : public UBlueprintFunctionLibrary
 	static void InitCSOutput(class UTextureRenderTarget2D* InOutputRenderTarget);
 
 	UFUNCTION(BlueprintCallable, Category = "FidelityFX | CAS", meta = (WorldContext = "WorldContextObject"))
-	static void DrawToRenderTarget(class UTextureRenderTarget2D* InOutputRenderTarget, class UTexture2D* InInputTexture, float InSharpness, bool InUseFP16 = false);
+	static void DrawToRenderTarget(class UTextureRenderTarget2D* InOutputRenderTarget, class UTexture2D* InInputTexture, float InSharpness, bool InUseFP16 = false, EFidelityFXCASQuality InQuality = EFidelityFXCASQuality::Low);
+
+	// Incremental DrawToRenderTarget for partially updated inputs. InDirtyRects are the changed regions of the input texture in pixels,
+	// they are grown by the CAS kernel apron and only the affected regions of the output are dispatched and drawn, the rest of the
+	// render target is left untouched. Falls back to a full update if the previous draw into the target used another input or settings.
+	UFUNCTION(BlueprintCallable, Category = "FidelityFX | CAS", meta = (WorldContext = "WorldContextObject"))
+	static void DrawToRenderTargetDirtyRects(class UTextureRenderTarget2D* InOutputRenderTarget, class UTexture2D* InInputTexture, const TArray<FBox2D>& InDirtyRects,
+		float InSharpness, bool InUseFP16 = false, EFidelityFXCASQuality InQuality = EFidelityFXCASQuality::Low);
+
+	// DrawToRenderTarget with a per pixel sharpness: InSharpnessMask (red channel in [0, 1], any resolution, stretched over the render target)
+	// scales InSharpness inside the CAS kernel, 0 leaves the pixels unsharpened. Ignored with a warning on downscales of more than 2x.
+	UFUNCTION(BlueprintCallable, Category = "FidelityFX | CAS", meta = (WorldContext = "WorldContextObject"))
+	static void DrawToRenderTargetMasked(class UTextureRenderTarget2D* InOutputRenderTarget, class UTexture2D* InInputTexture, class UTexture* InSharpnessMask,
+		float InSharpness, bool InUseFP16 = false, EFidelityFXCASQuality InQuality = EFidelityFXCASQuality::Low);
+
+	// DrawToRenderTarget for flipbooks, atlas sheets and other layered textures: sharpens (and upscales) every slice of a texture array,
+	// a volume texture or a render target array in a single dispatch. InOutputRenderTarget must be a render target array with the RGBA16f
+	// format, the slices are copied into it without per slice draws. Requires UE 4.25.
+	UFUNCTION(BlueprintCallable, Category = "FidelityFX | CAS", meta = (WorldContext = "WorldContextObject"))
+	static void DrawToRenderTargetArray(class UTextureRenderTarget* InOutputRenderTarget, class UTexture* InInputTexture, float InSharpness, bool InUseFP16 = false,
+		EFidelityFXCASQuality InQuality = EFidelityFXCASQuality::Low);
+
+	// Regenerates the mips of a render target (scene capture, portrait) from mip 0: every level is a 2x2 box downsample of the level
+	// above followed by CAS sharpening, all levels in a single dispatch. The render target needs mips (Auto Generate Mips) and the
+	// RGBA16f format. Call it after the render target was drawn or captured, the engine's box filtered mips are replaced.
+	UFUNCTION(BlueprintCallable, Category = "FidelityFX | CAS", meta = (WorldContext = "WorldContextObject"))
+	static void GenerateSharpenedMips(class UTextureRenderTarget2D* InRenderTarget, float InSharpness, EFidelityFXCASQuality InQuality = EFidelityFXCASQuality::Low);
 };
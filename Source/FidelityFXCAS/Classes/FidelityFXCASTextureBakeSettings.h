@@ -0,0 +1,21 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+#include "FidelityFXCASTextureBakeSettings.generated.h"
+
+// Per texture settings of the cook-time CAS bake, added to a UTexture2D's Asset User Data.
+// The cook bakes CAS sharpened levels made by the CPU engine into the cooked mips of the textures carrying them, so they need no shader work at runtime.
+UCLASS(BlueprintType, meta = (DisplayName = "FidelityFX CAS Bake Settings"))
+class FIDELITYFXCAS_API UFidelityFXCASTextureBakeSettings : public UAssetUserData
+{
+	GENERATED_UCLASS_BODY()
+
+	// Same meaning as the screen space sharpness: 0 = lower ringing, 1 = maximum sharpening
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "FidelityFX CAS", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float Sharpness = 0.5f;
+
+	// Also sharpens mip 0, otherwise it is kept as imported and only the lower mips are CAS downscales of it
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "FidelityFX CAS")
+	bool bSharpenTopMip = false;
+};
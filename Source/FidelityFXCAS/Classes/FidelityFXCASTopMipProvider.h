@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Streaming/TextureMipDataProvider.h"
+#include "FidelityFXCASTopMipProvider.generated.h"
+
+// Added to a UTexture2D's Asset User Data (UE v4.26+): when the texture streams in a top mip whose payload was not shipped (an optional mip
+// without its .uptnl file), the texture streamer gets it from this provider as a 2x CAS upscale of the mip below, made by the CPU engine on a
+// worker thread. Shipped top mips stream in as usual. Needs an uncompressed RGBA8 / BGRA8, RGBA16f or RGBA32f texture.
+UCLASS(BlueprintType, meta = (DisplayName = "FidelityFX CAS Top Mip Provider"))
+class FIDELITYFXCAS_API UFidelityFXCASTopMipProviderFactory : public UTextureMipDataProviderFactory
+{
+	GENERATED_UCLASS_BODY()
+
+	// Same meaning as the screen space sharpness: 0 = lower ringing, 1 = maximum sharpening
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "FidelityFX CAS", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float Sharpness = 0.5f;
+
+	virtual FTextureMipDataProvider* AllocateMipDataProvider(UTexture* Asset) override;
+	// The top mip is made without its payload, so the streamer requests it even though the optional mip data is missing
+	virtual bool WillProvideMipDataWithoutDisk() const override { return true; }
+};
@@ -21,7 +21,8 @@ public class FidelityFXCAS : ModuleRules
                 "Core",
                 "Engine",
                 "RenderCore",
-                "RHI"
+                "RHI",
+                "FidelityFXCASCPU"
 				// ... add other public dependencies that you statically link with here ...
 			});
 
@@ -35,6 +36,7 @@ public class FidelityFXCAS : ModuleRules
         PrivateDependencyModuleNames.AddRange(
             new string[]
             {
+                "AssetRegistry",
                 "CoreUObject",
                 "Engine",
                 "Projects",
@@ -93,5 +95,15 @@ public class FidelityFXCAS : ModuleRules
 
         // Change the following to 1 to enable upscaling, after you've modified the UE sources by adding upscale callback
         PublicDefinitions.Add("FX_CAS_CUSTOM_UPSCALE_CALLBACK=0");
+
+        // Post tonemap scene view extension, no engine changes needed (UE v4.26+, CAS upscaling as the primary spatial upscaler from UE v4.27)
+        if (Target.Version.MajorVersion > 4 || Target.Version.MinorVersion >= 26)
+        {
+            PublicDefinitions.Add("FX_CAS_VIEW_EXTENSION=1");
+        }
+        else
+        {
+            PublicDefinitions.Add("FX_CAS_VIEW_EXTENSION=0");
+        }
 	}
 }
@@ -2,13 +2,21 @@
 
 #include "FidelityFXCAS.h"
 #include "FidelityFXCASPassParams.h"
+#include "FidelityFXCASPassBackend.h"
 #include "FidelityFXCASShaderCS.h"
 #include "FidelityFXCASShaderPS.h"
 #include "FidelityFXCASShaderVS.h"
+#include "FidelityFXCASViewExtension.h"
 #include "FidelityFXCASIncludes.h"
+#include "FidelityFXCASCPU.h"
+#include "FidelityFXCASTextureBake.h"
 
+#include "Async/Async.h"
 #include "CommonRenderResources.h"
 #include "GlobalShader.h"
+#include "Containers/Ticker.h"
+#include "Engine/Engine.h"
+#include "Misc/CoreDelegates.h"
 #include "Interfaces/IPluginManager.h"
 #include "Misc/Paths.h"
 #include "ProfilingDebugging/RealtimeGPUProfiler.h"
@@ -21,15 +29,20 @@
 
 #define LOCTEXT_NAMESPACE "FFidelityFXCASModule"
 
-#if UE_VERSION_OLDER_THAN(4, 25, 0)	// UE v4.24
-	#define FXCAS_SHADER_ARG(shader) (*shader)
-	#define FXCAS_GET_PS(shader) GETSAFERHISHADER_PIXEL(*shader)
-	#define FXCAS_GET_VS(shader) GETSAFERHISHADER_VERTEX(*shader)
-#else
-	#define FXCAS_SHADER_ARG(shader) (shader)
-	#define FXCAS_GET_PS(shader) (shader.GetPixelShader())
-	#define FXCAS_GET_VS(shader) (shader.GetVertexShader())
-#endif	// UE v4.24
+DEFINE_LOG_CATEGORY_STATIC(LogFidelityFXCAS, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("FidelityFX CAS"), STATGROUP_FidelityFXCAS, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("SS CAS passes on the graphics pipe"), STAT_FidelityFXCAS_GraphicsPasses, STATGROUP_FidelityFXCAS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("SS CAS passes on async compute"), STAT_FidelityFXCAS_AsyncComputePasses, STATGROUP_FidelityFXCAS);
+DECLARE_DWORD_COUNTER_STAT(TEXT("SS CAS async compute fallbacks"), STAT_FidelityFXCAS_AsyncComputeFallbacks, STATGROUP_FidelityFXCAS);
+
+#if FX_CAS_PLUGIN_ENABLED
+// Defined here rather than in FidelityFXCASPassParams.h, which is included by several translation units
+FTextureRHIRef FFidelityFXCASPassParams::EMPTY_TextureRHIRef;
+FSceneRenderTargetItem FFidelityFXCASPassParams::EMPTY_SceneRenderTargetItem;
+FUnorderedAccessViewRHIRef FFidelityFXCASPassParams::EMPTY_UnorderedAccessViewRHIRef;
+TRefCountPtr<IPooledRenderTarget> FFidelityFXCASPassParams::EMPTY_PooledRenderTarget;
+#endif // FX_CAS_PLUGIN_ENABLED
 
 //-------------------------------------------------------------------------------------------------
 // Console variables
@@ -59,6 +72,120 @@ static TAutoConsoleVariable<float> CVarFidelityFXCAS_SSCASSharpness(
 	TEXT("1: maximum (higher ringing)"),
 	ECVF_Cheat);
 
+static TAutoConsoleVariable<int32> CVarFidelityFXCAS_Quality(
+	TEXT("r.fxcas.Quality"),
+	0,
+	TEXT("Sets the CAS quality tier, each tier is a separate shader permutation.\n")
+	TEXT("0: Low (default CAS, cheapest)\n")
+	TEXT("1: Medium (better diagonals)\n")
+	TEXT("2: High (better diagonals, per channel weights)\n")
+	TEXT("3: Ultra (better diagonals, per channel weights, exact math, same as High with FP16)"),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<bool> CVarFidelityFXCAS_DRS(
+	TEXT("r.fxcas.DRS"),
+	0,
+	TEXT("Enables the CAS-aware dynamic resolution controller. It moves r.ScreenPercentage within the configured bounds to keep\n")
+	TEXT("the GPU frame time in budget and raises the CAS sharpness as the resolution drops.\n")
+	TEXT("0: OFF (default)\n")
+	TEXT("1: ON"),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<float> CVarFidelityFXCAS_DRSTargetFrameTime(
+	TEXT("r.fxcas.DRSTargetFrameTime"),
+	16.67f,
+	TEXT("GPU frame time budget of the dynamic resolution controller in milliseconds (default: 16.67)."),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<float> CVarFidelityFXCAS_DRSMinScreenPercentage(
+	TEXT("r.fxcas.DRSMinScreenPercentage"),
+	50.0f,
+	TEXT("Lowest screen percentage the dynamic resolution controller may use (default: 50)."),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<float> CVarFidelityFXCAS_DRSMaxScreenPercentage(
+	TEXT("r.fxcas.DRSMaxScreenPercentage"),
+	100.0f,
+	TEXT("Highest screen percentage the dynamic resolution controller may use (default: 100)."),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<float> CVarFidelityFXCAS_DRSSharpnessAtMin(
+	TEXT("r.fxcas.DRSSharpnessAtMin"),
+	0.8f,
+	TEXT("CAS sharpness at the lowest screen percentage while dynamic resolution is enabled (default: 0.8)."),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<float> CVarFidelityFXCAS_DRSSharpnessAtMax(
+	TEXT("r.fxcas.DRSSharpnessAtMax"),
+	0.4f,
+	TEXT("CAS sharpness at the highest screen percentage while dynamic resolution is enabled (default: 0.4)."),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<int32> CVarFidelityFXCAS_AutoTune(
+	TEXT("r.fxcas.AutoTune"),
+	0,
+	TEXT("Times the FP32 and FP16 shaders on a synthetic frame at the current resolution and uses the faster one.\n")
+	TEXT("The result is saved to GameUserSettings.ini and applied in later sessions on the same GPU.\n")
+	TEXT("0: OFF (default)\n")
+	TEXT("1: apply the saved result, calibrate once if there is none for this GPU\n")
+	TEXT("2: calibrate again"),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<bool> CVarFidelityFXCAS_AsyncCompute(
+	TEXT("r.fxcas.AsyncCompute"),
+	0,
+	TEXT("Schedules the screen space CAS compute pass with upscaling on the async compute pipe, so it overlaps with the graphics work\n")
+	TEXT("around it. Needs UE 4.26 (RDG async compute) and RHI support, the graphics pipe is used otherwise (see stat FidelityFXCAS).\n")
+	TEXT("0: OFF (default)\n")
+	TEXT("1: ON"),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<bool> CVarFidelityFXCAS_ViewExtension(
+	TEXT("r.fxcas.ViewExtension"),
+	1,
+	TEXT("Runs the screen space CAS from a scene view extension after the tonemapper (after FXAA when enabled), on the display referred\n")
+	TEXT("colors CAS expects, and as the primary spatial upscaler from UE 4.27. Needs UE 4.26, no engine changes.\n")
+	TEXT("0: OFF (resolved scene color callback, linear HDR colors)\n")
+	TEXT("1: ON (default)"),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<float> CVarFidelityFXCAS_MipRebuildBudget(
+	TEXT("r.fxcas.MipRebuildBudget"),
+	1.0f,
+	TEXT("Estimated CPU time in milliseconds of the top mip rebuilds started per frame for the texture streamer (default: 1).\n")
+	TEXT("At least one rebuild is started every frame, see UFidelityFXCASTopMipProviderFactory."),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<int32> CVarFidelityFXCAS_ReadbackRingSize(
+	TEXT("r.fxcas.ReadbackRingSize"),
+	4,
+	TEXT("Staging textures of the asynchronous readback ring, the readbacks in flight at most (default: 4).\n")
+	TEXT("A readback requested while all of them are in flight waits for the oldest, see FFidelityFXCASModule::RequestReadback()."),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<int32> CVarFidelityFXCAS_Foveation(
+	TEXT("r.fxcas.Foveation"),
+	0,
+	TEXT("Fixed foveated screen space CAS (no upsampling): full CAS in the center of every view, the Low tier around it and a plain copy\n")
+	TEXT("in the periphery, chosen per 16x16 tile. Eye tracking overrides the regions with FFidelityFXCASModule::SetSSCASFoveation().\n")
+	TEXT("Only the RHI pass of the resolved scene color callback is foveated, the upscale and render graph passes run the whole frame.\n")
+	TEXT("0: OFF (default)\n")
+	TEXT("1: one view\n")
+	TEXT("2: two views side by side (stereo)"),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<float> CVarFidelityFXCAS_FoveationInner(
+	TEXT("r.fxcas.FoveationInner"),
+	0.4f,
+	TEXT("Radius of the full CAS region of r.fxcas.Foveation, as a fraction of the half size of the view (default: 0.4)."),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<float> CVarFidelityFXCAS_FoveationOuter(
+	TEXT("r.fxcas.FoveationOuter"),
+	0.8f,
+	TEXT("Radius of the Low tier region of r.fxcas.Foveation, as a fraction of the half size of the view (default: 0.8)."),
+	ECVF_Cheat);
+
 #if FX_CAS_FP16_ENABLED
 static TAutoConsoleVariable<bool> CVarFidelityFXCAS_SSCASFP16(
 	TEXT("r.fxcas.SSCASFP16"),
@@ -83,11 +210,11 @@ static void FidelityFXCASCVarSink()
 		{
 			Handle = FCoreDelegates::OnGetOnScreenMessages.AddLambda([](FCoreDelegates::FSeverityMessageMap& OutMessages) {
 				FFidelityFXCASModule& Module = FFidelityFXCASModule::Get();
-#if FX_CAS_CUSTOM_UPSCALE_CALLBACK
+#if FX_CAS_CUSTOM_UPSCALE_CALLBACK || FX_CAS_VIEW_EXTENSION_UPSCALE
 				static const FString SharpenOnly(TEXT(""));
 #else
 				static const FString SharpenOnly(TEXT(" (no upsampling)"));
-#endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK
+#endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK || FX_CAS_VIEW_EXTENSION_UPSCALE
 				// Screen space CAS ON / OFF
 				FString Message = FString::Printf(TEXT("FidelityFX SS CAS%s: %s"), *SharpenOnly, Module.GetIsSSCASEnabled() ? TEXT("ON") : TEXT("OFF"));
 				if (Module.GetIsSSCASEnabled())
@@ -100,7 +227,25 @@ static void FidelityFXCASCVarSink()
 					else
 						Message += FString::Printf(TEXT(" | Resolution: %dx%d -> %dx%d"), InputRes.X, InputRes.Y, OutputRes.X, OutputRes.Y);
 					// Sharpness
-					Message += FString::Printf(TEXT(" | Sharpness: %.2f"), Module.GetSSCASSharpness());
+					Message += FString::Printf(TEXT(" | Sharpness: %.2f"), Module.GetSSCASEffectiveSharpness());
+					// Dynamic resolution
+					if (Module.GetIsDRSEnabled())
+					{
+						const FFidelityFXCASResolutionController& Controller = Module.GetResolutionController();
+						Message += FString::Printf(TEXT(" | DRS: %.0f%% (GPU %.2f / %.2f ms)"), Controller.GetScreenPercentage(), Controller.GetSmoothedFrameTime(), Controller.GetSettings().TargetFrameTime);
+					}
+					// Quality
+					Message += FString::Printf(TEXT(" | Quality: %s"), GetFidelityFXCASQualityName(Module.GetSSCASQuality()));
+					// Foveation
+					const FFidelityFXCASFoveation Foveation = Module.GetSSCASFoveation();
+					if (Foveation.IsEnabled())
+						Message += FString::Printf(TEXT(" | Foveation: %d region(s)"), Foveation.Regions.Num());
+					// Sharpness mask
+					if (Module.HasSSCASSharpnessMask())
+						Message += TEXT(" | Sharpness mask");
+					// Compute pipe
+					if (Module.GetUseAsyncCompute())
+						Message += FString::Printf(TEXT(" | Pipe: %s"), GetFidelityFXCASComputePipeName(Module.GetSSCASComputePipe()));
 				}
 				OutMessages.Add(FCoreDelegates::EOnScreenMessageSeverity::Info, FText::AsCultureInvariant(Message));
 			});
@@ -131,6 +276,15 @@ static void FidelityFXCASCVarSink()
 		GSSCASSharpness = NewSSCASSharpness;
 	}
 
+	// CAS quality
+	static int32 GQuality = 0;
+	int32 NewQuality = FMath::Clamp(CVarFidelityFXCAS_Quality.GetValueOnGameThread(), 0, static_cast<int32>(EFidelityFXCASQuality::Ultra));
+	if (NewQuality != GQuality)
+	{
+		FFidelityFXCASModule::Get().SetSSCASQuality(static_cast<EFidelityFXCASQuality>(NewQuality));
+		GQuality = NewQuality;
+	}
+
 #if FX_CAS_FP16_ENABLED
 	// SS CAS half precision
 	static bool GSSCASFP16 = false;
@@ -142,6 +296,94 @@ static void FidelityFXCASCVarSink()
 	}
 #endif // FX_CAS_FP16_ENABLED
 
+	// Dynamic resolution, the settings are only re-applied when one of them changed (the sink also runs for the controller's own r.ScreenPercentage writes)
+	static float GDRSCVars[5] = { -1.0f, -1.0f, -1.0f, -1.0f, -1.0f };
+	const float NewDRSCVars[5] = {
+		CVarFidelityFXCAS_DRSTargetFrameTime.GetValueOnGameThread(),
+		CVarFidelityFXCAS_DRSMinScreenPercentage.GetValueOnGameThread(),
+		CVarFidelityFXCAS_DRSMaxScreenPercentage.GetValueOnGameThread(),
+		FMath::Clamp(CVarFidelityFXCAS_DRSSharpnessAtMin.GetValueOnGameThread(), 0.0f, 1.0f),
+		FMath::Clamp(CVarFidelityFXCAS_DRSSharpnessAtMax.GetValueOnGameThread(), 0.0f, 1.0f) };
+	if (FMemory::Memcmp(GDRSCVars, NewDRSCVars, sizeof(GDRSCVars)) != 0)
+	{
+		FFidelityFXCASResolutionControllerSettings DRSSettings = FFidelityFXCASModule::Get().GetResolutionController().GetSettings();
+		DRSSettings.TargetFrameTime = NewDRSCVars[0];
+		DRSSettings.MinScreenPercentage = NewDRSCVars[1];
+		DRSSettings.MaxScreenPercentage = NewDRSCVars[2];
+		DRSSettings.SharpnessAtMinScreenPercentage = NewDRSCVars[3];
+		DRSSettings.SharpnessAtMaxScreenPercentage = NewDRSCVars[4];
+		FFidelityFXCASModule::Get().GetResolutionController().SetSettings(DRSSettings);
+		FMemory::Memcpy(GDRSCVars, NewDRSCVars, sizeof(GDRSCVars));
+	}
+
+	static bool GDRS = false;
+	bool bNewDRS = CVarFidelityFXCAS_DRS.GetValueOnGameThread();
+	if (bNewDRS != GDRS)
+	{
+		FFidelityFXCASModule::Get().SetIsDRSEnabled(bNewDRS);
+		GDRS = bNewDRS;
+	}
+
+	// Async compute
+	static bool GAsyncCompute = false;
+	bool bNewAsyncCompute = CVarFidelityFXCAS_AsyncCompute.GetValueOnGameThread();
+	if (bNewAsyncCompute != GAsyncCompute)
+	{
+		FFidelityFXCASModule::Get().SetUseAsyncCompute(bNewAsyncCompute);
+		GAsyncCompute = bNewAsyncCompute;
+	}
+
+	// View extension
+	static bool GViewExtension = true;
+	bool bNewViewExtension = CVarFidelityFXCAS_ViewExtension.GetValueOnGameThread();
+	if (bNewViewExtension != GViewExtension)
+	{
+		FFidelityFXCASModule::Get().SetUseViewExtension(bNewViewExtension);
+		GViewExtension = bNewViewExtension;
+	}
+
+	// Top mip rebuild budget
+	static float GMipRebuildBudget = 1.0f;
+	float NewMipRebuildBudget = FMath::Max(CVarFidelityFXCAS_MipRebuildBudget.GetValueOnGameThread(), 0.0f);
+	if (!FMath::IsNearlyEqual(NewMipRebuildBudget, GMipRebuildBudget))
+	{
+		FFidelityFXCASModule::Get().SetMipRebuildBudget(NewMipRebuildBudget);
+		GMipRebuildBudget = NewMipRebuildBudget;
+	}
+
+	// Readback ring size
+	static int32 GReadbackRingSize = 4;
+	int32 NewReadbackRingSize = FMath::Max(CVarFidelityFXCAS_ReadbackRingSize.GetValueOnGameThread(), 1);
+	if (NewReadbackRingSize != GReadbackRingSize)
+	{
+		FFidelityFXCASModule::Get().SetReadbackRingSize(NewReadbackRingSize);
+		GReadbackRingSize = NewReadbackRingSize;
+	}
+
+	// Fixed foveation, only applied when the cvars change so eye tracking can set the regions in between
+	static int32 GFoveation = 0;
+	static float GFoveationInner = 0.4f;
+	static float GFoveationOuter = 0.8f;
+	int32 NewFoveation = FMath::Max(CVarFidelityFXCAS_Foveation.GetValueOnGameThread(), 0);
+	float NewFoveationInner = FMath::Max(CVarFidelityFXCAS_FoveationInner.GetValueOnGameThread(), 0.0f);
+	float NewFoveationOuter = FMath::Max(CVarFidelityFXCAS_FoveationOuter.GetValueOnGameThread(), 0.0f);
+	if (NewFoveation != GFoveation || !FMath::IsNearlyEqual(NewFoveationInner, GFoveationInner) || !FMath::IsNearlyEqual(NewFoveationOuter, GFoveationOuter))
+	{
+		FFidelityFXCASModule::Get().SetSSCASFoveation(FFidelityFXCASFoveation::MakeFixed(NewFoveation, NewFoveationInner, NewFoveationOuter));
+		GFoveation = NewFoveation;
+		GFoveationInner = NewFoveationInner;
+		GFoveationOuter = NewFoveationOuter;
+	}
+
+	// Auto-tune
+	static int32 GAutoTune = 0;
+	int32 NewAutoTune = CVarFidelityFXCAS_AutoTune.GetValueOnGameThread();
+	if (NewAutoTune != GAutoTune)
+	{
+		FFidelityFXCASModule::Get().SetAutoTune(NewAutoTune);
+		GAutoTune = NewAutoTune;
+	}
+
 	// Screen percentage
 	static const TConsoleVariableData<float>* CVarScreenPercentage = IConsoleManager::Get().FindTConsoleVariableDataFloat(TEXT("r.ScreenPercentage"));
 	if (CVarScreenPercentage)
@@ -190,9 +432,17 @@ void FFidelityFXCASModule::StartupModule()
 	// Reset variables
 	bIsSSCASEnabled = false;
 	SSCASSharpness = 0.5f;
+	SSCASQuality = EFidelityFXCASQuality::Low;
 #if FX_CAS_PLUGIN_ENABLED
 	OnResolvedSceneColorHandle.Reset();
 #endif // FX_CAS_PLUGIN_ENABLED
+#if FX_CAS_PLUGIN_ENABLED && FX_CAS_VIEW_EXTENSION
+	// The view extension can only be registered with the engine, SS CAS enabled before runs from the resolved scene color callback until then
+	FCoreDelegates::OnPostEngineInit.AddRaw(this, &FFidelityFXCASModule::UpdateSSCASEnabled);
+#endif // FX_CAS_PLUGIN_ENABLED && FX_CAS_VIEW_EXTENSION
+#if WITH_EDITOR
+	StartFidelityFXCASCookBake();	// Bakes CAS into the cooked mips of the textures with bake settings, cook commandlet only
+#endif // WITH_EDITOR
 }
 
 void FFidelityFXCASModule::ShutdownModule()
@@ -200,7 +450,18 @@ void FFidelityFXCASModule::ShutdownModule()
 	// This function may be called during shutdown to clean up your module.
 	// For modules that support dynamic reloading, we call this function before unloading the module.
 
+	SetIsDRSEnabled(false);		// Stop the dynamic resolution controller
 	SetIsSSCASEnabled(false);	// Turn off screen space CAS
+	CancelTopMipRebuilds();		// Hand the queued top mips back to the streamer
+#if WITH_EDITOR
+	StopFidelityFXCASCookBake();	// Logs the bake throughput of the cook
+#endif // WITH_EDITOR
+	if (ReadbackTickerHandle.IsValid())	// Readbacks still in flight are not delivered
+		FTicker::GetCoreTicker().RemoveTicker(ReadbackTickerHandle);
+#if FX_CAS_PLUGIN_ENABLED && FX_CAS_VIEW_EXTENSION
+	FCoreDelegates::OnPostEngineInit.RemoveAll(this);
+	ViewExtension.Reset();
+#endif // FX_CAS_PLUGIN_ENABLED && FX_CAS_VIEW_EXTENSION
 }
 
 void FFidelityFXCASModule::SetIsSSCASEnabled(bool Enabled)
@@ -215,43 +476,126 @@ void FFidelityFXCASModule::SetIsSSCASEnabled(bool Enabled)
 #endif // FX_CAS_PLUGIN_ENABLED
 }
 
-void FFidelityFXCASModule::UpdateSSCASEnabled()
+FFidelityFXCASModule::ESSCASCallback FFidelityFXCASModule::ChooseSSCASCallback(bool bEnabled, bool bUseViewExtension, float ScreenPercentage, bool bNeedsRHIPass)
 {
+	if (!bEnabled)
+		return ESSCASCallback::None;
+
+	ESSCASCallback Callback = ESSCASCallback::ResolvedSceneColor;
+#if FX_CAS_VIEW_EXTENSION
+	// The render graph passes have no foveated or masked dispatch, without upscaling the resolved scene color callback runs them
+	if (bUseViewExtension && !(bNeedsRHIPass && ScreenPercentage >= 100.0f))
+		Callback = ESSCASCallback::ViewExtension;
+#endif // FX_CAS_VIEW_EXTENSION
+#if FX_CAS_CUSTOM_UPSCALE_CALLBACK
+	// The patched engine callback keeps upscaling on engines that have it
+	if (ScreenPercentage < 100.0f)
+		Callback = ESSCASCallback::CustomUpscale;
+#endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK
+	return Callback;
+}
+
 #if FX_CAS_PLUGIN_ENABLED
-	const FName RendererModuleName("Renderer");
-	IRendererModule* RendererModule = FModuleManager::GetModulePtr<IRendererModule>(RendererModuleName);
+// Binds the renderer callbacks of the screen space CAS, no passes (see FFidelityFXCASRHIPassBackend / FFidelityFXCASRDGPassBackend)
+class FFidelityFXCASSSCASCallbackBackend : public IFidelityFXCASPassBackend
+{
+public:
+	FFidelityFXCASSSCASCallbackBackend(FFidelityFXCASModule& InModule) : Module(InModule) { }
+
+	virtual void OutputBarrier() override { checkNoEntry(); }
+	virtual void UploadTileLists(const FFidelityFXCASTileClassification& Classification) override { checkNoEntry(); }
+	virtual void DispatchPass(const TArray<FFidelityFXCASDispatch>& Dispatches) override { checkNoEntry(); }
 
-	if (bIsSSCASEnabled)
+	virtual void RebindSSCASCallback(FFidelityFXCASModule::ESSCASCallback From, FFidelityFXCASModule::ESSCASCallback To) override
 	{
+		using ESSCASCallback = FFidelityFXCASModule::ESSCASCallback;
+		const FName RendererModuleName("Renderer");
+		IRendererModule* RendererModule = FModuleManager::GetModulePtr<IRendererModule>(RendererModuleName);
+
+		if (To == ESSCASCallback::CustomUpscale)
+		{
 #if FX_CAS_CUSTOM_UPSCALE_CALLBACK
-		bool bUpscale = false;
-		static const TConsoleVariableData<float>* CVarScreenPercentage = IConsoleManager::Get().FindTConsoleVariableDataFloat(TEXT("r.ScreenPercentage"));
-		if (CVarScreenPercentage)
-			bUpscale = CVarScreenPercentage->GetValueOnAnyThread() < 100.0f;
-		if (bUpscale)
+			Module.UnbindResolvedSceneColorCallback(RendererModule);
+			Module.BindCustomUpscaleCallback(RendererModule);
+#endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK
+		}
+		else if (To == ESSCASCallback::ResolvedSceneColor)
 		{
-			UnbindResolvedSceneColorCallback(RendererModule);
-			BindCustomUpscaleCallback(RendererModule);
+#if FX_CAS_CUSTOM_UPSCALE_CALLBACK
+			Module.UnbindCustomUpscaleCallback(RendererModule);
+#endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK
+			Module.BindResolvedSceneColorCallback(RendererModule);
 		}
 		else
 		{
-			UnbindCustomUpscaleCallback(RendererModule);
-			BindResolvedSceneColorCallback(RendererModule);
-		}
-#else // FX_CAS_CUSTOM_UPSCALE_CALLBACK
-		BindResolvedSceneColorCallback(RendererModule);
+			Module.UnbindResolvedSceneColorCallback(RendererModule);
+#if FX_CAS_CUSTOM_UPSCALE_CALLBACK
+			Module.UnbindCustomUpscaleCallback(RendererModule);
 #endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK
+		}
+#if FX_CAS_VIEW_EXTENSION
+		// Once registered the extension stays, it is only active while bound (see FFidelityFXCASViewExtension::IsActiveThisFrame_Internal)
+		if (To == ESSCASCallback::ViewExtension && !Module.ViewExtension.IsValid())
+			Module.ViewExtension = FSceneViewExtensions::NewExtension<FFidelityFXCASViewExtension>();
+#endif // FX_CAS_VIEW_EXTENSION
+	}
+
+protected:
+	FFidelityFXCASModule& Module;
+};
+#endif // FX_CAS_PLUGIN_ENABLED
+
+void FFidelityFXCASModule::UpdateSSCASEnabled()
+{
+#if FX_CAS_PLUGIN_ENABLED
+	static const TConsoleVariableData<float>* CVarScreenPercentage = IConsoleManager::Get().FindTConsoleVariableDataFloat(TEXT("r.ScreenPercentage"));
+	const float ScreenPercentage = CVarScreenPercentage ? CVarScreenPercentage->GetValueOnAnyThread() : 100.0f;
+	const bool bNeedsRHIPass = bHasSSCASSharpnessMask || GetSSCASFoveation().IsEnabled();
+	const ESSCASCallback NewCallback = ChooseSSCASCallback(bIsSSCASEnabled, bUseViewExtension && GEngine != nullptr, ScreenPercentage, bNeedsRHIPass);
+
+	FFidelityFXCASSSCASCallbackBackend Backend(*this);
+	BindSSCASCallback(NewCallback, BoundSSCASCallback, Backend);
+#endif // FX_CAS_PLUGIN_ENABLED
+}
+
+void FFidelityFXCASModule::SetIsDRSEnabled(bool Enabled)
+{
+#if FX_CAS_PLUGIN_ENABLED
+	if (Enabled == bIsDRSEnabled)
+		return;
+
+	bIsDRSEnabled = Enabled;
+	if (Enabled)
+	{
+		static const TConsoleVariableData<float>* CVarScreenPercentage = IConsoleManager::Get().FindTConsoleVariableDataFloat(TEXT("r.ScreenPercentage"));
+		ResolutionController.Reset(CVarScreenPercentage ? CVarScreenPercentage->GetValueOnGameThread() : 100.0f);
+		DRSTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FFidelityFXCASModule::TickDRS));
 	}
 	else
 	{
-		UnbindResolvedSceneColorCallback(RendererModule);
-#if FX_CAS_CUSTOM_UPSCALE_CALLBACK
-		UnbindCustomUpscaleCallback(RendererModule);
-#endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK
+		FTicker::GetCoreTicker().RemoveTicker(DRSTickerHandle);
+		DRSTickerHandle.Reset();
 	}
+	CVarFidelityFXCAS_DRS->Set(Enabled);
 #endif // FX_CAS_PLUGIN_ENABLED
 }
 
+bool FFidelityFXCASModule::TickDRS(float DeltaTime)
+{
+#if FX_CAS_PLUGIN_ENABLED
+	// GPU time of the last finished frame
+	const float GPUFrameTime = FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles());
+	if (ResolutionController.Update(GPUFrameTime))
+	{
+		static IConsoleVariable* CVarScreenPercentage = IConsoleManager::Get().FindConsoleVariable(TEXT("r.ScreenPercentage"));
+		// Same priority as the current value, so a value typed in the console does not lock the controller out
+		if (CVarScreenPercentage)
+			CVarScreenPercentage->Set(ResolutionController.GetScreenPercentage(), static_cast<EConsoleVariableFlags>(CVarScreenPercentage->GetFlags() & ECVF_SetByMask));
+	}
+#endif // FX_CAS_PLUGIN_ENABLED
+	return true;
+}
+
 void FFidelityFXCASModule::SetSSCASSharpness(float Sharpness)
 {
 #if FX_CAS_PLUGIN_ENABLED
@@ -263,6 +607,17 @@ void FFidelityFXCASModule::SetSSCASSharpness(float Sharpness)
 #endif // FX_CAS_PLUGIN_ENABLED
 }
 
+void FFidelityFXCASModule::SetSSCASQuality(EFidelityFXCASQuality Quality)
+{
+#if FX_CAS_PLUGIN_ENABLED
+	if (Quality != SSCASQuality)
+	{
+		SSCASQuality = Quality;
+		CVarFidelityFXCAS_Quality->Set(static_cast<int32>(Quality));
+	}
+#endif // FX_CAS_PLUGIN_ENABLED
+}
+
 void FFidelityFXCASModule::SetUseFP16(bool UseFP16)
 {
 #if FX_CAS_PLUGIN_ENABLED && FX_CAS_FP16_ENABLED
@@ -274,7 +629,106 @@ void FFidelityFXCASModule::SetUseFP16(bool UseFP16)
 #endif // FX_CAS_PLUGIN_ENABLED && FX_CAS_FP16_ENABLED
 }
 
+void FFidelityFXCASModule::SetUseAsyncCompute(bool UseAsyncCompute)
+{
+#if FX_CAS_PLUGIN_ENABLED
+	if (UseAsyncCompute != bUseAsyncCompute)
+	{
+		bUseAsyncCompute = UseAsyncCompute;
+		CVarFidelityFXCAS_AsyncCompute->Set(UseAsyncCompute);
+	}
+#endif // FX_CAS_PLUGIN_ENABLED
+}
+
+void FFidelityFXCASModule::SetUseViewExtension(bool UseViewExtension)
+{
+#if FX_CAS_PLUGIN_ENABLED
+	if (UseViewExtension != bUseViewExtension)
+	{
+		bUseViewExtension = UseViewExtension;
+		UpdateSSCASEnabled();
+		CVarFidelityFXCAS_ViewExtension->Set(UseViewExtension);
+	}
+#endif // FX_CAS_PLUGIN_ENABLED
+}
+
+void FFidelityFXCASModule::SetMipRebuildBudget(float Milliseconds)
+{
+	MipRebuildBudget = FMath::Max(Milliseconds, 0.0f);
 #if FX_CAS_PLUGIN_ENABLED
+	CVarFidelityFXCAS_MipRebuildBudget->Set(MipRebuildBudget);
+#endif // FX_CAS_PLUGIN_ENABLED
+}
+
+void FFidelityFXCASModule::SetReadbackRingSize(int32 Size)
+{
+	check(IsInGameThread());
+
+	ReadbackRingSize = FMath::Max(Size, 1);
+#if FX_CAS_PLUGIN_ENABLED
+	CVarFidelityFXCAS_ReadbackRingSize->Set(ReadbackRingSize);
+
+	// The ring is only touched on the render thread, the size reaches it in order with the requests
+	const int32 RingSize = ReadbackRingSize;
+	ENQUEUE_RENDER_COMMAND(FidelityFXCASModule_SetReadbackRingSize)(
+		[this, RingSize](FRHICommandListImmediate& RHICmdList)
+		{
+			ReadbackRingSize_RenderThread = RingSize;
+		});
+#endif // FX_CAS_PLUGIN_ENABLED
+}
+
+void FFidelityFXCASModule::SetSSCASFoveation(const FFidelityFXCASFoveation& Foveation)
+{
+	bool bWasEnabled;
+	{
+		FScopeLock Lock(&FoveationCS);
+		bWasEnabled = SSCASFoveation.IsEnabled();
+		SSCASFoveation = Foveation;
+	}
+#if FX_CAS_PLUGIN_ENABLED
+	// Switching foveation on or off may change the renderer callback, which is bound on the game thread
+	if (bWasEnabled != Foveation.IsEnabled())
+	{
+		if (IsInGameThread())
+			UpdateSSCASEnabled();
+		else
+			AsyncTask(ENamedThreads::GameThread, [this]() { UpdateSSCASEnabled(); });
+	}
+#endif // FX_CAS_PLUGIN_ENABLED
+}
+
+FFidelityFXCASFoveation FFidelityFXCASModule::GetSSCASFoveation() const
+{
+	FScopeLock Lock(&FoveationCS);
+	return SSCASFoveation;
+}
+
+EFidelityFXCASComputePipe FFidelityFXCASModule::GetSSCASComputePipe() const
+{
+	if (!bUseAsyncCompute)
+		return EFidelityFXCASComputePipe::Graphics;
+
+	// Only the RDG passes (upscale callback, view extension) can be scheduled on async compute, the resolved scene color callback runs on the immediate command list
+#if FX_CAS_PLUGIN_ENABLED && (FX_CAS_CUSTOM_UPSCALE_CALLBACK || FX_CAS_VIEW_EXTENSION) && FX_CAS_RDG_ASYNC_COMPUTE
+	if ((BoundSSCASCallback == ESSCASCallback::CustomUpscale || BoundSSCASCallback == ESSCASCallback::ViewExtension) && GSupportsEfficientAsyncCompute)
+		return EFidelityFXCASComputePipe::AsyncCompute;
+#endif // FX_CAS_PLUGIN_ENABLED && (FX_CAS_CUSTOM_UPSCALE_CALLBACK || FX_CAS_VIEW_EXTENSION) && FX_CAS_RDG_ASYNC_COMPUTE
+	return EFidelityFXCASComputePipe::GraphicsFallback;
+}
+
+#if FX_CAS_PLUGIN_ENABLED
+// Per frame counts of the SS CAS passes on each pipe (stat FidelityFXCAS)
+static void CountSSCASPass(EFidelityFXCASComputePipe Pipe)
+{
+	switch (Pipe)
+	{
+	case EFidelityFXCASComputePipe::AsyncCompute:     INC_DWORD_STAT(STAT_FidelityFXCAS_AsyncComputePasses); break;
+	case EFidelityFXCASComputePipe::GraphicsFallback: INC_DWORD_STAT(STAT_FidelityFXCAS_AsyncComputeFallbacks); break;
+	default:                                          INC_DWORD_STAT(STAT_FidelityFXCAS_GraphicsPasses); break;
+	}
+}
+
 void FFidelityFXCASModule::BindResolvedSceneColorCallback(IRendererModule* RendererModule)
 {
 	if (!OnResolvedSceneColorHandle.IsValid())
@@ -300,37 +754,52 @@ void FFidelityFXCASModule::UnbindCustomUpscaleCallback(IRendererModule* Renderer
 }
 #endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK
 
-void FFidelityFXCASModule::PrepareComputeShaderOutput_RenderThread(FRHICommandListImmediate& RHICmdList, const FIntPoint& OutputSize, TRefCountPtr<IPooledRenderTarget>& CSOutput, const TCHAR* InDebugName)
+void FFidelityFXCASModule::PrepareComputeShaderOutput_RenderThread(FRHICommandListImmediate& RHICmdList, const FIntPoint& OutputSize, TRefCountPtr<IPooledRenderTarget>& CSOutput, const TCHAR* InDebugName, int32 ArraySize, EPixelFormat Format)
 {
 	check(IsInRenderingThread());
 
 	static const TCHAR* GFXCASCSOutputDebugName = TEXT("FidelityFXCASModule_CSOutput");
 	const TCHAR* DebugName = InDebugName ? InDebugName : GFXCASCSOutputDebugName;
 
-	bool bNeedsRecreate = false;
+	// If the render target already exists, check if the size and the format haven't changed
+	FFidelityFXCASOutputDesc CurrentDesc;
 	if (CSOutput.IsValid())
 	{
-		// If the render target already exists, check if the size hasn't changed
-		FRHITexture2D* RHITexture2D = CSOutput->GetRenderTargetItem().TargetableTexture->GetTexture2D();
-		bNeedsRecreate = (!RHITexture2D || (RHITexture2D->GetSizeXY() != OutputSize));
+		const FTextureRHIRef& Texture = CSOutput->GetRenderTargetItem().TargetableTexture;
+		const FRHITexture2DArray* RHITexture2DArray = Texture->GetTexture2DArray();
+		const FIntVector TextureSize = Texture->GetSizeXYZ();
+		CurrentDesc = FFidelityFXCASOutputDesc(FIntPoint(TextureSize.X, TextureSize.Y), RHITexture2DArray ? TextureSize.Z : 0, Texture->GetFormat());
 	}
+	if (!FFidelityFXCASOutputDesc::NeedsRecreate(CSOutput.IsValid() ? &CurrentDesc : nullptr, FFidelityFXCASOutputDesc(OutputSize, ArraySize, Format)))
+		return;
+
+	// The named outputs (tiles, readback conversions, mip rebuilds, ...) are recreated often and also in commandlets, they only log
+	const bool bOnScreenMessages = !InDebugName && GEngine;
 
-	if (bNeedsRecreate)
+	if (CSOutput.IsValid())
 	{
 		// Release the shader output
-		GEngine->AddOnScreenDebugMessage(INDEX_NONE, 2.f, FColor::Silver, FString::Printf(TEXT("Releasing compute shader output...")));
+		if (bOnScreenMessages)
+			GEngine->AddOnScreenDebugMessage(INDEX_NONE, 2.f, FColor::Silver, FString::Printf(TEXT("Releasing compute shader output...")));
+		else
+			UE_LOG(LogFidelityFXCAS, Verbose, TEXT("Releasing compute shader output %s."), DebugName);
 		GRenderTargetPool.FreeUnusedResource(CSOutput);
 	}
 
 	// Create the shader output
-	if (!CSOutput.IsValid() || bNeedsRecreate)
-	{
+	if (bOnScreenMessages)
 		GEngine->AddOnScreenDebugMessage(INDEX_NONE, 2.f, FColor::Silver, FString::Printf(TEXT("Creating compute shader output [%dx%d]..."), OutputSize.X, OutputSize.Y));
-		FPooledRenderTargetDesc CSOutputDesc(FPooledRenderTargetDesc::Create2DDesc(OutputSize, PF_FloatRGBA, FClearValueBinding::None,
-			TexCreate_None, TexCreate_ShaderResource | TexCreate_UAV, false));
-		CSOutputDesc.DebugName = DebugName;
-		GRenderTargetPool.FindFreeElement(RHICmdList, CSOutputDesc, CSOutput, DebugName);
+	else
+		UE_LOG(LogFidelityFXCAS, Verbose, TEXT("Creating compute shader output %s [%dx%d]."), DebugName, OutputSize.X, OutputSize.Y);
+	FPooledRenderTargetDesc CSOutputDesc(FPooledRenderTargetDesc::Create2DDesc(OutputSize, Format, FClearValueBinding::None,
+		TexCreate_None, TexCreate_ShaderResource | TexCreate_UAV, false));
+	if (ArraySize > 0)
+	{
+		CSOutputDesc.ArraySize = ArraySize;
+		CSOutputDesc.bIsArray = true;
 	}
+	CSOutputDesc.DebugName = DebugName;
+	GRenderTargetPool.FindFreeElement(RHICmdList, CSOutputDesc, CSOutput, DebugName);
 }
 #endif // FX_CAS_PLUGIN_ENABLED
 
@@ -369,12 +838,20 @@ void FFidelityFXCASModule::OnResolvedSceneColor_RenderThread(FRHICommandListImme
 
 	// Prepare pass parameters
 	FFidelityFXCASPassParams_RHI CASPassParams(SceneColorTexture, SceneColorTexture, ComputeShaderOutput_RHI);
-	CASPassParams.Sharpness = FMath::Clamp(SSCASSharpness, 0.0f, 1.0f);
+	CASPassParams.Sharpness = FMath::Clamp(GetSSCASEffectiveSharpness(), 0.0f, 1.0f);
 	CASPassParams.bUseFP16 = bUseFP16;
+	CASPassParams.Quality = SSCASQuality;
+	CASPassParams.Foveation = GetSSCASFoveation();
+	CASPassParams.SharpnessMask = SSCASSharpnessMask;
+	CountSSCASPass(GetSSCASComputePipe());
 
 	// Update resolution info
 	SetSSCASResolutionInfo(CASPassParams.GetInputSize(), CASPassParams.GetOutputSize());
 
+	// First launch calibration at the current resolution
+	if (bAutoTunePending.AtomicSet(false))
+		RunAutoTune_RenderThread(RHICmdList, CASPassParams.GetInputSize(), CASPassParams.GetOutputSize(), CASPassParams.Quality);
+
 	// Make sure the computer shader output is ready and has the correct size
 	PrepareComputeShaderOutput_RenderThread(RHICmdList, CASPassParams.GetOutputSize(), CASPassParams.CSOutput);
 
@@ -393,21 +870,159 @@ void FFidelityFXCASModule::OnAddUpscalePass_RenderThread(class FRDGBuilder& Grap
 
 	// Prepare pass parameters
 	FFidelityFXCASPassParams_RDG CASPassParams(InInputViewRect, SceneColor, RTBinding, ComputeShaderOutput_RDG);
-	CASPassParams.Sharpness = FMath::Clamp(SSCASSharpness, 0.0f, 1.0f);
+	CASPassParams.Sharpness = FMath::Clamp(GetSSCASEffectiveSharpness(), 0.0f, 1.0f);
 	CASPassParams.bUseFP16 = bUseFP16;
+	CASPassParams.Quality = SSCASQuality;
 
 	// Update resolution info
 	SetSSCASResolutionInfo(CASPassParams.GetInputSize(), CASPassParams.GetOutputSize());
 
+	// First launch calibration at the current resolution
+	if (bAutoTunePending.AtomicSet(false))
+		RunAutoTune_RenderThread(GraphBuilder.RHICmdList, CASPassParams.GetInputSize(), CASPassParams.GetOutputSize(), CASPassParams.Quality);
+
 	// Make sure the computer shader output is ready and has the correct size
 	PrepareComputeShaderOutput_RenderThread(GraphBuilder.RHICmdList, CASPassParams.GetOutputSize(), CASPassParams.CSOutput);
 
+	// The graph tracks the CS output, so the CS pass can move to the async compute pipe
+	CASPassParams.RegisterCSOutput(GraphBuilder);
+	CASPassParams.ComputePipe = GetSSCASComputePipe();
+	CountSSCASPass(CASPassParams.ComputePipe);
+
 	// Call shaders
 	RunComputeShader_RDG_RenderThread(GraphBuilder, CASPassParams);
 	DrawToRenderTarget_RDG_RenderThread(GraphBuilder, CASPassParams);
 }
 #endif	// FX_CAS_CUSTOM_UPSCALE_CALLBACK
 
+#if FX_CAS_VIEW_EXTENSION
+void FFidelityFXCASModule::OnViewExtensionPass_RenderThread(class FRDGBuilder& GraphBuilder, const FIntRect& InInputViewRect, class FRDGTexture* SceneColor, const FIntRect& OutputViewRect, class FRDGTexture* Output)
+{
+	check(IsInRenderingThread());
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASModule_OnViewExtensionPass);             // Used to gather CPU profiling data for the UE4 session frontend
+	SCOPED_DRAW_EVENT(GraphBuilder.RHICmdList, FidelityFXCASModule_OnViewExtensionPass); // Used to profile GPU activity and add metadata to be consumed by for example RenderDoc
+
+	// Prepare pass parameters, the CS writes the output texture directly
+	FFidelityFXCASPassParams_RDG CASPassParams(InInputViewRect, SceneColor, OutputViewRect, Output);
+	CASPassParams.Sharpness = FMath::Clamp(GetSSCASEffectiveSharpness(), 0.0f, 1.0f);
+	CASPassParams.bUseFP16 = bUseFP16;
+	CASPassParams.Quality = SSCASQuality;
+	CASPassParams.ComputePipe = GetSSCASComputePipe();
+	CountSSCASPass(CASPassParams.ComputePipe);
+
+	// Update resolution info
+	SetSSCASResolutionInfo(CASPassParams.GetInputSize(), CASPassParams.GetOutputSize());
+
+	// First launch calibration at the current resolution
+	if (bAutoTunePending.AtomicSet(false))
+		RunAutoTune_RenderThread(GraphBuilder.RHICmdList, CASPassParams.GetInputSize(), CASPassParams.GetOutputSize(), CASPassParams.Quality);
+
+	// Call shader
+	RunComputeShader_RDG_RenderThread(GraphBuilder, CASPassParams);
+}
+#endif // FX_CAS_VIEW_EXTENSION
+
+// Prefilter constants of the downscales beyond 2x (CAS_SAMPLE_PREFILTER). Returns the CAS input size for CasSetup(), the reduced size when prefiltering.
+template<typename TParameters>
+static FIntPoint SetupPrefilter(TParameters& PassParameters, const FIntPoint& InputSize, const FIntPoint& OutputSize)
+{
+	PassParameters.PrefilterSize = FFidelityFXCASCPUModule::GetPrefilterSize(InputSize, OutputSize);
+	PassParameters.PrefilterInputMax = InputSize - FIntPoint(1, 1);
+	return FFidelityFXCASCPUModule::GetPrefilteredSize(InputSize, PassParameters.PrefilterSize);
+}
+
+// Issues the pass plans (FidelityFXCASPassBackend.h) on the RHI command list
+class FFidelityFXCASRHIPassBackend : public IFidelityFXCASPassBackend
+{
+public:
+	FFidelityFXCASRHIPassBackend(FFidelityFXCASModule& InModule, FRHICommandListImmediate& InRHICmdList, const FFidelityFXCASPassParams_RHI& InCASPassParams)
+		: Module(InModule)
+		, RHICmdList(InRHICmdList)
+		, CASPassParams(InCASPassParams)
+	{
+	}
+
+	virtual void OutputBarrier() override
+	{
+		PRAGMA_DISABLE_DEPRECATION_WARNINGS
+		UnbindRenderTargets(RHICmdList);
+		PRAGMA_ENABLE_DEPRECATION_WARNINGS
+		RHICmdList.TransitionResource(EResourceTransitionAccess::ERWBarrier, EResourceTransitionPipeline::EGfxToCompute, CASPassParams.GetUAV());
+	}
+
+	virtual void UploadTileLists(const FFidelityFXCASTileClassification& Classification) override
+	{
+		Module.UploadFoveatedTileLists_RenderThread(Classification);
+	}
+
+	virtual void DispatchPass(const TArray<FFidelityFXCASDispatch>& Dispatches) override
+	{
+		if (Dispatches.Num() == 0)
+			return;
+
+		switch (Dispatches[0].Permutation.Kind)
+		{
+		case EFidelityFXCASPassKind::Masked:   Module.RunComputeShaderMasked_RHI_RenderThread(RHICmdList, CASPassParams, Dispatches); break;
+		case EFidelityFXCASPassKind::Foveated: Module.RunComputeShaderFoveated_RHI_RenderThread(RHICmdList, CASPassParams, Dispatches); break;
+		case EFidelityFXCASPassKind::Array:    Module.DispatchComputeShaderArray_RHI_RenderThread(RHICmdList, CASPassParams, Dispatches); break;
+		default:                               Module.DispatchComputeShader_RHI_RenderThread(RHICmdList, CASPassParams, Dispatches); break;
+		}
+	}
+
+protected:
+	FFidelityFXCASModule& Module;
+	FRHICommandListImmediate& RHICmdList;
+	const FFidelityFXCASPassParams_RHI& CASPassParams;
+};
+
+template<typename TShader>
+static void DispatchShader_RHI(FRHICommandListImmediate& RHICmdList, const FFidelityFXCASShaderCS_RHI::FParameters& PassParameters, const FFidelityFXCASPassParams_RHI& CASPassParams,
+	const TArray<FFidelityFXCASDispatch>& Dispatches)
+{
+	// The quality tier is part of the event name so ProfileGPU and stat GPU report the cost of each tier
+	SCOPED_DRAW_EVENTF(RHICmdList, FidelityFXCAS_Dispatch, TEXT("CAS CS %s %dx%d -> %dx%d"), GetFidelityFXCASQualityName(CASPassParams.Quality),
+		CASPassParams.GetInputSize().X, CASPassParams.GetInputSize().Y, CASPassParams.GetOutputSize().X, CASPassParams.GetOutputSize().Y);
+	TShaderMapRef<TShader> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+
+	// Whole output, or one dispatch per dirty region covering the thread groups it touches
+	FFidelityFXCASShaderCS_RHI::FParameters RegionParameters = PassParameters;
+	for (const FFidelityFXCASDispatch& Dispatch : Dispatches)
+	{
+		RegionParameters.GroupOffset = Dispatch.GroupOffset;
+		FComputeShaderUtils::Dispatch(RHICmdList, FXCAS_SHADER_ARG(ComputeShader), RegionParameters, Dispatch.GroupCount);
+	}
+}
+
+// Quality permutation, the plan already applied the FP16 fallback from Ultra to High
+template<bool FP16, bool SHARPEN_ONLY, int32 FIXED_RATIO>
+static void Dispatch_RHI(FRHICommandListImmediate& RHICmdList, const FFidelityFXCASShaderCS_RHI::FParameters& PassParameters, const FFidelityFXCASPassParams_RHI& CASPassParams,
+	const TArray<FFidelityFXCASDispatch>& Dispatches)
+{
+	switch (Dispatches[0].Permutation.Quality)
+	{
+	case EFidelityFXCASQuality::Medium: DispatchShader_RHI<TFidelityFXCASShaderCS_RHI<FP16, SHARPEN_ONLY, FIXED_RATIO, 1>>(RHICmdList, PassParameters, CASPassParams, Dispatches); break;
+	case EFidelityFXCASQuality::High:   DispatchShader_RHI<TFidelityFXCASShaderCS_RHI<FP16, SHARPEN_ONLY, FIXED_RATIO, 2>>(RHICmdList, PassParameters, CASPassParams, Dispatches); break;
+	case EFidelityFXCASQuality::Ultra:  DispatchShader_RHI<TFidelityFXCASShaderCS_RHI<FP16, SHARPEN_ONLY, FIXED_RATIO, 3>>(RHICmdList, PassParameters, CASPassParams, Dispatches); break;
+	default:                            DispatchShader_RHI<TFidelityFXCASShaderCS_RHI<FP16, SHARPEN_ONLY, FIXED_RATIO, 0>>(RHICmdList, PassParameters, CASPassParams, Dispatches); break;
+	}
+}
+
+// Scale permutation matching the scale ratio, the common upscales have the scale constants compiled in
+template<bool FP16>
+static void DispatchUpscale_RHI(FRHICommandListImmediate& RHICmdList, const FFidelityFXCASShaderCS_RHI::FParameters& PassParameters, const FFidelityFXCASPassParams_RHI& CASPassParams,
+	const TArray<FFidelityFXCASDispatch>& Dispatches)
+{
+	switch (Dispatches[0].Permutation.FixedRatio)
+	{
+	case EFidelityFXCASFixedRatio::Upscale2x:            Dispatch_RHI<FP16, false, 1>(RHICmdList, PassParameters, CASPassParams, Dispatches); break;
+	case EFidelityFXCASFixedRatio::Upscale3_2:           Dispatch_RHI<FP16, false, 2>(RHICmdList, PassParameters, CASPassParams, Dispatches); break;
+	case EFidelityFXCASFixedRatio::Upscale4_3:           Dispatch_RHI<FP16, false, 3>(RHICmdList, PassParameters, CASPassParams, Dispatches); break;
+	case EFidelityFXCASFixedRatio::DownscalePrefiltered: Dispatch_RHI<FP16, false, 4>(RHICmdList, PassParameters, CASPassParams, Dispatches); break;
+	default:                                             Dispatch_RHI<FP16, false, 0>(RHICmdList, PassParameters, CASPassParams, Dispatches); break;
+	}
+}
+
 void FFidelityFXCASModule::RunComputeShader_RHI_RenderThread(FRHICommandListImmediate& RHICmdList, const class FFidelityFXCASPassParams_RHI& CASPassParams)
 {
 	check(IsInRenderingThread());
@@ -415,119 +1030,267 @@ void FFidelityFXCASModule::RunComputeShader_RHI_RenderThread(FRHICommandListImme
 	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASModule_RunComputeShader_RHI); // Used to gather CPU profiling data for the UE4 session frontend
 	SCOPED_DRAW_EVENT(RHICmdList, FidelityFXCASModule_RunComputeShader_RHI);  // Used to profile GPU activity and add metadata to be consumed by for example RenderDoc
 
-	PRAGMA_DISABLE_DEPRECATION_WARNINGS
-	UnbindRenderTargets(RHICmdList);
-	PRAGMA_ENABLE_DEPRECATION_WARNINGS
-	RHICmdList.TransitionResource(EResourceTransitionAccess::ERWBarrier, EResourceTransitionPipeline::EGfxToCompute, CASPassParams.GetUAV());
+	// Masked passes scale the sharpness per pixel, foveated passes dispatch over tile lists instead of the whole output
+	FFidelityFXCASPassDesc PassDesc = CASPassParams.GetPassDesc();
+	PassDesc.TileClassification = &GetFoveatedTileClassification_RenderThread();
+	FFidelityFXCASRHIPassBackend Backend(*this, RHICmdList, CASPassParams);
+	BuildFidelityFXCASComputePass(PassDesc, Backend);
+}
 
+void FFidelityFXCASModule::DispatchComputeShader_RHI_RenderThread(FRHICommandListImmediate& RHICmdList, const class FFidelityFXCASPassParams_RHI& CASPassParams,
+	const TArray<FFidelityFXCASDispatch>& Dispatches)
+{
 	// Setup shader parameters
 	FFidelityFXCASShaderCS_RHI::FParameters PassParameters;
 	PassParameters.InputTexture = CASPassParams.GetInputTexture();
+	PassParameters.GroupOffset = FIntPoint::ZeroValue;
+	PassParameters.TileSourceOffset = CASPassParams.TileSourceOffset;
+	PassParameters.TileOutputOffset = CASPassParams.TileOutputOffset;
 	PassParameters.OutputTexture = CASPassParams.GetUAV();
+	const FIntPoint CASInputSize = SetupPrefilter(PassParameters, CASPassParams.GetInputSize(), CASPassParams.GetOutputSize());
 	CasSetup(reinterpret_cast<AU1*>(&PassParameters.const0), reinterpret_cast<AU1*>(&PassParameters.const1),
 		CASPassParams.Sharpness,
-		static_cast<AF1>(CASPassParams.GetInputSize().X), static_cast<AF1>(CASPassParams.GetInputSize().Y),
+		static_cast<AF1>(CASInputSize.X), static_cast<AF1>(CASInputSize.Y),
 		CASPassParams.GetOutputSize().X, CASPassParams.GetOutputSize().Y);
 
-	// Choose shader version and dispatch
-	bool SharpenOnly = (CASPassParams.GetInputSize() == CASPassParams.GetOutputSize());
+	// Shader version chosen by the plan
+	const FFidelityFXCASPermutation& Permutation = Dispatches[0].Permutation;
 #if FX_CAS_FP16_ENABLED
-	if (CASPassParams.bUseFP16 && SharpenOnly)
+	if (Permutation.bFP16 && Permutation.bSharpenOnly)
 	{
-		TShaderMapRef<TFidelityFXCASShaderCS_RHI_FP16_SharpenOnly> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-		FComputeShaderUtils::Dispatch(RHICmdList, FXCAS_SHADER_ARG(ComputeShader), PassParameters, GetDispatchGroupCount(CASPassParams.GetOutputSize()));
+		Dispatch_RHI<true, true, 0>(RHICmdList, PassParameters, CASPassParams, Dispatches);
 	}
 	else
 #endif // FX_CAS_FP16_ENABLED
-	if (SharpenOnly)
+	if (Permutation.bSharpenOnly)
 	{
-		TShaderMapRef<TFidelityFXCASShaderCS_RHI_FP32_SharpenOnly> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-		FComputeShaderUtils::Dispatch(RHICmdList, FXCAS_SHADER_ARG(ComputeShader), PassParameters, GetDispatchGroupCount(CASPassParams.GetOutputSize()));
+		Dispatch_RHI<false, true, 0>(RHICmdList, PassParameters, CASPassParams, Dispatches);
 	}
 #if FX_CAS_FP16_ENABLED
-	else if (CASPassParams.bUseFP16)
+	else if (Permutation.bFP16)
 	{
-		TShaderMapRef<TFidelityFXCASShaderCS_RHI_FP16_Upscale> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-		FComputeShaderUtils::Dispatch(RHICmdList, FXCAS_SHADER_ARG(ComputeShader), PassParameters, GetDispatchGroupCount(CASPassParams.GetOutputSize()));
+		DispatchUpscale_RHI<true>(RHICmdList, PassParameters, CASPassParams, Dispatches);
 	}
 #endif // FX_CAS_FP16_ENABLED
 	else
 	{
-		TShaderMapRef<TFidelityFXCASShaderCS_RHI_FP32_Upscale> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-		FComputeShaderUtils::Dispatch(RHICmdList, FXCAS_SHADER_ARG(ComputeShader), PassParameters, GetDispatchGroupCount(CASPassParams.GetOutputSize()));
+		DispatchUpscale_RHI<false>(RHICmdList, PassParameters, CASPassParams, Dispatches);
 	}
 }
 
-#if FX_CAS_CUSTOM_UPSCALE_CALLBACK
-void FFidelityFXCASModule::RunComputeShader_RDG_RenderThread(FRDGBuilder& GraphBuilder, const class FFidelityFXCASPassParams_RDG& CASPassParams)
+template<typename TShader>
+static void DispatchArrayShader_RHI(FRHICommandListImmediate& RHICmdList, const FFidelityFXCASShaderArrayCS_RHI::FParameters& PassParameters, const FFidelityFXCASPassParams_RHI& CASPassParams,
+	const TArray<FFidelityFXCASDispatch>& Dispatches)
+{
+	SCOPED_DRAW_EVENTF(RHICmdList, FidelityFXCAS_DispatchArray, TEXT("CAS CS %s %dx%d -> %dx%d, %d slices"), GetFidelityFXCASQualityName(CASPassParams.Quality),
+		CASPassParams.GetInputSize().X, CASPassParams.GetInputSize().Y, CASPassParams.GetOutputSize().X, CASPassParams.GetOutputSize().Y, CASPassParams.NumSlices);
+	TShaderMapRef<TShader> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+	for (const FFidelityFXCASDispatch& Dispatch : Dispatches)
+		FComputeShaderUtils::Dispatch(RHICmdList, FXCAS_SHADER_ARG(ComputeShader), PassParameters, Dispatch.GroupCount);
+}
+
+// Quality permutation, the plan already applied the FP16 fallback from Ultra to High
+template<bool FP16, bool SHARPEN_ONLY, bool VOLUME>
+static void DispatchArrayQuality_RHI(FRHICommandListImmediate& RHICmdList, const FFidelityFXCASShaderArrayCS_RHI::FParameters& PassParameters, const FFidelityFXCASPassParams_RHI& CASPassParams,
+	const TArray<FFidelityFXCASDispatch>& Dispatches)
+{
+	switch (Dispatches[0].Permutation.Quality)
+	{
+	case EFidelityFXCASQuality::Medium: DispatchArrayShader_RHI<TFidelityFXCASShaderArrayCS_RHI<FP16, SHARPEN_ONLY, VOLUME, 1>>(RHICmdList, PassParameters, CASPassParams, Dispatches); break;
+	case EFidelityFXCASQuality::High:   DispatchArrayShader_RHI<TFidelityFXCASShaderArrayCS_RHI<FP16, SHARPEN_ONLY, VOLUME, 2>>(RHICmdList, PassParameters, CASPassParams, Dispatches); break;
+	case EFidelityFXCASQuality::Ultra:  DispatchArrayShader_RHI<TFidelityFXCASShaderArrayCS_RHI<FP16, SHARPEN_ONLY, VOLUME, 3>>(RHICmdList, PassParameters, CASPassParams, Dispatches); break;
+	default:                            DispatchArrayShader_RHI<TFidelityFXCASShaderArrayCS_RHI<FP16, SHARPEN_ONLY, VOLUME, 0>>(RHICmdList, PassParameters, CASPassParams, Dispatches); break;
+	}
+}
+
+// Texture3D or Texture2DArray input permutation
+template<bool FP16, bool SHARPEN_ONLY>
+static void DispatchArray_RHI(FRHICommandListImmediate& RHICmdList, const FFidelityFXCASShaderArrayCS_RHI::FParameters& PassParameters, const FFidelityFXCASPassParams_RHI& CASPassParams,
+	const TArray<FFidelityFXCASDispatch>& Dispatches)
+{
+	if (Dispatches[0].Permutation.bVolume)
+		DispatchArrayQuality_RHI<FP16, SHARPEN_ONLY, true>(RHICmdList, PassParameters, CASPassParams, Dispatches);
+	else
+		DispatchArrayQuality_RHI<FP16, SHARPEN_ONLY, false>(RHICmdList, PassParameters, CASPassParams, Dispatches);
+}
+
+void FFidelityFXCASModule::RunComputeShaderArray_RHI_RenderThread(FRHICommandListImmediate& RHICmdList, const class FFidelityFXCASPassParams_RHI& CASPassParams)
 {
 	check(IsInRenderingThread());
 
-	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASModule_RunComputeShader_RDG);             // Used to gather CPU profiling data for the UE4 session frontend
-	SCOPED_DRAW_EVENT(GraphBuilder.RHICmdList, FidelityFXCASModule_RunComputeShader_RDG); // Used to profile GPU activity and add metadata to be consumed by for example RenderDoc
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASModule_RunComputeShaderArray_RHI); // Used to gather CPU profiling data for the UE4 session frontend
+	SCOPED_DRAW_EVENT(RHICmdList, FidelityFXCASModule_RunComputeShaderArray_RHI);  // Used to profile GPU activity and add metadata to be consumed by for example RenderDoc
 
-	PRAGMA_DISABLE_DEPRECATION_WARNINGS
-	UnbindRenderTargets(GraphBuilder.RHICmdList);
-	PRAGMA_ENABLE_DEPRECATION_WARNINGS
-	GraphBuilder.RHICmdList.TransitionResource(EResourceTransitionAccess::ERWBarrier, EResourceTransitionPipeline::EGfxToCompute, CASPassParams.GetUAV());
+	FFidelityFXCASPassDesc PassDesc = CASPassParams.GetPassDesc();
+	PassDesc.bArray = true;
+	FFidelityFXCASRHIPassBackend Backend(*this, RHICmdList, CASPassParams);
+	BuildFidelityFXCASComputePass(PassDesc, Backend);
+}
 
-	// Setup shader parameters
-	FFidelityFXCASShaderCS_RDG::FParameters* PassParameters = GraphBuilder.AllocParameters<FFidelityFXCASShaderCS_RDG::FParameters>();
-	PassParameters->InputTexture = CASPassParams.GetInputTexture();
-	PassParameters->OutputTexture = CASPassParams.GetUAV();
-	CasSetup(reinterpret_cast<AU1*>(&PassParameters->const0), reinterpret_cast<AU1*>(&PassParameters->const1),
+void FFidelityFXCASModule::DispatchComputeShaderArray_RHI_RenderThread(FRHICommandListImmediate& RHICmdList, const class FFidelityFXCASPassParams_RHI& CASPassParams,
+	const TArray<FFidelityFXCASDispatch>& Dispatches)
+{
+	// Setup shader parameters, the slices share the constants
+	FFidelityFXCASShaderArrayCS_RHI::FParameters PassParameters;
+	PassParameters.InputTexture = CASPassParams.GetInputTexture();
+	PassParameters.GroupOffset = FIntPoint::ZeroValue;
+	PassParameters.OutputTexture = CASPassParams.GetUAV();
+	CasSetup(reinterpret_cast<AU1*>(&PassParameters.const0), reinterpret_cast<AU1*>(&PassParameters.const1),
 		CASPassParams.Sharpness,
 		static_cast<AF1>(CASPassParams.GetInputSize().X), static_cast<AF1>(CASPassParams.GetInputSize().Y),
 		CASPassParams.GetOutputSize().X, CASPassParams.GetOutputSize().Y);
 
-	// Choose shader version and dispatch
-	bool SharpenOnly = (CASPassParams.GetInputSize() == CASPassParams.GetOutputSize());
+	// Shader version chosen by the plan
+	const FFidelityFXCASPermutation& Permutation = Dispatches[0].Permutation;
 #if FX_CAS_FP16_ENABLED
-	if (CASPassParams.bUseFP16 && SharpenOnly)
+	if (Permutation.bFP16 && Permutation.bSharpenOnly)
 	{
-		TShaderMapRef<TFidelityFXCASShaderCS_RDG<true, true>> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-		FComputeShaderUtils::AddPass(GraphBuilder,
-			RDG_EVENT_NAME("Upscale CS %dx%d -> %dx%d", CASPassParams.GetInputSize().X, CASPassParams.GetInputSize().Y, CASPassParams.GetOutputSize().X, CASPassParams.GetOutputSize().Y),
-			FXCAS_SHADER_ARG(ComputeShader), PassParameters, GetDispatchGroupCount(CASPassParams.GetOutputSize()));
+		DispatchArray_RHI<true, true>(RHICmdList, PassParameters, CASPassParams, Dispatches);
 	}
 	else
 #endif // FX_CAS_FP16_ENABLED
-	if (SharpenOnly)
+	if (Permutation.bSharpenOnly)
 	{
-		TShaderMapRef<TFidelityFXCASShaderCS_RDG<false, true>> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-		FComputeShaderUtils::AddPass(GraphBuilder,
-			RDG_EVENT_NAME("Upscale CS %dx%d -> %dx%d", CASPassParams.GetInputSize().X, CASPassParams.GetInputSize().Y, CASPassParams.GetOutputSize().X, CASPassParams.GetOutputSize().Y),
-			FXCAS_SHADER_ARG(ComputeShader), PassParameters, GetDispatchGroupCount(CASPassParams.GetOutputSize()));
+		DispatchArray_RHI<false, true>(RHICmdList, PassParameters, CASPassParams, Dispatches);
 	}
 #if FX_CAS_FP16_ENABLED
-	else if (CASPassParams.bUseFP16)
+	else if (Permutation.bFP16)
 	{
-		TShaderMapRef<TFidelityFXCASShaderCS_RDG<true, false>> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-		FComputeShaderUtils::AddPass(GraphBuilder,
-			RDG_EVENT_NAME("Upscale CS %dx%d -> %dx%d", CASPassParams.GetInputSize().X, CASPassParams.GetInputSize().Y, CASPassParams.GetOutputSize().X, CASPassParams.GetOutputSize().Y),
-			FXCAS_SHADER_ARG(ComputeShader), PassParameters, GetDispatchGroupCount(CASPassParams.GetOutputSize()));
+		DispatchArray_RHI<true, false>(RHICmdList, PassParameters, CASPassParams, Dispatches);
 	}
 #endif // FX_CAS_FP16_ENABLED
 	else
 	{
-		TShaderMapRef<TFidelityFXCASShaderCS_RDG<false, false>> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-		FComputeShaderUtils::AddPass(GraphBuilder,
-			RDG_EVENT_NAME("Upscale CS %dx%d -> %dx%d", CASPassParams.GetInputSize().X, CASPassParams.GetInputSize().Y, CASPassParams.GetOutputSize().X, CASPassParams.GetOutputSize().Y),
-			FXCAS_SHADER_ARG(ComputeShader), PassParameters, GetDispatchGroupCount(CASPassParams.GetOutputSize()));
+		DispatchArray_RHI<false, false>(RHICmdList, PassParameters, CASPassParams, Dispatches);
 	}
 }
-#endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK
 
-FIntVector FFidelityFXCASModule::GetDispatchGroupCount(FIntPoint OutputSize)
+#if FX_CAS_CUSTOM_UPSCALE_CALLBACK || FX_CAS_VIEW_EXTENSION
+template<typename TShader>
+static void AddPass_RDG(FRDGBuilder& GraphBuilder, FFidelityFXCASShaderCS_RDG::FParameters* PassParameters, const FFidelityFXCASPassParams_RDG& CASPassParams,
+	const FFidelityFXCASDispatch& Dispatch)
 {
-	// This value is the image region dim that each thread group of the CAS shader operates on
-	static const int32 ThreadGroupWorkRegionDim = 16;
-	FIntVector DispatchGroupCount(0, 0, 1);
-	DispatchGroupCount.X = (OutputSize.X + (ThreadGroupWorkRegionDim - 1)) / ThreadGroupWorkRegionDim;
-	DispatchGroupCount.Y = (OutputSize.Y + (ThreadGroupWorkRegionDim - 1)) / ThreadGroupWorkRegionDim;
-	return DispatchGroupCount;
+	// The quality tier and the pipe are part of the event name so ProfileGPU and stat GPU report the cost of each tier and the overlap
+	TShaderMapRef<TShader> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+	const bool bAsyncCompute = CASPassParams.ComputePipe == EFidelityFXCASComputePipe::AsyncCompute;
+	FComputeShaderUtils::AddPass(GraphBuilder,
+		RDG_EVENT_NAME("CAS CS %s%s %dx%d -> %dx%d", GetFidelityFXCASQualityName(CASPassParams.Quality), bAsyncCompute ? TEXT(" (async compute)") : TEXT(""),
+			CASPassParams.GetInputSize().X, CASPassParams.GetInputSize().Y, CASPassParams.GetOutputSize().X, CASPassParams.GetOutputSize().Y),
+#if FX_CAS_RDG_ASYNC_COMPUTE
+		bAsyncCompute ? ERDGPassFlags::AsyncCompute : ERDGPassFlags::Compute,
+#endif // FX_CAS_RDG_ASYNC_COMPUTE
+		FXCAS_SHADER_ARG(ComputeShader), PassParameters, Dispatch.GroupCount);
 }
 
+// Quality permutation, the plan already applied the FP16 fallback from Ultra to High
+template<bool FP16, bool SHARPEN_ONLY, int32 FIXED_RATIO>
+static void AddQualityPass_RDG(FRDGBuilder& GraphBuilder, FFidelityFXCASShaderCS_RDG::FParameters* PassParameters, const FFidelityFXCASPassParams_RDG& CASPassParams,
+	const FFidelityFXCASDispatch& Dispatch)
+{
+	switch (Dispatch.Permutation.Quality)
+	{
+	case EFidelityFXCASQuality::Medium: AddPass_RDG<TFidelityFXCASShaderCS_RDG<FP16, SHARPEN_ONLY, FIXED_RATIO, 1>>(GraphBuilder, PassParameters, CASPassParams, Dispatch); break;
+	case EFidelityFXCASQuality::High:   AddPass_RDG<TFidelityFXCASShaderCS_RDG<FP16, SHARPEN_ONLY, FIXED_RATIO, 2>>(GraphBuilder, PassParameters, CASPassParams, Dispatch); break;
+	case EFidelityFXCASQuality::Ultra:  AddPass_RDG<TFidelityFXCASShaderCS_RDG<FP16, SHARPEN_ONLY, FIXED_RATIO, 3>>(GraphBuilder, PassParameters, CASPassParams, Dispatch); break;
+	default:                            AddPass_RDG<TFidelityFXCASShaderCS_RDG<FP16, SHARPEN_ONLY, FIXED_RATIO, 0>>(GraphBuilder, PassParameters, CASPassParams, Dispatch); break;
+	}
+}
+
+// Scale permutation matching the scale ratio, the common upscales have the scale constants compiled in
+template<bool FP16>
+static void AddUpscalePass_RDG(FRDGBuilder& GraphBuilder, FFidelityFXCASShaderCS_RDG::FParameters* PassParameters, const FFidelityFXCASPassParams_RDG& CASPassParams,
+	const FFidelityFXCASDispatch& Dispatch)
+{
+	switch (Dispatch.Permutation.FixedRatio)
+	{
+	case EFidelityFXCASFixedRatio::Upscale2x:            AddQualityPass_RDG<FP16, false, 1>(GraphBuilder, PassParameters, CASPassParams, Dispatch); break;
+	case EFidelityFXCASFixedRatio::Upscale3_2:           AddQualityPass_RDG<FP16, false, 2>(GraphBuilder, PassParameters, CASPassParams, Dispatch); break;
+	case EFidelityFXCASFixedRatio::Upscale4_3:           AddQualityPass_RDG<FP16, false, 3>(GraphBuilder, PassParameters, CASPassParams, Dispatch); break;
+	case EFidelityFXCASFixedRatio::DownscalePrefiltered: AddQualityPass_RDG<FP16, false, 4>(GraphBuilder, PassParameters, CASPassParams, Dispatch); break;
+	default:                                             AddQualityPass_RDG<FP16, false, 0>(GraphBuilder, PassParameters, CASPassParams, Dispatch); break;
+	}
+}
+
+// Adds the planned passes to the graph, RDG transitions the input and the output (across pipes on async compute)
+class FFidelityFXCASRDGPassBackend : public IFidelityFXCASPassBackend
+{
+public:
+	FFidelityFXCASRDGPassBackend(FRDGBuilder& InGraphBuilder, const FFidelityFXCASShaderCS_RDG::FParameters& InPassParameters, const FFidelityFXCASPassParams_RDG& InCASPassParams)
+		: GraphBuilder(InGraphBuilder)
+		, PassParameters(InPassParameters)
+		, CASPassParams(InCASPassParams)
+	{
+	}
+
+	virtual void OutputBarrier() override { }
+	virtual void UploadTileLists(const FFidelityFXCASTileClassification& Classification) override { checkNoEntry(); }	// No foveated RDG passes
+
+	virtual void DispatchPass(const TArray<FFidelityFXCASDispatch>& Dispatches) override
+	{
+		for (const FFidelityFXCASDispatch& Dispatch : Dispatches)
+		{
+			// The graph keeps the parameters of each pass until it executes
+			FFidelityFXCASShaderCS_RDG::FParameters* DispatchParameters = GraphBuilder.AllocParameters<FFidelityFXCASShaderCS_RDG::FParameters>();
+			*DispatchParameters = PassParameters;
+			DispatchParameters->GroupOffset = Dispatch.GroupOffset;
+
+			const FFidelityFXCASPermutation& Permutation = Dispatch.Permutation;
+#if FX_CAS_FP16_ENABLED
+			if (Permutation.bFP16 && Permutation.bSharpenOnly)
+			{
+				AddQualityPass_RDG<true, true, 0>(GraphBuilder, DispatchParameters, CASPassParams, Dispatch);
+			}
+			else
+#endif // FX_CAS_FP16_ENABLED
+			if (Permutation.bSharpenOnly)
+			{
+				AddQualityPass_RDG<false, true, 0>(GraphBuilder, DispatchParameters, CASPassParams, Dispatch);
+			}
+#if FX_CAS_FP16_ENABLED
+			else if (Permutation.bFP16)
+			{
+				AddUpscalePass_RDG<true>(GraphBuilder, DispatchParameters, CASPassParams, Dispatch);
+			}
+#endif // FX_CAS_FP16_ENABLED
+			else
+			{
+				AddUpscalePass_RDG<false>(GraphBuilder, DispatchParameters, CASPassParams, Dispatch);
+			}
+		}
+	}
+
+protected:
+	FRDGBuilder& GraphBuilder;
+	const FFidelityFXCASShaderCS_RDG::FParameters& PassParameters;
+	const FFidelityFXCASPassParams_RDG& CASPassParams;
+};
+
+void FFidelityFXCASModule::RunComputeShader_RDG_RenderThread(FRDGBuilder& GraphBuilder, const class FFidelityFXCASPassParams_RDG& CASPassParams)
+{
+	check(IsInRenderingThread());
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASModule_RunComputeShader_RDG);             // Used to gather CPU profiling data for the UE4 session frontend
+	SCOPED_DRAW_EVENT(GraphBuilder.RHICmdList, FidelityFXCASModule_RunComputeShader_RDG); // Used to profile GPU activity and add metadata to be consumed by for example RenderDoc
+
+	// Setup shader parameters
+	FFidelityFXCASShaderCS_RDG::FParameters PassParameters;
+	PassParameters.InputTexture = CASPassParams.GetInputTexture();
+	PassParameters.GroupOffset = FIntPoint::ZeroValue;
+	PassParameters.TileSourceOffset = -CASPassParams.InputViewMin;
+	PassParameters.TileOutputOffset = -CASPassParams.OutputViewMin;
+	PassParameters.OutputTexture = GraphBuilder.CreateUAV(FRDGTextureUAVDesc(CASPassParams.CSOutputTexture));
+	const FIntPoint CASInputSize = SetupPrefilter(PassParameters, CASPassParams.GetInputSize(), CASPassParams.GetOutputSize());
+	CasSetup(reinterpret_cast<AU1*>(&PassParameters.const0), reinterpret_cast<AU1*>(&PassParameters.const1),
+		CASPassParams.Sharpness,
+		static_cast<AF1>(CASInputSize.X), static_cast<AF1>(CASInputSize.Y),
+		CASPassParams.GetOutputSize().X, CASPassParams.GetOutputSize().Y);
+
+	// The pass plan chooses the shader version and the dispatch, same as the RHI passes
+	FFidelityFXCASRDGPassBackend Backend(GraphBuilder, PassParameters, CASPassParams);
+	BuildFidelityFXCASComputePass(CASPassParams.GetPassDesc(), Backend);
+}
+#endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK || FX_CAS_VIEW_EXTENSION
+
 void FFidelityFXCASModule::DrawToRenderTarget_RHI_RenderThread(FRHICommandListImmediate& RHICmdList, const class FFidelityFXCASPassParams_RHI& CASPassParams)
 {
 	check(IsInRenderingThread());
@@ -535,7 +1298,17 @@ void FFidelityFXCASModule::DrawToRenderTarget_RHI_RenderThread(FRHICommandListIm
 	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASModule_DrawToRenderTarget_RHI); // Used to gather CPU profiling data for the UE4 session frontend
 	SCOPED_DRAW_EVENT(RHICmdList, FidelityFXCASModule_DrawToRenderTarget_RHI);  // Used to profile GPU activity and add metadata to be consumed by for example RenderDoc
 
-	FRHIRenderPassInfo RenderPassInfo(CASPassParams.GetRTTexture(), ERenderTargetActions::Clear_Store);
+	// Dirty region updates keep the rest of the render target
+	DrawTextureToRenderTarget_RHI_RenderThread(RHICmdList, CASPassParams.GetCSOutputTargetableTexture(), CASPassParams.GetRTTexture(), CASPassParams.DirtyRects);
+}
+
+void FFidelityFXCASModule::DrawTextureToRenderTarget_RHI_RenderThread(FRHICommandListImmediate& RHICmdList, const FTextureRHIRef& Texture, const FTextureRHIRef& RenderTarget,
+	const TArray<FIntRect>& ScissorRects)
+{
+	check(IsInRenderingThread());
+
+	const bool bScissorRectsOnly = (ScissorRects.Num() > 0);
+	FRHIRenderPassInfo RenderPassInfo(RenderTarget, bScissorRectsOnly ? ERenderTargetActions::Load_Store : ERenderTargetActions::Clear_Store);
 	RHICmdList.BeginRenderPass(RenderPassInfo, TEXT("FidelityFXCASModule_DrawToRenderTarget_RHI_RenderThread"));
 
 	auto ShaderMap = GetGlobalShaderMap(GMaxRHIFeatureLevel);
@@ -544,7 +1317,7 @@ void FFidelityFXCASModule::DrawToRenderTarget_RHI_RenderThread(FRHICommandListIm
 
 	// Setup the pixel shader
 	FFidelityFXCASShaderPS_RHI::FParameters PassParameters;
-	PassParameters.UpscaledTexture = CASPassParams.GetCSOutputTargetableTexture();
+	PassParameters.UpscaledTexture = Texture;
 	PassParameters.samLinearClamp = TStaticSamplerState<SF_Point, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
 
 	// Set the graphic pipeline state.
@@ -563,14 +1336,89 @@ void FFidelityFXCASModule::DrawToRenderTarget_RHI_RenderThread(FRHICommandListIm
 
 	// Draw
 	RHICmdList.SetStreamSource(0, GFidelityFXCASVertexBuffer.VertexBufferRHI, 0);
-	RHICmdList.DrawPrimitive(0, 2, 1);
+	if (bScissorRectsOnly)
+	{
+		for (const FIntRect& ScissorRect : ScissorRects)
+		{
+			RHICmdList.SetScissorRect(true, ScissorRect.Min.X, ScissorRect.Min.Y, ScissorRect.Max.X, ScissorRect.Max.Y);
+			RHICmdList.DrawPrimitive(0, 2, 1);
+		}
+		RHICmdList.SetScissorRect(false, 0, 0, 0, 0);
+	}
+	else
+	{
+		RHICmdList.DrawPrimitive(0, 2, 1);
+	}
 
 	// Resolve render target
-	//RHICmdList.CopyToResolveTarget(CASPassParams.GetRTTexture(), CASPassParams.GetRTTexture(), FResolveParams());
+	//RHICmdList.CopyToResolveTarget(RenderTarget, RenderTarget, FResolveParams());
+
+	RHICmdList.EndRenderPass();
+}
+
+void FFidelityFXCASModule::ResampleChroma_RenderThread(FRHICommandListImmediate& RHICmdList, const FTextureRHIRef& InputChroma, const FTextureRHIRef& OutputChroma)
+{
+	check(IsInRenderingThread());
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASModule_ResampleChroma); // Used to gather CPU profiling data for the UE4 session frontend
+	SCOPED_DRAW_EVENT(RHICmdList, FidelityFXCASModule_ResampleChroma);  // Used to profile GPU activity and add metadata to be consumed by for example RenderDoc
+
+	if (!InputChroma.IsValid() || !OutputChroma.IsValid() || InputChroma == OutputChroma)
+		return;
+
+	// Same size, pass through
+	if (InputChroma->GetSizeXYZ() == OutputChroma->GetSizeXYZ() && InputChroma->GetFormat() == OutputChroma->GetFormat())
+	{
+		RHICmdList.CopyTexture(InputChroma, OutputChroma, FRHICopyTextureInfo());
+		return;
+	}
+
+	// Bilinear upscale with the render target draw, the chroma planes are smooth enough that CAS would not add anything
+	FRHIRenderPassInfo RenderPassInfo(OutputChroma, ERenderTargetActions::DontLoad_Store);
+	RHICmdList.BeginRenderPass(RenderPassInfo, TEXT("FidelityFXCASModule_ResampleChroma"));
+
+	auto ShaderMap = GetGlobalShaderMap(GMaxRHIFeatureLevel);
+	TShaderMapRef<FFidelityFXCASShaderVS> VertexShader(ShaderMap);
+	TShaderMapRef<FFidelityFXCASShaderPS_RHI> PixelShader(ShaderMap);
+
+	FFidelityFXCASShaderPS_RHI::FParameters PassParameters;
+	PassParameters.UpscaledTexture = InputChroma;
+	PassParameters.samLinearClamp = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+
+	FGraphicsPipelineStateInitializer GraphicsPSOInit;
+	RHICmdList.ApplyCachedRenderTargets(GraphicsPSOInit);
+	GraphicsPSOInit.BlendState = TStaticBlendState<>::GetRHI();
+	GraphicsPSOInit.RasterizerState = TStaticRasterizerState<>::GetRHI();
+	GraphicsPSOInit.DepthStencilState = TStaticDepthStencilState<false, CF_Always>::GetRHI();
+	GraphicsPSOInit.BoundShaderState.VertexDeclarationRHI = GFilterVertexDeclaration.VertexDeclarationRHI;
+	GraphicsPSOInit.BoundShaderState.VertexShaderRHI = FXCAS_GET_VS(VertexShader);
+	GraphicsPSOInit.BoundShaderState.PixelShaderRHI = FXCAS_GET_PS(PixelShader);
+	GraphicsPSOInit.PrimitiveType = PT_TriangleStrip;
+	SetGraphicsPipelineState(RHICmdList, GraphicsPSOInit);
+
+	SetShaderParameters(RHICmdList, FXCAS_SHADER_ARG(PixelShader), FXCAS_GET_PS(PixelShader), PassParameters);
+
+	RHICmdList.SetStreamSource(0, GFidelityFXCASVertexBuffer.VertexBufferRHI, 0);
+	RHICmdList.DrawPrimitive(0, 2, 1);
 
 	RHICmdList.EndRenderPass();
 }
 
+void FFidelityFXCASModule::CopyToRenderTargetArray_RHI_RenderThread(FRHICommandListImmediate& RHICmdList, const class FFidelityFXCASPassParams_RHI& CASPassParams)
+{
+	check(IsInRenderingThread());
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASModule_CopyToRenderTargetArray_RHI); // Used to gather CPU profiling data for the UE4 session frontend
+	SCOPED_DRAW_EVENT(RHICmdList, FidelityFXCASModule_CopyToRenderTargetArray_RHI);  // Used to profile GPU activity and add metadata to be consumed by for example RenderDoc
+
+	// One copy for all slices instead of a pixel shader draw per slice
+	RHICmdList.TransitionResource(EResourceTransitionAccess::EReadable, CASPassParams.GetCSOutputTargetableTexture());
+	FRHICopyTextureInfo CopyInfo;
+	CopyInfo.Size = FIntVector(CASPassParams.GetOutputSize().X, CASPassParams.GetOutputSize().Y, 1);
+	CopyInfo.NumSlices = CASPassParams.NumSlices;
+	RHICmdList.CopyTexture(CASPassParams.GetCSOutputTargetableTexture(), CASPassParams.GetRTTexture(), CopyInfo);
+}
+
 #if FX_CAS_CUSTOM_UPSCALE_CALLBACK
 void FFidelityFXCASModule::DrawToRenderTarget_RDG_RenderThread(FRDGBuilder& GraphBuilder, const class FFidelityFXCASPassParams_RDG& CASPassParams)
 {
@@ -585,7 +1433,7 @@ void FFidelityFXCASModule::DrawToRenderTarget_RDG_RenderThread(FRDGBuilder& Grap
 
 	// Setup the pixel shader
 	FFidelityFXCASShaderPS_RDG::FParameters* PassParameters = GraphBuilder.AllocParameters<FFidelityFXCASShaderPS_RDG::FParameters>();
-	PassParameters->UpscaledTexture = CASPassParams.GetCSOutputTargetableTexture();
+	PassParameters->UpscaledTexture = CASPassParams.CSOutputTexture;
 	PassParameters->samLinearClamp = TStaticSamplerState<SF_Point, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
 	PassParameters->RenderTargets[0] = CASPassParams.GetRTBinding();
 
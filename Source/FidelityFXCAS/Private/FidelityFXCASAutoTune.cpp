@@ -0,0 +1,184 @@
+#include "FidelityFXCAS.h"
+#include "FidelityFXCASPassParams.h"
+#include "FidelityFXCASShaderCompilationRules.h"
+
+#include "Async/Async.h"
+#include "ClearQuad.h"
+#include "Misc/ConfigCacheIni.h"
+#include "RendererInterface.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogFidelityFXCASAutoTune, Log, All);
+
+// GameUserSettings.ini section holding the result of the last calibration
+static const TCHAR* GFXCASAutoTuneSection = TEXT("FidelityFXCAS.AutoTune");
+
+static FString GetAutoTuneTierKey(EFidelityFXCASQuality Quality, bool bFP16)
+{
+	return FString::Printf(TEXT("%s%sMilliseconds"), GetFidelityFXCASQualityName(Quality), bFP16 ? TEXT("FP16") : TEXT("FP32"));
+}
+
+void FFidelityFXCASModule::SetAutoTune(int32 Mode)
+{
+#if FX_CAS_PLUGIN_ENABLED
+	if (Mode <= 0)
+	{
+		bAutoTunePending = false;
+		return;
+	}
+
+	// A saved result measured on this GPU skips the calibration
+	if (Mode == 1 && LoadAutoTuneResult())
+		return;
+
+	// Runs on the render thread before the next SS CAS pass, at that pass' resolution
+	bAutoTunePending = true;
+#endif // FX_CAS_PLUGIN_ENABLED
+}
+
+float FFidelityFXCASModule::GetQualityTierMilliseconds(EFidelityFXCASQuality Quality, bool bFP16) const
+{
+	const int32 Tier = static_cast<int32>(Quality);
+	return Tier < FX_CAS_NUM_QUALITY_TIERS ? AutoTuneTierMilliseconds[bFP16 ? 1 : 0][Tier] : 0.0f;
+}
+
+bool FFidelityFXCASModule::LoadAutoTuneResult()
+{
+#if FX_CAS_PLUGIN_ENABLED
+	FString AdapterName;
+	if (!GConfig->GetString(GFXCASAutoTuneSection, TEXT("AdapterName"), AdapterName, GGameUserSettingsIni) || AdapterName != GRHIAdapterName)
+		return false;
+
+	bool bSavedUseFP16 = false;
+	if (!GConfig->GetBool(GFXCASAutoTuneSection, TEXT("bUseFP16"), bSavedUseFP16, GGameUserSettingsIni))
+		return false;
+
+	SetUseFP16(bSavedUseFP16);
+	for (int32 Precision = 0; Precision < 2; ++Precision)
+	{
+		for (int32 Tier = 0; Tier < FX_CAS_NUM_QUALITY_TIERS; ++Tier)
+		{
+			AutoTuneTierMilliseconds[Precision][Tier] = 0.0f;
+			GConfig->GetFloat(GFXCASAutoTuneSection, *GetAutoTuneTierKey(static_cast<EFidelityFXCASQuality>(Tier), Precision == 1),
+				AutoTuneTierMilliseconds[Precision][Tier], GGameUserSettingsIni);
+		}
+	}
+	UE_LOG(LogFidelityFXCASAutoTune, Log, TEXT("Applied the saved auto-tune result for %s: %s."), *AdapterName, bSavedUseFP16 ? TEXT("FP16") : TEXT("FP32"));
+	return true;
+#else
+	return false;
+#endif // FX_CAS_PLUGIN_ENABLED
+}
+
+#if FX_CAS_PLUGIN_ENABLED
+void FFidelityFXCASModule::RunAutoTune_RenderThread(FRHICommandListImmediate& RHICmdList, const FIntPoint& InputSize, const FIntPoint& OutputSize, EFidelityFXCASQuality Quality)
+{
+	check(IsInRenderingThread());
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASModule_AutoTune); // Used to gather CPU profiling data for the UE4 session frontend
+	SCOPED_DRAW_EVENT(RHICmdList, FidelityFXCASModule_AutoTune);  // Used to profile GPU activity and add metadata to be consumed by for example RenderDoc
+
+	if (!GSupportsTimestampRenderQueries)
+	{
+		UE_LOG(LogFidelityFXCASAutoTune, Warning, TEXT("The RHI does not support timestamp queries, keeping the current settings."));
+		return;
+	}
+
+	// Synthetic frame. CAS has no data dependent branches, so a flat frame costs the same as scene content.
+	TRefCountPtr<IPooledRenderTarget> SyntheticInput, SyntheticOutput;
+	PrepareComputeShaderOutput_RenderThread(RHICmdList, InputSize, SyntheticInput, TEXT("FidelityFXCASModule_AutoTuneInput"));
+	PrepareComputeShaderOutput_RenderThread(RHICmdList, OutputSize, SyntheticOutput, TEXT("FidelityFXCASModule_AutoTuneOutput"));
+	ClearUAV(RHICmdList, SyntheticInput->GetRenderTargetItem(), FLinearColor(0.5f, 0.5f, 0.5f, 1.0f));
+	RHICmdList.TransitionResource(EResourceTransitionAccess::EReadable, SyntheticInput->GetRenderTargetItem().ShaderResourceTexture);
+
+	FFidelityFXCASPassParams_RHI CASPassParams(SyntheticInput->GetRenderTargetItem().ShaderResourceTexture,
+		SyntheticOutput->GetRenderTargetItem().TargetableTexture, SyntheticOutput);
+
+	// Candidates, the FP16 permutations are not compiled everywhere (see FFidelityFXCASShaderCompilationRules)
+	TArray<bool> FP16Candidates = { false };
+#if FX_CAS_FP16_ENABLED
+	if (FFidelityFXCASShaderCompilationRules::IsFP16Supported(GMaxRHIShaderPlatform))
+		FP16Candidates.Add(true);
+#endif // FX_CAS_FP16_ENABLED
+
+	// Every quality tier with every precision, so the cost of the tiers is published next to the choice
+	static const int32 NumDispatches = 16;
+	float Milliseconds[2][FX_CAS_NUM_QUALITY_TIERS];
+	for (int32 Precision = 0; Precision < 2; ++Precision)
+		for (int32 Tier = 0; Tier < FX_CAS_NUM_QUALITY_TIERS; ++Tier)
+			Milliseconds[Precision][Tier] = MAX_flt;
+	for (bool bFP16 : FP16Candidates)
+	{
+		CASPassParams.bUseFP16 = bFP16;
+		for (int32 Tier = 0; Tier < FX_CAS_NUM_QUALITY_TIERS; ++Tier)
+		{
+			CASPassParams.Quality = static_cast<EFidelityFXCASQuality>(Tier);
+
+			// Warm up, the first dispatch may create the pipeline state
+			RunComputeShader_RHI_RenderThread(RHICmdList, CASPassParams);
+
+			FRenderQueryRHIRef BeginQuery = RHICreateRenderQuery(RQT_AbsoluteTime);
+			FRenderQueryRHIRef EndQuery = RHICreateRenderQuery(RQT_AbsoluteTime);
+			RHICmdList.EndRenderQuery(BeginQuery);
+			for (int32 Dispatch = 0; Dispatch < NumDispatches; ++Dispatch)
+				RunComputeShader_RHI_RenderThread(RHICmdList, CASPassParams);
+			RHICmdList.EndRenderQuery(EndQuery);
+
+			// Waiting for the GPU stalls this one frame, which is acceptable for a one time calibration
+			RHICmdList.ImmediateFlush(EImmediateFlushType::FlushRHIThread);
+			uint64 BeginMicroseconds = 0, EndMicroseconds = 0;
+			if (RHIGetRenderQueryResult(BeginQuery, BeginMicroseconds, true) && RHIGetRenderQueryResult(EndQuery, EndMicroseconds, true) && EndMicroseconds > BeginMicroseconds)
+				Milliseconds[bFP16 ? 1 : 0][Tier] = static_cast<float>(EndMicroseconds - BeginMicroseconds) / (1000.0f * NumDispatches);
+		}
+	}
+	const int32 QualityTier = static_cast<int32>(Quality);
+	if (Milliseconds[0][QualityTier] == MAX_flt && Milliseconds[1][QualityTier] == MAX_flt)
+	{
+		UE_LOG(LogFidelityFXCASAutoTune, Warning, TEXT("Timestamp queries failed, keeping the current settings."));
+		return;
+	}
+	// The precision is chosen for the quality in use
+	const bool bFP16Wins = Milliseconds[1][QualityTier] < Milliseconds[0][QualityTier];
+
+	UE_LOG(LogFidelityFXCASAutoTune, Log, TEXT("%s, %s quality, %dx%d -> %dx%d: FP32 %.3f ms, FP16 %s -> using %s."),
+		*GRHIAdapterName, GetFidelityFXCASQualityName(Quality), InputSize.X, InputSize.Y, OutputSize.X, OutputSize.Y, Milliseconds[0][QualityTier],
+		Milliseconds[1][QualityTier] == MAX_flt ? TEXT("n/a") : *FString::Printf(TEXT("%.3f ms"), Milliseconds[1][QualityTier]), bFP16Wins ? TEXT("FP16") : TEXT("FP32"));
+	for (int32 Tier = 0; Tier < FX_CAS_NUM_QUALITY_TIERS; ++Tier)
+	{
+		UE_LOG(LogFidelityFXCASAutoTune, Log, TEXT("  %-6s tier: FP32 %s, FP16 %s."), GetFidelityFXCASQualityName(static_cast<EFidelityFXCASQuality>(Tier)),
+			Milliseconds[0][Tier] == MAX_flt ? TEXT("n/a") : *FString::Printf(TEXT("%.3f ms"), Milliseconds[0][Tier]),
+			Milliseconds[1][Tier] == MAX_flt ? TEXT("n/a") : *FString::Printf(TEXT("%.3f ms"), Milliseconds[1][Tier]));
+	}
+
+	// Apply and save on the game thread, the setters update the console variables
+	TArray<float> TierMilliseconds;
+	for (int32 Precision = 0; Precision < 2; ++Precision)
+		for (int32 Tier = 0; Tier < FX_CAS_NUM_QUALITY_TIERS; ++Tier)
+			TierMilliseconds.Add(Milliseconds[Precision][Tier] == MAX_flt ? 0.0f : Milliseconds[Precision][Tier]);
+	AsyncTask(ENamedThreads::GameThread, [this, bFP16Wins, TierMilliseconds, QualityTier, InputSize, OutputSize]()
+	{
+		SetUseFP16(bFP16Wins);
+		FMemory::Memcpy(AutoTuneTierMilliseconds, TierMilliseconds.GetData(), sizeof(AutoTuneTierMilliseconds));
+
+		GConfig->SetString(GFXCASAutoTuneSection, TEXT("AdapterName"), *GRHIAdapterName, GGameUserSettingsIni);
+		GConfig->SetBool(GFXCASAutoTuneSection, TEXT("bUseFP16"), bFP16Wins, GGameUserSettingsIni);
+		GConfig->SetString(GFXCASAutoTuneSection, TEXT("InputResolution"), *FString::Printf(TEXT("%dx%d"), InputSize.X, InputSize.Y), GGameUserSettingsIni);
+		GConfig->SetString(GFXCASAutoTuneSection, TEXT("OutputResolution"), *FString::Printf(TEXT("%dx%d"), OutputSize.X, OutputSize.Y), GGameUserSettingsIni);
+		GConfig->SetFloat(GFXCASAutoTuneSection, TEXT("FP32Milliseconds"), AutoTuneTierMilliseconds[0][QualityTier], GGameUserSettingsIni);
+		if (AutoTuneTierMilliseconds[1][QualityTier] > 0.0f)
+			GConfig->SetFloat(GFXCASAutoTuneSection, TEXT("FP16Milliseconds"), AutoTuneTierMilliseconds[1][QualityTier], GGameUserSettingsIni);
+		// Cost of every tier, i.e. LowFP32Milliseconds, UltraFP16Milliseconds
+		for (int32 Precision = 0; Precision < 2; ++Precision)
+		{
+			for (int32 Tier = 0; Tier < FX_CAS_NUM_QUALITY_TIERS; ++Tier)
+			{
+				const FString Key = GetAutoTuneTierKey(static_cast<EFidelityFXCASQuality>(Tier), Precision == 1);
+				if (AutoTuneTierMilliseconds[Precision][Tier] > 0.0f)
+					GConfig->SetFloat(GFXCASAutoTuneSection, *Key, AutoTuneTierMilliseconds[Precision][Tier], GGameUserSettingsIni);
+				else
+					GConfig->RemoveKey(GFXCASAutoTuneSection, *Key, GGameUserSettingsIni);
+			}
+		}
+		GConfig->Flush(false, GGameUserSettingsIni);
+	});
+}
+#endif // FX_CAS_PLUGIN_ENABLED
@@ -0,0 +1,117 @@
+#include "FidelityFXCASBakeMipsCommandlet.h"
+#include "FidelityFXCASTextureBakeSettings.h"
+#include "FidelityFXCASTextureBake.h"
+
+#include "AssetRegistryModule.h"
+#include "Engine/Texture2D.h"
+#include "HAL/PlatformTime.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogFidelityFXCASBakeMips, Log, All);
+
+UFidelityFXCASBakeMipsCommandlet::UFidelityFXCASBakeMipsCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UFidelityFXCASBakeMipsCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString Path = TEXT("/Game");
+	FParse::Value(*Params, TEXT("Path="), Path);
+	FString TextureList;
+	FParse::Value(*Params, TEXT("Textures="), TextureList, false);
+	float DefaultSharpness = 0.5f;
+	FParse::Value(*Params, TEXT("Sharpness="), DefaultSharpness);
+	DefaultSharpness = FMath::Clamp(DefaultSharpness, 0.0f, 1.0f);
+	const bool bRebuildPlatformData = FParse::Param(*Params, TEXT("RebuildPlatformData"));
+	// Memory of the top mips and chains held at once, the textures are baked in batches below it
+	int32 BatchMegabytes = 1024;
+	FParse::Value(*Params, TEXT("BatchMemory="), BatchMegabytes);
+
+	// Gather the textures: the listed ones, or the ones with bake settings under the path
+	const double StartTime = FPlatformTime::Seconds();
+	TArray<UTexture2D*> Textures;
+	if (!TextureList.IsEmpty())
+	{
+		TArray<FString> ObjectPaths;
+		TextureList.ParseIntoArray(ObjectPaths, TEXT("+"));
+		for (const FString& ObjectPath : ObjectPaths)
+		{
+			UTexture2D* Texture = LoadObject<UTexture2D>(nullptr, *ObjectPath);
+			if (Texture)
+				Textures.Add(Texture);
+			else
+				UE_LOG(LogFidelityFXCASBakeMips, Error, TEXT("Texture %s not found."), *ObjectPath);
+		}
+	}
+	else
+	{
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+		AssetRegistry.SearchAllAssets(true);
+		FARFilter Filter;
+		Filter.ClassNames.Add(UTexture2D::StaticClass()->GetFName());
+		Filter.PackagePaths.Add(FName(*Path));
+		Filter.bRecursivePaths = true;
+		TArray<FAssetData> Assets;
+		AssetRegistry.GetAssets(Filter, Assets);
+		for (const FAssetData& Asset : Assets)
+		{
+			UTexture2D* Texture = Cast<UTexture2D>(Asset.GetAsset());
+			if (Texture && Texture->GetAssetUserData<UFidelityFXCASTextureBakeSettings>())
+				Textures.Add(Texture);
+		}
+	}
+	if (Textures.Num() == 0)
+	{
+		UE_LOG(LogFidelityFXCASBakeMips, Error, TEXT("No textures to bake (-Textures=<object paths> or UFidelityFXCASTextureBakeSettings on textures under %s)."), *Path);
+		return 1;
+	}
+
+	// The cook bakes each texture as it is loaded, the same bake over the textures in batches gives its throughput
+	FFidelityFXCASBakeStats Stats;
+	double RebuildTime = 0.0;
+	for (int32 FirstTexture = 0; FirstTexture < Textures.Num(); )
+	{
+		// Read the top mips of a batch
+		TArray<FFidelityFXCASBakeTexture> Batch;
+		int64 BatchBytes = 0;
+		for (; FirstTexture < Textures.Num() && (Batch.Num() == 0 || BatchBytes < static_cast<int64>(BatchMegabytes) * 1024 * 1024); ++FirstTexture)
+		{
+			UTexture2D* Texture = Textures[FirstTexture];
+			FFidelityFXCASBakeTexture BakeTexture;
+			if (!InitFidelityFXCASBakeTexture(Texture, Texture->GetAssetUserData<UFidelityFXCASTextureBakeSettings>(), DefaultSharpness, BakeTexture))
+			{
+				++Stats.NumFailed;
+				continue;
+			}
+			BatchBytes += BakeTexture.GetNumBytes();
+			Batch.Add(MoveTemp(BakeTexture));
+		}
+		BakeFidelityFXCASTextures(Batch, Stats);
+
+		// What the cook does next, in memory only: the packages are never saved
+		if (bRebuildPlatformData)
+		{
+			const double RebuildStartTime = FPlatformTime::Seconds();
+			for (FFidelityFXCASBakeTexture& BakeTexture : Batch)
+			{
+				if (!BakeTexture.bFailed)
+					ApplyFidelityFXCASBake(BakeTexture);
+			}
+			RebuildTime += FPlatformTime::Seconds() - RebuildStartTime;
+		}
+	}
+	const double TotalTime = FPlatformTime::Seconds() - StartTime;
+
+	// Report, the CAS throughput is what the cook budget depends on
+	UE_LOG(LogFidelityFXCASBakeMips, Display, TEXT("Baked %s. Total %.2f s, platform data rebuild %.2f s."), *Stats.ToString(), TotalTime, RebuildTime);
+	return Stats.NumFailed > 0 ? 1 : 0;
+#else
+	UE_LOG(LogFidelityFXCASBakeMips, Error, TEXT("FidelityFXCASBakeMips needs the editor (texture source data)."));
+	return 1;
+#endif // WITH_EDITOR
+}
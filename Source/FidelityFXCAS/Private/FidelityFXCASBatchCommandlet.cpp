@@ -0,0 +1,183 @@
+#include "FidelityFXCASBatchCommandlet.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+
+#include "FidelityFXCAS.h"
+#include "FidelityFXCASCPU.h"
+#include "FidelityFXCASCPUContext.h"
+#include "FidelityFXCASMappedFrame.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogFidelityFXCASBatch, Log, All);
+
+UFidelityFXCASBatchCommandlet::UFidelityFXCASBatchCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UFidelityFXCASBatchCommandlet::Main(const FString& Params)
+{
+	FString Input, Output;
+	if (!FParse::Value(*Params, TEXT("Input="), Input) || !FParse::Value(*Params, TEXT("Output="), Output))
+	{
+		UE_LOG(LogFidelityFXCASBatch, Error, TEXT("Usage: -run=FidelityFXCASBatch -Input=<file or wildcard> -Output=<file or directory> [-Sharpness=0.5] [-Scale=1.0] [-Streaming] [-GPU [-TileSize=4096]]"));
+		return 1;
+	}
+
+	// Settings
+	FFidelityFXCASCPUSettings Settings;
+	FParse::Value(*Params, TEXT("Sharpness="), Settings.Sharpness);
+	const bool bStreaming = FParse::Param(*Params, TEXT("Streaming"));
+	const bool bReportError = FParse::Param(*Params, TEXT("ReportError"));
+	float Scale = 1.0f;
+	FParse::Value(*Params, TEXT("Scale="), Scale);
+	FIntPoint OutputSize = FIntPoint::ZeroValue;
+	FParse::Value(*Params, TEXT("OutputWidth="), OutputSize.X);
+	FParse::Value(*Params, TEXT("OutputHeight="), OutputSize.Y);
+	const bool bAutoTune = FParse::Param(*Params, TEXT("AutoTune"));
+	FString TuningProfile = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("FidelityFXCAS"), TEXT("CPUTuning.ini"));
+	FParse::Value(*Params, TEXT("TuningProfile="), TuningProfile);
+	int32 TileCacheMegabytes = 0;
+	if (FParse::Value(*Params, TEXT("TileCache="), TileCacheMegabytes) && TileCacheMegabytes > 0)
+		Settings.bUseTileCache = true;
+	// Tiled GPU processing, needs -AllowCommandletRendering (the CPU engine is used otherwise)
+	const bool bGPU = FParse::Param(*Params, TEXT("GPU"));
+	int32 TileSize = 4096;
+	FParse::Value(*Params, TEXT("TileSize="), TileSize);
+
+	// Raw frame layout
+	FFidelityFXCASRawFrameDesc RawDesc;
+	FParse::Value(*Params, TEXT("RawWidth="), RawDesc.Width);
+	FParse::Value(*Params, TEXT("RawHeight="), RawDesc.Height);
+	FParse::Value(*Params, TEXT("RawPitch="), RawDesc.RowPitch);
+	FParse::Value(*Params, TEXT("RawHeader="), RawDesc.HeaderSize);
+	FString RawFormat;
+	if (FParse::Value(*Params, TEXT("RawFormat="), RawFormat) && !ParseFidelityFXCASPixelFormat(RawFormat, RawDesc.Format))
+	{
+		UE_LOG(LogFidelityFXCASBatch, Error, TEXT("Unknown raw format %s."), *RawFormat);
+		return 1;
+	}
+	if (FParse::Param(*Params, TEXT("RawBGRA")))
+		RawDesc.ChannelOrder = EFidelityFXCASChannelOrder::BGRA;
+
+	// Gather the input frames
+	TArray<FString> InputFiles;
+	if (Input.Contains(TEXT("*")) || Input.Contains(TEXT("?")))
+	{
+		TArray<FString> FoundFiles;
+		IFileManager::Get().FindFiles(FoundFiles, *Input, true, false);
+		FoundFiles.Sort();
+		for (const FString& FoundFile : FoundFiles)
+			InputFiles.Add(FPaths::Combine(FPaths::GetPath(Input), FoundFile));
+	}
+	else
+	{
+		InputFiles.Add(Input);
+	}
+	if (InputFiles.Num() == 0)
+	{
+		UE_LOG(LogFidelityFXCASBatch, Error, TEXT("No input frames found for %s."), *Input);
+		return 1;
+	}
+	const bool bOutputIsDirectory = InputFiles.Num() > 1 || IFileManager::Get().DirectoryExists(*Output);
+	if (bOutputIsDirectory)
+		IFileManager::Get().MakeDirectory(*Output, true);
+
+	// Process
+	FFidelityFXCASCPUModule& CPUModule = FFidelityFXCASCPUModule::Get();
+	TUniquePtr<FFidelityFXCASCPUContext> Context;	// Created for the first frame, its thread count may come from the tuning profile
+	int32 NumFailed = 0;
+	int64 NumPixels = 0;
+	double ProcessTime = 0.0;
+	const double StartTime = FPlatformTime::Seconds();
+	for (const FString& InputFile : InputFiles)
+	{
+		const FString OutputFile = bOutputIsDirectory ? FPaths::Combine(Output, FPaths::GetCleanFilename(InputFile)) : Output;
+
+		TUniquePtr<FFidelityFXCASMappedFrame> InputFrame = FFidelityFXCASMappedFrame::OpenRead(InputFile, &RawDesc, bStreaming);
+		if (!InputFrame.IsValid())
+		{
+			++NumFailed;
+			continue;
+		}
+		const FFidelityFXCASImageView& InputView = InputFrame->GetView();
+
+		FIntPoint FrameOutputSize = OutputSize;
+		if (FrameOutputSize.X <= 0 || FrameOutputSize.Y <= 0)
+			FrameOutputSize = FIntPoint(FMath::RoundToInt(InputView.Width * Scale), FMath::RoundToInt(InputView.Height * Scale));
+
+		TUniquePtr<FFidelityFXCASMappedFrame> OutputFrame = FFidelityFXCASMappedFrame::CreateWrite(OutputFile, FFidelityFXCASMappedFrame::GetFileType(OutputFile),
+			FrameOutputSize.X, FrameOutputSize.Y, InputView.Format, bStreaming);
+		if (!OutputFrame.IsValid())
+		{
+			++NumFailed;
+			continue;
+		}
+
+		// Raw outputs keep the channel order of the input
+		FFidelityFXCASImageView OutputView = OutputFrame->GetView();
+		if (FFidelityFXCASMappedFrame::GetFileType(OutputFile) == EFidelityFXCASFrameFileType::Raw)
+			OutputView.ChannelOrder = InputView.ChannelOrder;
+
+		if (!Context.IsValid())
+		{
+			// Saved tuning for this CPU and workload, or a new calibration with -AutoTune
+			FFidelityFXCASCPUTuning Tuning;
+			bool bTuned = FFidelityFXCASCPUModule::LoadTuning(TuningProfile, InputView.GetSize(), FrameOutputSize, InputView.Format, Tuning);
+			if (!bTuned && bAutoTune && CPUModule.AutoTune(InputView.GetSize(), FrameOutputSize, InputView.Format, Tuning))
+			{
+				FFidelityFXCASCPUModule::SaveTuning(TuningProfile, Tuning);
+				bTuned = true;
+			}
+			if (bTuned)
+			{
+				Tuning.ApplyTo(Settings);
+				UE_LOG(LogFidelityFXCASBatch, Display, TEXT("Tuning: SIMD %s, %d rows per task, %d threads."),
+					Settings.bAllowSIMD ? TEXT("ON") : TEXT("OFF"), Settings.RowsPerTask, Tuning.NumThreads);
+			}
+			Context = MakeUnique<FFidelityFXCASCPUContext>(bTuned ? Tuning.NumThreads : 0);
+			if (Settings.bUseTileCache)
+				Context->SetTileCacheBudget(static_cast<int64>(TileCacheMegabytes) * 1024 * 1024);
+		}
+
+		const double FrameStartTime = FPlatformTime::Seconds();
+		const bool bProcessed = bGPU
+			? FFidelityFXCASModule::Get().ProcessImageTiled(InputView, OutputView, Settings.Sharpness, false, EFidelityFXCASQuality::Low, TileSize)
+			: CPUModule.Process(*Context, InputView, OutputView, Settings);
+		if (!bProcessed)
+		{
+			++NumFailed;
+			continue;
+		}
+		ProcessTime += FPlatformTime::Seconds() - FrameStartTime;
+		NumPixels += static_cast<int64>(FrameOutputSize.X) * FrameOutputSize.Y;
+
+		FFidelityFXCASImageDifference Difference;
+		if (bReportError && CPUModule.MeasureErrorToReference(InputView, OutputView, Settings, Difference))
+		{
+			UE_LOG(LogFidelityFXCASBatch, Display, TEXT("%s: error to FP32 reference: max %g, mean %g, PSNR %.2f dB."),
+				*FPaths::GetCleanFilename(InputFile), Difference.MaxAbsError, Difference.MeanAbsError, Difference.PSNR);
+		}
+	}
+	const double TotalTime = FPlatformTime::Seconds() - StartTime;
+
+	// Report
+	const int32 NumProcessed = InputFiles.Num() - NumFailed;
+	UE_LOG(LogFidelityFXCASBatch, Display, TEXT("Processed %d frame(s), %d failed. Total %.2f s, CAS %.2f ms/frame, %.1f Mpix/s."),
+		NumProcessed, NumFailed, TotalTime,
+		NumProcessed > 0 ? ProcessTime * 1000.0 / NumProcessed : 0.0,
+		ProcessTime > 0.0 ? NumPixels / ProcessTime / 1000000.0 : 0.0);
+	if (Settings.bUseTileCache && Context.IsValid())
+	{
+		const FFidelityFXCASTileCacheStats CacheStats = Context->GetTileCacheStats();
+		UE_LOG(LogFidelityFXCASBatch, Display, TEXT("Tile cache: %lld tiles, hit rate %.1f%%, %lld evictions, saved %.2f s (hashing and copies %.2f s)."),
+			CacheStats.NumTiles, CacheStats.GetHitRate() * 100.0, CacheStats.NumEvictions, CacheStats.GetSavedSeconds(), CacheStats.OverheadSeconds);
+	}
+
+	return NumFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,412 @@
+#include "FidelityFXCASBenchmarkCommandlet.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include "FidelityFXCAS.h"
+#include "FidelityFXCASCPU.h"
+#include "FidelityFXCASMappedFrame.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogFidelityFXCASBenchmark, Log, All);
+
+// How the reference is rebuilt from the downscaled frame
+enum class EFidelityFXCASBenchmarkMethod : uint8
+{
+	Bilinear,			// Bilinear upscale
+	BilinearSharpen,	// Bilinear upscale, then CAS sharpen only
+	CASUpscale,			// CAS upscale
+};
+
+static const TCHAR* GetFidelityFXCASBenchmarkMethodName(EFidelityFXCASBenchmarkMethod Method)
+{
+	switch (Method)
+	{
+	case EFidelityFXCASBenchmarkMethod::Bilinear:        return TEXT("Bilinear");
+	case EFidelityFXCASBenchmarkMethod::BilinearSharpen: return TEXT("BilinearSharpen");
+	default:                                             return TEXT("CASUpscale");
+	}
+}
+
+// One point of the frontier, accumulated over the frames of the corpus
+struct FFidelityFXCASBenchmarkConfig
+{
+	float Ratio = 1.0f;
+	EFidelityFXCASBenchmarkMethod Method = EFidelityFXCASBenchmarkMethod::Bilinear;
+	float Sharpness = 0.0f;
+	bool bGPU = false;
+	EFidelityFXCASQuality Quality = EFidelityFXCASQuality::Low;
+
+	double Seconds = 0.0;			// The GPU rows count the GPU time of the dispatches
+	double TotalSeconds = 0.0;		// Wall time, with the uploads and the readbacks of the GPU rows
+	int64 NumPixels = 0;
+	double SumPSNR = 0.0;
+	double SumSSIM = 0.0;
+	int32 NumFrames = 0;
+	bool bFrontier = false;
+
+	FORCEINLINE double GetNsPerPixel() const { return NumPixels > 0 ? Seconds * 1.0e9 / NumPixels : 0.0; }
+	FORCEINLINE double GetTotalNsPerPixel() const { return NumPixels > 0 ? TotalSeconds * 1.0e9 / NumPixels : 0.0; }
+	FORCEINLINE float GetPSNR() const        { return NumFrames > 0 ? static_cast<float>(SumPSNR / NumFrames) : 0.0f; }
+	FORCEINLINE float GetSSIM() const        { return NumFrames > 0 ? static_cast<float>(SumSSIM / NumFrames) : 0.0f; }
+	// The CPU engine has a single CAS quality, the tiers are GPU shader permutations
+	FORCEINLINE const TCHAR* GetQualityName() const { return bGPU ? GetFidelityFXCASQualityName(Quality) : TEXT("CPU"); }
+
+	// No worse on cost and both metrics and better on one of them
+	bool IsDominatedBy(const FFidelityFXCASBenchmarkConfig& Other) const
+	{
+		const bool bNoWorse = Other.GetNsPerPixel() <= GetNsPerPixel() && Other.GetPSNR() >= GetPSNR() && Other.GetSSIM() >= GetSSIM();
+		const bool bBetter = Other.GetNsPerPixel() < GetNsPerPixel() || Other.GetPSNR() > GetPSNR() || Other.GetSSIM() > GetSSIM();
+		return bNoWorse && bBetter;
+	}
+};
+
+// Owning image buffer of the working format
+struct FFidelityFXCASBenchmarkImage
+{
+	TArray64<uint8> Data;
+	FFidelityFXCASImageView View;
+
+	void Init(const FIntPoint& Size, EFidelityFXCASPixelFormat Format, EFidelityFXCASChannelOrder ChannelOrder)
+	{
+		const int64 RowPitch = static_cast<int64>(Size.X) * GetFidelityFXCASBytesPerPixel(Format);
+		Data.SetNumUninitialized(RowPitch * Size.Y);
+		View = FFidelityFXCASImageView(Data.GetData(), Size.X, Size.Y, RowPitch, Format, ChannelOrder);
+	}
+};
+
+// Format of the GPU rows: the working format if the tile shader loads it as it is, RGBA32F otherwise (sRGB, RGB32F, ...)
+static EFidelityFXCASPixelFormat GetFidelityFXCASBenchmarkGPUFormat(EFidelityFXCASPixelFormat Format)
+{
+	switch (Format)
+	{
+	case EFidelityFXCASPixelFormat::RGBA32F:
+	case EFidelityFXCASPixelFormat::RGBA16F:
+	case EFidelityFXCASPixelFormat::RGBA8:   return Format;
+	default:                                 return EFidelityFXCASPixelFormat::RGBA32F;
+	}
+}
+
+static void ParseFidelityFXCASBenchmarkList(const FString& Params, const TCHAR* Name, TArray<float>& InOutValues)
+{
+	FString List;
+	if (!FParse::Value(*Params, Name, List, false))
+		return;
+	TArray<FString> Values;
+	List.ParseIntoArray(Values, TEXT("+"));
+	InOutValues.Reset();
+	for (const FString& Value : Values)
+		InOutValues.Add(FCString::Atof(*Value));
+}
+
+UFidelityFXCASBenchmarkCommandlet::UFidelityFXCASBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UFidelityFXCASBenchmarkCommandlet::Main(const FString& Params)
+{
+	FString Input;
+	if (!FParse::Value(*Params, TEXT("Input="), Input))
+	{
+		UE_LOG(LogFidelityFXCASBenchmark, Error, TEXT("Usage: -run=FidelityFXCASBenchmark -Input=<file or wildcard> [-Ratios=1.25+1.5+2] [-Sharpness=0+0.5+1] [-Output=Benchmark.csv] [-MinPSNR=35] [-MinSSIM=0.95] [-GPU]"));
+		return 1;
+	}
+
+	// Settings
+	TArray<float> Ratios = { 1.25f, 1.5f, 1.75f, 2.0f };
+	ParseFidelityFXCASBenchmarkList(Params, TEXT("Ratios="), Ratios);
+	Ratios.RemoveAll([](float Ratio)
+	{
+		// Larger ratios would need a prefiltered downscale, which is not bilinear anymore
+		const bool bSupported = Ratio > 1.0f && Ratio <= 2.0f;
+		if (!bSupported)
+			UE_LOG(LogFidelityFXCASBenchmark, Warning, TEXT("Ratio %g skipped, the ratios must be in (1, 2]."), Ratio);
+		return !bSupported;
+	});
+	TArray<float> SharpnessValues = { 0.0f, 0.25f, 0.5f, 0.75f, 1.0f };
+	ParseFidelityFXCASBenchmarkList(Params, TEXT("Sharpness="), SharpnessValues);
+	int32 NumRepeats = 3;
+	FParse::Value(*Params, TEXT("Repeat="), NumRepeats);
+	NumRepeats = FMath::Max(NumRepeats, 1);
+	FFidelityFXCASCPUSettings Settings;
+	Settings.bMultithreaded = !FParse::Param(*Params, TEXT("SingleThreaded"));
+	const bool bGPU = FParse::Param(*Params, TEXT("GPU"));
+	FString Output = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("FidelityFXCAS"), TEXT("Benchmark.csv"));
+	FParse::Value(*Params, TEXT("Output="), Output);
+	float MinPSNR = 0.0f, MinSSIM = 0.0f;
+	const bool bQualityBar = FParse::Value(*Params, TEXT("MinPSNR="), MinPSNR) | FParse::Value(*Params, TEXT("MinSSIM="), MinSSIM);
+	FString FormatName;
+	EFidelityFXCASPixelFormat WorkingFormat = EFidelityFXCASPixelFormat::RGBA32F;
+	const bool bWorkingFormat = FParse::Value(*Params, TEXT("Format="), FormatName);
+	if (bWorkingFormat && !ParseFidelityFXCASPixelFormat(FormatName, WorkingFormat))
+	{
+		UE_LOG(LogFidelityFXCASBenchmark, Error, TEXT("Unknown format %s."), *FormatName);
+		return 1;
+	}
+
+	// The GPU rows must not silently fall back to the CPU engine
+	if (bGPU)
+	{
+		float Pixel[4] = {};
+		const FFidelityFXCASImageView PixelView(Pixel, 1, 1, sizeof(Pixel), EFidelityFXCASPixelFormat::RGBA32F, EFidelityFXCASChannelOrder::RGBA);
+		if (!FFidelityFXCASModule::CanProcessImageTiledOnGPU(PixelView, PixelView))
+		{
+			UE_LOG(LogFidelityFXCASBenchmark, Error, TEXT("-GPU needs -AllowCommandletRendering and a GPU RHI, the GPU configurations would run on the CPU engine."));
+			return 1;
+		}
+	}
+
+	// Raw frame layout, same as the batch commandlet
+	FFidelityFXCASRawFrameDesc RawDesc;
+	FParse::Value(*Params, TEXT("RawWidth="), RawDesc.Width);
+	FParse::Value(*Params, TEXT("RawHeight="), RawDesc.Height);
+	FParse::Value(*Params, TEXT("RawPitch="), RawDesc.RowPitch);
+	FParse::Value(*Params, TEXT("RawHeader="), RawDesc.HeaderSize);
+	FString RawFormat;
+	if (FParse::Value(*Params, TEXT("RawFormat="), RawFormat) && !ParseFidelityFXCASPixelFormat(RawFormat, RawDesc.Format))
+	{
+		UE_LOG(LogFidelityFXCASBenchmark, Error, TEXT("Unknown raw format %s."), *RawFormat);
+		return 1;
+	}
+	if (FParse::Param(*Params, TEXT("RawBGRA")))
+		RawDesc.ChannelOrder = EFidelityFXCASChannelOrder::BGRA;
+
+	// Gather the reference frames
+	TArray<FString> InputFiles;
+	if (Input.Contains(TEXT("*")) || Input.Contains(TEXT("?")))
+	{
+		TArray<FString> FoundFiles;
+		IFileManager::Get().FindFiles(FoundFiles, *Input, true, false);
+		FoundFiles.Sort();
+		for (const FString& FoundFile : FoundFiles)
+			InputFiles.Add(FPaths::Combine(FPaths::GetPath(Input), FoundFile));
+	}
+	else
+	{
+		InputFiles.Add(Input);
+	}
+	if (InputFiles.Num() == 0 || Ratios.Num() == 0)
+	{
+		UE_LOG(LogFidelityFXCASBenchmark, Error, TEXT("No reference frames found for %s, or no valid ratio."), *Input);
+		return 1;
+	}
+
+	// Configurations, the bilinear upscale has no sharpness
+	TArray<FFidelityFXCASBenchmarkConfig> Configs;
+	for (float Ratio : Ratios)
+	{
+		FFidelityFXCASBenchmarkConfig& BilinearConfig = Configs.AddDefaulted_GetRef();
+		BilinearConfig.Ratio = Ratio;
+		for (float Sharpness : SharpnessValues)
+		{
+			for (int32 Tier = -1; Tier < (bGPU ? 4 : 0); ++Tier)
+			{
+				for (EFidelityFXCASBenchmarkMethod Method : { EFidelityFXCASBenchmarkMethod::BilinearSharpen, EFidelityFXCASBenchmarkMethod::CASUpscale })
+				{
+					FFidelityFXCASBenchmarkConfig& Config = Configs.AddDefaulted_GetRef();
+					Config.Ratio = Ratio;
+					Config.Method = Method;
+					Config.Sharpness = FMath::Clamp(Sharpness, 0.0f, 1.0f);
+					Config.bGPU = Tier >= 0;
+					Config.Quality = static_cast<EFidelityFXCASQuality>(FMath::Max(Tier, 0));
+				}
+			}
+		}
+	}
+
+	// Run
+	const FFidelityFXCASCPUModule& CPUModule = FFidelityFXCASCPUModule::Get();
+	int32 NumFrames = 0;
+	const double StartTime = FPlatformTime::Seconds();
+	for (const FString& InputFile : InputFiles)
+	{
+		TUniquePtr<FFidelityFXCASMappedFrame> InputFrame = FFidelityFXCASMappedFrame::OpenRead(InputFile, &RawDesc, false);
+		if (!InputFrame.IsValid())
+			continue;
+		const FFidelityFXCASImageView& InputView = InputFrame->GetView();
+
+		// Reference in the working format, so the rebuilds are compared without the conversion error
+		FFidelityFXCASBenchmarkImage Reference;
+		Reference.Init(InputView.GetSize(), bWorkingFormat ? WorkingFormat : InputView.Format, InputView.ChannelOrder);
+		if (!CPUModule.Resample(InputView, Reference.View, Settings))
+			continue;
+		++NumFrames;
+
+		FFidelityFXCASBenchmarkImage Downscaled, Upscaled, Rebuilt;
+		Upscaled.Init(Reference.View.GetSize(), Reference.View.Format, Reference.View.ChannelOrder);
+		Rebuilt.Init(Reference.View.GetSize(), Reference.View.Format, Reference.View.ChannelOrder);
+		// RGBA copies the tile shader loads as they are, converted outside of the timed runs
+		const EFidelityFXCASPixelFormat GPUFormat = GetFidelityFXCASBenchmarkGPUFormat(Reference.View.Format);
+		FFidelityFXCASBenchmarkImage GPUDownscaled, GPUUpscaled, GPURebuilt;
+		if (bGPU)
+		{
+			GPUUpscaled.Init(Reference.View.GetSize(), GPUFormat, EFidelityFXCASChannelOrder::RGBA);
+			GPURebuilt.Init(Reference.View.GetSize(), GPUFormat, EFidelityFXCASChannelOrder::RGBA);
+		}
+		float DownscaledRatio = 0.0f;
+		for (FFidelityFXCASBenchmarkConfig& Config : Configs)
+		{
+			if (Config.Ratio != DownscaledRatio)
+			{
+				const FIntPoint DownscaledSize(FMath::Max(FMath::RoundToInt(Reference.View.Width / Config.Ratio), 1), FMath::Max(FMath::RoundToInt(Reference.View.Height / Config.Ratio), 1));
+				Downscaled.Init(DownscaledSize, Reference.View.Format, Reference.View.ChannelOrder);
+				CPUModule.Resample(Reference.View, Downscaled.View, Settings);
+				if (bGPU)
+				{
+					GPUDownscaled.Init(DownscaledSize, GPUFormat, EFidelityFXCASChannelOrder::RGBA);
+					CPUModule.Resample(Downscaled.View, GPUDownscaled.View, Settings);
+				}
+				DownscaledRatio = Config.Ratio;
+			}
+
+			// Fastest of the runs. The GPU rows count the timestamps of the dispatches (plus the CPU bilinear upscale of BilinearSharpen),
+			// the uploads and the readbacks of ProcessImageTiled only count in the total.
+			FFidelityFXCASCPUSettings ConfigSettings = Settings;
+			ConfigSettings.Sharpness = Config.Sharpness;
+			const FFidelityFXCASBenchmarkImage& GPUInput = Config.Method == EFidelityFXCASBenchmarkMethod::BilinearSharpen ? GPUUpscaled : GPUDownscaled;
+			double Seconds = MAX_dbl;
+			double TotalSeconds = MAX_dbl;
+			bool bProcessed = !Config.bGPU || FFidelityFXCASModule::CanProcessImageTiledOnGPU(GPUInput.View, GPURebuilt.View);
+			for (int32 Repeat = 0; Repeat < NumRepeats && bProcessed; ++Repeat)
+			{
+				const double RunStartTime = FPlatformTime::Seconds();
+				double CPUSeconds = 0.0;
+				float GPUMilliseconds = -1.0f;
+				switch (Config.Method)
+				{
+				case EFidelityFXCASBenchmarkMethod::Bilinear:
+					bProcessed = CPUModule.Resample(Downscaled.View, Rebuilt.View, ConfigSettings);
+					break;
+				case EFidelityFXCASBenchmarkMethod::BilinearSharpen:
+					if (Config.bGPU)
+					{
+						bProcessed = CPUModule.Resample(Downscaled.View, GPUUpscaled.View, ConfigSettings);
+						CPUSeconds = FPlatformTime::Seconds() - RunStartTime;
+						bProcessed = bProcessed && FFidelityFXCASModule::Get().ProcessImageTiled(GPUUpscaled.View, GPURebuilt.View, Config.Sharpness, false, Config.Quality, 4096, &GPUMilliseconds);
+					}
+					else
+					{
+						bProcessed = CPUModule.Resample(Downscaled.View, Upscaled.View, ConfigSettings) && CPUModule.Process(Upscaled.View, Rebuilt.View, ConfigSettings);
+					}
+					break;
+				default:
+					bProcessed = Config.bGPU
+						? FFidelityFXCASModule::Get().ProcessImageTiled(GPUDownscaled.View, GPURebuilt.View, Config.Sharpness, false, Config.Quality, 4096, &GPUMilliseconds)
+						: CPUModule.Process(Downscaled.View, Rebuilt.View, ConfigSettings);
+					break;
+				}
+				const double RunSeconds = FPlatformTime::Seconds() - RunStartTime;
+				if (bProcessed && Config.bGPU && GPUMilliseconds < 0.0f)
+				{
+					UE_LOG(LogFidelityFXCASBenchmark, Error, TEXT("No GPU timestamps for %s %s, the RHI has no timestamp queries."), GetFidelityFXCASBenchmarkMethodName(Config.Method), Config.GetQualityName());
+					bProcessed = false;
+				}
+				Seconds = FMath::Min(Seconds, Config.bGPU ? CPUSeconds + GPUMilliseconds / 1000.0 : RunSeconds);
+				TotalSeconds = FMath::Min(TotalSeconds, RunSeconds);
+			}
+			// Back to the working format, the conversion error would otherwise count against the GPU rows
+			if (bProcessed && Config.bGPU)
+				bProcessed = CPUModule.Resample(GPURebuilt.View, Rebuilt.View, Settings);
+
+			FFidelityFXCASImageDifference Difference;
+			if (!bProcessed || !CPUModule.ComputeDifference(Reference.View, Rebuilt.View, Difference))
+			{
+				UE_LOG(LogFidelityFXCASBenchmark, Error, TEXT("%s: %s %s x%g failed."), *FPaths::GetCleanFilename(InputFile), GetFidelityFXCASBenchmarkMethodName(Config.Method),
+					Config.GetQualityName(), Config.Ratio);
+				continue;
+			}
+			Config.Seconds += Seconds;
+			Config.TotalSeconds += TotalSeconds;
+			Config.NumPixels += static_cast<int64>(Rebuilt.View.Width) * Rebuilt.View.Height;
+			Config.SumPSNR += FMath::Min(Difference.PSNR, 100.0f);	// Identical images count as 100 dB
+			Config.SumSSIM += Difference.SSIM;
+			++Config.NumFrames;
+		}
+	}
+	const double TotalTime = FPlatformTime::Seconds() - StartTime;
+	if (NumFrames == 0)
+	{
+		UE_LOG(LogFidelityFXCASBenchmark, Error, TEXT("No reference frame could be read."));
+		return 1;
+	}
+
+	// Frontier: the configurations of a ratio no other one beats on cost and quality at once
+	for (FFidelityFXCASBenchmarkConfig& Config : Configs)
+	{
+		Config.bFrontier = Config.NumFrames > 0 && !Configs.ContainsByPredicate([&Config](const FFidelityFXCASBenchmarkConfig& Other)
+		{
+			return Other.Ratio == Config.Ratio && Other.NumFrames > 0 && Config.IsDominatedBy(Other);
+		});
+	}
+
+	// Report
+	UE_LOG(LogFidelityFXCASBenchmark, Display, TEXT("%d frame(s), %d configuration(s), %.2f s%s."), NumFrames, Configs.Num(), TotalTime,
+		bGPU ? TEXT(" (GPU rows: GPU time of the dispatches, the total adds the upload and the readback)") : TEXT(""));
+	for (const FFidelityFXCASBenchmarkConfig& Config : Configs)
+	{
+		if (!Config.bFrontier)
+			continue;
+		UE_LOG(LogFidelityFXCASBenchmark, Display, TEXT("Frontier x%.2f %-16s %-6s sharpness %.2f: %8.2f ns/pixel (%8.2f total), PSNR %.2f dB, SSIM %.4f"),
+			Config.Ratio, GetFidelityFXCASBenchmarkMethodName(Config.Method), Config.GetQualityName(), Config.Sharpness, Config.GetNsPerPixel(), Config.GetTotalNsPerPixel(),
+			Config.GetPSNR(), Config.GetSSIM());
+	}
+	if (bQualityBar)
+	{
+		for (float Ratio : Ratios)
+		{
+			const FFidelityFXCASBenchmarkConfig* Cheapest = nullptr;
+			for (const FFidelityFXCASBenchmarkConfig& Config : Configs)
+			{
+				if (Config.Ratio == Ratio && Config.NumFrames > 0 && Config.GetPSNR() >= MinPSNR && Config.GetSSIM() >= MinSSIM
+					&& (!Cheapest || Config.GetNsPerPixel() < Cheapest->GetNsPerPixel()))
+				{
+					Cheapest = &Config;
+				}
+			}
+			if (Cheapest)
+				UE_LOG(LogFidelityFXCASBenchmark, Display, TEXT("Cheapest x%.2f meeting PSNR >= %.2f, SSIM >= %.4f: %s %s sharpness %.2f (%.2f ns/pixel)."), Ratio, MinPSNR, MinSSIM,
+					GetFidelityFXCASBenchmarkMethodName(Cheapest->Method), Cheapest->GetQualityName(), Cheapest->Sharpness, Cheapest->GetNsPerPixel());
+			else
+				UE_LOG(LogFidelityFXCASBenchmark, Display, TEXT("No configuration meets PSNR >= %.2f, SSIM >= %.4f at x%.2f."), MinPSNR, MinSSIM, Ratio);
+		}
+	}
+
+	// All configurations, the frontier flagged
+	FString Text;
+	const bool bJson = FPaths::GetExtension(Output).Equals(TEXT("json"), ESearchCase::IgnoreCase);
+	if (bJson)
+		Text = FString::Printf(TEXT("{\n\t\"frames\": %d,\n\t\"configurations\": [\n"), NumFrames);
+	else
+		Text = TEXT("Ratio,Method,Quality,Sharpness,NsPerPixel,TotalNsPerPixel,PSNR,SSIM,Frontier\n");
+	for (int32 Index = 0; Index < Configs.Num(); ++Index)
+	{
+		const FFidelityFXCASBenchmarkConfig& Config = Configs[Index];
+		if (bJson)
+		{
+			Text += FString::Printf(TEXT("\t\t{ \"ratio\": %g, \"method\": \"%s\", \"quality\": \"%s\", \"sharpness\": %g, \"nsPerPixel\": %.3f, \"totalNsPerPixel\": %.3f, \"psnr\": %.3f, \"ssim\": %.5f, \"frontier\": %s }%s\n"),
+				Config.Ratio, GetFidelityFXCASBenchmarkMethodName(Config.Method), Config.GetQualityName(), Config.Sharpness, Config.GetNsPerPixel(), Config.GetTotalNsPerPixel(),
+				Config.GetPSNR(), Config.GetSSIM(), Config.bFrontier ? TEXT("true") : TEXT("false"), Index + 1 < Configs.Num() ? TEXT(",") : TEXT(""));
+		}
+		else
+		{
+			Text += FString::Printf(TEXT("%g,%s,%s,%g,%.3f,%.3f,%.3f,%.5f,%d\n"),
+				Config.Ratio, GetFidelityFXCASBenchmarkMethodName(Config.Method), Config.GetQualityName(), Config.Sharpness, Config.GetNsPerPixel(), Config.GetTotalNsPerPixel(),
+				Config.GetPSNR(), Config.GetSSIM(), Config.bFrontier ? 1 : 0);
+		}
+	}
+	if (bJson)
+		Text += TEXT("\t]\n}\n");
+	if (!FFileHelper::SaveStringToFile(Text, *Output))
+	{
+		UE_LOG(LogFidelityFXCASBenchmark, Error, TEXT("Failed to write %s."), *Output);
+		return 1;
+	}
+	UE_LOG(LogFidelityFXCASBenchmark, Display, TEXT("Results written to %s."), *Output);
+	return 0;
+}
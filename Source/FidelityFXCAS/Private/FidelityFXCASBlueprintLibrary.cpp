@@ -2,9 +2,14 @@
 
 #include "Engine/Texture2D.h"
 #include "Logging/MessageLog.h"
+#include "Misc/EngineVersionComparison.h"
 #include "ProfilingDebugging/RealtimeGPUProfiler.h"
+#if !UE_VERSION_OLDER_THAN(4, 25, 0)	// UE v4.25
+#include "Engine/TextureRenderTarget2DArray.h"
+#endif	// UE v4.25
 
 #include "FidelityFXCAS.h"
+#include "FidelityFXCASCPU.h"
 #include "FidelityFXCASPassParams.h"
 
 //-------------------------------------------------------------------------------------------------
@@ -16,6 +21,119 @@ FORCEINLINE static TRefCountPtr<IPooledRenderTarget>& GFXCASGetCSOutput(UTexture
 {
 	return GFXCASCSOutputs.FindOrAdd(InOutputRenderTarget);
 }
+
+// Input and settings of the last pass into each compute shader output. A dirty rectangle update is only valid
+// on top of a pass with the same ones, otherwise the whole output is updated.
+struct FFXCASCSOutputState
+{
+	FTextureRHIRef InputTexture;
+	FTextureRHIRef SharpnessMask;
+	float Sharpness = 0.0f;
+	bool bUseFP16 = false;
+	EFidelityFXCASQuality Quality = EFidelityFXCASQuality::Low;
+
+	FORCEINLINE bool operator==(const FFXCASCSOutputState& Other) const
+	{
+		return InputTexture == Other.InputTexture && SharpnessMask == Other.SharpnessMask && Sharpness == Other.Sharpness && bUseFP16 == Other.bUseFP16 && Quality == Other.Quality;
+	}
+};
+TMap<UTextureRenderTarget2D*, FFXCASCSOutputState> GFXCASCSOutputStates;
+
+// Texture array outputs of DrawToRenderTargetArray
+TMap<UTextureRenderTarget*, TRefCountPtr<IPooledRenderTarget>> GFXCASArrayCSOutputs;
+
+// Shared by the full, the dirty rectangle and the masked draws. InputDirtyRects (input pixels) is null for a full update.
+static void GFXCASEnqueueDrawToRenderTarget(const TCHAR* FunctionName, UTextureRenderTarget2D* InOutputRenderTarget, UTexture2D* InInputTexture,
+	float InSharpness, bool InUseFP16, EFidelityFXCASQuality InQuality, const TArray<FIntRect>* InputDirtyRects, UTexture* InSharpnessMask = nullptr)
+{
+	// Check input texture
+	if (!InInputTexture)
+	{
+		FMessageLog("Blueprint").Warning(FText::FromString(FString::Printf(TEXT("FidelityFXCAS %s: InInputTexture is required."), FunctionName)));
+		return;
+	}
+	FTextureResource* InputTextureResource = InInputTexture->Resource;
+	if (!InputTextureResource)
+	{
+		FMessageLog("Blueprint").Warning(FText::FromString(FString::Printf(TEXT("FidelityFXCAS %s: Input texture's resource is NULL."), FunctionName)));
+		return;
+	}
+
+	// Check output
+	if (!InOutputRenderTarget)
+	{
+		FMessageLog("Blueprint").Warning(FText::FromString(FString::Printf(TEXT("FidelityFXCAS %s: OutputRenderTarget is required."), FunctionName)));
+		return;
+	}
+
+	// Check the sharpness mask
+	if (InSharpnessMask && !InSharpnessMask->Resource)
+	{
+		FMessageLog("Blueprint").Warning(FText::FromString(FString::Printf(TEXT("FidelityFXCAS %s: Sharpness mask's resource is NULL."), FunctionName)));
+		return;
+	}
+
+	// Downscales beyond 2x run the prefiltered pass, which has no masked permutation
+	const FIntPoint InputSize(InInputTexture->GetSizeX(), InInputTexture->GetSizeY());
+	const FIntPoint OutputSize(InOutputRenderTarget->SizeX, InOutputRenderTarget->SizeY);
+	if (InSharpnessMask && FFidelityFXCASCPUModule::GetPrefilterSize(InputSize, OutputSize) != FIntPoint(1, 1))
+	{
+		FMessageLog("Blueprint").Warning(FText::FromString(FString::Printf(TEXT("FidelityFXCAS %s: the sharpness mask is ignored for downscales of more than 2x (%dx%d -> %dx%d)."),
+			FunctionName, InputSize.X, InputSize.Y, OutputSize.X, OutputSize.Y)));
+	}
+
+	FTextureRHIRef InputTexture = InInputTexture->Resource->TextureRHI;
+	FTextureResource* SharpnessMaskResource = InSharpnessMask ? InSharpnessMask->Resource : nullptr;
+	const bool bDirtyRectsOnly = (InputDirtyRects != nullptr);
+	TArray<FIntRect> DirtyRects = bDirtyRectsOnly ? *InputDirtyRects : TArray<FIntRect>();
+
+	ENQUEUE_RENDER_COMMAND(FidelityFXCASBP_DrawToRenderTarget)(
+		[InOutputRenderTarget, InputTexture, SharpnessMaskResource, InSharpness, InUseFP16, InQuality, bDirtyRectsOnly, DirtyRects](FRHICommandListImmediate& RHICmdList)
+		{
+			QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASBP_DrawToRenderTarget); // Used to gather CPU profiling data for the UE4 session frontend
+			SCOPED_DRAW_EVENT(RHICmdList, FidelityFXCASBP_DrawToRenderTarget);  // Used to profile GPU activity and add metadata to be consumed by for example RenderDoc
+
+			FTextureRenderTargetResource* RTResource = InOutputRenderTarget->GetRenderTargetResource();
+			if (!RTResource)
+				return;
+
+			// Prepare pass parameters
+			FFidelityFXCASPassParams_RHI CASPassParams(InputTexture, RTResource->TextureRHI, GFXCASGetCSOutput(InOutputRenderTarget));
+			CASPassParams.Sharpness = FMath::Clamp(InSharpness, 0.0f, 1.0f);
+			CASPassParams.Quality = InQuality;
+			CASPassParams.SharpnessMask = SharpnessMaskResource ? SharpnessMaskResource->TextureRHI : FTextureRHIRef();
+#if FX_CAS_FP16_ENABLED
+			CASPassParams.bUseFP16 = InUseFP16;
+#else
+			CASPassParams.bUseFP16 = false;	// Disregard the parameter
+#endif
+
+			// Make sure the computer shader output is ready and has the correct size
+			const IPooledRenderTarget* PreviousCSOutput = CASPassParams.CSOutput.GetReference();
+			FFidelityFXCASModule::Get().PrepareComputeShaderOutput_RenderThread(RHICmdList, CASPassParams.GetOutputSize(), CASPassParams.CSOutput);
+
+			// Dirty rectangles apply on top of the previous output, if it is still there and was made with the same input and settings
+			FFXCASCSOutputState NewState;
+			NewState.InputTexture = InputTexture;
+			NewState.SharpnessMask = CASPassParams.SharpnessMask;
+			NewState.Sharpness = CASPassParams.Sharpness;
+			NewState.bUseFP16 = CASPassParams.bUseFP16;
+			NewState.Quality = CASPassParams.Quality;
+			FFXCASCSOutputState& State = GFXCASCSOutputStates.FindOrAdd(InOutputRenderTarget);
+			if (bDirtyRectsOnly && State == NewState && CASPassParams.CSOutput.GetReference() == PreviousCSOutput)
+			{
+				FFidelityFXCASCPUModule::GetDirtyOutputRects(CASPassParams.GetInputSize(), CASPassParams.GetOutputSize(), DirtyRects, CASPassParams.DirtyRects);
+				if (CASPassParams.DirtyRects.Num() == 0)
+					return;
+			}
+			State = NewState;
+
+			// Call shaders
+			FFidelityFXCASModule::Get().RunComputeShader_RHI_RenderThread(RHICmdList, CASPassParams);
+			FFidelityFXCASModule::Get().DrawToRenderTarget_RHI_RenderThread(RHICmdList, CASPassParams);
+		}
+	);
+}
 #endif // FX_CAS_PLUGIN_ENABLED
 
 //-------------------------------------------------------------------------------------------------
@@ -52,6 +170,31 @@ void UFidelityFXCASBlueprintLibrary::SetSSCASSharpness(float Sharpness)
 	FFidelityFXCASModule::Get().SetSSCASSharpness(Sharpness);
 }
 
+EFidelityFXCASQuality UFidelityFXCASBlueprintLibrary::GetSSCASQuality()
+{
+	return FFidelityFXCASModule::Get().GetSSCASQuality();
+}
+
+void UFidelityFXCASBlueprintLibrary::SetSSCASQuality(EFidelityFXCASQuality Quality)
+{
+	FFidelityFXCASModule::Get().SetSSCASQuality(Quality);
+}
+
+float UFidelityFXCASBlueprintLibrary::GetQualityTierMilliseconds(EFidelityFXCASQuality Quality, bool bUseFP16)
+{
+	return FFidelityFXCASModule::Get().GetQualityTierMilliseconds(Quality, bUseFP16);
+}
+
+bool UFidelityFXCASBlueprintLibrary::GetIsDRSEnabled()
+{
+	return FFidelityFXCASModule::Get().GetIsDRSEnabled();
+}
+
+void UFidelityFXCASBlueprintLibrary::SetIsDRSEnabled(bool bEnabled)
+{
+	FFidelityFXCASModule::Get().SetIsDRSEnabled(bEnabled);
+}
+
 bool UFidelityFXCASBlueprintLibrary::GetUseFP16()
 {
 	return FFidelityFXCASModule::Get().GetUseFP16();
@@ -62,6 +205,11 @@ void UFidelityFXCASBlueprintLibrary::SetUseFP16(bool UseFP16)
 	FFidelityFXCASModule::Get().SetUseFP16(UseFP16);
 }
 
+void UFidelityFXCASBlueprintLibrary::SetSSCASSharpnessMask(class UTexture* Mask)
+{
+	FFidelityFXCASModule::Get().SetSSCASSharpnessMask(Mask);
+}
+
 void UFidelityFXCASBlueprintLibrary::InitSSCASCSOutputs(const FIntPoint& Size)
 {
 	FFidelityFXCASModule::Get().InitSSCASCSOutputs(Size);
@@ -90,58 +238,133 @@ void UFidelityFXCASBlueprintLibrary::InitCSOutput(class UTextureRenderTarget2D*
 #endif // FX_CAS_PLUGIN_ENABLED
 }
 
-void UFidelityFXCASBlueprintLibrary::DrawToRenderTarget(class UTextureRenderTarget2D* InOutputRenderTarget, class UTexture2D* InInputTexture, float InSharpness, bool InUseFP16)
+void UFidelityFXCASBlueprintLibrary::DrawToRenderTarget(class UTextureRenderTarget2D* InOutputRenderTarget, class UTexture2D* InInputTexture, float InSharpness, bool InUseFP16, EFidelityFXCASQuality InQuality)
+{
+#if FX_CAS_PLUGIN_ENABLED
+	GFXCASEnqueueDrawToRenderTarget(TEXT("DrawToRenderTarget"), InOutputRenderTarget, InInputTexture, InSharpness, InUseFP16, InQuality, nullptr);
+#endif // FX_CAS_PLUGIN_ENABLED
+}
+
+void UFidelityFXCASBlueprintLibrary::DrawToRenderTargetDirtyRects(class UTextureRenderTarget2D* InOutputRenderTarget, class UTexture2D* InInputTexture,
+	const TArray<FBox2D>& InDirtyRects, float InSharpness, bool InUseFP16, EFidelityFXCASQuality InQuality)
+{
+#if FX_CAS_PLUGIN_ENABLED
+	// Whole pixels covering the boxes
+	TArray<FIntRect> DirtyRects;
+	DirtyRects.Reserve(InDirtyRects.Num());
+	for (const FBox2D& DirtyBox : InDirtyRects)
+	{
+		if (DirtyBox.bIsValid)
+		{
+			DirtyRects.Add(FIntRect(FMath::FloorToInt(DirtyBox.Min.X), FMath::FloorToInt(DirtyBox.Min.Y),
+				FMath::CeilToInt(DirtyBox.Max.X), FMath::CeilToInt(DirtyBox.Max.Y)));
+		}
+	}
+	GFXCASEnqueueDrawToRenderTarget(TEXT("DrawToRenderTargetDirtyRects"), InOutputRenderTarget, InInputTexture, InSharpness, InUseFP16, InQuality, &DirtyRects);
+#endif // FX_CAS_PLUGIN_ENABLED
+}
+
+void UFidelityFXCASBlueprintLibrary::DrawToRenderTargetMasked(class UTextureRenderTarget2D* InOutputRenderTarget, class UTexture2D* InInputTexture,
+	class UTexture* InSharpnessMask, float InSharpness, bool InUseFP16, EFidelityFXCASQuality InQuality)
 {
 #if FX_CAS_PLUGIN_ENABLED
+	GFXCASEnqueueDrawToRenderTarget(TEXT("DrawToRenderTargetMasked"), InOutputRenderTarget, InInputTexture, InSharpness, InUseFP16, InQuality, nullptr, InSharpnessMask);
+#endif // FX_CAS_PLUGIN_ENABLED
+}
+
+void UFidelityFXCASBlueprintLibrary::DrawToRenderTargetArray(class UTextureRenderTarget* InOutputRenderTarget, class UTexture* InInputTexture, float InSharpness,
+	bool InUseFP16, EFidelityFXCASQuality InQuality)
+{
+#if FX_CAS_PLUGIN_ENABLED
+#if !UE_VERSION_OLDER_THAN(4, 25, 0)	// UE v4.25
 	// Check input texture
-	if (!InInputTexture)
+	if (!InInputTexture || (InInputTexture->GetMaterialType() != MCT_Texture2DArray && InInputTexture->GetMaterialType() != MCT_VolumeTexture))
 	{
-		FMessageLog("Blueprint").Warning(FText::FromString(TEXT("FidelityFXCAS DrawToRenderTarget: InInputTexture is required.")));
+		FMessageLog("Blueprint").Warning(FText::FromString(TEXT("FidelityFXCAS DrawToRenderTargetArray: InInputTexture must be a texture array, a volume texture or a render target array.")));
 		return;
 	}
-	FTextureResource* InputTextureResource = InInputTexture->Resource;
-	if (!InputTextureResource)
+	if (!InInputTexture->Resource)
 	{
-		FMessageLog("Blueprint").Warning(FText::FromString(TEXT("FidelityFXCAS DrawToRenderTarget: Input texture's resource is NULL.")));
+		FMessageLog("Blueprint").Warning(FText::FromString(TEXT("FidelityFXCAS DrawToRenderTargetArray: Input texture's resource is NULL.")));
 		return;
 	}
 
-	// Check output
-	if (!InOutputRenderTarget)
+	// Check output, the slices are copied so the format has to match the compute shader output
+	UTextureRenderTarget2DArray* OutputRenderTarget = Cast<UTextureRenderTarget2DArray>(InOutputRenderTarget);
+	if (!OutputRenderTarget)
 	{
-		FMessageLog("Blueprint").Warning(FText::FromString(TEXT("FidelityFXCAS DrawToRenderTarget: OutputRenderTarget is required.")));
+		FMessageLog("Blueprint").Warning(FText::FromString(TEXT("FidelityFXCAS DrawToRenderTargetArray: OutputRenderTarget must be a render target array.")));
+		return;
+	}
+	if (OutputRenderTarget->GetFormat() != PF_FloatRGBA)
+	{
+		FMessageLog("Blueprint").Warning(FText::FromString(TEXT("FidelityFXCAS DrawToRenderTargetArray: OutputRenderTarget must use the RGBA16f format.")));
 		return;
 	}
-
-	//FRHICommandListImmediate& RHICmdList = GRHICommandList.GetImmediateCommandList();
 
 	FTextureRHIRef InputTexture = InInputTexture->Resource->TextureRHI;
 
-	ENQUEUE_RENDER_COMMAND(FidelityFXCASBP_DrawToRenderTarget)(
-		[InOutputRenderTarget, InputTexture, InSharpness, InUseFP16](FRHICommandListImmediate& RHICmdList)
+	ENQUEUE_RENDER_COMMAND(FidelityFXCASBP_DrawToRenderTargetArray)(
+		[InOutputRenderTarget, InputTexture, InSharpness, InUseFP16, InQuality](FRHICommandListImmediate& RHICmdList)
 		{
-			QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASBP_DrawToRenderTarget); // Used to gather CPU profiling data for the UE4 session frontend
-			SCOPED_DRAW_EVENT(RHICmdList, FidelityFXCASBP_DrawToRenderTarget);  // Used to profile GPU activity and add metadata to be consumed by for example RenderDoc
+			QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASBP_DrawToRenderTargetArray); // Used to gather CPU profiling data for the UE4 session frontend
+			SCOPED_DRAW_EVENT(RHICmdList, FidelityFXCASBP_DrawToRenderTargetArray);  // Used to profile GPU activity and add metadata to be consumed by for example RenderDoc
 
 			FTextureRenderTargetResource* RTResource = InOutputRenderTarget->GetRenderTargetResource();
-			if (!RTResource)
+			if (!RTResource || !RTResource->TextureRHI.IsValid())
 				return;
 
 			// Prepare pass parameters
-			FFidelityFXCASPassParams_RHI CASPassParams(InputTexture, RTResource->TextureRHI, GFXCASGetCSOutput(InOutputRenderTarget));
+			FFidelityFXCASPassParams_RHI CASPassParams(InputTexture, RTResource->TextureRHI, GFXCASArrayCSOutputs.FindOrAdd(InOutputRenderTarget));
 			CASPassParams.Sharpness = FMath::Clamp(InSharpness, 0.0f, 1.0f);
+			CASPassParams.Quality = InQuality;
 #if FX_CAS_FP16_ENABLED
 			CASPassParams.bUseFP16 = InUseFP16;
 #else
 			CASPassParams.bUseFP16 = false;	// Disregard the parameter
 #endif
 
-			// Make sure the computer shader output is ready and has the correct size
-			FFidelityFXCASModule::Get().PrepareComputeShaderOutput_RenderThread(RHICmdList, CASPassParams.GetOutputSize(), CASPassParams.CSOutput);
+			// Make sure the computer shader output is ready and matches the render target
+			FFidelityFXCASModule::Get().PrepareComputeShaderOutput_RenderThread(RHICmdList, CASPassParams.GetOutputSize(), CASPassParams.CSOutput,
+				TEXT("FidelityFXCASModule_ArrayCSOutput"), RTResource->TextureRHI->GetSizeXYZ().Z);
 
 			// Call shaders
-			FFidelityFXCASModule::Get().RunComputeShader_RHI_RenderThread(RHICmdList, CASPassParams);
-			FFidelityFXCASModule::Get().DrawToRenderTarget_RHI_RenderThread(RHICmdList, CASPassParams);
+			FFidelityFXCASModule::Get().RunComputeShaderArray_RHI_RenderThread(RHICmdList, CASPassParams);
+			FFidelityFXCASModule::Get().CopyToRenderTargetArray_RHI_RenderThread(RHICmdList, CASPassParams);
+		}
+	);
+#else
+	FMessageLog("Blueprint").Warning(FText::FromString(TEXT("FidelityFXCAS DrawToRenderTargetArray: render target arrays require UE 4.25.")));
+#endif	// UE v4.25
+#endif // FX_CAS_PLUGIN_ENABLED
+}
+
+void UFidelityFXCASBlueprintLibrary::GenerateSharpenedMips(class UTextureRenderTarget2D* InRenderTarget, float InSharpness, EFidelityFXCASQuality InQuality)
+{
+#if FX_CAS_PLUGIN_ENABLED
+	// Check the render target
+	if (!InRenderTarget)
+	{
+		FMessageLog("Blueprint").Warning(FText::FromString(TEXT("FidelityFXCAS GenerateSharpenedMips: InRenderTarget is required.")));
+		return;
+	}
+	if (!InRenderTarget->bAutoGenerateMips || InRenderTarget->GetFormat() != PF_FloatRGBA)
+	{
+		FMessageLog("Blueprint").Warning(FText::FromString(TEXT("FidelityFXCAS GenerateSharpenedMips: InRenderTarget needs mips (Auto Generate Mips) and the RGBA16f format.")));
+		return;
+	}
+
+	ENQUEUE_RENDER_COMMAND(FidelityFXCASBP_GenerateSharpenedMips)(
+		[InRenderTarget, InSharpness, InQuality](FRHICommandListImmediate& RHICmdList)
+		{
+			QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASBP_GenerateSharpenedMips); // Used to gather CPU profiling data for the UE4 session frontend
+			SCOPED_DRAW_EVENT(RHICmdList, FidelityFXCASBP_GenerateSharpenedMips);  // Used to profile GPU activity and add metadata to be consumed by for example RenderDoc
+
+			FTextureRenderTargetResource* RTResource = InRenderTarget->GetRenderTargetResource();
+			if (!RTResource)
+				return;
+
+			FFidelityFXCASModule::Get().GenerateSharpenedMips_RenderThread(RHICmdList, RTResource->TextureRHI, FMath::Clamp(InSharpness, 0.0f, 1.0f), InQuality);
 		}
 	);
 #endif // FX_CAS_PLUGIN_ENABLED
@@ -0,0 +1,141 @@
+#include "FidelityFXCAS.h"
+#include "FidelityFXCASPassParams.h"
+#include "FidelityFXCASPassBackend.h"
+#include "FidelityFXCASShaderCS.h"
+#include "FidelityFXCASShaderCompilationRules.h"
+#include "FidelityFXCASIncludes.h"
+#include "FidelityFXCASCPU.h"
+
+#include "RenderGraphUtils.h"
+#include "RenderResource.h"
+#include "RHIUtilities.h"
+
+#if FX_CAS_PLUGIN_ENABLED
+// Tile lists of the foveated passes, the lists of all classes one after the other in a single buffer rewritten every frame
+class FFidelityFXCASFoveatedTileLists : public FRenderResource
+{
+public:
+	FReadBuffer Buffer;
+	uint32 NumEntries = 0;
+	FFidelityFXCASTileClassification Classification;	// Kept so steady state classification does not allocate
+
+	void Upload()
+	{
+		uint32 NumTiles = 0;
+		for (const TArray<uint32>& TileList : Classification.TileLists)
+			NumTiles += TileList.Num();
+		if (NumTiles > NumEntries)
+		{
+			NumEntries = FMath::RoundUpToPowerOfTwo(NumTiles);
+			Buffer.Release();
+			Buffer.Initialize(sizeof(uint32), NumEntries, PF_R32_UINT, BUF_Dynamic);
+		}
+
+		uint8* Data = static_cast<uint8*>(RHILockVertexBuffer(Buffer.Buffer, 0, NumTiles * sizeof(uint32), RLM_WriteOnly));
+		for (const TArray<uint32>& TileList : Classification.TileLists)
+		{
+			FMemory::Memcpy(Data, TileList.GetData(), TileList.Num() * sizeof(uint32));
+			Data += TileList.Num() * sizeof(uint32);
+		}
+		RHIUnlockVertexBuffer(Buffer.Buffer);
+	}
+
+	virtual void ReleaseDynamicRHI() override
+	{
+		Buffer.Release();
+		NumEntries = 0;
+	}
+};
+static TGlobalResource<FFidelityFXCASFoveatedTileLists> GFXCASFoveatedTileLists;
+
+// One thread group per tile of the planned range of the lists
+template<typename TShader>
+static void DispatchTileList_RHI(FRHICommandListImmediate& RHICmdList, FFidelityFXCASShaderFoveatedCS_RHI::FParameters PassParameters, const FFidelityFXCASDispatch& Dispatch)
+{
+	TShaderMapRef<TShader> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+	PassParameters.TileListOffset = Dispatch.TileListOffset;
+	FComputeShaderUtils::Dispatch(RHICmdList, FXCAS_SHADER_ARG(ComputeShader), PassParameters, Dispatch.GroupCount);
+}
+
+// Quality permutation, the plan already applied the FP16 fallback from Ultra to High
+template<bool FP16, bool SHARPEN_ONLY>
+static void DispatchFoveated_RHI(FRHICommandListImmediate& RHICmdList, const FFidelityFXCASShaderFoveatedCS_RHI::FParameters& PassParameters, const FFidelityFXCASDispatch& Dispatch)
+{
+	switch (Dispatch.Permutation.Quality)
+	{
+	case EFidelityFXCASQuality::Medium: DispatchTileList_RHI<TFidelityFXCASShaderFoveatedCS_RHI<FP16, SHARPEN_ONLY, false, 1>>(RHICmdList, PassParameters, Dispatch); break;
+	case EFidelityFXCASQuality::High:   DispatchTileList_RHI<TFidelityFXCASShaderFoveatedCS_RHI<FP16, SHARPEN_ONLY, false, 2>>(RHICmdList, PassParameters, Dispatch); break;
+	case EFidelityFXCASQuality::Ultra:  DispatchTileList_RHI<TFidelityFXCASShaderFoveatedCS_RHI<FP16, SHARPEN_ONLY, false, 3>>(RHICmdList, PassParameters, Dispatch); break;
+	default:                            DispatchTileList_RHI<TFidelityFXCASShaderFoveatedCS_RHI<FP16, SHARPEN_ONLY, false, 0>>(RHICmdList, PassParameters, Dispatch); break;
+	}
+}
+
+static void DispatchFoveated_RHI(FRHICommandListImmediate& RHICmdList, const FFidelityFXCASShaderFoveatedCS_RHI::FParameters& PassParameters, const FFidelityFXCASDispatch& Dispatch)
+{
+	const FFidelityFXCASPermutation& Permutation = Dispatch.Permutation;
+	if (Permutation.bBilinear)
+	{
+		DispatchTileList_RHI<TFidelityFXCASShaderFoveatedCS_RHI<false, false, true, 0>>(RHICmdList, PassParameters, Dispatch);
+		return;
+	}
+#if FX_CAS_FP16_ENABLED
+	if (Permutation.bFP16)
+	{
+		if (Permutation.bSharpenOnly)
+			DispatchFoveated_RHI<true, true>(RHICmdList, PassParameters, Dispatch);
+		else
+			DispatchFoveated_RHI<true, false>(RHICmdList, PassParameters, Dispatch);
+		return;
+	}
+#endif // FX_CAS_FP16_ENABLED
+	if (Permutation.bSharpenOnly)
+		DispatchFoveated_RHI<false, true>(RHICmdList, PassParameters, Dispatch);
+	else
+		DispatchFoveated_RHI<false, false>(RHICmdList, PassParameters, Dispatch);
+}
+
+FFidelityFXCASTileClassification& FFidelityFXCASModule::GetFoveatedTileClassification_RenderThread()
+{
+	check(IsInRenderingThread());
+	return GFXCASFoveatedTileLists.Classification;
+}
+
+void FFidelityFXCASModule::UploadFoveatedTileLists_RenderThread(const FFidelityFXCASTileClassification& Classification)
+{
+	check(IsInRenderingThread());
+
+	// The plan classifies into the kept classification, other ones are copied
+	if (&Classification != &GFXCASFoveatedTileLists.Classification)
+		GFXCASFoveatedTileLists.Classification = Classification;
+	GFXCASFoveatedTileLists.Upload();
+}
+
+void FFidelityFXCASModule::RunComputeShaderFoveated_RHI_RenderThread(FRHICommandListImmediate& RHICmdList, const class FFidelityFXCASPassParams_RHI& CASPassParams,
+	const TArray<FFidelityFXCASDispatch>& Dispatches)
+{
+	check(IsInRenderingThread());
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASModule_RunComputeShaderFoveated_RHI); // Used to gather CPU profiling data for the UE4 session frontend
+
+	FFidelityFXCASShaderFoveatedCS_RHI::FParameters PassParameters;
+	PassParameters.InputTexture = CASPassParams.GetInputTexture();
+	PassParameters.OutputTexture = CASPassParams.GetUAV();
+	PassParameters.TileList = GFXCASFoveatedTileLists.Buffer.SRV;
+	PassParameters.TileListOffset = 0;
+	PassParameters.TileSourceOffset = CASPassParams.TileSourceOffset;
+	PassParameters.TileOutputOffset = CASPassParams.TileOutputOffset;
+	CasSetup(reinterpret_cast<AU1*>(&PassParameters.const0), reinterpret_cast<AU1*>(&PassParameters.const1),
+		CASPassParams.Sharpness,
+		static_cast<AF1>(CASPassParams.GetInputSize().X), static_cast<AF1>(CASPassParams.GetInputSize().Y),
+		CASPassParams.GetOutputSize().X, CASPassParams.GetOutputSize().Y);
+
+	// One dispatch per class (split at the group limit). The class and the tile count are part of the event name, so ProfileGPU shows what the periphery saves.
+	for (const FFidelityFXCASDispatch& Dispatch : Dispatches)
+	{
+		const FFidelityFXCASPermutation& Permutation = Dispatch.Permutation;
+		SCOPED_DRAW_EVENTF(RHICmdList, FidelityFXCAS_DispatchFoveated, TEXT("CAS CS foveated %s, %d tiles"),
+			Permutation.bBilinear ? TEXT("bilinear") : GetFidelityFXCASQualityName(Permutation.Quality), Dispatch.GroupCount.X);
+		DispatchFoveated_RHI(RHICmdList, PassParameters, Dispatch);
+	}
+}
+#endif // FX_CAS_PLUGIN_ENABLED
@@ -0,0 +1,92 @@
+#include "FidelityFXCAS.h"
+#include "FidelityFXCASShaderCS.h"
+#include "FidelityFXCASShaderCompilationRules.h"
+#include "FidelityFXCASIncludes.h"
+#include "FidelityFXCASCPU.h"
+
+#include "RenderGraphUtils.h"
+
+#if FX_CAS_PLUGIN_ENABLED
+template<bool FP16, bool SHARPEN_ONLY, bool PREFILTER, int32 QUALITY>
+static void DispatchLuma_RHI(FRHICommandListImmediate& RHICmdList, const FFidelityFXCASShaderLumaCS_RHI::FParameters& PassParameters, const FIntVector& GroupCount)
+{
+	TShaderMapRef<TFidelityFXCASShaderLumaCS_RHI<FP16, SHARPEN_ONLY, PREFILTER, QUALITY>> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+	FComputeShaderUtils::Dispatch(RHICmdList, FXCAS_SHADER_ARG(ComputeShader), PassParameters, GroupCount);
+}
+
+template<bool FP16, bool SHARPEN_ONLY, bool PREFILTER>
+static void DispatchLuma_RHI(FRHICommandListImmediate& RHICmdList, const FFidelityFXCASShaderLumaCS_RHI::FParameters& PassParameters, const FIntVector& GroupCount,
+	EFidelityFXCASQuality Quality)
+{
+	switch (GetFidelityFXCASLumaShaderQuality<FP16>(Quality))
+	{
+	case EFidelityFXCASQuality::Medium: DispatchLuma_RHI<FP16, SHARPEN_ONLY, PREFILTER, 1>(RHICmdList, PassParameters, GroupCount); break;
+	case EFidelityFXCASQuality::Ultra:  DispatchLuma_RHI<FP16, SHARPEN_ONLY, PREFILTER, 3>(RHICmdList, PassParameters, GroupCount); break;
+	default:                            DispatchLuma_RHI<FP16, SHARPEN_ONLY, PREFILTER, 0>(RHICmdList, PassParameters, GroupCount); break;
+	}
+}
+
+template<bool FP16>
+static void DispatchLuma_RHI(FRHICommandListImmediate& RHICmdList, const FFidelityFXCASShaderLumaCS_RHI::FParameters& PassParameters, const FIntVector& GroupCount,
+	EFidelityFXCASQuality Quality, bool bSharpenOnly, bool bPrefilter)
+{
+	if (bSharpenOnly)
+		DispatchLuma_RHI<FP16, true, false>(RHICmdList, PassParameters, GroupCount, Quality);
+	else if (bPrefilter)
+		DispatchLuma_RHI<FP16, false, true>(RHICmdList, PassParameters, GroupCount, Quality);
+	else
+		DispatchLuma_RHI<FP16, false, false>(RHICmdList, PassParameters, GroupCount, Quality);
+}
+
+void FFidelityFXCASModule::ProcessLuma_RenderThread(FRHICommandListImmediate& RHICmdList, const FTextureRHIRef& InputLuma, const FTextureRHIRef& OutputLuma,
+	float Sharpness, bool bInUseFP16, EFidelityFXCASQuality Quality)
+{
+	check(IsInRenderingThread());
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASModule_ProcessLuma); // Used to gather CPU profiling data for the UE4 session frontend
+	SCOPED_DRAW_EVENT(RHICmdList, FidelityFXCASModule_ProcessLuma);  // Used to profile GPU activity and add metadata to be consumed by for example RenderDoc
+
+	if (!InputLuma.IsValid() || !OutputLuma.IsValid() || !InputLuma->GetTexture2D() || !OutputLuma->GetTexture2D())
+		return;
+
+	const FIntPoint InputSize(InputLuma->GetSizeXYZ().X, InputLuma->GetSizeXYZ().Y);
+	const FIntPoint OutputSize(OutputLuma->GetSizeXYZ().X, OutputLuma->GetSizeXYZ().Y);
+
+	// The CS output has the format of the output plane, so the result is a plain copy
+	PrepareComputeShaderOutput_RenderThread(RHICmdList, OutputSize, LumaOutput, TEXT("FidelityFXCASModule_LumaOutput"), 0, OutputLuma->GetFormat());
+	const FSceneRenderTargetItem& LumaOutputItem = LumaOutput->GetRenderTargetItem();
+
+	PRAGMA_DISABLE_DEPRECATION_WARNINGS
+	UnbindRenderTargets(RHICmdList);
+	PRAGMA_ENABLE_DEPRECATION_WARNINGS
+	RHICmdList.TransitionResource(EResourceTransitionAccess::ERWBarrier, EResourceTransitionPipeline::EGfxToCompute, LumaOutputItem.UAV);
+
+	// Same constants as the RGB passes, downscales beyond 2x box filter the luma first
+	FFidelityFXCASShaderLumaCS_RHI::FParameters PassParameters;
+	PassParameters.InputTexture = InputLuma;
+	PassParameters.OutputTexture = LumaOutputItem.UAV;
+	PassParameters.GroupOffset = FIntPoint::ZeroValue;
+	PassParameters.PrefilterSize = FFidelityFXCASCPUModule::GetPrefilterSize(InputSize, OutputSize);
+	PassParameters.PrefilterInputMax = InputSize - FIntPoint(1, 1);
+	const FIntPoint CASInputSize = FFidelityFXCASCPUModule::GetPrefilteredSize(InputSize, PassParameters.PrefilterSize);
+	CasSetup(reinterpret_cast<AU1*>(&PassParameters.const0), reinterpret_cast<AU1*>(&PassParameters.const1), Sharpness,
+		static_cast<AF1>(CASInputSize.X), static_cast<AF1>(CASInputSize.Y), OutputSize.X, OutputSize.Y);
+
+	const bool bSharpenOnly = (InputSize == OutputSize);
+	const bool bPrefilter = (PassParameters.PrefilterSize != FIntPoint(1, 1));
+	const FIntVector GroupCount = GetDispatchGroupCount(OutputSize);
+	{
+		SCOPED_DRAW_EVENTF(RHICmdList, FidelityFXCAS_DispatchLuma, TEXT("CAS Luma %s %dx%d -> %dx%d"), GetFidelityFXCASQualityName(Quality),
+			InputSize.X, InputSize.Y, OutputSize.X, OutputSize.Y);
+#if FX_CAS_FP16_ENABLED
+		if (bInUseFP16)
+			DispatchLuma_RHI<true>(RHICmdList, PassParameters, GroupCount, Quality, bSharpenOnly, bPrefilter);
+		else
+#endif // FX_CAS_FP16_ENABLED
+			DispatchLuma_RHI<false>(RHICmdList, PassParameters, GroupCount, Quality, bSharpenOnly, bPrefilter);
+	}
+
+	RHICmdList.TransitionResource(EResourceTransitionAccess::EReadable, LumaOutputItem.TargetableTexture);
+	RHICmdList.CopyTexture(LumaOutputItem.TargetableTexture, OutputLuma, FRHICopyTextureInfo());
+}
+#endif // FX_CAS_PLUGIN_ENABLED
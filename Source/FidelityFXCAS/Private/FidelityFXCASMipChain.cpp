@@ -0,0 +1,121 @@
+#include "FidelityFXCAS.h"
+#include "FidelityFXCASShaderCS.h"
+#include "FidelityFXCASShaderCompilationRules.h"
+#include "FidelityFXCASIncludes.h"
+
+#include "ClearQuad.h"
+#include "RenderGraphUtils.h"
+#include "RenderResource.h"
+#include "RHIUtilities.h"
+
+#if FX_CAS_PLUGIN_ENABLED
+// Dependency counters of the mip chain tiles, shared by all textures
+class FFidelityFXCASMipChainCounters : public FRenderResource
+{
+public:
+	FRWBuffer Buffer;
+	uint32 NumCounters = 0;
+
+	void Reserve(uint32 InNumCounters)
+	{
+		if (InNumCounters > NumCounters)
+		{
+			NumCounters = FMath::RoundUpToPowerOfTwo(InNumCounters);
+			Buffer.Release();
+			Buffer.Initialize(sizeof(uint32), NumCounters, PF_R32_UINT, BUF_Static, TEXT("FidelityFXCASModule_MipChainCounters"));
+		}
+	}
+
+	virtual void ReleaseDynamicRHI() override
+	{
+		Buffer.Release();
+		NumCounters = 0;
+	}
+};
+static TGlobalResource<FFidelityFXCASMipChainCounters> GFXCASMipChainCounters;
+
+template<int32 QUALITY>
+static void DispatchMipChain_RHI(FRHICommandListImmediate& RHICmdList, const FFidelityFXCASShaderMipChainCS_RHI::FParameters& PassParameters, const FIntVector& GroupCount)
+{
+	TShaderMapRef<TFidelityFXCASShaderMipChainCS_RHI<QUALITY>> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+	FComputeShaderUtils::Dispatch(RHICmdList, FXCAS_SHADER_ARG(ComputeShader), PassParameters, GroupCount);
+}
+
+void FFidelityFXCASModule::GenerateSharpenedMips_RenderThread(FRHICommandListImmediate& RHICmdList, const FTextureRHIRef& Texture, float Sharpness, EFidelityFXCASQuality Quality)
+{
+	check(IsInRenderingThread());
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASModule_GenerateSharpenedMips); // Used to gather CPU profiling data for the UE4 session frontend
+	SCOPED_DRAW_EVENT(RHICmdList, FidelityFXCASModule_GenerateSharpenedMips);  // Used to profile GPU activity and add metadata to be consumed by for example RenderDoc
+
+	if (!Texture.IsValid() || !Texture->GetTexture2D() || Texture->GetFormat() != PF_FloatRGBA)
+		return;
+
+	// Levels, the atlases stack them vertically below each other
+	const int32 NumLevels = FMath::Min<int32>(Texture->GetNumMips(), FX_CAS_MAX_MIP_LEVELS) - 1;
+	if (NumLevels < 1)
+		return;
+
+	FFidelityFXCASShaderMipChainCS_RHI::FParameters PassParameters;
+	FIntPoint LevelSize(Texture->GetSizeXYZ().X, Texture->GetSizeXYZ().Y);
+	FIntPoint AtlasSize(FMath::Max(LevelSize.X >> 1, 1), 0);
+	uint32 NumCounters = 0;
+	for (int32 Level = 0; Level <= NumLevels; ++Level)
+	{
+		const FIntVector TileCount = GetDispatchGroupCount(LevelSize);
+		PassParameters.LevelSizes[Level] = FUintVector4(LevelSize.X, LevelSize.Y, TileCount.X, TileCount.Y);
+		PassParameters.LevelOffsets[Level] = FUintVector4(0, Level > 0 ? AtlasSize.Y : 0, NumCounters, 0);
+		if (Level > 0)
+		{
+			AtlasSize.Y += LevelSize.Y;
+			NumCounters += (Level > 1) ? TileCount.X * TileCount.Y : 0;	// Level 1 reads the texture, nothing to wait for
+		}
+		LevelSize = FIntPoint(FMath::Max(LevelSize.X >> 1, 1), FMath::Max(LevelSize.Y >> 1, 1));
+	}
+
+	PrepareComputeShaderOutput_RenderThread(RHICmdList, AtlasSize, MipChainAtlas, TEXT("FidelityFXCASModule_MipChainAtlas"));
+	PrepareComputeShaderOutput_RenderThread(RHICmdList, AtlasSize, MipChainBoxAtlas, TEXT("FidelityFXCASModule_MipChainBoxAtlas"));
+	GFXCASMipChainCounters.Reserve(FMath::Max<uint32>(NumCounters, 1));
+
+	PRAGMA_DISABLE_DEPRECATION_WARNINGS
+	UnbindRenderTargets(RHICmdList);
+	PRAGMA_ENABLE_DEPRECATION_WARNINGS
+	ClearUAV(RHICmdList, GFXCASMipChainCounters.Buffer, 0);
+	RHICmdList.TransitionResource(EResourceTransitionAccess::ERWBarrier, EResourceTransitionPipeline::EGfxToCompute, MipChainAtlas->GetRenderTargetItem().UAV);
+	RHICmdList.TransitionResource(EResourceTransitionAccess::ERWBarrier, EResourceTransitionPipeline::EGfxToCompute, MipChainBoxAtlas->GetRenderTargetItem().UAV);
+	RHICmdList.TransitionResource(EResourceTransitionAccess::ERWBarrier, EResourceTransitionPipeline::EGfxToCompute, GFXCASMipChainCounters.Buffer.UAV);
+
+	// Sharpen only uses the sharpness constant, so one setup fits every level
+	PassParameters.NumLevels = NumLevels;
+	PassParameters.InputTexture = Texture;
+	PassParameters.BoxAtlas = MipChainBoxAtlas->GetRenderTargetItem().UAV;
+	PassParameters.OutputAtlas = MipChainAtlas->GetRenderTargetItem().UAV;
+	PassParameters.Counters = GFXCASMipChainCounters.Buffer.UAV;
+	CasSetup(reinterpret_cast<AU1*>(&PassParameters.const0), reinterpret_cast<AU1*>(&PassParameters.const1), Sharpness, 1.0f, 1.0f, 1, 1);
+
+	// One thread group per tile of level 1, the groups continue with the next levels
+	const FIntVector GroupCount(PassParameters.LevelSizes[1].Z, PassParameters.LevelSizes[1].W, 1);
+	{
+		SCOPED_DRAW_EVENTF(RHICmdList, FidelityFXCAS_DispatchMipChain, TEXT("CAS Mip Chain %s %dx%d, %d levels"), GetFidelityFXCASQualityName(Quality),
+			Texture->GetSizeXYZ().X, Texture->GetSizeXYZ().Y, NumLevels);
+		switch (Quality)
+		{
+		case EFidelityFXCASQuality::Medium: DispatchMipChain_RHI<1>(RHICmdList, PassParameters, GroupCount); break;
+		case EFidelityFXCASQuality::High:   DispatchMipChain_RHI<2>(RHICmdList, PassParameters, GroupCount); break;
+		case EFidelityFXCASQuality::Ultra:  DispatchMipChain_RHI<3>(RHICmdList, PassParameters, GroupCount); break;
+		default:                            DispatchMipChain_RHI<0>(RHICmdList, PassParameters, GroupCount); break;
+		}
+	}
+
+	// Copy the levels to the mips
+	RHICmdList.TransitionResource(EResourceTransitionAccess::EReadable, MipChainAtlas->GetRenderTargetItem().TargetableTexture);
+	for (int32 Level = 1; Level <= NumLevels; ++Level)
+	{
+		FRHICopyTextureInfo CopyInfo;
+		CopyInfo.Size = FIntVector(PassParameters.LevelSizes[Level].X, PassParameters.LevelSizes[Level].Y, 1);
+		CopyInfo.SourcePosition = FIntVector(PassParameters.LevelOffsets[Level].X, PassParameters.LevelOffsets[Level].Y, 0);
+		CopyInfo.DestMipIndex = Level;
+		RHICmdList.CopyTexture(MipChainAtlas->GetRenderTargetItem().TargetableTexture, Texture, CopyInfo);
+	}
+}
+#endif // FX_CAS_PLUGIN_ENABLED
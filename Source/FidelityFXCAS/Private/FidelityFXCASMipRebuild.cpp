@@ -0,0 +1,317 @@
+#include "FidelityFXCAS.h"
+#include "FidelityFXCASTopMipProvider.h"
+#include "FidelityFXCASCPU.h"
+
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "Engine/Texture2D.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Serialization/BulkData.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogFidelityFXCASMipRebuild, Log, All);
+
+// CPU engine view of a texture's mip data, false for the formats it can't read (block compressed, ...)
+static bool GetFidelityFXCASMipFormat(EPixelFormat PixelFormat, bool bSRGB, EFidelityFXCASPixelFormat& OutFormat, EFidelityFXCASChannelOrder& OutChannelOrder)
+{
+	OutChannelOrder = EFidelityFXCASChannelOrder::RGBA;
+	switch (PixelFormat)
+	{
+	case PF_B8G8R8A8:        OutChannelOrder = EFidelityFXCASChannelOrder::BGRA; // Fall through
+	case PF_R8G8B8A8:        OutFormat = bSRGB ? EFidelityFXCASPixelFormat::RGBA8_SRGB : EFidelityFXCASPixelFormat::RGBA8; return true;
+	case PF_FloatRGBA:       OutFormat = EFidelityFXCASPixelFormat::RGBA16F; return true;
+	case PF_A32B32G32R32F:   OutFormat = EFidelityFXCASPixelFormat::RGBA32F; return true;
+	default:                 return false;
+	}
+}
+
+// A top mip requested by the texture streamer, shared by the mip data provider and the rebuild queue.
+// The streamer waits for Counter before it touches the mip memory again, so it stays valid until the rebuild is done.
+struct FFidelityFXCASTopMipRebuild
+{
+	TWeakObjectPtr<UTexture> Texture;
+	const FTexture2DMipMap* SourceMip = nullptr;	// Largest shipped mip, read on the worker thread
+	void* SourceMipData = nullptr;					// Streamer memory of the shipped mip when it streams in too, read into it
+	void* TopMipData = nullptr;						// Streamer memory of the top mip
+	FIntPoint TopMipSize = FIntPoint::ZeroValue;
+	EFidelityFXCASPixelFormat Format = EFidelityFXCASPixelFormat::RGBA8;
+	EFidelityFXCASChannelOrder ChannelOrder = EFidelityFXCASChannelOrder::RGBA;
+	float Sharpness = 0.5f;
+	FThreadSafeCounter* Counter = nullptr;
+	TFunction<void()> RescheduleCallback;
+	FThreadSafeBool bAborted = false;				// The streamer gave up on the update, a queued rebuild is dropped
+	bool bSucceeded = false;
+
+	float GetMegapixels() const { return static_cast<float>(TopMipSize.X) * static_cast<float>(TopMipSize.Y) / 1000000.0f; }
+
+	// Hands the mips back to the streamer, the rebuild must not touch them afterwards
+	void Finish(bool bInSucceeded)
+	{
+		bSucceeded = bInSucceeded;
+		Counter->Decrement();
+		if (RescheduleCallback)
+			RescheduleCallback();
+	}
+};
+
+// Reads the largest shipped mip and upscales it into the top mip with the CPU engine, worker thread. Returns the CAS time in milliseconds.
+static bool RebuildFidelityFXCASTopMip(const FFidelityFXCASCPUModule& CPUModule, const FFidelityFXCASTopMipRebuild& Rebuild, float& OutMilliseconds)
+{
+	OutMilliseconds = 0.0f;
+	const FTexture2DMipMap& SourceMip = *Rebuild.SourceMip;
+	const int32 BytesPerPixel = GetFidelityFXCASBytesPerPixel(Rebuild.Format);
+	const int64 SourcePitch = static_cast<int64>(SourceMip.SizeX) * BytesPerPixel;
+	if (SourceMip.BulkData.GetBulkDataSize() < SourcePitch * SourceMip.SizeY)
+	{
+		UE_LOG(LogFidelityFXCASMipRebuild, Warning, TEXT("Top mip rebuild: the shipped mip of %s has no pixel data."), Rebuild.Texture.IsValid() ? *Rebuild.Texture->GetName() : TEXT("<destroyed texture>"));
+		return false;
+	}
+
+	// Loads the shipped mip without blocking the game thread, straight into the streamer's memory if it streams in with the top mip
+	IBulkDataIORequest* Request = SourceMip.BulkData.CreateStreamingRequest(AIOP_Low, nullptr, static_cast<uint8*>(Rebuild.SourceMipData));
+	if (!Request)
+		return false;
+	Request->WaitCompletion();
+	uint8* SourceData = Request->GetReadResults();
+	delete Request;
+	if (!SourceData)
+		return false;
+
+	const double StartTime = FPlatformTime::Seconds();
+	const FFidelityFXCASImageView Input(SourceData, SourceMip.SizeX, SourceMip.SizeY, SourcePitch, Rebuild.Format, Rebuild.ChannelOrder);
+	const FFidelityFXCASImageView Output(Rebuild.TopMipData, Rebuild.TopMipSize.X, Rebuild.TopMipSize.Y, static_cast<int64>(Rebuild.TopMipSize.X) * BytesPerPixel,
+		Rebuild.Format, Rebuild.ChannelOrder);
+	FFidelityFXCASCPUSettings Settings;
+	Settings.Sharpness = Rebuild.Sharpness;
+	Settings.bMultithreaded = false;	// One worker per texture
+	const bool bProcessed = CPUModule.Process(Input, Output, Settings);
+	OutMilliseconds = static_cast<float>((FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	if (SourceData != Rebuild.SourceMipData)
+		FMemory::Free(SourceData);
+	return bProcessed;
+}
+
+// Streamer side of the rebuild: claims a top mip without payload (and the shipped mip below when it streams in too),
+// the following providers stream in the other mips. Ticked by the streamer on its async thread.
+class FFidelityFXCASTopMipDataProvider : public FTextureMipDataProvider
+{
+public:
+	FFidelityFXCASTopMipDataProvider(FFidelityFXCASModule* InModule, const UTexture* InTexture, float InSharpness)
+		: FTextureMipDataProvider(InTexture, ETickState::Init, ETickThread::Async)
+		, Module(InModule)
+		, Texture(const_cast<UTexture*>(InTexture))
+		, Sharpness(InSharpness)
+		, bSRGB(InTexture->SRGB)
+	{
+	}
+
+	virtual void Init(const FTextureUpdateContext& Context, const FTextureUpdateSyncOptions& SyncOptions) override
+	{
+		AdvanceTo(ETickState::GetMips, ETickThread::Async);
+	}
+
+	virtual int32 GetMips(const FTextureUpdateContext& Context, int32 StartingMipIndex, const FTextureMipInfoArray& MipInfos, const FTextureUpdateSyncOptions& SyncOptions) override
+	{
+		AdvanceTo(ETickState::PollMips, ETickThread::Async);
+
+		// Shipped top mips stream in as usual
+		if (StartingMipIndex != 0 || Context.MipsView.Num() < 2 || Context.MipsView[0]->BulkData.DoesExist())
+			return StartingMipIndex;
+
+		const FTextureMipInfo& TopMipInfo = MipInfos[0];
+		EFidelityFXCASPixelFormat Format;
+		EFidelityFXCASChannelOrder ChannelOrder;
+		if (!GetFidelityFXCASMipFormat(TopMipInfo.Format, bSRGB, Format, ChannelOrder) || !TopMipInfo.DestData
+			|| TopMipInfo.DataSize < static_cast<uint64>(TopMipInfo.SizeX) * TopMipInfo.SizeY * GetFidelityFXCASBytesPerPixel(Format))
+		{
+			UE_LOG(LogFidelityFXCASMipRebuild, Warning, TEXT("Top mip rebuild: the CPU engine can't write the top mip of %s (%s)."),
+				Texture.IsValid() ? *Texture->GetName() : TEXT("<destroyed texture>"), GetPixelFormatString(TopMipInfo.Format));
+			return StartingMipIndex;
+		}
+
+		Rebuild = MakeShared<FFidelityFXCASTopMipRebuild, ESPMode::ThreadSafe>();
+		Rebuild->Texture = Texture;
+		Rebuild->SourceMip = Context.MipsView[1];
+		Rebuild->SourceMipData = CurrentFirstLODIdx > 1 ? MipInfos[1].DestData : nullptr;
+		Rebuild->TopMipData = TopMipInfo.DestData;
+		Rebuild->TopMipSize = FIntPoint(TopMipInfo.SizeX, TopMipInfo.SizeY);
+		Rebuild->Format = Format;
+		Rebuild->ChannelOrder = ChannelOrder;
+		Rebuild->Sharpness = Sharpness;
+		Rebuild->Counter = SyncOptions.Counter;
+		Rebuild->RescheduleCallback = SyncOptions.RescheduleCallback;
+		SyncOptions.Counter->Increment();
+		Module->QueueTopMipRebuild(Rebuild.ToSharedRef());
+		return Rebuild->SourceMipData ? 2 : 1;
+	}
+
+	virtual bool PollMips(const FTextureUpdateSyncOptions& SyncOptions) override
+	{
+		AdvanceTo(ETickState::CleanUp, ETickThread::Async);
+		return !Rebuild.IsValid() || Rebuild->bSucceeded;
+	}
+
+	virtual void CleanUp(const FTextureUpdateSyncOptions& SyncOptions) override
+	{
+		Rebuild.Reset();
+		AdvanceTo(ETickState::Done, ETickThread::None);
+	}
+
+	virtual void Cancel(const FTextureUpdateSyncOptions& SyncOptions) override
+	{
+		AbortPollMips();
+		Rebuild.Reset();
+	}
+
+	virtual ETickThread GetCancelThread() const override { return ETickThread::None; }
+
+	virtual void AbortPollMips() override
+	{
+		if (Rebuild.IsValid())
+			Rebuild->bAborted = true;
+	}
+
+protected:
+	FFidelityFXCASModule* Module;
+	TWeakObjectPtr<UTexture> Texture;
+	float Sharpness;
+	bool bSRGB;
+	TSharedPtr<FFidelityFXCASTopMipRebuild, ESPMode::ThreadSafe> Rebuild;
+};
+
+UFidelityFXCASTopMipProviderFactory::UFidelityFXCASTopMipProviderFactory(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+}
+
+FTextureMipDataProvider* UFidelityFXCASTopMipProviderFactory::AllocateMipDataProvider(UTexture* Asset)
+{
+	const UTexture2D* Texture = Cast<UTexture2D>(Asset);
+	EFidelityFXCASPixelFormat Format;
+	EFidelityFXCASChannelOrder ChannelOrder;
+	if (!Texture || !Texture->PlatformData || !GetFidelityFXCASMipFormat(Texture->PlatformData->PixelFormat, Texture->SRGB, Format, ChannelOrder))
+	{
+		UE_LOG(LogFidelityFXCASMipRebuild, Warning, TEXT("Top mip rebuild: %s is not an uncompressed RGBA8 / BGRA8, RGBA16f or RGBA32f 2D texture, its top mip streams in as shipped."),
+			Asset ? *Asset->GetName() : TEXT("<no texture>"));
+		return nullptr;
+	}
+	FFidelityFXCASCPUModule::Get();	// Loaded on the game thread, the rebuilds run on worker threads
+	return new FFidelityFXCASTopMipDataProvider(&FFidelityFXCASModule::Get(), Texture, FMath::Clamp(Sharpness, 0.0f, 1.0f));
+}
+
+void FFidelityFXCASModule::QueueTopMipRebuild(const TSharedRef<FFidelityFXCASTopMipRebuild, ESPMode::ThreadSafe>& Rebuild)
+{
+	{
+		FScopeLock Lock(&MipRebuildQueueCS);
+		MipRebuildQueue.Add(Rebuild);
+	}
+
+	// Requested from the streamer's threads, the queue is drained by a game thread ticker
+	AsyncTask(ENamedThreads::GameThread, [this]()
+	{
+		if (!MipRebuildTickerHandle.IsValid())
+			MipRebuildTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FFidelityFXCASModule::TickMipRebuild));
+	});
+}
+
+bool FFidelityFXCASModule::TickMipRebuild(float DeltaTime)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASModule_TickMipRebuild); // Used to gather CPU profiling data for the UE4 session frontend
+
+	TArray<TSharedRef<FFidelityFXCASTopMipRebuild, ESPMode::ThreadSafe>> Started;
+	{
+		FScopeLock Lock(&MipRebuildQueueCS);
+		float SpentMilliseconds = 0.0f;
+		int32 NumStarted = 0;
+		for (; NumStarted < MipRebuildQueue.Num(); ++NumStarted)
+		{
+			const FFidelityFXCASTopMipRebuild& Rebuild = MipRebuildQueue[NumStarted].Get();
+			if (Rebuild.bAborted)
+				continue;
+
+			// At least one rebuild per frame, so textures beyond the budget still get their top mip
+			const float Estimate = Rebuild.GetMegapixels() * MipRebuildStats.CPUMillisecondsPerMegapixel;
+			if (SpentMilliseconds > 0.0f && SpentMilliseconds + Estimate > MipRebuildBudget)
+				break;
+			SpentMilliseconds += Estimate;
+		}
+		Started.Append(MipRebuildQueue.GetData(), NumStarted);
+		MipRebuildQueue.RemoveAt(0, NumStarted, false);
+		MipRebuildStats.NumPending = MipRebuildQueue.Num();
+	}
+
+	const FFidelityFXCASCPUModule* CPUModule = &FFidelityFXCASCPUModule::Get();
+	for (const TSharedRef<FFidelityFXCASTopMipRebuild, ESPMode::ThreadSafe>& Rebuild : Started)
+	{
+		if (Rebuild->bAborted)
+		{
+			Rebuild->Finish(false);
+			continue;
+		}
+
+		++MipRebuildStats.NumInFlight;
+		Async(EAsyncExecution::ThreadPool, [this, CPUModule, Rebuild]()
+		{
+			float Milliseconds = 0.0f;
+			const bool bRebuilt = !Rebuild->bAborted && RebuildFidelityFXCASTopMip(*CPUModule, Rebuild.Get(), Milliseconds);
+			const TWeakObjectPtr<UTexture> Texture = Rebuild->Texture;
+			const float Megapixels = Rebuild->GetMegapixels();
+			Rebuild->Finish(bRebuilt);
+
+			AsyncTask(ENamedThreads::GameThread, [this, Texture, Megapixels, Milliseconds, bRebuilt]()
+			{
+				OnTopMipRebuildDone(Texture, Megapixels, Milliseconds, bRebuilt);
+			});
+		});
+	}
+
+	// Ticks until the queue is empty and the last durations are in
+	FScopeLock Lock(&MipRebuildQueueCS);
+	const bool bKeepTicking = MipRebuildQueue.Num() > 0 || MipRebuildStats.NumInFlight > 0;
+	if (!bKeepTicking)
+		MipRebuildTickerHandle.Reset();
+	return bKeepTicking;
+}
+
+void FFidelityFXCASModule::CancelTopMipRebuilds()
+{
+	check(IsInGameThread());
+
+	if (MipRebuildTickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(MipRebuildTickerHandle);
+		MipRebuildTickerHandle.Reset();
+	}
+
+	// The streamer waits for every queued rebuild, they fail so it cancels their stream-ins
+	FScopeLock Lock(&MipRebuildQueueCS);
+	for (const TSharedRef<FFidelityFXCASTopMipRebuild, ESPMode::ThreadSafe>& Rebuild : MipRebuildQueue)
+		Rebuild->Finish(false);
+	MipRebuildQueue.Empty();
+	MipRebuildStats.NumPending = 0;
+}
+
+void FFidelityFXCASModule::OnTopMipRebuildDone(const TWeakObjectPtr<UTexture>& Texture, float Megapixels, float Milliseconds, bool bRebuilt)
+{
+	check(IsInGameThread());
+
+	MipRebuildStats.NumInFlight = FMath::Max(MipRebuildStats.NumInFlight - 1, 0);
+	const FString TextureName = Texture.IsValid() ? Texture->GetName() : TEXT("<destroyed texture>");
+	if (!bRebuilt)
+	{
+		++MipRebuildStats.NumFailed;
+		UE_LOG(LogFidelityFXCASMipRebuild, Verbose, TEXT("The top mip rebuild of %s was aborted or failed, the stream-in is cancelled."), *TextureName);
+		return;
+	}
+
+	++MipRebuildStats.NumRebuilt;
+	MipRebuildStats.LastMilliseconds = Milliseconds;
+	MipRebuildStats.TotalMilliseconds += Milliseconds;
+
+	// The budget follows the measured cost
+	if (Milliseconds > 0.0f && Megapixels > 0.0f)
+		MipRebuildStats.CPUMillisecondsPerMegapixel = FMath::Lerp(MipRebuildStats.CPUMillisecondsPerMegapixel, Milliseconds / Megapixels, 0.25f);
+
+	UE_LOG(LogFidelityFXCASMipRebuild, Verbose, TEXT("Rebuilt the top mip of %s (%.2f MP) in %.3f ms."), *TextureName, Megapixels, Milliseconds);
+	OnTopMipRebuilt.Broadcast(Texture.Get(), Milliseconds);
+}
@@ -0,0 +1,254 @@
+#include "FidelityFXCASPassBackend.h"
+#include "FidelityFXCASCPU.h"
+
+#include "RHI.h"
+
+// Thread group limit of one dispatch dimension, longer foveated tile lists are split
+static const uint32 GFXCASMaxTileListGroups = 65535;
+
+bool FFidelityFXCASPermutation::operator==(const FFidelityFXCASPermutation& Other) const
+{
+	return Kind == Other.Kind && bFP16 == Other.bFP16 && bSharpenOnly == Other.bSharpenOnly && bVolume == Other.bVolume
+		&& bBilinear == Other.bBilinear && FixedRatio == Other.FixedRatio && Quality == Other.Quality;
+}
+
+FString FFidelityFXCASPermutation::ToString() const
+{
+	static const TCHAR* KindNames[] = { TEXT("Uniform"), TEXT("Masked"), TEXT("Foveated"), TEXT("Array") };
+	return FString::Printf(TEXT("%s %s%s%s%s%s FixedRatio=%d"), KindNames[static_cast<int32>(Kind)], GetFidelityFXCASQualityName(Quality),
+		bFP16 ? TEXT(" FP16") : TEXT(""), bSharpenOnly ? TEXT(" SharpenOnly") : TEXT(""), bVolume ? TEXT(" Volume") : TEXT(""),
+		bBilinear ? TEXT(" Bilinear") : TEXT(""), static_cast<int32>(FixedRatio));
+}
+
+int64 FFidelityFXCASOutputDesc::GetBytes() const
+{
+	return static_cast<int64>(Size.X) * Size.Y * FMath::Max(ArraySize, 1) * GPixelFormats[Format].BlockBytes;
+}
+
+// This value is the image region dim that each thread group of the CAS shader operates on
+static const int32 GFXCASThreadGroupWorkRegionDim = 16;
+
+FIntVector FFidelityFXCASModule::GetDispatchGroupCount(FIntPoint OutputSize)
+{
+	FIntVector DispatchGroupCount(0, 0, 1);
+	DispatchGroupCount.X = (OutputSize.X + (GFXCASThreadGroupWorkRegionDim - 1)) / GFXCASThreadGroupWorkRegionDim;
+	DispatchGroupCount.Y = (OutputSize.Y + (GFXCASThreadGroupWorkRegionDim - 1)) / GFXCASThreadGroupWorkRegionDim;
+	return DispatchGroupCount;
+}
+
+FIntRect FFidelityFXCASModule::GetDispatchGroupRect(const FIntRect& OutputRect)
+{
+	// Thread groups touching the rect. Their extra pixels are recomputed from the same input, so they keep their values.
+	return FIntRect(
+		FIntPoint(OutputRect.Min.X / GFXCASThreadGroupWorkRegionDim, OutputRect.Min.Y / GFXCASThreadGroupWorkRegionDim),
+		FIntPoint(FMath::DivideAndRoundUp(OutputRect.Max.X, GFXCASThreadGroupWorkRegionDim), FMath::DivideAndRoundUp(OutputRect.Max.Y, GFXCASThreadGroupWorkRegionDim)));
+}
+
+bool FFidelityFXCASModule::BindSSCASCallback(ESSCASCallback Callback, ESSCASCallback& BoundCallback, IFidelityFXCASPassBackend& Backend)
+{
+	// Dynamic resolution changes the screen percentage often, the callbacks are only rebound when the upscale mode changes
+	if (Callback == BoundCallback)
+		return false;
+
+	Backend.RebindSSCASCallback(BoundCallback, Callback);
+	BoundCallback = Callback;
+	return true;
+}
+
+FFidelityFXCASPermutation GetFidelityFXCASPermutation(const FFidelityFXCASPassDesc& Desc)
+{
+	// Masked and foveated passes have no prefilter permutation, the uniform pass prefilters them (DrawToRenderTargetMasked warns about the dropped mask)
+	const bool bPrefilter = FFidelityFXCASCPUModule::GetPrefilterSize(Desc.InputSize, Desc.OutputSize) != FIntPoint(1, 1);
+
+	FFidelityFXCASPermutation Permutation;
+	if (Desc.bArray)
+		Permutation.Kind = EFidelityFXCASPassKind::Array;
+	else if (Desc.bHasSharpnessMask && !bPrefilter)
+		Permutation.Kind = EFidelityFXCASPassKind::Masked;
+	else if (Desc.Foveation.IsEnabled() && Desc.DirtyRects.Num() == 0 && !bPrefilter)
+		Permutation.Kind = EFidelityFXCASPassKind::Foveated;
+	Permutation.bFP16 = FX_CAS_FP16_ENABLED && Desc.bUseFP16;
+	Permutation.bSharpenOnly = (Desc.InputSize == Desc.OutputSize);
+	Permutation.bVolume = Desc.bArray && Desc.bInputVolume;
+	Permutation.Quality = GetFidelityFXCASShaderQuality(Desc.Quality, Permutation.bFP16);
+	if (Permutation.Kind == EFidelityFXCASPassKind::Uniform && !Permutation.bSharpenOnly)
+		Permutation.FixedRatio = GetFidelityFXCASFixedRatio(Desc.InputSize, Desc.OutputSize);
+	return Permutation;
+}
+
+// Whole output, or one dispatch per dirty region covering the thread groups it touches
+static void AddRegionDispatches(const FFidelityFXCASPassDesc& Desc, const FFidelityFXCASPermutation& Permutation, TArray<FFidelityFXCASDispatch>& OutDispatches)
+{
+	if (Desc.DirtyRects.Num() == 0)
+	{
+		FFidelityFXCASDispatch& Dispatch = OutDispatches.AddDefaulted_GetRef();
+		Dispatch.Permutation = Permutation;
+		Dispatch.GroupCount = FFidelityFXCASModule::GetDispatchGroupCount(Desc.OutputSize);
+		return;
+	}
+
+	for (const FIntRect& DirtyRect : Desc.DirtyRects)
+	{
+		const FIntRect GroupRect = FFidelityFXCASModule::GetDispatchGroupRect(DirtyRect);
+		FFidelityFXCASDispatch& Dispatch = OutDispatches.AddDefaulted_GetRef();
+		Dispatch.Permutation = Permutation;
+		Dispatch.GroupOffset = GroupRect.Min;
+		Dispatch.GroupCount = FIntVector(GroupRect.Width(), GroupRect.Height(), 1);
+	}
+}
+
+// One dispatch per tile class (split at the group limit): full CAS, the Low tier and the bilinear periphery
+static void AddFoveatedDispatches(const FFidelityFXCASTileClassification& Classification, const FFidelityFXCASPermutation& Permutation,
+	TArray<FFidelityFXCASDispatch>& OutDispatches)
+{
+	uint32 ListOffset = 0;
+	for (int32 ClassIndex = 0; ClassIndex < static_cast<int32>(EFidelityFXCASTileClass::Num); ++ClassIndex)
+	{
+		const EFidelityFXCASTileClass Class = static_cast<EFidelityFXCASTileClass>(ClassIndex);
+		const uint32 NumTiles = Classification.GetTileList(Class).Num();
+
+		FFidelityFXCASPermutation ClassPermutation = Permutation;
+		if (Class == EFidelityFXCASTileClass::Reduced)
+		{
+			ClassPermutation.Quality = EFidelityFXCASQuality::Low;
+		}
+		else if (Class != EFidelityFXCASTileClass::Full)
+		{
+			ClassPermutation.bBilinear = true;
+			ClassPermutation.bFP16 = false;
+			ClassPermutation.bSharpenOnly = false;
+			ClassPermutation.Quality = EFidelityFXCASQuality::Low;
+		}
+
+		for (uint32 First = 0; First < NumTiles; First += GFXCASMaxTileListGroups)
+		{
+			FFidelityFXCASDispatch& Dispatch = OutDispatches.AddDefaulted_GetRef();
+			Dispatch.Permutation = ClassPermutation;
+			Dispatch.GroupCount = FIntVector(FMath::Min(NumTiles - First, GFXCASMaxTileListGroups), 1, 1);
+			Dispatch.TileListOffset = ListOffset + First;
+		}
+		ListOffset += NumTiles;
+	}
+}
+
+void BuildFidelityFXCASComputePass(const FFidelityFXCASPassDesc& Desc, IFidelityFXCASPassBackend& Backend)
+{
+	const FFidelityFXCASPermutation Permutation = GetFidelityFXCASPermutation(Desc);
+	Backend.OutputBarrier();
+
+	TArray<FFidelityFXCASDispatch> PassDispatches;
+	switch (Permutation.Kind)
+	{
+	case EFidelityFXCASPassKind::Foveated:
+	{
+		// Same classification as FFidelityFXCASCPUModule::ProcessFoveated()
+		FFidelityFXCASTileClassification LocalClassification;
+		FFidelityFXCASTileClassification& Classification = Desc.TileClassification ? *Desc.TileClassification : LocalClassification;
+		FFidelityFXCASCPUModule::ClassifyTiles(Desc.OutputSize, Desc.Foveation, Classification);
+		Backend.UploadTileLists(Classification);
+		AddFoveatedDispatches(Classification, Permutation, PassDispatches);
+		break;
+	}
+	case EFidelityFXCASPassKind::Array:
+	{
+		FFidelityFXCASDispatch& Dispatch = PassDispatches.AddDefaulted_GetRef();
+		Dispatch.Permutation = Permutation;
+		Dispatch.GroupCount = FFidelityFXCASModule::GetDispatchGroupCount(Desc.OutputSize);
+		Dispatch.GroupCount.Z = Desc.NumSlices;
+		break;
+	}
+	default:
+		AddRegionDispatches(Desc, Permutation, PassDispatches);
+		break;
+	}
+	Backend.DispatchPass(PassDispatches);
+}
+
+//-------------------------------------------------------------------------------------------------
+// Recording backend
+//-------------------------------------------------------------------------------------------------
+
+bool FFidelityFXCASPassCounters::operator==(const FFidelityFXCASPassCounters& Other) const
+{
+	return NumPasses == Other.NumPasses && NumDispatches == Other.NumDispatches && NumThreadGroups == Other.NumThreadGroups
+		&& NumBarriers == Other.NumBarriers && NumAllocations == Other.NumAllocations && AllocatedBytes == Other.AllocatedBytes
+		&& UploadedBytes == Other.UploadedBytes && NumCallbackRebinds == Other.NumCallbackRebinds;
+}
+
+FString FFidelityFXCASPassCounters::ToString() const
+{
+	return FString::Printf(TEXT("passes %d, dispatches %d, thread groups %lld, barriers %d, allocations %d (%lld bytes), uploads %lld bytes, callback rebinds %d"),
+		NumPasses, NumDispatches, NumThreadGroups, NumBarriers, NumAllocations, AllocatedBytes, UploadedBytes, NumCallbackRebinds);
+}
+
+void FFidelityFXCASRecordingPassBackend::OutputBarrier()
+{
+	++FrameCounters.NumBarriers;
+}
+
+void FFidelityFXCASRecordingPassBackend::UploadTileLists(const FFidelityFXCASTileClassification& Classification)
+{
+	for (const TArray<uint32>& TileList : Classification.TileLists)
+		FrameCounters.UploadedBytes += TileList.Num() * sizeof(uint32);
+}
+
+void FFidelityFXCASRecordingPassBackend::DispatchPass(const TArray<FFidelityFXCASDispatch>& Dispatches)
+{
+	++FrameCounters.NumPasses;
+	FrameCounters.NumDispatches += Dispatches.Num();
+	for (const FFidelityFXCASDispatch& Dispatch : Dispatches)
+		FrameCounters.NumThreadGroups += static_cast<int64>(Dispatch.GroupCount.X) * Dispatch.GroupCount.Y * Dispatch.GroupCount.Z;
+	FrameDispatches.Append(Dispatches);
+}
+
+void FFidelityFXCASRecordingPassBackend::PrepareOutput(const FName& Name, const FFidelityFXCASOutputDesc& Desc)
+{
+	if (!FFidelityFXCASOutputDesc::NeedsRecreate(Outputs.Find(Name), Desc))
+		return;
+
+	Outputs.Add(Name, Desc);
+	++FrameCounters.NumAllocations;
+	FrameCounters.AllocatedBytes += Desc.GetBytes();
+}
+
+void FFidelityFXCASRecordingPassBackend::RebindSSCASCallback(FFidelityFXCASModule::ESSCASCallback From, FFidelityFXCASModule::ESSCASCallback To)
+{
+	++FrameCounters.NumCallbackRebinds;
+}
+
+void FFidelityFXCASRecordingPassBackend::BindSSCASCallback(FFidelityFXCASModule::ESSCASCallback Callback)
+{
+	FFidelityFXCASModule::BindSSCASCallback(Callback, BoundCallback, *this);
+}
+
+void FFidelityFXCASRecordingPassBackend::EndFrame()
+{
+	RecordedFrames.Add(FrameCounters);
+	FrameCounters = FFidelityFXCASPassCounters();
+	FrameDispatches.Reset();
+}
+
+void FFidelityFXCASRecordingPassBackend::Reset()
+{
+	FrameCounters = FFidelityFXCASPassCounters();
+	FrameDispatches.Empty();
+	RecordedFrames.Empty();
+	Outputs.Empty();
+	BoundCallback = FFidelityFXCASModule::ESSCASCallback::None;
+}
+
+bool FFidelityFXCASRecordingPassBackend::CompareFrames(const TArray<FFidelityFXCASPassCounters>& Baseline, const TArray<FFidelityFXCASPassCounters>& Frames, FString& OutReport)
+{
+	OutReport.Reset();
+	if (Baseline.Num() != Frames.Num())
+		OutReport += FString::Printf(TEXT("%d frames recorded, %d in the baseline\n"), Frames.Num(), Baseline.Num());
+
+	for (int32 Index = 0; Index < FMath::Min(Baseline.Num(), Frames.Num()); ++Index)
+	{
+		if (Frames[Index] != Baseline[Index])
+		{
+			OutReport += FString::Printf(TEXT("Frame %d: %s\n  baseline: %s\n"), Index, *Frames[Index].ToString(), *Baseline[Index].ToString());
+		}
+	}
+	return OutReport.IsEmpty();
+}
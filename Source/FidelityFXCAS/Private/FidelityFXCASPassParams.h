@@ -4,6 +4,9 @@
 
 #include "RHIResources.h"
 #include "RendererInterface.h"
+#include "FidelityFXCASTypes.h"
+#include "FidelityFXCASCPUTypes.h"
+#include "FidelityFXCASPassBackend.h"
 
 //-------------------------------------------------------------------------------------------------
 // Base class
@@ -16,6 +19,8 @@ class FFidelityFXCASPassParams
 	static FUnorderedAccessViewRHIRef EMPTY_UnorderedAccessViewRHIRef;
 
 protected:
+	static TRefCountPtr<IPooledRenderTarget> EMPTY_PooledRenderTarget;	// CS output of the passes writing a graph texture
+
 	FIntPoint InputSize = FIntPoint::ZeroValue;
 	FIntPoint OutputSize = FIntPoint::ZeroValue;
 
@@ -24,6 +29,7 @@ public:
 
 	float Sharpness = 0.5f;
 	bool bUseFP16 = false;
+	EFidelityFXCASQuality Quality = EFidelityFXCASQuality::Low;
 
 	FFidelityFXCASPassParams(TRefCountPtr<IPooledRenderTarget>& InCSOutput) : CSOutput(InCSOutput) { }
 
@@ -35,10 +41,6 @@ public:
 	FORCEINLINE const FTextureRHIRef& GetCSOutputTargetableTexture() const { return GetCSOutputRTItem().IsValid() ? GetCSOutputRTItem().TargetableTexture : EMPTY_TextureRHIRef; }
 };
 
-FTextureRHIRef FFidelityFXCASPassParams::EMPTY_TextureRHIRef;
-FSceneRenderTargetItem FFidelityFXCASPassParams::EMPTY_SceneRenderTargetItem;
-FUnorderedAccessViewRHIRef FFidelityFXCASPassParams::EMPTY_UnorderedAccessViewRHIRef;
-
 //-------------------------------------------------------------------------------------------------
 // RHI Version
 //-------------------------------------------------------------------------------------------------
@@ -52,6 +54,25 @@ protected:
 	FTextureRHIRef RTTexture;
 
 public:
+	// Output regions to update (e.g. from FFidelityFXCASCPUModule::GetDirtyOutputRects), empty to update the whole output.
+	// The rest of the compute shader output and the render target keep their contents.
+	TArray<FIntRect> DirtyRects;
+
+	// Slices processed by one dispatch when the input is a texture array or a volume (see RunComputeShaderArray_RHI_RenderThread)
+	int32 NumSlices = 1;
+
+	// Tiled processing (FidelityFXCASTiled.cpp): the input texture holds the image pixels from TileSourceOffset and the output
+	// texture the pixels from TileOutputOffset, the sizes are the ones of the whole image (see SetTile)
+	FIntPoint TileSourceOffset = FIntPoint::ZeroValue;
+	FIntPoint TileOutputOffset = FIntPoint::ZeroValue;
+
+	// Focus regions of a foveated pass (see RunComputeShaderFoveated_RHI_RenderThread), ignored with dirty regions, tiles and prefiltered downscales
+	FFidelityFXCASFoveation Foveation;
+
+	// Per pixel sharpness scale in [0, 1] (red channel, any resolution, bilinearly stretched over the output), null for a uniform
+	// sharpness. 0 leaves a pixel unsharpened. Takes precedence over the foveation, ignored by prefiltered downscales and array passes.
+	FTextureRHIRef SharpnessMask;
+
 	FFidelityFXCASPassParams_RHI(const FTextureRHIRef& InInputTexture, const FTextureRHIRef& InRTTexture, TRefCountPtr<IPooledRenderTarget>& InCSOutput)
 		: FFidelityFXCASPassParams(InCSOutput)
 		, InputTexture(InInputTexture)
@@ -59,18 +80,47 @@ public:
 	{
 		InputSize = InputTexture.IsValid() ? FIntPoint(InputTexture->GetSizeXYZ().X, InputTexture->GetSizeXYZ().Y) : FIntPoint::ZeroValue;
 		OutputSize = RTTexture.IsValid() ? FIntPoint(RTTexture->GetSizeXYZ().X, RTTexture->GetSizeXYZ().Y) : FIntPoint::ZeroValue;
+		NumSlices = (InputTexture.IsValid() && RTTexture.IsValid()) ? FMath::Min(InputTexture->GetSizeXYZ().Z, RTTexture->GetSizeXYZ().Z) : 1;
 	}
 
 	FORCEINLINE const FTextureRHIRef& GetInputTexture() const { return InputTexture; }
 	FORCEINLINE const FTextureRHIRef& GetRTTexture() const    { return RTTexture; }
+	FORCEINLINE bool IsInputVolume() const                    { return InputTexture.IsValid() && InputTexture->GetTexture3D() != nullptr; }
+
+	// The pass without its RHI resources, for the pass plan (see BuildFidelityFXCASComputePass)
+	FFidelityFXCASPassDesc GetPassDesc() const
+	{
+		FFidelityFXCASPassDesc Desc;
+		Desc.InputSize = InputSize;
+		Desc.OutputSize = OutputSize;
+		Desc.bUseFP16 = bUseFP16;
+		Desc.Quality = Quality;
+		Desc.DirtyRects = DirtyRects;
+		Desc.bHasSharpnessMask = SharpnessMask.IsValid();
+		Desc.Foveation = Foveation;
+		Desc.bInputVolume = IsInputVolume();
+		Desc.NumSlices = NumSlices;
+		return Desc;
+	}
+
+	// Runs CAS on the output region TileOutputRect of an ImageInputSize -> ImageOutputSize image, TileOutputRect.Min must be a multiple of 16
+	void SetTile(const FIntPoint& ImageInputSize, const FIntPoint& ImageOutputSize, const FIntPoint& InTileSourceOffset, const FIntRect& TileOutputRect)
+	{
+		InputSize = ImageInputSize;
+		OutputSize = ImageOutputSize;
+		TileSourceOffset = InTileSourceOffset;
+		TileOutputOffset = TileOutputRect.Min;
+		DirtyRects = { TileOutputRect };
+	}
 };
 
-#if FX_CAS_CUSTOM_UPSCALE_CALLBACK
+#if FX_CAS_CUSTOM_UPSCALE_CALLBACK || FX_CAS_VIEW_EXTENSION
 //-------------------------------------------------------------------------------------------------
 // RDG Version
 //-------------------------------------------------------------------------------------------------
 
 #include "RenderGraphResources.h"
+#include "RenderGraphBuilder.h"
 
 class FFidelityFXCASPassParams_RDG : public FFidelityFXCASPassParams
 {
@@ -89,9 +139,43 @@ public:
 		OutputSize = RTBinding.GetTexture() != nullptr ? RTBinding.GetTexture()->Desc.Extent : FIntPoint::ZeroValue;
 	}
 
+	// View extension (FidelityFXCASViewExtension.cpp): the CS writes OutputViewRect of a graph texture, without pooled output and render target
+	FFidelityFXCASPassParams_RDG(const FIntRect& InInputViewRect, const FRDGTextureRef& InInputTexture, const FIntRect& InOutputViewRect, FRDGTextureRef InOutputTexture)
+		: FFidelityFXCASPassParams(EMPTY_PooledRenderTarget)
+		, InputTexture(InInputTexture)
+	{
+		InputSize = InInputViewRect.Size();
+		OutputSize = InOutputViewRect.Size();
+		InputViewMin = InInputViewRect.Min;
+		OutputViewMin = InOutputViewRect.Min;
+		CSOutputTexture = InOutputTexture;
+	}
+
 	FORCEINLINE const FRDGTextureRef& GetInputTexture() const    { return InputTexture; }
 	FORCEINLINE const FRenderTargetBinding& GetRTBinding() const { return RTBinding; }
+
+	// The pass without its graph resources, for the pass plan: the whole view, no mask and no foveation
+	FFidelityFXCASPassDesc GetPassDesc() const
+	{
+		FFidelityFXCASPassDesc Desc;
+		Desc.InputSize = InputSize;
+		Desc.OutputSize = OutputSize;
+		Desc.bUseFP16 = bUseFP16;
+		Desc.Quality = Quality;
+		return Desc;
+	}
+
+	// The CS output is registered with the graph, so RDG orders the CS and PS passes and fences them when the CS runs on async compute
+	FRDGTextureRef CSOutputTexture = nullptr;
+	void RegisterCSOutput(FRDGBuilder& GraphBuilder) { CSOutputTexture = GraphBuilder.RegisterExternalTexture(CSOutput, TEXT("FidelityFXCAS.CSOutput")); }
+
+	// First pixel of the view in the input and in the CS output, the views of split screen or stereo families don't start at the origin
+	FIntPoint InputViewMin = FIntPoint::ZeroValue;
+	FIntPoint OutputViewMin = FIntPoint::ZeroValue;
+
+	// Pipe of the CS pass, async compute if requested and supported by the RHI (see FFidelityFXCASModule::GetSSCASComputePipe)
+	EFidelityFXCASComputePipe ComputePipe = EFidelityFXCASComputePipe::Graphics;
 };
 
-#endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK
+#endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK || FX_CAS_VIEW_EXTENSION
 #endif // FX_CAS_PLUGIN_ENABLED
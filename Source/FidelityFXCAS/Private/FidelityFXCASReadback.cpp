@@ -0,0 +1,227 @@
+#include "FidelityFXCAS.h"
+
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "RenderingThread.h"
+#if FX_CAS_PLUGIN_ENABLED
+#include "RenderTargetPool.h"
+#endif // FX_CAS_PLUGIN_ENABLED
+
+DEFINE_LOG_CATEGORY_STATIC(LogFidelityFXCASReadback, Log, All);
+
+// Callbacks run on a worker thread, never on the thread that requested or polled the readback
+static void DeliverReadback(FOnFidelityFXCASReadback Callback, FFidelityFXCASReadbackResult&& Result)
+{
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [Callback, Result = MoveTemp(Result)]()
+	{
+		Callback.ExecuteIfBound(Result);
+	});
+}
+
+bool FFidelityFXCASModule::RequestReadback(UTextureRenderTarget2D* RenderTarget, const FFidelityFXCASReadbackSettings& Settings, FOnFidelityFXCASReadback Callback)
+{
+	check(IsInGameThread());
+
+#if FX_CAS_PLUGIN_ENABLED
+	FTextureRenderTargetResource* RTResource = RenderTarget ? RenderTarget->GameThread_GetRenderTargetResource() : nullptr;
+	if (!RTResource)
+	{
+		UE_LOG(LogFidelityFXCASReadback, Warning, TEXT("RequestReadback: no render target or its resource isn't initialized."));
+		return false;
+	}
+
+	ENQUEUE_RENDER_COMMAND(FidelityFXCASModule_RequestReadback)(
+		[this, RTResource, Settings, Callback](FRHICommandListImmediate& RHICmdList)
+		{
+			RequestReadback_RenderThread(RHICmdList, RTResource->GetRenderTargetTexture(), Settings, Callback);
+		});
+	return true;
+#else
+	UE_LOG(LogFidelityFXCASReadback, Warning, TEXT("RequestReadback: the plugin is disabled on this platform."));
+	return false;
+#endif // FX_CAS_PLUGIN_ENABLED
+}
+
+FFidelityFXCASReadbackStats FFidelityFXCASModule::GetReadbackStats() const
+{
+	FFidelityFXCASReadbackStats Stats;
+	Stats.NumInFlight = NumReadbacksInFlight.GetValue();
+	Stats.NumCompleted = NumReadbacksCompleted.GetValue();
+	Stats.NumStalls = NumReadbackStalls.GetValue();
+	Stats.NumBytes = NumReadbackBytes.GetValue();
+	return Stats;
+}
+
+bool FFidelityFXCASModule::TickReadback(float DeltaTime)
+{
+	// Ticks while copies are in flight, requests made later add the ticker again
+	if (NumReadbacksInFlight.GetValue() == 0)
+	{
+		ReadbackTickerHandle.Reset();
+		return false;
+	}
+
+#if FX_CAS_PLUGIN_ENABLED
+	ENQUEUE_RENDER_COMMAND(FidelityFXCASModule_PollReadbacks)(
+		[this](FRHICommandListImmediate& RHICmdList)
+		{
+			PollReadbacks_RenderThread(RHICmdList);
+		});
+#endif // FX_CAS_PLUGIN_ENABLED
+	return true;
+}
+
+#if FX_CAS_PLUGIN_ENABLED
+void FFidelityFXCASModule::RequestReadback_RenderThread(FRHICommandListImmediate& RHICmdList, const FTextureRHIRef& Texture, const FFidelityFXCASReadbackSettings& Settings,
+	FOnFidelityFXCASReadback Callback)
+{
+	check(IsInRenderingThread());
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASModule_RequestReadback); // Used to gather CPU profiling data for the UE4 session frontend
+	SCOPED_DRAW_EVENT(RHICmdList, FidelityFXCASModule_RequestReadback);  // Used to profile GPU activity and add metadata to be consumed by for example RenderDoc
+
+	FRHITexture2D* Texture2D = Texture.IsValid() ? Texture->GetTexture2D() : nullptr;
+	const FIntRect TextureRect(FIntPoint::ZeroValue, Texture2D ? Texture2D->GetSizeXY() : FIntPoint::ZeroValue);
+	FIntRect SourceRect = Settings.SourceRect.IsEmpty() ? TextureRect : Settings.SourceRect;
+	SourceRect.Clip(TextureRect);
+	if (SourceRect.IsEmpty())
+	{
+		UE_LOG(LogFidelityFXCASReadback, Warning, TEXT("RequestReadback: no 2D texture or the source rect is outside of it."));
+		DeliverReadback(Callback, FFidelityFXCASReadbackResult());
+		return;
+	}
+
+	// Copies finished since the last poll free their slots
+	PollReadbacks_RenderThread(RHICmdList);
+
+	// Ring size changes apply here, slots in flight are kept until they complete
+	const int32 RingSize = FMath::Max(ReadbackRingSize_RenderThread, 1);
+	while (ReadbackRing.Num() < RingSize)
+		ReadbackRing.AddDefaulted();
+	while (ReadbackRing.Num() > RingSize && !ReadbackRing.Last().bInFlight)
+		ReadbackRing.Pop();
+
+	FReadbackSlot* Slot = ReadbackRing.FindByPredicate([](const FReadbackSlot& Candidate) { return !Candidate.bInFlight; });
+	if (!Slot)
+	{
+		// Ring full: mapping the oldest copy waits for the GPU
+		for (FReadbackSlot& Candidate : ReadbackRing)
+		{
+			if (!Slot || Candidate.Sequence < Slot->Sequence)
+				Slot = &Candidate;
+		}
+		NumReadbackStalls.Increment();
+		CompleteReadback_RenderThread(RHICmdList, *Slot);
+	}
+
+	// Wider formats are drawn into an RGBA8 target first, only the source rect is shaded
+	FTextureRHIRef CopySource = Texture;
+	if (Settings.bCompressToRGBA8 && GPixelFormats[Texture->GetFormat()].BlockBytes > 4)
+	{
+		FPooledRenderTargetDesc ConversionDesc(FPooledRenderTargetDesc::Create2DDesc(TextureRect.Size(), PF_R8G8B8A8, FClearValueBinding::None,
+			TexCreate_None, TexCreate_RenderTargetable | TexCreate_ShaderResource, false));
+		GRenderTargetPool.FindFreeElement(RHICmdList, ConversionDesc, ReadbackConversion, TEXT("FidelityFXCASModule_ReadbackConversion"));
+		CopySource = ReadbackConversion->GetRenderTargetItem().TargetableTexture;
+
+		RHICmdList.TransitionResource(EResourceTransitionAccess::EReadable, Texture);
+		DrawTextureToRenderTarget_RHI_RenderThread(RHICmdList, Texture, CopySource, TArray<FIntRect>({ SourceRect }));
+	}
+
+	// Staging textures are kept while the size and the format stay the same
+	const FIntPoint Size = SourceRect.Size();
+	const EPixelFormat Format = CopySource->GetFormat();
+	if (!Slot->StagingTexture.IsValid() || Slot->StagingTexture->GetSizeXY() != Size || Slot->StagingTexture->GetFormat() != Format)
+	{
+		FRHIResourceCreateInfo CreateInfo;
+		Slot->StagingTexture = RHICreateTexture2D(Size.X, Size.Y, Format, 1, 1, TexCreate_CPUReadback, CreateInfo);
+	}
+	if (Slot->Fence.IsValid())
+		Slot->Fence->Clear();
+	else
+		Slot->Fence = RHICreateGPUFence(TEXT("FidelityFXCASModule_ReadbackFence"));
+
+	RHICmdList.TransitionResource(EResourceTransitionAccess::EReadable, CopySource);
+	FRHICopyTextureInfo CopyInfo;
+	CopyInfo.Size = FIntVector(Size.X, Size.Y, 1);
+	CopyInfo.SourcePosition = FIntVector(SourceRect.Min.X, SourceRect.Min.Y, 0);
+	RHICmdList.CopyTexture(CopySource, Slot->StagingTexture, CopyInfo);
+	RHICmdList.WriteGPUFence(Slot->Fence);
+
+	Slot->Callback = Callback;
+	Slot->SourceRect = SourceRect;
+	Slot->bInFlight = true;
+	Slot->Sequence = ++ReadbackSequence;
+
+	// The first readback in flight starts the polling
+	if (NumReadbacksInFlight.Increment() == 1)
+	{
+		AsyncTask(ENamedThreads::GameThread, [this]()
+		{
+			if (!ReadbackTickerHandle.IsValid())
+				ReadbackTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FFidelityFXCASModule::TickReadback));
+		});
+	}
+}
+
+void FFidelityFXCASModule::PollReadbacks_RenderThread(FRHICommandListImmediate& RHICmdList)
+{
+	check(IsInRenderingThread());
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASModule_PollReadbacks); // Used to gather CPU profiling data for the UE4 session frontend
+
+	// In issue order, the fences are signaled in that order too
+	for (;;)
+	{
+		FReadbackSlot* Oldest = nullptr;
+		for (FReadbackSlot& Slot : ReadbackRing)
+		{
+			if (Slot.bInFlight && (!Oldest || Slot.Sequence < Oldest->Sequence))
+				Oldest = &Slot;
+		}
+		if (!Oldest || !Oldest->Fence->Poll())
+			break;
+		CompleteReadback_RenderThread(RHICmdList, *Oldest);
+	}
+}
+
+void FFidelityFXCASModule::CompleteReadback_RenderThread(FRHICommandListImmediate& RHICmdList, FReadbackSlot& Slot)
+{
+	check(IsInRenderingThread() && Slot.bInFlight);
+
+	FFidelityFXCASReadbackResult Result;
+	Result.Size = Slot.SourceRect.Size();
+	Result.Format = Slot.StagingTexture->GetFormat();
+	Result.SourceRect = Slot.SourceRect;
+
+	// Staging textures can only be mapped here, the callback gets rows without the pitch padding
+	void* Data = nullptr;
+	int32 MappedWidth = 0;		// Row pitch in pixels
+	int32 MappedHeight = 0;
+	RHICmdList.MapStagingSurface(Slot.StagingTexture, Data, MappedWidth, MappedHeight);
+	if (Data)
+	{
+		const int64 BytesPerPixel = GPixelFormats[Result.Format].BlockBytes;
+		const int64 RowSize = static_cast<int64>(Result.Size.X) * BytesPerPixel;
+		const int64 MappedPitch = static_cast<int64>(MappedWidth) * BytesPerPixel;
+		Result.Pixels.SetNumUninitialized(RowSize * Result.Size.Y);
+		for (int32 Y = 0; Y < Result.Size.Y; ++Y)
+			FMemory::Memcpy(Result.Pixels.GetData() + Y * RowSize, static_cast<const uint8*>(Data) + Y * MappedPitch, RowSize);
+		Result.bSuccess = true;
+		RHICmdList.UnmapStagingSurface(Slot.StagingTexture);
+	}
+	else
+	{
+		UE_LOG(LogFidelityFXCASReadback, Warning, TEXT("RequestReadback: couldn't map the staging texture."));
+	}
+
+	FOnFidelityFXCASReadback Callback = MoveTemp(Slot.Callback);
+	Slot.Callback.Unbind();
+	Slot.bInFlight = false;
+	NumReadbacksCompleted.Increment();
+	NumReadbackBytes.Add(Result.Pixels.Num());
+	NumReadbacksInFlight.Decrement();
+
+	DeliverReadback(Callback, MoveTemp(Result));
+}
+#endif // FX_CAS_PLUGIN_ENABLED
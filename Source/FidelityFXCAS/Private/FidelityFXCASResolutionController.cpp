@@ -0,0 +1,70 @@
+#include "FidelityFXCASResolutionController.h"
+
+FFidelityFXCASResolutionController::FFidelityFXCASResolutionController(const FFidelityFXCASResolutionControllerSettings& InSettings)
+{
+	SetSettings(InSettings);
+	Reset(Settings.MaxScreenPercentage);
+}
+
+void FFidelityFXCASResolutionController::SetSettings(const FFidelityFXCASResolutionControllerSettings& InSettings)
+{
+	Settings = InSettings;
+	Settings.TargetFrameTime = FMath::Max(Settings.TargetFrameTime, 0.1f);
+	Settings.MinScreenPercentage = FMath::Clamp(Settings.MinScreenPercentage, 1.0f, 400.0f);
+	Settings.MaxScreenPercentage = FMath::Clamp(Settings.MaxScreenPercentage, Settings.MinScreenPercentage, 400.0f);
+	Settings.LowerThreshold = FMath::Clamp(Settings.LowerThreshold, 0.0f, 1.0f);
+	Settings.UpperThreshold = FMath::Max(Settings.UpperThreshold, Settings.LowerThreshold);
+	Settings.Smoothing = FMath::Clamp(Settings.Smoothing, 0.01f, 1.0f);
+	Settings.CooldownFrames = FMath::Max(Settings.CooldownFrames, 0);
+	Settings.MinStep = FMath::Max(Settings.MinStep, 0.0f);
+	Settings.MaxStep = FMath::Max(Settings.MaxStep, Settings.MinStep);
+
+	ScreenPercentage = FMath::Clamp(ScreenPercentage, Settings.MinScreenPercentage, Settings.MaxScreenPercentage);
+}
+
+void FFidelityFXCASResolutionController::Reset(float InScreenPercentage)
+{
+	ScreenPercentage = FMath::Clamp(InScreenPercentage, Settings.MinScreenPercentage, Settings.MaxScreenPercentage);
+	SmoothedFrameTime = 0.0f;
+	CooldownFramesLeft = Settings.CooldownFrames;	// Gather some history before the first decision
+}
+
+bool FFidelityFXCASResolutionController::Update(float GPUFrameTime)
+{
+	if (GPUFrameTime <= 0.0f)
+		return false;
+
+	SmoothedFrameTime = (SmoothedFrameTime > 0.0f) ? FMath::Lerp(SmoothedFrameTime, GPUFrameTime, Settings.Smoothing) : GPUFrameTime;
+	if (CooldownFramesLeft > 0)
+	{
+		--CooldownFramesLeft;
+		return false;
+	}
+
+	// Hold inside the hysteresis band
+	const float UpperBound = Settings.TargetFrameTime * Settings.UpperThreshold;
+	const float LowerBound = Settings.TargetFrameTime * Settings.LowerThreshold;
+	if (SmoothedFrameTime <= UpperBound && SmoothedFrameTime >= LowerBound)
+		return false;
+
+	// The upscaled passes cost roughly proportionally to the pixel count, so aim for the middle of the band with the square root of the ratio
+	const float Goal = 0.5f * (UpperBound + LowerBound);
+	const float Desired = ScreenPercentage * FMath::Sqrt(Goal / SmoothedFrameTime);
+	const float Step = FMath::Clamp(Desired - ScreenPercentage, -Settings.MaxStep, Settings.MaxStep);
+	const float NewScreenPercentage = FMath::Clamp(static_cast<float>(FMath::RoundToInt(ScreenPercentage + Step)), Settings.MinScreenPercentage, Settings.MaxScreenPercentage);
+	if (FMath::Abs(NewScreenPercentage - ScreenPercentage) < FMath::Max(Settings.MinStep, KINDA_SMALL_NUMBER))
+		return false;
+
+	// The smoothed time still describes the old resolution, scale it to the new one so the next decision does not overshoot
+	SmoothedFrameTime *= FMath::Square(NewScreenPercentage / ScreenPercentage);
+	ScreenPercentage = NewScreenPercentage;
+	CooldownFramesLeft = Settings.CooldownFrames;
+	return true;
+}
+
+float FFidelityFXCASResolutionController::GetSharpness() const
+{
+	const float Range = Settings.MaxScreenPercentage - Settings.MinScreenPercentage;
+	const float Alpha = Range > 0.0f ? (ScreenPercentage - Settings.MinScreenPercentage) / Range : 1.0f;
+	return FMath::Clamp(FMath::Lerp(Settings.SharpnessAtMinScreenPercentage, Settings.SharpnessAtMaxScreenPercentage, Alpha), 0.0f, 1.0f);
+}
@@ -5,6 +5,26 @@
 #include "FidelityFXCASShaderCompilationRules.h"
 #include "Misc/EngineVersionComparison.h"
 
+// IMPLEMENT_SHADER_TYPE() does not accept template arguments with commas, so every permutation gets a typedef first
+#define FX_CAS_IMPLEMENT_CS(Api, FP16, SharpenOnly, FixedRatio, Quality) \
+	typedef TFidelityFXCASShaderCS_##Api<FP16, SharpenOnly, FixedRatio, Quality> TFidelityFXCASShaderCS_##Api##_##FP16##SharpenOnly##FixedRatio##Quality; \
+	IMPLEMENT_SHADER_TYPE(template<> FIDELITYFXCAS_API, TFidelityFXCASShaderCS_##Api##_##FP16##SharpenOnly##FixedRatio##Quality, TEXT("/Plugin/FidelityFXCAS/Private/CAS_ShaderCS.usf"), TEXT("mainCS"), SF_Compute)
+
+#define FX_CAS_IMPLEMENT_CS_QUALITIES(Api, FP16, SharpenOnly, FixedRatio) \
+	FX_CAS_IMPLEMENT_CS(Api, FP16, SharpenOnly, FixedRatio, 0); \
+	FX_CAS_IMPLEMENT_CS(Api, FP16, SharpenOnly, FixedRatio, 1); \
+	FX_CAS_IMPLEMENT_CS(Api, FP16, SharpenOnly, FixedRatio, 2); \
+	FX_CAS_IMPLEMENT_CS(Api, FP16, SharpenOnly, FixedRatio, 3)
+
+// Sharpen only, then scale with the generic, the fixed ratio and the prefiltered downscale permutations
+#define FX_CAS_IMPLEMENT_CS_ALL(Api, FP16) \
+	FX_CAS_IMPLEMENT_CS_QUALITIES(Api, FP16, 1, 0); \
+	FX_CAS_IMPLEMENT_CS_QUALITIES(Api, FP16, 0, 0); \
+	FX_CAS_IMPLEMENT_CS_QUALITIES(Api, FP16, 0, 1); \
+	FX_CAS_IMPLEMENT_CS_QUALITIES(Api, FP16, 0, 2); \
+	FX_CAS_IMPLEMENT_CS_QUALITIES(Api, FP16, 0, 3); \
+	FX_CAS_IMPLEMENT_CS_QUALITIES(Api, FP16, 0, 4)
+
 //-------------------------------------------------------------------------------------------------
 // RHI Version
 //-------------------------------------------------------------------------------------------------
@@ -13,11 +33,9 @@
 IMPLEMENT_TYPE_LAYOUT(FFidelityFXCASShaderCS_RHI);
 #endif	// UE v4.25
 
-IMPLEMENT_SHADER_TYPE(template<> FIDELITYFXCAS_API, TFidelityFXCASShaderCS_RHI_FP32_Upscale,     TEXT("/Plugin/FidelityFXCAS/Private/CAS_ShaderCS.usf"), TEXT("mainCS"), SF_Compute);
-IMPLEMENT_SHADER_TYPE(template<> FIDELITYFXCAS_API, TFidelityFXCASShaderCS_RHI_FP32_SharpenOnly, TEXT("/Plugin/FidelityFXCAS/Private/CAS_ShaderCS.usf"), TEXT("mainCS"), SF_Compute);
+FX_CAS_IMPLEMENT_CS_ALL(RHI, 0);
 #if FX_CAS_FP16_ENABLED
-IMPLEMENT_SHADER_TYPE(template<> FIDELITYFXCAS_API, TFidelityFXCASShaderCS_RHI_FP16_Upscale,     TEXT("/Plugin/FidelityFXCAS/Private/CAS_ShaderCS.usf"), TEXT("mainCS"), SF_Compute);
-IMPLEMENT_SHADER_TYPE(template<> FIDELITYFXCAS_API, TFidelityFXCASShaderCS_RHI_FP16_SharpenOnly, TEXT("/Plugin/FidelityFXCAS/Private/CAS_ShaderCS.usf"), TEXT("mainCS"), SF_Compute);
+FX_CAS_IMPLEMENT_CS_ALL(RHI, 1);
 #endif // FX_CAS_FP16_ENABLED
 
 bool FFidelityFXCASShaderCS_RHI::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
@@ -32,23 +50,381 @@ void FFidelityFXCASShaderCS_RHI::ModifyCompilationEnvironment(const FGlobalShade
 	OutEnvironment.SetDefine(TEXT("WIDTH"), 64);
 	OutEnvironment.SetDefine(TEXT("HEIGHT"), 1);
 	OutEnvironment.SetDefine(TEXT("DEPTH"),  1);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_ARRAY"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_LUMA"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_TILE_LIST"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_BILINEAR"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_SHARPNESS_MASK"), 0);
 }
 
-template<bool FP16, bool SHARPEN_ONLY>
-bool TFidelityFXCASShaderCS_RHI<FP16, SHARPEN_ONLY>::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+template<bool FP16, bool SHARPEN_ONLY, int32 FIXED_RATIO, int32 QUALITY>
+bool TFidelityFXCASShaderCS_RHI<FP16, SHARPEN_ONLY, FIXED_RATIO, QUALITY>::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 {
+	// Never dispatched, see GetFidelityFXCASShaderQuality()
+	if (static_cast<EFidelityFXCASQuality>(QUALITY) != GetFidelityFXCASShaderQuality<FP16>(static_cast<EFidelityFXCASQuality>(QUALITY)))
+		return false;
+
 	return FFidelityFXCASShaderCompilationRules::ShouldCompilePermutationCS<FP16>(Parameters);
 }
 
-template<bool FP16, bool SHARPEN_ONLY>
-void TFidelityFXCASShaderCS_RHI<FP16, SHARPEN_ONLY>::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+template<bool FP16, bool SHARPEN_ONLY, int32 FIXED_RATIO, int32 QUALITY>
+void TFidelityFXCASShaderCS_RHI<FP16, SHARPEN_ONLY, FIXED_RATIO, QUALITY>::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
 {
 	FFidelityFXCASShaderCS_RHI::ModifyCompilationEnvironment(Parameters, OutEnvironment);
 	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_FP16"), FP16 ? 1 : 0);
 	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_SHARPEN_ONLY"), SHARPEN_ONLY ? 1 : 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_FIXED_RATIO"), FIXED_RATIO != static_cast<int32>(EFidelityFXCASFixedRatio::DownscalePrefiltered) ? FIXED_RATIO : 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_PREFILTER"), FIXED_RATIO == static_cast<int32>(EFidelityFXCASFixedRatio::DownscalePrefiltered) ? 1 : 0);
+	// ffx_cas.ush tests the quality defines with #ifdef, so they are only set when enabled
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::Medium))
+		OutEnvironment.SetDefine(TEXT("CAS_BETTER_DIAGONALS"), 1);
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::High))
+		OutEnvironment.SetDefine(TEXT("CAS_SLOW"), 1);
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::Ultra))
+		OutEnvironment.SetDefine(TEXT("CAS_GO_SLOWER"), 1);
+}
+
+//-------------------------------------------------------------------------------------------------
+// RHI Version, texture array and volume inputs
+//-------------------------------------------------------------------------------------------------
+
+#define FX_CAS_IMPLEMENT_ARRAY_CS(FP16, SharpenOnly, Volume, Quality) \
+	typedef TFidelityFXCASShaderArrayCS_RHI<FP16, SharpenOnly, Volume, Quality> TFidelityFXCASShaderArrayCS_RHI_##FP16##SharpenOnly##Volume##Quality; \
+	IMPLEMENT_SHADER_TYPE(template<> FIDELITYFXCAS_API, TFidelityFXCASShaderArrayCS_RHI_##FP16##SharpenOnly##Volume##Quality, TEXT("/Plugin/FidelityFXCAS/Private/CAS_ShaderCS.usf"), TEXT("mainCS"), SF_Compute)
+
+#define FX_CAS_IMPLEMENT_ARRAY_CS_QUALITIES(FP16, SharpenOnly, Volume) \
+	FX_CAS_IMPLEMENT_ARRAY_CS(FP16, SharpenOnly, Volume, 0); \
+	FX_CAS_IMPLEMENT_ARRAY_CS(FP16, SharpenOnly, Volume, 1); \
+	FX_CAS_IMPLEMENT_ARRAY_CS(FP16, SharpenOnly, Volume, 2); \
+	FX_CAS_IMPLEMENT_ARRAY_CS(FP16, SharpenOnly, Volume, 3)
+
+#define FX_CAS_IMPLEMENT_ARRAY_CS_ALL(FP16) \
+	FX_CAS_IMPLEMENT_ARRAY_CS_QUALITIES(FP16, 1, 0); \
+	FX_CAS_IMPLEMENT_ARRAY_CS_QUALITIES(FP16, 0, 0); \
+	FX_CAS_IMPLEMENT_ARRAY_CS_QUALITIES(FP16, 1, 1); \
+	FX_CAS_IMPLEMENT_ARRAY_CS_QUALITIES(FP16, 0, 1)
+
+#if !UE_VERSION_OLDER_THAN(4, 25, 0)	// UE v4.25
+IMPLEMENT_TYPE_LAYOUT(FFidelityFXCASShaderArrayCS_RHI);
+#endif	// UE v4.25
+
+FX_CAS_IMPLEMENT_ARRAY_CS_ALL(0);
+#if FX_CAS_FP16_ENABLED
+FX_CAS_IMPLEMENT_ARRAY_CS_ALL(1);
+#endif // FX_CAS_FP16_ENABLED
+
+bool FFidelityFXCASShaderArrayCS_RHI::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+{
+	return FFidelityFXCASShaderCompilationRules::ShouldCompilePermutation(Parameters);
+}
+
+void FFidelityFXCASShaderArrayCS_RHI::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+{
+	FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	OutEnvironment.SetDefine(TEXT("PLATFORM_PS4"), Parameters.Platform == EShaderPlatform::SP_PS4 ? 1 : 0);
+	OutEnvironment.SetDefine(TEXT("WIDTH"), 64);
+	OutEnvironment.SetDefine(TEXT("HEIGHT"), 1);
+	OutEnvironment.SetDefine(TEXT("DEPTH"), 1);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_LUMA"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_TILE_LIST"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_BILINEAR"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_SHARPNESS_MASK"), 0);
+}
+
+template<bool FP16, bool SHARPEN_ONLY, bool VOLUME, int32 QUALITY>
+bool TFidelityFXCASShaderArrayCS_RHI<FP16, SHARPEN_ONLY, VOLUME, QUALITY>::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+{
+	// Never dispatched, see GetFidelityFXCASShaderQuality()
+	if (static_cast<EFidelityFXCASQuality>(QUALITY) != GetFidelityFXCASShaderQuality<FP16>(static_cast<EFidelityFXCASQuality>(QUALITY)))
+		return false;
+
+	return FFidelityFXCASShaderCompilationRules::ShouldCompilePermutationCS<FP16>(Parameters);
+}
+
+template<bool FP16, bool SHARPEN_ONLY, bool VOLUME, int32 QUALITY>
+void TFidelityFXCASShaderArrayCS_RHI<FP16, SHARPEN_ONLY, VOLUME, QUALITY>::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+{
+	FFidelityFXCASShaderArrayCS_RHI::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_FP16"), FP16 ? 1 : 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_SHARPEN_ONLY"), SHARPEN_ONLY ? 1 : 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_FIXED_RATIO"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_PREFILTER"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_ARRAY"), VOLUME ? 2 : 1);
+	// ffx_cas.ush tests the quality defines with #ifdef, so they are only set when enabled
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::Medium))
+		OutEnvironment.SetDefine(TEXT("CAS_BETTER_DIAGONALS"), 1);
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::High))
+		OutEnvironment.SetDefine(TEXT("CAS_SLOW"), 1);
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::Ultra))
+		OutEnvironment.SetDefine(TEXT("CAS_GO_SLOWER"), 1);
+}
+
+//-------------------------------------------------------------------------------------------------
+// RHI Version, luma plane of planar YUV frames
+//-------------------------------------------------------------------------------------------------
+
+#define FX_CAS_IMPLEMENT_LUMA_CS(FP16, SharpenOnly, Prefilter, Quality) \
+	typedef TFidelityFXCASShaderLumaCS_RHI<FP16, SharpenOnly, Prefilter, Quality> TFidelityFXCASShaderLumaCS_RHI_##FP16##SharpenOnly##Prefilter##Quality; \
+	IMPLEMENT_SHADER_TYPE(template<> FIDELITYFXCAS_API, TFidelityFXCASShaderLumaCS_RHI_##FP16##SharpenOnly##Prefilter##Quality, TEXT("/Plugin/FidelityFXCAS/Private/CAS_ShaderCS.usf"), TEXT("mainCS"), SF_Compute)
+
+// No High quality permutations, see GetFidelityFXCASLumaShaderQuality()
+#define FX_CAS_IMPLEMENT_LUMA_CS_QUALITIES(FP16, SharpenOnly, Prefilter) \
+	FX_CAS_IMPLEMENT_LUMA_CS(FP16, SharpenOnly, Prefilter, 0); \
+	FX_CAS_IMPLEMENT_LUMA_CS(FP16, SharpenOnly, Prefilter, 1); \
+	FX_CAS_IMPLEMENT_LUMA_CS(FP16, SharpenOnly, Prefilter, 3)
+
+#define FX_CAS_IMPLEMENT_LUMA_CS_ALL(FP16) \
+	FX_CAS_IMPLEMENT_LUMA_CS_QUALITIES(FP16, 1, 0); \
+	FX_CAS_IMPLEMENT_LUMA_CS_QUALITIES(FP16, 0, 0); \
+	FX_CAS_IMPLEMENT_LUMA_CS_QUALITIES(FP16, 0, 1)
+
+#if !UE_VERSION_OLDER_THAN(4, 25, 0)	// UE v4.25
+IMPLEMENT_TYPE_LAYOUT(FFidelityFXCASShaderLumaCS_RHI);
+#endif	// UE v4.25
+
+FX_CAS_IMPLEMENT_LUMA_CS_ALL(0);
+#if FX_CAS_FP16_ENABLED
+FX_CAS_IMPLEMENT_LUMA_CS_ALL(1);
+#endif // FX_CAS_FP16_ENABLED
+
+bool FFidelityFXCASShaderLumaCS_RHI::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+{
+	return FFidelityFXCASShaderCompilationRules::ShouldCompilePermutation(Parameters);
+}
+
+void FFidelityFXCASShaderLumaCS_RHI::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+{
+	FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	OutEnvironment.SetDefine(TEXT("PLATFORM_PS4"), Parameters.Platform == EShaderPlatform::SP_PS4 ? 1 : 0);
+	OutEnvironment.SetDefine(TEXT("WIDTH"), 64);
+	OutEnvironment.SetDefine(TEXT("HEIGHT"), 1);
+	OutEnvironment.SetDefine(TEXT("DEPTH"), 1);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_ARRAY"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_LUMA"), 1);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_FIXED_RATIO"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_TILE_LIST"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_BILINEAR"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_SHARPNESS_MASK"), 0);
+}
+
+template<bool FP16, bool SHARPEN_ONLY, bool PREFILTER, int32 QUALITY>
+bool TFidelityFXCASShaderLumaCS_RHI<FP16, SHARPEN_ONLY, PREFILTER, QUALITY>::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+{
+	// Never dispatched, see GetFidelityFXCASLumaShaderQuality()
+	if (static_cast<EFidelityFXCASQuality>(QUALITY) != GetFidelityFXCASLumaShaderQuality<FP16>(static_cast<EFidelityFXCASQuality>(QUALITY)))
+		return false;
+
+	return FFidelityFXCASShaderCompilationRules::ShouldCompilePermutationCS<FP16>(Parameters);
+}
+
+template<bool FP16, bool SHARPEN_ONLY, bool PREFILTER, int32 QUALITY>
+void TFidelityFXCASShaderLumaCS_RHI<FP16, SHARPEN_ONLY, PREFILTER, QUALITY>::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+{
+	FFidelityFXCASShaderLumaCS_RHI::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_FP16"), FP16 ? 1 : 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_SHARPEN_ONLY"), SHARPEN_ONLY ? 1 : 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_PREFILTER"), PREFILTER ? 1 : 0);
+	// ffx_cas.ush tests the quality defines with #ifdef, so they are only set when enabled
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::Medium))
+		OutEnvironment.SetDefine(TEXT("CAS_BETTER_DIAGONALS"), 1);
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::High))
+		OutEnvironment.SetDefine(TEXT("CAS_SLOW"), 1);
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::Ultra))
+		OutEnvironment.SetDefine(TEXT("CAS_GO_SLOWER"), 1);
+}
+
+//-------------------------------------------------------------------------------------------------
+// RHI Version, foveated tile lists
+//-------------------------------------------------------------------------------------------------
+
+#define FX_CAS_IMPLEMENT_FOVEATED_CS(FP16, SharpenOnly, Bilinear, Quality) \
+	typedef TFidelityFXCASShaderFoveatedCS_RHI<FP16, SharpenOnly, Bilinear, Quality> TFidelityFXCASShaderFoveatedCS_RHI_##FP16##SharpenOnly##Bilinear##Quality; \
+	IMPLEMENT_SHADER_TYPE(template<> FIDELITYFXCAS_API, TFidelityFXCASShaderFoveatedCS_RHI_##FP16##SharpenOnly##Bilinear##Quality, TEXT("/Plugin/FidelityFXCAS/Private/CAS_ShaderCS.usf"), TEXT("mainCS"), SF_Compute)
+
+#define FX_CAS_IMPLEMENT_FOVEATED_CS_QUALITIES(FP16, SharpenOnly) \
+	FX_CAS_IMPLEMENT_FOVEATED_CS(FP16, SharpenOnly, 0, 0); \
+	FX_CAS_IMPLEMENT_FOVEATED_CS(FP16, SharpenOnly, 0, 1); \
+	FX_CAS_IMPLEMENT_FOVEATED_CS(FP16, SharpenOnly, 0, 2); \
+	FX_CAS_IMPLEMENT_FOVEATED_CS(FP16, SharpenOnly, 0, 3)
+
+#if !UE_VERSION_OLDER_THAN(4, 25, 0)	// UE v4.25
+IMPLEMENT_TYPE_LAYOUT(FFidelityFXCASShaderFoveatedCS_RHI);
+#endif	// UE v4.25
+
+FX_CAS_IMPLEMENT_FOVEATED_CS_QUALITIES(0, 1);
+FX_CAS_IMPLEMENT_FOVEATED_CS_QUALITIES(0, 0);
+#if FX_CAS_FP16_ENABLED
+FX_CAS_IMPLEMENT_FOVEATED_CS_QUALITIES(1, 1);
+FX_CAS_IMPLEMENT_FOVEATED_CS_QUALITIES(1, 0);
+#endif // FX_CAS_FP16_ENABLED
+// The bilinear periphery is a copy when sharpening only, one full precision permutation covers both
+FX_CAS_IMPLEMENT_FOVEATED_CS(0, 0, 1, 0);
+
+bool FFidelityFXCASShaderFoveatedCS_RHI::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+{
+	return FFidelityFXCASShaderCompilationRules::ShouldCompilePermutation(Parameters);
+}
+
+void FFidelityFXCASShaderFoveatedCS_RHI::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+{
+	FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	OutEnvironment.SetDefine(TEXT("PLATFORM_PS4"), Parameters.Platform == EShaderPlatform::SP_PS4 ? 1 : 0);
+	OutEnvironment.SetDefine(TEXT("WIDTH"), 64);
+	OutEnvironment.SetDefine(TEXT("HEIGHT"), 1);
+	OutEnvironment.SetDefine(TEXT("DEPTH"), 1);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_ARRAY"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_LUMA"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_FIXED_RATIO"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_PREFILTER"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_TILE_LIST"), 1);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_SHARPNESS_MASK"), 0);
+}
+
+template<bool FP16, bool SHARPEN_ONLY, bool BILINEAR, int32 QUALITY>
+bool TFidelityFXCASShaderFoveatedCS_RHI<FP16, SHARPEN_ONLY, BILINEAR, QUALITY>::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+{
+	// Never dispatched, see GetFidelityFXCASShaderQuality()
+	if (static_cast<EFidelityFXCASQuality>(QUALITY) != GetFidelityFXCASShaderQuality<FP16>(static_cast<EFidelityFXCASQuality>(QUALITY)))
+		return false;
+
+	return FFidelityFXCASShaderCompilationRules::ShouldCompilePermutationCS<FP16>(Parameters);
+}
+
+template<bool FP16, bool SHARPEN_ONLY, bool BILINEAR, int32 QUALITY>
+void TFidelityFXCASShaderFoveatedCS_RHI<FP16, SHARPEN_ONLY, BILINEAR, QUALITY>::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+{
+	FFidelityFXCASShaderFoveatedCS_RHI::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_FP16"), FP16 ? 1 : 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_SHARPEN_ONLY"), SHARPEN_ONLY ? 1 : 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_BILINEAR"), BILINEAR ? 1 : 0);
+	// ffx_cas.ush tests the quality defines with #ifdef, so they are only set when enabled
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::Medium))
+		OutEnvironment.SetDefine(TEXT("CAS_BETTER_DIAGONALS"), 1);
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::High))
+		OutEnvironment.SetDefine(TEXT("CAS_SLOW"), 1);
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::Ultra))
+		OutEnvironment.SetDefine(TEXT("CAS_GO_SLOWER"), 1);
 }
 
-#if FX_CAS_CUSTOM_UPSCALE_CALLBACK
+//-------------------------------------------------------------------------------------------------
+// RHI Version, per pixel sharpness mask
+//-------------------------------------------------------------------------------------------------
+
+#define FX_CAS_IMPLEMENT_MASKED_CS(FP16, SharpenOnly, Quality) \
+	typedef TFidelityFXCASShaderMaskedCS_RHI<FP16, SharpenOnly, Quality> TFidelityFXCASShaderMaskedCS_RHI_##FP16##SharpenOnly##Quality; \
+	IMPLEMENT_SHADER_TYPE(template<> FIDELITYFXCAS_API, TFidelityFXCASShaderMaskedCS_RHI_##FP16##SharpenOnly##Quality, TEXT("/Plugin/FidelityFXCAS/Private/CAS_ShaderCS.usf"), TEXT("mainCS"), SF_Compute)
+
+#define FX_CAS_IMPLEMENT_MASKED_CS_QUALITIES(FP16, SharpenOnly) \
+	FX_CAS_IMPLEMENT_MASKED_CS(FP16, SharpenOnly, 0); \
+	FX_CAS_IMPLEMENT_MASKED_CS(FP16, SharpenOnly, 1); \
+	FX_CAS_IMPLEMENT_MASKED_CS(FP16, SharpenOnly, 2); \
+	FX_CAS_IMPLEMENT_MASKED_CS(FP16, SharpenOnly, 3)
+
+#if !UE_VERSION_OLDER_THAN(4, 25, 0)	// UE v4.25
+IMPLEMENT_TYPE_LAYOUT(FFidelityFXCASShaderMaskedCS_RHI);
+#endif	// UE v4.25
+
+FX_CAS_IMPLEMENT_MASKED_CS_QUALITIES(0, 1);
+FX_CAS_IMPLEMENT_MASKED_CS_QUALITIES(0, 0);
+#if FX_CAS_FP16_ENABLED
+FX_CAS_IMPLEMENT_MASKED_CS_QUALITIES(1, 1);
+FX_CAS_IMPLEMENT_MASKED_CS_QUALITIES(1, 0);
+#endif // FX_CAS_FP16_ENABLED
+
+bool FFidelityFXCASShaderMaskedCS_RHI::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+{
+	return FFidelityFXCASShaderCompilationRules::ShouldCompilePermutation(Parameters);
+}
+
+void FFidelityFXCASShaderMaskedCS_RHI::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+{
+	FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	OutEnvironment.SetDefine(TEXT("PLATFORM_PS4"), Parameters.Platform == EShaderPlatform::SP_PS4 ? 1 : 0);
+	OutEnvironment.SetDefine(TEXT("WIDTH"), 64);
+	OutEnvironment.SetDefine(TEXT("HEIGHT"), 1);
+	OutEnvironment.SetDefine(TEXT("DEPTH"), 1);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_ARRAY"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_LUMA"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_FIXED_RATIO"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_PREFILTER"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_TILE_LIST"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_BILINEAR"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_SHARPNESS_MASK"), 1);
+}
+
+template<bool FP16, bool SHARPEN_ONLY, int32 QUALITY>
+bool TFidelityFXCASShaderMaskedCS_RHI<FP16, SHARPEN_ONLY, QUALITY>::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+{
+	// Never dispatched, see GetFidelityFXCASShaderQuality()
+	if (static_cast<EFidelityFXCASQuality>(QUALITY) != GetFidelityFXCASShaderQuality<FP16>(static_cast<EFidelityFXCASQuality>(QUALITY)))
+		return false;
+
+	return FFidelityFXCASShaderCompilationRules::ShouldCompilePermutationCS<FP16>(Parameters);
+}
+
+template<bool FP16, bool SHARPEN_ONLY, int32 QUALITY>
+void TFidelityFXCASShaderMaskedCS_RHI<FP16, SHARPEN_ONLY, QUALITY>::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+{
+	FFidelityFXCASShaderMaskedCS_RHI::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_FP16"), FP16 ? 1 : 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_SHARPEN_ONLY"), SHARPEN_ONLY ? 1 : 0);
+	// ffx_cas.ush tests the quality defines with #ifdef, so they are only set when enabled
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::Medium))
+		OutEnvironment.SetDefine(TEXT("CAS_BETTER_DIAGONALS"), 1);
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::High))
+		OutEnvironment.SetDefine(TEXT("CAS_SLOW"), 1);
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::Ultra))
+		OutEnvironment.SetDefine(TEXT("CAS_GO_SLOWER"), 1);
+}
+
+//-------------------------------------------------------------------------------------------------
+// RHI Version, sharpened mip chain
+//-------------------------------------------------------------------------------------------------
+
+#define FX_CAS_IMPLEMENT_MIP_CHAIN_CS(Quality) \
+	IMPLEMENT_SHADER_TYPE(template<> FIDELITYFXCAS_API, TFidelityFXCASShaderMipChainCS_RHI<Quality>, TEXT("/Plugin/FidelityFXCAS/Private/CAS_MipChainCS.usf"), TEXT("mainCS"), SF_Compute)
+
+#if !UE_VERSION_OLDER_THAN(4, 25, 0)	// UE v4.25
+IMPLEMENT_TYPE_LAYOUT(FFidelityFXCASShaderMipChainCS_RHI);
+#endif	// UE v4.25
+
+FX_CAS_IMPLEMENT_MIP_CHAIN_CS(0);
+FX_CAS_IMPLEMENT_MIP_CHAIN_CS(1);
+FX_CAS_IMPLEMENT_MIP_CHAIN_CS(2);
+FX_CAS_IMPLEMENT_MIP_CHAIN_CS(3);
+
+bool FFidelityFXCASShaderMipChainCS_RHI::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+{
+	return FFidelityFXCASShaderCompilationRules::ShouldCompilePermutation(Parameters);
+}
+
+void FFidelityFXCASShaderMipChainCS_RHI::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+{
+	FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	OutEnvironment.SetDefine(TEXT("PLATFORM_PS4"), Parameters.Platform == EShaderPlatform::SP_PS4 ? 1 : 0);
+	OutEnvironment.SetDefine(TEXT("CAS_MAX_MIP_LEVELS"), FX_CAS_MAX_MIP_LEVELS);
+}
+
+template<int32 QUALITY>
+bool TFidelityFXCASShaderMipChainCS_RHI<QUALITY>::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+{
+	return FFidelityFXCASShaderCompilationRules::ShouldCompilePermutationCS<false>(Parameters);
+}
+
+template<int32 QUALITY>
+void TFidelityFXCASShaderMipChainCS_RHI<QUALITY>::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+{
+	FFidelityFXCASShaderMipChainCS_RHI::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+	// ffx_cas.ush tests the quality defines with #ifdef, so they are only set when enabled
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::Medium))
+		OutEnvironment.SetDefine(TEXT("CAS_BETTER_DIAGONALS"), 1);
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::High))
+		OutEnvironment.SetDefine(TEXT("CAS_SLOW"), 1);
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::Ultra))
+		OutEnvironment.SetDefine(TEXT("CAS_GO_SLOWER"), 1);
+}
+
+#if FX_CAS_CUSTOM_UPSCALE_CALLBACK || FX_CAS_VIEW_EXTENSION
 //-------------------------------------------------------------------------------------------------
 // RDG Version
 //-------------------------------------------------------------------------------------------------
@@ -57,11 +433,9 @@ void TFidelityFXCASShaderCS_RHI<FP16, SHARPEN_ONLY>::ModifyCompilationEnvironmen
 IMPLEMENT_TYPE_LAYOUT(FFidelityFXCASShaderCS_RDG);
 #endif	// UE v4.25
 
-IMPLEMENT_SHADER_TYPE(template<> FIDELITYFXCAS_API, TFidelityFXCASShaderCS_RDG_FP32_Upscale,     TEXT("/Plugin/FidelityFXCAS/Private/CAS_ShaderCS.usf"), TEXT("mainCS"), SF_Compute);
-IMPLEMENT_SHADER_TYPE(template<> FIDELITYFXCAS_API, TFidelityFXCASShaderCS_RDG_FP32_SharpenOnly, TEXT("/Plugin/FidelityFXCAS/Private/CAS_ShaderCS.usf"), TEXT("mainCS"), SF_Compute);
+FX_CAS_IMPLEMENT_CS_ALL(RDG, 0);
 #if FX_CAS_FP16_ENABLED
-IMPLEMENT_SHADER_TYPE(template<> FIDELITYFXCAS_API, TFidelityFXCASShaderCS_RDG_FP16_Upscale,     TEXT("/Plugin/FidelityFXCAS/Private/CAS_ShaderCS.usf"), TEXT("mainCS"), SF_Compute);
-IMPLEMENT_SHADER_TYPE(template<> FIDELITYFXCAS_API, TFidelityFXCASShaderCS_RDG_FP16_SharpenOnly, TEXT("/Plugin/FidelityFXCAS/Private/CAS_ShaderCS.usf"), TEXT("mainCS"), SF_Compute);
+FX_CAS_IMPLEMENT_CS_ALL(RDG, 1);
 #endif // FX_CAS_FP16_ENABLED
 
 bool FFidelityFXCASShaderCS_RDG::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
@@ -76,21 +450,39 @@ void FFidelityFXCASShaderCS_RDG::ModifyCompilationEnvironment(const FGlobalShade
 	OutEnvironment.SetDefine(TEXT("WIDTH"), 64);
 	OutEnvironment.SetDefine(TEXT("HEIGHT"), 1);
 	OutEnvironment.SetDefine(TEXT("DEPTH"), 1);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_ARRAY"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_LUMA"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_TILE_LIST"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_BILINEAR"), 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_SHARPNESS_MASK"), 0);
 }
 
-template<bool FP16, bool SHARPEN_ONLY>
-bool TFidelityFXCASShaderCS_RDG<FP16, SHARPEN_ONLY>::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+template<bool FP16, bool SHARPEN_ONLY, int32 FIXED_RATIO, int32 QUALITY>
+bool TFidelityFXCASShaderCS_RDG<FP16, SHARPEN_ONLY, FIXED_RATIO, QUALITY>::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 {
+	// Never dispatched, see GetFidelityFXCASShaderQuality()
+	if (static_cast<EFidelityFXCASQuality>(QUALITY) != GetFidelityFXCASShaderQuality<FP16>(static_cast<EFidelityFXCASQuality>(QUALITY)))
+		return false;
+
 	return FFidelityFXCASShaderCompilationRules::ShouldCompilePermutationCS<FP16>(Parameters);
 }
 
-template<bool FP16, bool SHARPEN_ONLY>
-void TFidelityFXCASShaderCS_RDG<FP16, SHARPEN_ONLY>::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+template<bool FP16, bool SHARPEN_ONLY, int32 FIXED_RATIO, int32 QUALITY>
+void TFidelityFXCASShaderCS_RDG<FP16, SHARPEN_ONLY, FIXED_RATIO, QUALITY>::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
 {
 	FFidelityFXCASShaderCS_RDG::ModifyCompilationEnvironment(Parameters, OutEnvironment);
 	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_FP16"), FP16 ? 1 : 0);
 	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_SHARPEN_ONLY"), SHARPEN_ONLY ? 1 : 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_FIXED_RATIO"), FIXED_RATIO != static_cast<int32>(EFidelityFXCASFixedRatio::DownscalePrefiltered) ? FIXED_RATIO : 0);
+	OutEnvironment.SetDefine(TEXT("CAS_SAMPLE_PREFILTER"), FIXED_RATIO == static_cast<int32>(EFidelityFXCASFixedRatio::DownscalePrefiltered) ? 1 : 0);
+	// ffx_cas.ush tests the quality defines with #ifdef, so they are only set when enabled
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::Medium))
+		OutEnvironment.SetDefine(TEXT("CAS_BETTER_DIAGONALS"), 1);
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::High))
+		OutEnvironment.SetDefine(TEXT("CAS_SLOW"), 1);
+	if (QUALITY >= static_cast<int32>(EFidelityFXCASQuality::Ultra))
+		OutEnvironment.SetDefine(TEXT("CAS_GO_SLOWER"), 1);
 }
 
-#endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK
+#endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK || FX_CAS_VIEW_EXTENSION
 #endif // FX_CAS_PLUGIN_ENABLED
@@ -5,6 +5,23 @@
 #include "CoreMinimal.h"
 #include "GlobalShader.h"
 #include "ShaderParameterStruct.h"
+#include "FidelityFXCASTypes.h"
+#include "FidelityFXCASPassBackend.h"
+
+// Fixed ratio and quality permutations, see FidelityFXCASPassBackend.h
+template<bool FP16>
+FORCEINLINE EFidelityFXCASQuality GetFidelityFXCASShaderQuality(EFidelityFXCASQuality Quality)
+{
+	return GetFidelityFXCASShaderQuality(Quality, FP16);
+}
+
+// Luma has a single channel, so the per channel weights of High are the luma weights and High runs the Medium shader
+template<bool FP16>
+FORCEINLINE EFidelityFXCASQuality GetFidelityFXCASLumaShaderQuality(EFidelityFXCASQuality Quality)
+{
+	Quality = GetFidelityFXCASShaderQuality<FP16>(Quality);
+	return (Quality == EFidelityFXCASQuality::High) ? EFidelityFXCASQuality::Medium : Quality;
+}
 
 //-------------------------------------------------------------------------------------------------
 // RHI Version
@@ -19,6 +36,11 @@ public:
 	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
 	SHADER_PARAMETER(FUintVector4, const0)
 	SHADER_PARAMETER(FUintVector4, const1)
+	SHADER_PARAMETER(FIntPoint, GroupOffset)
+	SHADER_PARAMETER(FIntPoint, PrefilterSize)
+	SHADER_PARAMETER(FIntPoint, PrefilterInputMax)
+	SHADER_PARAMETER(FIntPoint, TileSourceOffset)
+	SHADER_PARAMETER(FIntPoint, TileOutputOffset)
 	SHADER_PARAMETER_TEXTURE(Texture2D<float4>, InputTexture)
 	SHADER_PARAMETER_UAV(RWTexture2D<float4>, OutputTexture)
 	END_SHADER_PARAMETER_STRUCT()
@@ -27,7 +49,8 @@ public:
 	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
 };
 
-template<bool FP16, bool SHARPEN_ONLY>
+// Permutation dimensions: half precision, sharpen only or upscale, EFidelityFXCASFixedRatio, EFidelityFXCASQuality
+template<bool FP16, bool SHARPEN_ONLY, int32 FIXED_RATIO, int32 QUALITY>
 class TFidelityFXCASShaderCS_RHI : public FFidelityFXCASShaderCS_RHI
 {
 	DECLARE_EXPORTED_SHADER_TYPE(TFidelityFXCASShaderCS_RHI, Global, FIDELITYFXCAS_API);
@@ -39,14 +62,208 @@ public:
 	explicit TFidelityFXCASShaderCS_RHI(const ShaderMetaType::CompiledShaderInitializerType& Initializer) : FFidelityFXCASShaderCS_RHI(Initializer) { }
 };
 
-typedef TFidelityFXCASShaderCS_RHI<0, 0> TFidelityFXCASShaderCS_RHI_FP32_Upscale;
-typedef TFidelityFXCASShaderCS_RHI<0, 1> TFidelityFXCASShaderCS_RHI_FP32_SharpenOnly;
-#if FX_CAS_FP16_ENABLED
-typedef TFidelityFXCASShaderCS_RHI<1, 0> TFidelityFXCASShaderCS_RHI_FP16_Upscale;
-typedef TFidelityFXCASShaderCS_RHI<1, 1> TFidelityFXCASShaderCS_RHI_FP16_SharpenOnly;
-#endif // FX_CAS_FP16_ENABLED
+//-------------------------------------------------------------------------------------------------
+// RHI Version, texture array and volume inputs
+//-------------------------------------------------------------------------------------------------
+
+// Processes every slice of the input in one dispatch, one layer of thread groups per slice (SV_GroupID.z)
+class FFidelityFXCASShaderArrayCS_RHI : public FGlobalShader
+{
+	DECLARE_EXPORTED_SHADER_TYPE(FFidelityFXCASShaderArrayCS_RHI, Global, FIDELITYFXCAS_API);
+public:
+	SHADER_USE_PARAMETER_STRUCT(FFidelityFXCASShaderArrayCS_RHI, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+	SHADER_PARAMETER(FUintVector4, const0)
+	SHADER_PARAMETER(FUintVector4, const1)
+	SHADER_PARAMETER(FIntPoint, GroupOffset)
+	SHADER_PARAMETER_TEXTURE(Texture2DArray<float4>, InputTexture)	// Texture3D<float4> in the VOLUME permutations
+	SHADER_PARAMETER_UAV(RWTexture2DArray<float4>, OutputTexture)
+	END_SHADER_PARAMETER_STRUCT()
 
-#if FX_CAS_CUSTOM_UPSCALE_CALLBACK
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters);
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
+};
+
+// Permutation dimensions: half precision, sharpen only or upscale, Texture3D or Texture2DArray input, EFidelityFXCASQuality.
+// Upscaling uses the generic scale constants, there are no fixed ratio permutations for arrays.
+template<bool FP16, bool SHARPEN_ONLY, bool VOLUME, int32 QUALITY>
+class TFidelityFXCASShaderArrayCS_RHI : public FFidelityFXCASShaderArrayCS_RHI
+{
+	DECLARE_EXPORTED_SHADER_TYPE(TFidelityFXCASShaderArrayCS_RHI, Global, FIDELITYFXCAS_API);
+public:
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters);
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
+
+	TFidelityFXCASShaderArrayCS_RHI() = default;
+	explicit TFidelityFXCASShaderArrayCS_RHI(const ShaderMetaType::CompiledShaderInitializerType& Initializer) : FFidelityFXCASShaderArrayCS_RHI(Initializer) { }
+};
+
+//-------------------------------------------------------------------------------------------------
+// RHI Version, luma plane of planar YUV frames
+//-------------------------------------------------------------------------------------------------
+
+// Single channel load and store (CAS_SAMPLE_LUMA), see FFidelityFXCASModule::ProcessLuma_RenderThread()
+class FFidelityFXCASShaderLumaCS_RHI : public FGlobalShader
+{
+	DECLARE_EXPORTED_SHADER_TYPE(FFidelityFXCASShaderLumaCS_RHI, Global, FIDELITYFXCAS_API);
+public:
+	SHADER_USE_PARAMETER_STRUCT(FFidelityFXCASShaderLumaCS_RHI, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+	SHADER_PARAMETER(FUintVector4, const0)
+	SHADER_PARAMETER(FUintVector4, const1)
+	SHADER_PARAMETER(FIntPoint, GroupOffset)
+	SHADER_PARAMETER(FIntPoint, PrefilterSize)
+	SHADER_PARAMETER(FIntPoint, PrefilterInputMax)
+	SHADER_PARAMETER_TEXTURE(Texture2D<float>, InputTexture)
+	SHADER_PARAMETER_UAV(RWTexture2D<float>, OutputTexture)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters);
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
+};
+
+// Permutation dimensions: half precision, sharpen only or upscale, prefiltered downscale, EFidelityFXCASQuality (see GetFidelityFXCASLumaShaderQuality()).
+// Upscaling uses the generic scale constants, there are no fixed ratio permutations for luma.
+template<bool FP16, bool SHARPEN_ONLY, bool PREFILTER, int32 QUALITY>
+class TFidelityFXCASShaderLumaCS_RHI : public FFidelityFXCASShaderLumaCS_RHI
+{
+	DECLARE_EXPORTED_SHADER_TYPE(TFidelityFXCASShaderLumaCS_RHI, Global, FIDELITYFXCAS_API);
+public:
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters);
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
+
+	TFidelityFXCASShaderLumaCS_RHI() = default;
+	explicit TFidelityFXCASShaderLumaCS_RHI(const ShaderMetaType::CompiledShaderInitializerType& Initializer) : FFidelityFXCASShaderLumaCS_RHI(Initializer) { }
+};
+
+//-------------------------------------------------------------------------------------------------
+// RHI Version, foveated tile lists
+//-------------------------------------------------------------------------------------------------
+
+// One thread group per entry of a tile list (CAS_SAMPLE_TILE_LIST), see FFidelityFXCASModule::RunComputeShaderFoveated_RHI_RenderThread()
+class FFidelityFXCASShaderFoveatedCS_RHI : public FGlobalShader
+{
+	DECLARE_EXPORTED_SHADER_TYPE(FFidelityFXCASShaderFoveatedCS_RHI, Global, FIDELITYFXCAS_API);
+public:
+	SHADER_USE_PARAMETER_STRUCT(FFidelityFXCASShaderFoveatedCS_RHI, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+	SHADER_PARAMETER(FUintVector4, const0)
+	SHADER_PARAMETER(FUintVector4, const1)
+	SHADER_PARAMETER(uint32, TileListOffset)
+	SHADER_PARAMETER(FIntPoint, TileSourceOffset)
+	SHADER_PARAMETER(FIntPoint, TileOutputOffset)
+	SHADER_PARAMETER_SRV(Buffer<uint>, TileList)
+	SHADER_PARAMETER_TEXTURE(Texture2D<float4>, InputTexture)
+	SHADER_PARAMETER_UAV(RWTexture2D<float4>, OutputTexture)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters);
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
+};
+
+// Permutation dimensions: half precision, sharpen only or upscale, bilinear periphery, EFidelityFXCASQuality.
+// The bilinear permutation is full precision and quality 0 only.
+template<bool FP16, bool SHARPEN_ONLY, bool BILINEAR, int32 QUALITY>
+class TFidelityFXCASShaderFoveatedCS_RHI : public FFidelityFXCASShaderFoveatedCS_RHI
+{
+	DECLARE_EXPORTED_SHADER_TYPE(TFidelityFXCASShaderFoveatedCS_RHI, Global, FIDELITYFXCAS_API);
+public:
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters);
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
+
+	TFidelityFXCASShaderFoveatedCS_RHI() = default;
+	explicit TFidelityFXCASShaderFoveatedCS_RHI(const ShaderMetaType::CompiledShaderInitializerType& Initializer) : FFidelityFXCASShaderFoveatedCS_RHI(Initializer) { }
+};
+
+//-------------------------------------------------------------------------------------------------
+// RHI Version, per pixel sharpness mask
+//-------------------------------------------------------------------------------------------------
+
+// The peak of const1 is scaled per pixel by a sharpness mask texture (CAS_SAMPLE_SHARPNESS_MASK), see FFidelityFXCASPassParams_RHI::SharpnessMask
+class FFidelityFXCASShaderMaskedCS_RHI : public FGlobalShader
+{
+	DECLARE_EXPORTED_SHADER_TYPE(FFidelityFXCASShaderMaskedCS_RHI, Global, FIDELITYFXCAS_API);
+public:
+	SHADER_USE_PARAMETER_STRUCT(FFidelityFXCASShaderMaskedCS_RHI, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+	SHADER_PARAMETER(FUintVector4, const0)
+	SHADER_PARAMETER(FUintVector4, const1)
+	SHADER_PARAMETER(FIntPoint, GroupOffset)
+	SHADER_PARAMETER(FIntPoint, TileSourceOffset)
+	SHADER_PARAMETER(FIntPoint, TileOutputOffset)
+	SHADER_PARAMETER(FVector2D, SharpnessMaskUVScale)
+	SHADER_PARAMETER_TEXTURE(Texture2D<float>, SharpnessMask)
+	SHADER_PARAMETER_SAMPLER(SamplerState, SharpnessMaskSampler)
+	SHADER_PARAMETER_TEXTURE(Texture2D<float4>, InputTexture)
+	SHADER_PARAMETER_UAV(RWTexture2D<float4>, OutputTexture)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters);
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
+};
+
+// Permutation dimensions: half precision, sharpen only or upscale, EFidelityFXCASQuality.
+// Upscaling uses the generic scale constants, prefiltered downscales have no masked permutations.
+template<bool FP16, bool SHARPEN_ONLY, int32 QUALITY>
+class TFidelityFXCASShaderMaskedCS_RHI : public FFidelityFXCASShaderMaskedCS_RHI
+{
+	DECLARE_EXPORTED_SHADER_TYPE(TFidelityFXCASShaderMaskedCS_RHI, Global, FIDELITYFXCAS_API);
+public:
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters);
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
+
+	TFidelityFXCASShaderMaskedCS_RHI() = default;
+	explicit TFidelityFXCASShaderMaskedCS_RHI(const ShaderMetaType::CompiledShaderInitializerType& Initializer) : FFidelityFXCASShaderMaskedCS_RHI(Initializer) { }
+};
+
+//-------------------------------------------------------------------------------------------------
+// RHI Version, sharpened mip chain
+//-------------------------------------------------------------------------------------------------
+
+// Levels of the mip chain shader including the source level, enough for 8192x8192
+#define FX_CAS_MAX_MIP_LEVELS 14
+
+// Box downsample and CAS sharpen only for all mip levels in one dispatch (CAS_MipChainCS.usf)
+class FFidelityFXCASShaderMipChainCS_RHI : public FGlobalShader
+{
+	DECLARE_EXPORTED_SHADER_TYPE(FFidelityFXCASShaderMipChainCS_RHI, Global, FIDELITYFXCAS_API);
+public:
+	SHADER_USE_PARAMETER_STRUCT(FFidelityFXCASShaderMipChainCS_RHI, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+	SHADER_PARAMETER(FUintVector4, const0)
+	SHADER_PARAMETER(FUintVector4, const1)
+	SHADER_PARAMETER(uint32, NumLevels)
+	SHADER_PARAMETER_ARRAY(FUintVector4, LevelSizes, [FX_CAS_MAX_MIP_LEVELS])
+	SHADER_PARAMETER_ARRAY(FUintVector4, LevelOffsets, [FX_CAS_MAX_MIP_LEVELS])
+	SHADER_PARAMETER_TEXTURE(Texture2D<float4>, InputTexture)
+	SHADER_PARAMETER_UAV(RWTexture2D<float4>, BoxAtlas)
+	SHADER_PARAMETER_UAV(RWTexture2D<float4>, OutputAtlas)
+	SHADER_PARAMETER_UAV(RWBuffer<uint>, Counters)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters);
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
+};
+
+// Permutation dimension: EFidelityFXCASQuality, full precision only
+template<int32 QUALITY>
+class TFidelityFXCASShaderMipChainCS_RHI : public FFidelityFXCASShaderMipChainCS_RHI
+{
+	DECLARE_EXPORTED_SHADER_TYPE(TFidelityFXCASShaderMipChainCS_RHI, Global, FIDELITYFXCAS_API);
+public:
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters);
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
+
+	TFidelityFXCASShaderMipChainCS_RHI() = default;
+	explicit TFidelityFXCASShaderMipChainCS_RHI(const ShaderMetaType::CompiledShaderInitializerType& Initializer) : FFidelityFXCASShaderMipChainCS_RHI(Initializer) { }
+};
+
+#if FX_CAS_CUSTOM_UPSCALE_CALLBACK || FX_CAS_VIEW_EXTENSION
 //-------------------------------------------------------------------------------------------------
 // RDG Version
 //-------------------------------------------------------------------------------------------------
@@ -60,15 +277,21 @@ public:
 	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
 	SHADER_PARAMETER(FUintVector4, const0)
 	SHADER_PARAMETER(FUintVector4, const1)
+	SHADER_PARAMETER(FIntPoint, GroupOffset)
+	SHADER_PARAMETER(FIntPoint, PrefilterSize)
+	SHADER_PARAMETER(FIntPoint, PrefilterInputMax)
+	SHADER_PARAMETER(FIntPoint, TileSourceOffset)
+	SHADER_PARAMETER(FIntPoint, TileOutputOffset)
 	SHADER_PARAMETER_RDG_TEXTURE(Texture2D<float4>, InputTexture)
-	SHADER_PARAMETER_UAV(RWTexture2D<float4>, OutputTexture)
+	SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, OutputTexture)
 	END_SHADER_PARAMETER_STRUCT()
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters);
 	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
 };
 
-template<bool FP16, bool SHARPEN_ONLY>
+// Permutation dimensions: half precision, sharpen only or upscale, EFidelityFXCASFixedRatio, EFidelityFXCASQuality
+template<bool FP16, bool SHARPEN_ONLY, int32 FIXED_RATIO, int32 QUALITY>
 class TFidelityFXCASShaderCS_RDG : public FFidelityFXCASShaderCS_RDG
 {
 	DECLARE_EXPORTED_SHADER_TYPE(TFidelityFXCASShaderCS_RDG, Global, FIDELITYFXCAS_API);
@@ -80,12 +303,5 @@ public:
 	explicit TFidelityFXCASShaderCS_RDG(const ShaderMetaType::CompiledShaderInitializerType& Initializer) : FFidelityFXCASShaderCS_RDG(Initializer) { }
 };
 
-typedef TFidelityFXCASShaderCS_RDG<0, 0> TFidelityFXCASShaderCS_RDG_FP32_Upscale;
-typedef TFidelityFXCASShaderCS_RDG<0, 1> TFidelityFXCASShaderCS_RDG_FP32_SharpenOnly;
-#if FX_CAS_FP16_ENABLED
-typedef TFidelityFXCASShaderCS_RDG<1, 0> TFidelityFXCASShaderCS_RDG_FP16_Upscale;
-typedef TFidelityFXCASShaderCS_RDG<1, 1> TFidelityFXCASShaderCS_RDG_FP16_SharpenOnly;
-#endif // FX_CAS_FP16_ENABLED
-
-#endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK
+#endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK || FX_CAS_VIEW_EXTENSION
 #endif // FX_CAS_PLUGIN_ENABLED
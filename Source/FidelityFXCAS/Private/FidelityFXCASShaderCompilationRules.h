@@ -3,6 +3,21 @@
 #if FX_CAS_PLUGIN_ENABLED
 
 #include "GlobalShader.h"
+#include "Misc/EngineVersionComparison.h"
+
+// Shader reference arguments, TShaderMapRef is a pointer wrapper before UE v4.25
+#if UE_VERSION_OLDER_THAN(4, 25, 0)	// UE v4.24
+	#define FXCAS_SHADER_ARG(shader) (*shader)
+	#define FXCAS_GET_PS(shader) GETSAFERHISHADER_PIXEL(*shader)
+	#define FXCAS_GET_VS(shader) GETSAFERHISHADER_VERTEX(*shader)
+#else
+	#define FXCAS_SHADER_ARG(shader) (shader)
+	#define FXCAS_GET_PS(shader) (shader.GetPixelShader())
+	#define FXCAS_GET_VS(shader) (shader.GetVertexShader())
+#endif	// UE v4.24
+
+// RDG schedules passes on the async compute pipe from UE v4.26, older versions run the CAS pass on the graphics pipe
+#define FX_CAS_RDG_ASYNC_COMPUTE !UE_VERSION_OLDER_THAN(4, 26, 0)
 
 class FFidelityFXCASShaderCompilationRules
 {
@@ -24,14 +39,18 @@ public:
 		return true;
 	}
 
+	// FP16 doesn't cook on XboxOne or PS4
+	static bool IsFP16Supported(EShaderPlatform Platform)
+	{
+		return Platform != EShaderPlatform::SP_XBOXONE_D3D12
+			&& Platform != EShaderPlatform::SP_PS4;
+	}
+
 	// Separate rules for compute shaders
 	template <bool FP16>
 	static bool ShouldCompilePermutationCS(const FGlobalShaderPermutationParameters& Parameters)
 	{
-		// FP16 doesn't cook on XboxOne or PS4
-		if (FP16 &&
-			(Parameters.Platform == EShaderPlatform::SP_XBOXONE_D3D12
-			|| Parameters.Platform == EShaderPlatform::SP_PS4))
+		if (FP16 && !IsFP16Supported(Parameters.Platform))
 			return false;
 
 		// Default rules
@@ -49,7 +49,7 @@ public:
 	SHADER_USE_PARAMETER_STRUCT(FFidelityFXCASShaderPS_RDG, FGlobalShader);
 
 	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
-	SHADER_PARAMETER_TEXTURE(Texture2D<float4>, UpscaledTexture)
+	SHADER_PARAMETER_RDG_TEXTURE(Texture2D<float4>, UpscaledTexture)
 	SHADER_PARAMETER_SAMPLER(SamplerState, samLinearClamp)
 	RENDER_TARGET_BINDING_SLOTS()
 	END_SHADER_PARAMETER_STRUCT()
@@ -0,0 +1,101 @@
+#include "FidelityFXCAS.h"
+#include "FidelityFXCASPassParams.h"
+#include "FidelityFXCASPassBackend.h"
+#include "FidelityFXCASShaderCS.h"
+#include "FidelityFXCASIncludes.h"
+
+#include "Engine/Texture.h"
+#include "RenderGraphUtils.h"
+#include "RenderingThread.h"
+
+void FFidelityFXCASModule::SetSSCASSharpnessMask(UTexture* Mask)
+{
+	const bool bHadSharpnessMask = bHasSSCASSharpnessMask;
+	bHasSSCASSharpnessMask = (Mask != nullptr && Mask->Resource != nullptr);
+#if FX_CAS_PLUGIN_ENABLED
+	// The texture resource is read on the render thread, where its RHI resource is created
+	FTextureResource* MaskResource = bHasSSCASSharpnessMask ? Mask->Resource : nullptr;
+	ENQUEUE_RENDER_COMMAND(FidelityFXCASModule_SetSSCASSharpnessMask)(
+		[this, MaskResource](FRHICommandListImmediate& RHICmdList)
+		{
+			SetSSCASSharpnessMask_RenderThread(MaskResource ? MaskResource->TextureRHI : FTextureRHIRef());
+		});
+
+	// The masked pass runs on the resolved scene color callback, which replaces the view extension while a mask is set
+	if (bHadSharpnessMask != bHasSSCASSharpnessMask)
+		UpdateSSCASEnabled();
+#endif // FX_CAS_PLUGIN_ENABLED
+}
+
+#if FX_CAS_PLUGIN_ENABLED
+template<typename TShader>
+static void DispatchMaskedShader_RHI(FRHICommandListImmediate& RHICmdList, const FFidelityFXCASShaderMaskedCS_RHI::FParameters& PassParameters, const FFidelityFXCASPassParams_RHI& CASPassParams,
+	const TArray<FFidelityFXCASDispatch>& Dispatches)
+{
+	SCOPED_DRAW_EVENTF(RHICmdList, FidelityFXCAS_DispatchMasked, TEXT("CAS CS masked %s %dx%d -> %dx%d"), GetFidelityFXCASQualityName(CASPassParams.Quality),
+		CASPassParams.GetInputSize().X, CASPassParams.GetInputSize().Y, CASPassParams.GetOutputSize().X, CASPassParams.GetOutputSize().Y);
+	TShaderMapRef<TShader> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+
+	// Whole output, or one dispatch per dirty region covering the thread groups it touches
+	FFidelityFXCASShaderMaskedCS_RHI::FParameters RegionParameters = PassParameters;
+	for (const FFidelityFXCASDispatch& Dispatch : Dispatches)
+	{
+		RegionParameters.GroupOffset = Dispatch.GroupOffset;
+		FComputeShaderUtils::Dispatch(RHICmdList, FXCAS_SHADER_ARG(ComputeShader), RegionParameters, Dispatch.GroupCount);
+	}
+}
+
+// Quality permutation, the plan already applied the FP16 fallback from Ultra to High
+template<bool FP16, bool SHARPEN_ONLY>
+static void DispatchMasked_RHI(FRHICommandListImmediate& RHICmdList, const FFidelityFXCASShaderMaskedCS_RHI::FParameters& PassParameters, const FFidelityFXCASPassParams_RHI& CASPassParams,
+	const TArray<FFidelityFXCASDispatch>& Dispatches)
+{
+	switch (Dispatches[0].Permutation.Quality)
+	{
+	case EFidelityFXCASQuality::Medium: DispatchMaskedShader_RHI<TFidelityFXCASShaderMaskedCS_RHI<FP16, SHARPEN_ONLY, 1>>(RHICmdList, PassParameters, CASPassParams, Dispatches); break;
+	case EFidelityFXCASQuality::High:   DispatchMaskedShader_RHI<TFidelityFXCASShaderMaskedCS_RHI<FP16, SHARPEN_ONLY, 2>>(RHICmdList, PassParameters, CASPassParams, Dispatches); break;
+	case EFidelityFXCASQuality::Ultra:  DispatchMaskedShader_RHI<TFidelityFXCASShaderMaskedCS_RHI<FP16, SHARPEN_ONLY, 3>>(RHICmdList, PassParameters, CASPassParams, Dispatches); break;
+	default:                            DispatchMaskedShader_RHI<TFidelityFXCASShaderMaskedCS_RHI<FP16, SHARPEN_ONLY, 0>>(RHICmdList, PassParameters, CASPassParams, Dispatches); break;
+	}
+}
+
+void FFidelityFXCASModule::RunComputeShaderMasked_RHI_RenderThread(FRHICommandListImmediate& RHICmdList, const class FFidelityFXCASPassParams_RHI& CASPassParams,
+	const TArray<FFidelityFXCASDispatch>& Dispatches)
+{
+	check(IsInRenderingThread());
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASModule_RunComputeShaderMasked_RHI); // Used to gather CPU profiling data for the UE4 session frontend
+
+	// Setup shader parameters, the mask is stretched over the whole image (tiles included)
+	FFidelityFXCASShaderMaskedCS_RHI::FParameters PassParameters;
+	PassParameters.InputTexture = CASPassParams.GetInputTexture();
+	PassParameters.GroupOffset = FIntPoint::ZeroValue;
+	PassParameters.TileSourceOffset = CASPassParams.TileSourceOffset;
+	PassParameters.TileOutputOffset = CASPassParams.TileOutputOffset;
+	PassParameters.OutputTexture = CASPassParams.GetUAV();
+	PassParameters.SharpnessMask = CASPassParams.SharpnessMask;
+	PassParameters.SharpnessMaskSampler = TStaticSamplerState<SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp>::GetRHI();
+	PassParameters.SharpnessMaskUVScale = FVector2D(1.0f / CASPassParams.GetOutputSize().X, 1.0f / CASPassParams.GetOutputSize().Y);
+	CasSetup(reinterpret_cast<AU1*>(&PassParameters.const0), reinterpret_cast<AU1*>(&PassParameters.const1),
+		CASPassParams.Sharpness,
+		static_cast<AF1>(CASPassParams.GetInputSize().X), static_cast<AF1>(CASPassParams.GetInputSize().Y),
+		CASPassParams.GetOutputSize().X, CASPassParams.GetOutputSize().Y);
+
+	// Shader version chosen by the plan
+	const FFidelityFXCASPermutation& Permutation = Dispatches[0].Permutation;
+#if FX_CAS_FP16_ENABLED
+	if (Permutation.bFP16)
+	{
+		if (Permutation.bSharpenOnly)
+			DispatchMasked_RHI<true, true>(RHICmdList, PassParameters, CASPassParams, Dispatches);
+		else
+			DispatchMasked_RHI<true, false>(RHICmdList, PassParameters, CASPassParams, Dispatches);
+		return;
+	}
+#endif // FX_CAS_FP16_ENABLED
+	if (Permutation.bSharpenOnly)
+		DispatchMasked_RHI<false, true>(RHICmdList, PassParameters, CASPassParams, Dispatches);
+	else
+		DispatchMasked_RHI<false, false>(RHICmdList, PassParameters, CASPassParams, Dispatches);
+}
+#endif // FX_CAS_PLUGIN_ENABLED
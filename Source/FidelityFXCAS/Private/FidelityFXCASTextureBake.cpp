@@ -0,0 +1,169 @@
+#include "FidelityFXCASTextureBake.h"
+#include "FidelityFXCASTextureBakeSettings.h"
+
+#include "Async/ParallelFor.h"
+#include "Engine/Texture2D.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "UObject/UObjectGlobals.h"
+
+#include "FidelityFXCASCPU.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogFidelityFXCASTextureBake, Log, All);
+
+UFidelityFXCASTextureBakeSettings::UFidelityFXCASTextureBakeSettings(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+}
+
+#if WITH_EDITOR
+// CPU engine view of a texture source, false for the formats it can't read (HDR, 16 bit integer, ...)
+static bool GetFidelityFXCASSourceFormat(const UTexture2D* Texture, EFidelityFXCASPixelFormat& OutFormat, EFidelityFXCASChannelOrder& OutChannelOrder)
+{
+	OutChannelOrder = EFidelityFXCASChannelOrder::RGBA;
+	switch (Texture->Source.GetFormat())
+	{
+	case TSF_BGRA8:
+		OutFormat = Texture->SRGB ? EFidelityFXCASPixelFormat::RGBA8_SRGB : EFidelityFXCASPixelFormat::RGBA8;
+		OutChannelOrder = EFidelityFXCASChannelOrder::BGRA;
+		return true;
+	case TSF_RGBA16F:   OutFormat = EFidelityFXCASPixelFormat::RGBA16F; return true;
+	case TSF_G8:        OutFormat = EFidelityFXCASPixelFormat::R8; return true;
+	default:            return false;
+	}
+}
+
+bool InitFidelityFXCASBakeTexture(UTexture2D* Texture, const UFidelityFXCASTextureBakeSettings* Settings, float DefaultSharpness, FFidelityFXCASBakeTexture& OutBakeTexture)
+{
+	OutBakeTexture.Texture = Texture;
+	if (!GetFidelityFXCASSourceFormat(Texture, OutBakeTexture.Format, OutBakeTexture.ChannelOrder) || Texture->Source.GetNumSlices() != 1)
+	{
+		UE_LOG(LogFidelityFXCASTextureBake, Warning, TEXT("%s: the CPU engine can't read its source (BGRA8, RGBA16F or G8 with a single slice only), not baked."), *Texture->GetName());
+		return false;
+	}
+	OutBakeTexture.Sharpness = Settings ? Settings->Sharpness : DefaultSharpness;
+	OutBakeTexture.bSharpenTopMip = Settings && Settings->bSharpenTopMip;
+
+	const FIntPoint TopMipSize(Texture->Source.GetSizeX(), Texture->Source.GetSizeY());
+	const uint8* TopMipData = Texture->Source.LockMip(0);
+	OutBakeTexture.TopMip.Append(TopMipData, static_cast<int64>(TopMipSize.X) * TopMipSize.Y * GetFidelityFXCASBytesPerPixel(OutBakeTexture.Format));
+	Texture->Source.UnlockMip(0);
+
+	// Full chain down to 1x1, the way the engine generates it
+	const int32 NumMips = FMath::FloorLog2(FMath::Max(TopMipSize.X, TopMipSize.Y)) + 1;
+	const int32 BytesPerPixel = GetFidelityFXCASBytesPerPixel(OutBakeTexture.Format);
+	int64 ChainSize = 0;
+	for (int32 MipIndex = 0; MipIndex < NumMips; ++MipIndex)
+	{
+		const FIntPoint MipSize(FMath::Max(TopMipSize.X >> MipIndex, 1), FMath::Max(TopMipSize.Y >> MipIndex, 1));
+		OutBakeTexture.MipSizes.Add(MipSize);
+		OutBakeTexture.MipOffsets.Add(ChainSize);
+		ChainSize += static_cast<int64>(MipSize.X) * MipSize.Y * BytesPerPixel;
+	}
+	OutBakeTexture.Chain.SetNumUninitialized(ChainSize);
+	return true;
+}
+
+void BakeFidelityFXCASTextures(TArray<FFidelityFXCASBakeTexture>& Batch, FFidelityFXCASBakeStats& Stats)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCAS_BakeTextures); // Used to gather CPU profiling data for the UE4 session frontend
+
+	TArray<FIntPoint> Jobs;	// Texture, mip
+	for (int32 TextureIndex = 0; TextureIndex < Batch.Num(); ++TextureIndex)
+	{
+		for (int32 MipIndex = 0; MipIndex < Batch[TextureIndex].MipSizes.Num(); ++MipIndex)
+			Jobs.Add(FIntPoint(TextureIndex, MipIndex));
+	}
+
+	const FFidelityFXCASCPUModule& CPUModule = FFidelityFXCASCPUModule::Get();
+	const double StartTime = FPlatformTime::Seconds();
+	ParallelFor(Jobs.Num(), [&Batch, &Jobs, &CPUModule](int32 JobIndex)
+	{
+		FFidelityFXCASBakeTexture& BakeTexture = Batch[Jobs[JobIndex].X];
+		const int32 MipIndex = Jobs[JobIndex].Y;
+		const FFidelityFXCASImageView Input = BakeTexture.GetTopMipView();
+		const FFidelityFXCASImageView Output = BakeTexture.GetMipView(MipIndex);
+		if (MipIndex == 0 && !BakeTexture.bSharpenTopMip)
+		{
+			FMemory::Memcpy(Output.Data, Input.Data, BakeTexture.TopMip.Num());
+			return;
+		}
+
+		FFidelityFXCASCPUSettings Settings;
+		Settings.Sharpness = BakeTexture.Sharpness;
+		Settings.bMultithreaded = false;
+		if (!CPUModule.Process(Input, Output, Settings))
+			BakeTexture.bFailed = true;	// Only ever set to true, the race is benign
+	});
+	Stats.BakeSeconds += FPlatformTime::Seconds() - StartTime;
+
+	for (const FFidelityFXCASBakeTexture& BakeTexture : Batch)
+	{
+		if (BakeTexture.bFailed)
+		{
+			UE_LOG(LogFidelityFXCASTextureBake, Error, TEXT("%s: CAS failed, not baked."), *BakeTexture.Texture->GetName());
+			++Stats.NumFailed;
+			continue;
+		}
+		++Stats.NumBaked;
+		Stats.NumMips += BakeTexture.MipSizes.Num();
+		Stats.NumInputPixels += static_cast<int64>(BakeTexture.MipSizes[0].X) * BakeTexture.MipSizes[0].Y;
+		Stats.NumOutputPixels += BakeTexture.Chain.Num() / GetFidelityFXCASBytesPerPixel(BakeTexture.Format);
+	}
+}
+
+void ApplyFidelityFXCASBake(FFidelityFXCASBakeTexture& BakeTexture)
+{
+	UTexture2D* Texture = BakeTexture.Texture;
+	Texture->Source.Init(BakeTexture.MipSizes[0].X, BakeTexture.MipSizes[0].Y, 1, BakeTexture.MipSizes.Num(), Texture->Source.GetFormat(), BakeTexture.Chain.GetData());
+	// The source id follows the baked pixels, so the derived data of a bake is reused until the source or the bake settings change
+	Texture->Source.UseHashAsGuid();
+	Texture->MipGenSettings = TMGS_LeaveExistingMips;
+	Texture->PostEditChange();
+}
+
+static FDelegateHandle GFidelityFXCASCookBakeHandle;
+static FFidelityFXCASBakeStats GFidelityFXCASCookBakeStats;
+
+// The cooker loads a package before it builds the cooked platform data of its textures
+static void OnFidelityFXCASCookAssetLoaded(UObject* Asset)
+{
+	UTexture2D* Texture = Cast<UTexture2D>(Asset);
+	const UFidelityFXCASTextureBakeSettings* Settings = Texture ? Texture->GetAssetUserData<UFidelityFXCASTextureBakeSettings>() : nullptr;
+	if (!Settings)
+		return;
+
+	TArray<FFidelityFXCASBakeTexture> Batch;
+	if (!InitFidelityFXCASBakeTexture(Texture, Settings, Settings->Sharpness, Batch.AddDefaulted_GetRef()))
+	{
+		++GFidelityFXCASCookBakeStats.NumFailed;
+		return;
+	}
+	BakeFidelityFXCASTextures(Batch, GFidelityFXCASCookBakeStats);
+	if (!Batch[0].bFailed)
+	{
+		ApplyFidelityFXCASBake(Batch[0]);
+		UE_LOG(LogFidelityFXCASTextureBake, Display, TEXT("Baked CAS into the mips of %s."), *Texture->GetPathName());
+	}
+}
+
+void StartFidelityFXCASCookBake()
+{
+	// Only the cook commandlet, the editor must never hold a baked source it could save
+	FString Commandlet;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("-run="), Commandlet) || !Commandlet.StartsWith(TEXT("cook"), ESearchCase::IgnoreCase))
+		return;
+	GFidelityFXCASCookBakeHandle = FCoreUObjectDelegates::OnAssetLoaded.AddStatic(&OnFidelityFXCASCookAssetLoaded);
+}
+
+void StopFidelityFXCASCookBake()
+{
+	if (!GFidelityFXCASCookBakeHandle.IsValid())
+		return;
+	FCoreUObjectDelegates::OnAssetLoaded.Remove(GFidelityFXCASCookBakeHandle);
+	GFidelityFXCASCookBakeHandle.Reset();
+	if (GFidelityFXCASCookBakeStats.NumBaked > 0 || GFidelityFXCASCookBakeStats.NumFailed > 0)
+		UE_LOG(LogFidelityFXCASTextureBake, Display, TEXT("Cook-time CAS bake: %s."), *GFidelityFXCASCookBakeStats.ToString());
+}
+#endif // WITH_EDITOR
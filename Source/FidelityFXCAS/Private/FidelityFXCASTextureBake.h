@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FidelityFXCASCPUTypes.h"
+
+#if WITH_EDITOR
+
+class UTexture2D;
+class UFidelityFXCASTextureBakeSettings;
+
+// Texture of a bake batch: its mip 0, the baked chain (all the mips one after the other, as FTextureSource::Init takes them) and its settings
+struct FFidelityFXCASBakeTexture
+{
+	UTexture2D* Texture = nullptr;
+	float Sharpness = 0.5f;
+	bool bSharpenTopMip = false;
+	EFidelityFXCASPixelFormat Format = EFidelityFXCASPixelFormat::RGBA8;
+	EFidelityFXCASChannelOrder ChannelOrder = EFidelityFXCASChannelOrder::RGBA;
+	TArray64<uint8> TopMip;
+	TArray64<uint8> Chain;
+	TArray<FIntPoint> MipSizes;
+	TArray<int64> MipOffsets;
+	bool bFailed = false;
+
+	FFidelityFXCASImageView GetTopMipView()
+	{
+		return FFidelityFXCASImageView(TopMip.GetData(), MipSizes[0].X, MipSizes[0].Y, static_cast<int64>(MipSizes[0].X) * GetFidelityFXCASBytesPerPixel(Format), Format, ChannelOrder);
+	}
+	FFidelityFXCASImageView GetMipView(int32 MipIndex)
+	{
+		const FIntPoint& Size = MipSizes[MipIndex];
+		return FFidelityFXCASImageView(Chain.GetData() + MipOffsets[MipIndex], Size.X, Size.Y, static_cast<int64>(Size.X) * GetFidelityFXCASBytesPerPixel(Format), Format, ChannelOrder);
+	}
+	int64 GetNumBytes() const { return TopMip.Num() + Chain.Num(); }
+};
+
+// Bake counters and CAS time, the throughput the cook budget depends on
+struct FFidelityFXCASBakeStats
+{
+	int32 NumBaked = 0;
+	int32 NumFailed = 0;
+	int32 NumMips = 0;
+	int64 NumInputPixels = 0;
+	int64 NumOutputPixels = 0;
+	double BakeSeconds = 0.0;
+
+	FString ToString() const
+	{
+		return FString::Printf(TEXT("%d texture(s) (%d mips), %d failed, CAS %.2f s (%.1f input Mpix/s, %.1f output Mpix/s)"), NumBaked, NumMips, NumFailed, BakeSeconds,
+			BakeSeconds > 0.0 ? NumInputPixels / BakeSeconds / 1000000.0 : 0.0, BakeSeconds > 0.0 ? NumOutputPixels / BakeSeconds / 1000000.0 : 0.0);
+	}
+};
+
+// Reads mip 0 of the texture source and sizes the chain, false (logged) for the sources the CPU engine can't read.
+// Settings may be null, the texture is then baked with DefaultSharpness.
+bool InitFidelityFXCASBakeTexture(UTexture2D* Texture, const UFidelityFXCASTextureBakeSettings* Settings, float DefaultSharpness, FFidelityFXCASBakeTexture& OutBakeTexture);
+// Every mip is a CAS downscale of mip 0, one single threaded job per mip of every texture of the batch, all in parallel
+void BakeFidelityFXCASTextures(TArray<FFidelityFXCASBakeTexture>& Batch, FFidelityFXCASBakeStats& Stats);
+// Makes the baked chain the in-memory source of its texture (TMGS_LeaveExistingMips) and rebuilds the platform data from it
+void ApplyFidelityFXCASBake(FFidelityFXCASBakeTexture& BakeTexture);
+
+// Cook-time bake, registered by the module in the cook commandlet: the textures with UFidelityFXCASTextureBakeSettings are baked as they are loaded,
+// before the cooker builds their platform data. The source packages are never saved by the cook, the assets on disk are untouched.
+void StartFidelityFXCASCookBake();
+void StopFidelityFXCASCookBake();
+
+#endif // WITH_EDITOR
@@ -0,0 +1,320 @@
+#include "FidelityFXCAS.h"
+#include "FidelityFXCASPassParams.h"
+#include "FidelityFXCASIncludes.h"
+#include "FidelityFXCASCPU.h"
+
+#include "HAL/PlatformProcess.h"
+#include "Misc/App.h"
+#include "RenderTargetPool.h"
+#include "RenderingThread.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogFidelityFXCASTiled, Log, All);
+
+#if FX_CAS_PLUGIN_ENABLED
+// Texture format holding the pixels of a view as they are, PF_Unknown if the shader would need a conversion
+static EPixelFormat GetFidelityFXCASTilePixelFormat(const FFidelityFXCASImageView& View)
+{
+	if (View.ChannelOrder != EFidelityFXCASChannelOrder::RGBA)
+		return PF_Unknown;
+
+	switch (View.Format)
+	{
+	case EFidelityFXCASPixelFormat::RGBA32F: return PF_A32B32G32R32F;
+	case EFidelityFXCASPixelFormat::RGBA16F: return PF_FloatRGBA;
+	case EFidelityFXCASPixelFormat::RGBA8:   return PF_R8G8B8A8;
+	default:                                 return PF_Unknown;
+	}
+}
+
+// Input pixels [OutSourceMin, OutSourceMax) read by the output pixels [OutputMin, OutputMax) on one axis.
+// The CAS window reads floor(X * Scale + Offset) - 1 .. + 2 in CAS input pixels, one more pixel on each side covers the rounding
+// differences of the GPU position math. Prefiltered downscales average PrefilterSize input pixels per CAS input pixel.
+// The range reaches outside of the image at its edges, see GatherTileSource.
+static void GetTileSourceRange(int32 OutputMin, int32 OutputMax, float Scale, float Offset, int32 PrefilterSize,
+	int32& OutSourceMin, int32& OutSourceMax)
+{
+	const int32 Min = FMath::FloorToInt(static_cast<float>(OutputMin) * Scale + Offset) - 2;
+	const int32 Max = FMath::FloorToInt(static_cast<float>(OutputMax - 1) * Scale + Offset) + 3;	// Inclusive
+	OutSourceMin = Min * PrefilterSize;
+	OutSourceMax = (Max + 1) * PrefilterSize;
+}
+
+// Input pixels of SourceRect, the rows and columns outside of the image repeat the edge pixels. The shader loads outside of a
+// texture return 0, so the tiles carry the edge clamp of the CPU engine and both give the same result on the image edges.
+static void GatherTileSource(const FFidelityFXCASImageView& Input, const FIntRect& SourceRect, TArray64<uint8>& OutData)
+{
+	const int64 BytesPerPixel = Input.GetBytesPerPixel();
+	const int64 RowSize = static_cast<int64>(SourceRect.Width()) * BytesPerPixel;
+	// Columns left of the image, inside it and right of it
+	const int32 InsideMinX = FMath::Clamp(0, SourceRect.Min.X, SourceRect.Max.X);
+	const int32 InsideMaxX = FMath::Clamp(Input.Width, SourceRect.Min.X, SourceRect.Max.X);
+	OutData.SetNumUninitialized(RowSize * SourceRect.Height(), false);
+	for (int32 Y = 0; Y < SourceRect.Height(); ++Y)
+	{
+		const uint8* SourceRow = Input.GetRow(FMath::Clamp(SourceRect.Min.Y + Y, 0, Input.Height - 1));
+		uint8* Row = OutData.GetData() + Y * RowSize;
+		for (int32 X = SourceRect.Min.X; X < InsideMinX; ++X, Row += BytesPerPixel)
+			FMemory::Memcpy(Row, SourceRow, BytesPerPixel);
+		FMemory::Memcpy(Row, SourceRow + InsideMinX * BytesPerPixel, (InsideMaxX - InsideMinX) * BytesPerPixel);
+		Row += (InsideMaxX - InsideMinX) * BytesPerPixel;
+		for (int32 X = InsideMaxX; X < SourceRect.Max.X; ++X, Row += BytesPerPixel)
+			FMemory::Memcpy(Row, SourceRow + (Input.Width - 1) * BytesPerPixel, BytesPerPixel);
+	}
+}
+
+// Tiles in flight at most: one uploaded, one on the GPU, one read back
+static const int32 GFXCASTileRingSize = 3;
+#endif // FX_CAS_PLUGIN_ENABLED
+
+bool FFidelityFXCASModule::CanProcessImageTiledOnGPU(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output)
+{
+#if FX_CAS_PLUGIN_ENABLED
+	return FApp::CanEverRender() && GetFidelityFXCASTilePixelFormat(Input) != PF_Unknown && GetFidelityFXCASTilePixelFormat(Output) != PF_Unknown;
+#else
+	return false;
+#endif // FX_CAS_PLUGIN_ENABLED
+}
+
+bool FFidelityFXCASModule::ProcessImageTiled(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, float Sharpness,
+	bool bInUseFP16, EFidelityFXCASQuality Quality, int32 TileSize, float* OutGPUMilliseconds)
+{
+	check(IsInGameThread());
+
+	if (OutGPUMilliseconds)
+		*OutGPUMilliseconds = -1.0f;
+
+	if (!Input.IsValid() || !Output.IsValid() || Input.Overlaps(Output))
+	{
+		UE_LOG(LogFidelityFXCASTiled, Error, TEXT("ProcessImageTiled: invalid or overlapping image views (input %dx%d, output %dx%d)."),
+			Input.Width, Input.Height, Output.Width, Output.Height);
+		return false;
+	}
+
+#if FX_CAS_PLUGIN_ENABLED
+	if (CanProcessImageTiledOnGPU(Input, Output))
+	{
+		const EPixelFormat InputFormat = GetFidelityFXCASTilePixelFormat(Input);
+		const EPixelFormat OutputFormat = GetFidelityFXCASTilePixelFormat(Output);
+		QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASModule_ProcessImageTiled);
+
+		// Tiles start on thread group boundaries
+		TileSize = FMath::Max(Align(TileSize, 16), 16);
+
+		const FIntPoint InputSize = Input.GetSize();
+		const FIntPoint OutputSize = Output.GetSize();
+
+		// Same constants as the dispatch, to find the input pixels every tile reads
+		const FIntPoint PrefilterSize = FFidelityFXCASCPUModule::GetPrefilterSize(InputSize, OutputSize);
+		const FIntPoint CASInputSize = FFidelityFXCASCPUModule::GetPrefilteredSize(InputSize, PrefilterSize);
+		varAU4(Const0);
+		varAU4(Const1);
+		CasSetup(Const0, Const1, Sharpness, static_cast<AF1>(CASInputSize.X), static_cast<AF1>(CASInputSize.Y),
+			static_cast<AF1>(OutputSize.X), static_cast<AF1>(OutputSize.Y));
+		const FVector2D Scale(AF1_AU1(Const0[0]), AF1_AU1(Const0[1]));
+		const FVector2D Offset(AF1_AU1(Const0[2]), AF1_AU1(Const0[3]));
+
+		// Output and source regions of the tiles, the ring textures fit the largest ones
+		struct FTile
+		{
+			FIntRect TileRect;
+			FIntRect SourceRect;
+		};
+		TArray<FTile> Tiles;
+		FIntPoint MaxTileSize = FIntPoint::ZeroValue;
+		FIntPoint MaxSourceSize = FIntPoint::ZeroValue;
+		for (int32 TileY = 0; TileY < OutputSize.Y; TileY += TileSize)
+		{
+			for (int32 TileX = 0; TileX < OutputSize.X; TileX += TileSize)
+			{
+				FTile& Tile = Tiles.AddDefaulted_GetRef();
+				Tile.TileRect = FIntRect(TileX, TileY, FMath::Min(TileX + TileSize, OutputSize.X), FMath::Min(TileY + TileSize, OutputSize.Y));
+				GetTileSourceRange(Tile.TileRect.Min.X, Tile.TileRect.Max.X, Scale.X, Offset.X, PrefilterSize.X, Tile.SourceRect.Min.X, Tile.SourceRect.Max.X);
+				GetTileSourceRange(Tile.TileRect.Min.Y, Tile.TileRect.Max.Y, Scale.Y, Offset.Y, PrefilterSize.Y, Tile.SourceRect.Min.Y, Tile.SourceRect.Max.Y);
+				MaxTileSize = MaxTileSize.ComponentMax(Tile.TileRect.Size());
+				MaxSourceSize = MaxSourceSize.ComponentMax(Tile.SourceRect.Size());
+			}
+		}
+
+		const bool bTimeGPU = OutGPUMilliseconds != nullptr;
+		ENQUEUE_RENDER_COMMAND(FidelityFXCASModule_BeginTiles)(
+			[this, MaxTileSize, MaxSourceSize, InputFormat, OutputFormat, bTimeGPU](FRHICommandListImmediate& RHICmdList)
+			{
+				TileRing.SetNum(GFXCASTileRingSize);
+				TileGPUMicroseconds = 0;
+				bTileGPUTimeValid = bTimeGPU && GSupportsTimestampRenderQueries;
+				for (FTileSlot& Slot : TileRing)
+				{
+					FRHIResourceCreateInfo CreateInfo;
+					Slot.SourceTexture = RHICreateTexture2D(MaxSourceSize.X, MaxSourceSize.Y, InputFormat, 1, 1, TexCreate_ShaderResource, CreateInfo);
+					Slot.StagingTexture = RHICreateTexture2D(MaxTileSize.X, MaxTileSize.Y, OutputFormat, 1, 1, TexCreate_CPUReadback, CreateInfo);
+					Slot.Fence = RHICreateGPUFence(TEXT("FidelityFXCASModule_TileFence"));
+					// The CS output is the render target, nothing is drawn
+					PrepareComputeShaderOutput_RenderThread(RHICmdList, MaxTileSize, Slot.Output, TEXT("FidelityFXCASModule_TileOutput"), 0, OutputFormat);
+					if (bTileGPUTimeValid)
+					{
+						Slot.BeginQuery = RHICreateRenderQuery(RQT_AbsoluteTime);
+						Slot.EndQuery = RHICreateRenderQuery(RQT_AbsoluteTime);
+					}
+				}
+			});
+
+		// Gathered tiles waiting for the render thread, at most a ring of them so the memory stays bounded by the tile size
+		FThreadSafeCounter NumTilesQueued;
+		for (const FTile& Tile : Tiles)
+		{
+			while (NumTilesQueued.GetValue() >= GFXCASTileRingSize)
+				FPlatformProcess::Sleep(0.0f);
+
+			// Views may be bottom-up or have any pitch
+			TArray64<uint8> SourceData;
+			GatherTileSource(Input, Tile.SourceRect, SourceData);
+			NumTilesQueued.Increment();
+
+			ENQUEUE_RENDER_COMMAND(FidelityFXCASModule_ProcessTile)(
+				[this, &NumTilesQueued, SourceData = MoveTemp(SourceData), Tile, Output, InputSize, OutputSize, InputFormat, Sharpness, bInUseFP16, Quality](FRHICommandListImmediate& RHICmdList)
+				{
+					SCOPED_DRAW_EVENT(RHICmdList, FidelityFXCASModule_ProcessTile);
+
+					// Tiles done since the last one free their slots, a full ring waits for the oldest tile
+					PollTiles_RenderThread(RHICmdList, Output);
+					FTileSlot* Slot = TileRing.FindByPredicate([](const FTileSlot& Candidate) { return !Candidate.bInFlight; });
+					if (!Slot)
+					{
+						for (FTileSlot& Candidate : TileRing)
+						{
+							if (!Slot || Candidate.Sequence < Slot->Sequence)
+								Slot = &Candidate;
+						}
+						CompleteTile_RenderThread(RHICmdList, *Slot, Output);
+					}
+
+					const FIntPoint SourceSize = Tile.SourceRect.Size();
+					RHIUpdateTexture2D(Slot->SourceTexture, 0, FUpdateTextureRegion2D(0, 0, 0, 0, SourceSize.X, SourceSize.Y),
+						static_cast<uint32>(SourceSize.X * GPixelFormats[InputFormat].BlockBytes), SourceData.GetData());
+					NumTilesQueued.Decrement();
+
+					const FTextureRHIRef TileTexture = Slot->Output->GetRenderTargetItem().TargetableTexture;
+					FFidelityFXCASPassParams_RHI CASPassParams(Slot->SourceTexture, TileTexture, Slot->Output);
+					CASPassParams.Sharpness = Sharpness;
+					CASPassParams.bUseFP16 = bInUseFP16;
+					CASPassParams.Quality = Quality;
+					CASPassParams.SetTile(InputSize, OutputSize, Tile.SourceRect.Min, Tile.TileRect);
+					// Only the dispatch is timed, the upload above and the copy below are not
+					if (Slot->BeginQuery)
+						RHICmdList.EndRenderQuery(Slot->BeginQuery);
+					RunComputeShader_RHI_RenderThread(RHICmdList, CASPassParams);
+					if (Slot->EndQuery)
+						RHICmdList.EndRenderQuery(Slot->EndQuery);
+
+					// Copy to the staging texture, read back when the fence passed
+					RHICmdList.TransitionResource(EResourceTransitionAccess::EReadable, TileTexture);
+					FRHICopyTextureInfo CopyInfo;
+					CopyInfo.Size = FIntVector(Tile.TileRect.Width(), Tile.TileRect.Height(), 1);
+					RHICmdList.CopyTexture(TileTexture, Slot->StagingTexture, CopyInfo);
+					Slot->Fence->Clear();
+					RHICmdList.WriteGPUFence(Slot->Fence);
+					Slot->TileRect = Tile.TileRect;
+					Slot->bInFlight = true;
+					Slot->Sequence = ++TileSequence;
+
+					// Submit the tile, so the GPU works on it while the next one is gathered
+					RHICmdList.ImmediateFlush(EImmediateFlushType::DispatchToRHIThread);
+				});
+		}
+
+		// Read back the last tiles and release the ring, the next call may use other sizes and formats
+		ENQUEUE_RENDER_COMMAND(FidelityFXCASModule_EndTiles)(
+			[this, Output](FRHICommandListImmediate& RHICmdList)
+			{
+				PollTiles_RenderThread(RHICmdList, Output);
+				for (;;)
+				{
+					FTileSlot* Oldest = nullptr;
+					for (FTileSlot& Slot : TileRing)
+					{
+						if (Slot.bInFlight && (!Oldest || Slot.Sequence < Oldest->Sequence))
+							Oldest = &Slot;
+					}
+					if (!Oldest)
+						break;
+					CompleteTile_RenderThread(RHICmdList, *Oldest, Output);
+				}
+				for (FTileSlot& Slot : TileRing)
+					GRenderTargetPool.FreeUnusedResource(Slot.Output);
+				TileRing.Empty();
+			});
+		// The only wait for the render thread and the GPU of the call
+		FlushRenderingCommands();
+		if (OutGPUMilliseconds && bTileGPUTimeValid)
+			*OutGPUMilliseconds = static_cast<float>(TileGPUMicroseconds) / 1000.0f;
+		return true;
+	}
+	UE_LOG(LogFidelityFXCASTiled, Log, TEXT("ProcessImageTiled: no GPU or pixel formats the shader can't use as they are, running on the CPU."));
+#endif // FX_CAS_PLUGIN_ENABLED
+
+	// The CPU engine streams row bands itself, FP16 and quality only apply to the shaders
+	FFidelityFXCASCPUSettings Settings;
+	Settings.Sharpness = Sharpness;
+	return FFidelityFXCASCPUModule::Get().Process(Input, Output, Settings);
+}
+
+#if FX_CAS_PLUGIN_ENABLED
+void FFidelityFXCASModule::PollTiles_RenderThread(FRHICommandListImmediate& RHICmdList, const FFidelityFXCASImageView& Output)
+{
+	check(IsInRenderingThread());
+
+	// In issue order, the fences are signaled in that order too
+	for (;;)
+	{
+		FTileSlot* Oldest = nullptr;
+		for (FTileSlot& Slot : TileRing)
+		{
+			if (Slot.bInFlight && (!Oldest || Slot.Sequence < Oldest->Sequence))
+				Oldest = &Slot;
+		}
+		if (!Oldest || !Oldest->Fence->Poll())
+			break;
+		CompleteTile_RenderThread(RHICmdList, *Oldest, Output);
+	}
+}
+
+void FFidelityFXCASModule::CompleteTile_RenderThread(FRHICommandListImmediate& RHICmdList, FTileSlot& Slot, const FFidelityFXCASImageView& Output)
+{
+	check(IsInRenderingThread() && Slot.bInFlight);
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASModule_CompleteTile); // Used to gather CPU profiling data for the UE4 session frontend
+
+	// Mapping waits for the copy if the fence hasn't passed yet
+	void* Data = nullptr;
+	int32 MappedWidth = 0;		// Row pitch in pixels
+	int32 MappedHeight = 0;
+	RHICmdList.MapStagingSurface(Slot.StagingTexture, Data, MappedWidth, MappedHeight);
+	if (Data)
+	{
+		const int64 BytesPerPixel = Output.GetBytesPerPixel();
+		const int64 RowSize = static_cast<int64>(Slot.TileRect.Width()) * BytesPerPixel;
+		const int64 MappedPitch = static_cast<int64>(MappedWidth) * BytesPerPixel;
+		for (int32 Y = 0; Y < Slot.TileRect.Height(); ++Y)
+		{
+			FMemory::Memcpy(Output.GetRow(Slot.TileRect.Min.Y + Y) + static_cast<int64>(Slot.TileRect.Min.X) * BytesPerPixel,
+				static_cast<const uint8*>(Data) + Y * MappedPitch, RowSize);
+		}
+		RHICmdList.UnmapStagingSurface(Slot.StagingTexture);
+	}
+	else
+	{
+		UE_LOG(LogFidelityFXCASTiled, Warning, TEXT("ProcessImageTiled: couldn't map the staging texture of tile [%d, %d]."), Slot.TileRect.Min.X, Slot.TileRect.Min.Y);
+	}
+
+	// The copy passed, so did the dispatch and its timestamps. The slot reuses its queries for its next tile.
+	uint64 BeginMicroseconds = 0, EndMicroseconds = 0;
+	if (Slot.BeginQuery && Slot.EndQuery && bTileGPUTimeValid)
+	{
+		if (RHIGetRenderQueryResult(Slot.BeginQuery, BeginMicroseconds, true) && RHIGetRenderQueryResult(Slot.EndQuery, EndMicroseconds, true) && EndMicroseconds >= BeginMicroseconds)
+			TileGPUMicroseconds += EndMicroseconds - BeginMicroseconds;
+		else
+			bTileGPUTimeValid = false;
+	}
+	Slot.bInFlight = false;
+}
+#endif // FX_CAS_PLUGIN_ENABLED
@@ -0,0 +1,109 @@
+#include "FidelityFXCASViewExtension.h"
+#include "FidelityFXCAS.h"
+
+#if FX_CAS_PLUGIN_ENABLED && FX_CAS_VIEW_EXTENSION
+
+#include "RenderGraphBuilder.h"
+#include "Runtime/Renderer/Private/SceneRendering.h"
+#include "Runtime/Renderer/Private/ScreenPass.h"
+
+//-------------------------------------------------------------------------------------------------
+// Scene view extension
+//-------------------------------------------------------------------------------------------------
+
+bool FFidelityFXCASViewExtension::IsActiveThisFrame_Internal(const FSceneViewExtensionContext& Context) const
+{
+	return FFidelityFXCASModule::Get().BoundSSCASCallback == FFidelityFXCASModule::ESSCASCallback::ViewExtension;
+}
+
+void FFidelityFXCASViewExtension::BeginRenderViewFamily(FSceneViewFamily& InViewFamily)
+{
+#if FX_CAS_VIEW_EXTENSION_UPSCALE
+	// Another plugin's spatial upscaler keeps precedence, its views are then only sharpened after the tonemapper
+	if (InViewFamily.GetPrimarySpatialUpscalerInterface() == nullptr)
+		InViewFamily.SetPrimarySpatialUpscalerInterface(new FFidelityFXCASSpatialUpscaler());
+#endif // FX_CAS_VIEW_EXTENSION_UPSCALE
+}
+
+void FFidelityFXCASViewExtension::SubscribeToPostProcessingPass(EPostProcessingPass Pass, FAfterPassCallbackDelegateArray& InOutPassCallbacks, bool bIsPassEnabled)
+{
+	// The tonemap pass is subscribed first, its callback only runs once the FXAA pass state of the view is known
+	if (Pass == EPostProcessingPass::FXAA)
+		bSharpenAfterFXAA = bIsPassEnabled;
+	if (bIsPassEnabled && (Pass == EPostProcessingPass::Tonemap || Pass == EPostProcessingPass::FXAA))
+		InOutPassCallbacks.Add(FAfterPassCallbackDelegate::CreateRaw(this, &FFidelityFXCASViewExtension::OnPostProcessingPass_RenderThread, Pass));
+}
+
+FScreenPassTexture FFidelityFXCASViewExtension::OnPostProcessingPass_RenderThread(FRDGBuilder& GraphBuilder, const FSceneView& View, const FPostProcessMaterialInputs& Inputs, EPostProcessingPass Pass)
+{
+	check(View.bIsViewInfo);
+	const FViewInfo& ViewInfo = static_cast<const FViewInfo&>(View);
+	const FScreenPassTexture SceneColor(Inputs.GetInput(EPostProcessMaterialInput::SceneColor));
+
+	// Sharpened once per view, upscaled views are sharpened by the spatial upscaler
+	bool bSharpen = (Pass == EPostProcessingPass::FXAA) == bSharpenAfterFXAA;
+#if FX_CAS_VIEW_EXTENSION_UPSCALE
+	bSharpen = bSharpen && !FFidelityFXCASSpatialUpscaler::UpscalesView(View);
+#endif // FX_CAS_VIEW_EXTENSION_UPSCALE
+	if (bSharpen)
+		return AddPasses_RenderThread(GraphBuilder, ViewInfo, SceneColor, SceneColor.ViewRect, Inputs.OverrideOutput);
+
+	// Pass through, the last pass of the chain still has to fill the override output
+	if (!Inputs.OverrideOutput.IsValid())
+		return SceneColor;
+	AddDrawTexturePass(GraphBuilder, ViewInfo, SceneColor, Inputs.OverrideOutput);
+	return FScreenPassTexture(Inputs.OverrideOutput);
+}
+
+FScreenPassTexture FFidelityFXCASViewExtension::AddPasses_RenderThread(FRDGBuilder& GraphBuilder, const FViewInfo& View, const FScreenPassTexture& SceneColor,
+	const FIntRect& OutputViewRect, const FScreenPassRenderTarget& OverrideOutput)
+{
+	// The CS has no bounds check, it writes whole 16x16 tiles, so it only writes the override output when no other view shares it
+	const bool bWriteOverrideOutput = OverrideOutput.IsValid() && EnumHasAnyFlags(OverrideOutput.Texture->Desc.Flags, TexCreate_UAV)
+		&& OverrideOutput.ViewRect == FIntRect(FIntPoint::ZeroValue, OverrideOutput.Texture->Desc.Extent);
+
+	FScreenPassTexture Output(OverrideOutput);
+	if (!bWriteOverrideOutput)
+	{
+		// Same format as the pooled CS outputs, the graph reuses the texture across frames
+		const FRDGTextureDesc Desc = FRDGTextureDesc::Create2D(OutputViewRect.Max.ComponentMax(SceneColor.Texture->Desc.Extent), PF_FloatRGBA,
+			FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV);
+		Output = FScreenPassTexture(GraphBuilder.CreateTexture(Desc, TEXT("FidelityFXCAS.Output")), OutputViewRect);
+	}
+	FFidelityFXCASModule::Get().OnViewExtensionPass_RenderThread(GraphBuilder, SceneColor.ViewRect, SceneColor.Texture, Output.ViewRect, Output.Texture);
+
+	// Render targets without UAV (i.e. the back buffer) get the result drawn, converting the format
+	if (OverrideOutput.IsValid() && !bWriteOverrideOutput)
+	{
+		AddDrawTexturePass(GraphBuilder, View, Output, OverrideOutput);
+		return FScreenPassTexture(OverrideOutput);
+	}
+	return Output;
+}
+
+#if FX_CAS_VIEW_EXTENSION_UPSCALE
+//-------------------------------------------------------------------------------------------------
+// Primary spatial upscaler
+//-------------------------------------------------------------------------------------------------
+
+const TCHAR* const FFidelityFXCASSpatialUpscaler::DebugName = TEXT("FidelityFXCAS");
+
+bool FFidelityFXCASSpatialUpscaler::UpscalesView(const FSceneView& View)
+{
+	const ISpatialUpscaler* Upscaler = View.Family->GetPrimarySpatialUpscalerInterface();
+	return Upscaler != nullptr && Upscaler->GetDebugName() == DebugName
+		&& View.PrimaryScreenPercentageMethod == EPrimaryScreenPercentageMethod::SpatialUpscale
+		&& View.ViewRect.Size() != View.GetSecondaryViewRectSize();
+}
+
+FScreenPassTexture FFidelityFXCASSpatialUpscaler::AddPasses(FRDGBuilder& GraphBuilder, const FViewInfo& View, const FInputs& PassInputs) const
+{
+	// Same output rect as the engine's upscale pass, the secondary upscale (if any) follows
+	const FIntRect OutputViewRect = PassInputs.OverrideOutput.IsValid() ? PassInputs.OverrideOutput.ViewRect
+		: PassInputs.Stage == EUpscaleStage::PrimaryToSecondary ? FIntRect(FIntPoint::ZeroValue, View.GetSecondaryViewRectSize())
+		: View.UnscaledViewRect;
+	return FFidelityFXCASViewExtension::AddPasses_RenderThread(GraphBuilder, View, PassInputs.SceneColor, OutputViewRect, PassInputs.OverrideOutput);
+}
+#endif // FX_CAS_VIEW_EXTENSION_UPSCALE
+
+#endif // FX_CAS_PLUGIN_ENABLED && FX_CAS_VIEW_EXTENSION
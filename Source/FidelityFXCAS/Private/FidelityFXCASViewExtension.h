@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Misc/EngineVersionComparison.h"
+
+// CAS upscaling as the primary spatial upscaler of the view family (ISpatialUpscaler), from UE v4.27
+#define FX_CAS_VIEW_EXTENSION_UPSCALE (FX_CAS_VIEW_EXTENSION && !UE_VERSION_OLDER_THAN(4, 27, 0))
+
+#if FX_CAS_PLUGIN_ENABLED && FX_CAS_VIEW_EXTENSION
+
+#include "SceneViewExtension.h"
+#include "Runtime/Renderer/Private/PostProcess/PostProcessMaterial.h"
+#if FX_CAS_VIEW_EXTENSION_UPSCALE
+#include "Runtime/Renderer/Private/PostProcess/PostProcessUpscale.h"
+#endif // FX_CAS_VIEW_EXTENSION_UPSCALE
+
+class FViewInfo;
+
+// Screen space CAS from a scene view extension: after the tonemapper (or after FXAA, which reads the luma the tonemapper stores in alpha),
+// so CAS gets the display referred [0, 1] colors ffx_cas.ush expects, without engine changes. Active while bound by UpdateSSCASEnabled().
+class FFidelityFXCASViewExtension : public FSceneViewExtensionBase
+{
+public:
+	FFidelityFXCASViewExtension(const FAutoRegister& AutoRegister) : FSceneViewExtensionBase(AutoRegister) { }
+
+	// ISceneViewExtension interface
+	virtual void SetupViewFamily(FSceneViewFamily& InViewFamily) override { }
+	virtual void SetupView(FSceneViewFamily& InViewFamily, FSceneView& InView) override { }
+	virtual void BeginRenderViewFamily(FSceneViewFamily& InViewFamily) override;
+	virtual void PreRenderViewFamily_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneViewFamily& InViewFamily) override { }
+	virtual void PreRenderView_RenderThread(FRHICommandListImmediate& RHICmdList, FSceneView& InView) override { }
+	virtual void SubscribeToPostProcessingPass(EPostProcessingPass Pass, FAfterPassCallbackDelegateArray& InOutPassCallbacks, bool bIsPassEnabled) override;
+
+	// Runs CAS from the view rect of SceneColor to OutputViewRect. The CS writes OverrideOutput when it is valid (last pass of the chain)
+	// and a UAV covering a single view, the result is drawn into it otherwise. A new texture is returned when there is no OverrideOutput.
+	static FScreenPassTexture AddPasses_RenderThread(FRDGBuilder& GraphBuilder, const FViewInfo& View, const FScreenPassTexture& SceneColor,
+		const FIntRect& OutputViewRect, const FScreenPassRenderTarget& OverrideOutput);
+
+protected:
+	virtual bool IsActiveThisFrame_Internal(const FSceneViewExtensionContext& Context) const override;
+
+private:
+	FScreenPassTexture OnPostProcessingPass_RenderThread(FRDGBuilder& GraphBuilder, const FSceneView& View, const FPostProcessMaterialInputs& Inputs, EPostProcessingPass Pass);
+
+	// FXAA pass enabled for the view being set up, the post processing passes of a view are subscribed and added before the next view's
+	bool bSharpenAfterFXAA = false;
+};
+
+#if FX_CAS_VIEW_EXTENSION_UPSCALE
+// Replaces the engine's primary spatial upscale (r.ScreenPercentage < 100 without temporal upsampling) with CAS upscaling
+class FFidelityFXCASSpatialUpscaler final : public ISpatialUpscaler
+{
+public:
+	static const TCHAR* const DebugName;
+
+	// ISpatialUpscaler interface
+	virtual const TCHAR* GetDebugName() const override { return DebugName; }
+	virtual ISpatialUpscaler* Fork_GameThread(const class FSceneViewFamily& ViewFamily) const override { return new FFidelityFXCASSpatialUpscaler(); }
+	virtual FScreenPassTexture AddPasses(FRDGBuilder& GraphBuilder, const FViewInfo& View, const FInputs& PassInputs) const override;
+
+	// True if CAS upscales the view, which is then not sharpened after the tonemapper
+	static bool UpscalesView(const FSceneView& View);
+};
+#endif // FX_CAS_VIEW_EXTENSION_UPSCALE
+
+#endif // FX_CAS_PLUGIN_ENABLED && FX_CAS_VIEW_EXTENSION
@@ -0,0 +1,77 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#include "FidelityFXCASCPU.h"
+#include "FidelityFXCASTestImage.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// CPU engine only, runs without a GPU. An output made by Process() and then updated with ProcessDirtyRects() after parts of the input
+// changed must be bit identical to Process() on the changed input, for sharpening, every fixed ratio, a generic scale and a prefiltered downscale.
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFidelityFXCASDirtyRectsTest, "Plugins.FidelityFXCAS.CPU.DirtyRects",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFidelityFXCASDirtyRectsTest::RunTest(const FString& Parameters)
+{
+	struct FCase
+	{
+		FIntPoint InputSize;
+		FIntPoint OutputSize;
+	};
+	const FCase Cases[] =
+	{
+		{ FIntPoint(96, 80), FIntPoint(96, 80) },		// Sharpen only
+		{ FIntPoint(48, 40), FIntPoint(96, 80) },		// 2x
+		{ FIntPoint(64, 54), FIntPoint(96, 81) },		// 1.5x
+		{ FIntPoint(72, 60), FIntPoint(96, 80) },		// 4/3
+		{ FIntPoint(70, 55), FIntPoint(111, 93) },		// Generic
+		{ FIntPoint(200, 160), FIntPoint(48, 40) },		// Prefiltered downscale
+	};
+	const EFidelityFXCASPixelFormat Formats[] = { EFidelityFXCASPixelFormat::RGBA32F, EFidelityFXCASPixelFormat::RGBA8, EFidelityFXCASPixelFormat::RGBA16F };
+
+	const FFidelityFXCASCPUModule& CPU = FFidelityFXCASCPUModule::Get();
+	FRandomStream Random(0xd1e7);
+	for (const FCase& Case : Cases)
+	{
+		for (EFidelityFXCASPixelFormat Format : Formats)
+		{
+			for (int32 bMultithreaded = 0; bMultithreaded < 2; ++bMultithreaded)
+			{
+				const FString Name = FString::Printf(TEXT("%dx%d -> %dx%d, format %d%s"), Case.InputSize.X, Case.InputSize.Y,
+					Case.OutputSize.X, Case.OutputSize.Y, static_cast<int32>(Format), bMultithreaded ? TEXT(", multithreaded") : TEXT(""));
+				FFidelityFXCASCPUSettings Settings;
+				Settings.Sharpness = 0.8f;
+				Settings.bMultithreaded = bMultithreaded != 0;
+				Settings.RowsPerTask = 7;
+
+				FFidelityFXCASTestImage Input(Case.InputSize.X, Case.InputSize.Y, Format);
+				FFidelityFXCASTestImage Incremental(Case.OutputSize.X, Case.OutputSize.Y, Format);
+				FFidelityFXCASTestImage Reference(Case.OutputSize.X, Case.OutputSize.Y, Format);
+				Input.FillNoise(Random);
+				if (!TestTrue(*FString::Printf(TEXT("First pass %s"), *Name), CPU.Process(Input.View, Incremental.View, Settings)))
+					continue;
+
+				// Regions touching the image edges, a one pixel region and two overlapping ones
+				const TArray<FIntRect> DirtyRects =
+				{
+					FIntRect(0, 0, 5, 3),
+					FIntRect(Case.InputSize.X - 7, 9, Case.InputSize.X, 21),
+					FIntRect(17, 23, 18, 24),
+					FIntRect(11, Case.InputSize.Y - 13, 33, Case.InputSize.Y - 2),
+					FIntRect(25, Case.InputSize.Y - 20, 41, Case.InputSize.Y - 9),
+				};
+				for (const FIntRect& Rect : DirtyRects)
+					Input.FillNoise(Random, Rect);
+
+				TestTrue(*FString::Printf(TEXT("Dirty rects %s"), *Name), CPU.ProcessDirtyRects(Input.View, Incremental.View, Settings, DirtyRects));
+				TestTrue(*FString::Printf(TEXT("Full pass %s"), *Name), CPU.Process(Input.View, Reference.View, Settings));
+				if (!Incremental.IsIdentical(Reference))
+					AddError(FString::Printf(TEXT("Dirty rects differ from a full pass %s: %s"), *Name, *Incremental.DescribeDifferences(Reference)));
+			}
+		}
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
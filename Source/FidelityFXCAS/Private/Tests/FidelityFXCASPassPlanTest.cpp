@@ -0,0 +1,322 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#include "FidelityFXCASPassBackend.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Pass plans recorded frame by frame and compared with the counters below. The baselines are the expected plan of every frame:
+// 16x16 thread groups, one barrier per pass, 8 bytes per PF_FloatRGBA texel and 4 bytes per uploaded foveated tile.
+
+static FFidelityFXCASPassCounters MakeFidelityFXCASBaseline(int32 NumPasses, int32 NumDispatches, int64 NumThreadGroups, int32 NumAllocations,
+	int64 AllocatedBytes, int64 UploadedBytes, int32 NumCallbackRebinds)
+{
+	FFidelityFXCASPassCounters Counters;
+	Counters.NumPasses = NumPasses;
+	Counters.NumDispatches = NumDispatches;
+	Counters.NumThreadGroups = NumThreadGroups;
+	Counters.NumBarriers = NumPasses;
+	Counters.NumAllocations = NumAllocations;
+	Counters.AllocatedBytes = AllocatedBytes;
+	Counters.UploadedBytes = UploadedBytes;
+	Counters.NumCallbackRebinds = NumCallbackRebinds;
+	return Counters;
+}
+
+static FFidelityFXCASPassDesc MakeFidelityFXCASPassDesc(const FIntPoint& InputSize, const FIntPoint& OutputSize)
+{
+	FFidelityFXCASPassDesc Desc;
+	Desc.InputSize = InputSize;
+	Desc.OutputSize = OutputSize;
+	Desc.bUseFP16 = true;
+	Desc.Quality = EFidelityFXCASQuality::Ultra;
+	return Desc;
+}
+
+// One pass into the CS output, as the module prepares and runs it (the array passes write a texture array)
+static void RecordFidelityFXCASPass(FFidelityFXCASRecordingPassBackend& Backend, const FFidelityFXCASPassDesc& Desc)
+{
+	Backend.PrepareOutput(TEXT("CSOutput"), FFidelityFXCASOutputDesc(Desc.OutputSize, Desc.bArray ? Desc.NumSlices : 0, PF_FloatRGBA));
+	BuildFidelityFXCASComputePass(Desc, Backend);
+}
+
+// One screen space CAS frame, the callback chosen for the screen percentage is bound first
+static void RecordFidelityFXCASSSCASFrame(FFidelityFXCASRecordingPassBackend& Backend, const FFidelityFXCASPassDesc& Desc, float ScreenPercentage)
+{
+	Backend.BindSSCASCallback(FFidelityFXCASModule::ChooseSSCASCallback(true, false, ScreenPercentage));
+	RecordFidelityFXCASPass(Backend, Desc);
+	Backend.EndFrame();
+}
+
+static void TestFidelityFXCASBaseline(FAutomationTestBase& Test, const FFidelityFXCASRecordingPassBackend& Backend, const TArray<FFidelityFXCASPassCounters>& Baseline)
+{
+	FString Report;
+	if (!FFidelityFXCASRecordingPassBackend::CompareFrames(Baseline, Backend.GetRecordedFrames(), Report))
+		Test.AddError(FString::Printf(TEXT("Pass plan differs from the baseline:\n%s"), *Report));
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFidelityFXCASPassPlanSharpenTest, "Plugins.FidelityFXCAS.PassPlan.Sharpen",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFidelityFXCASPassPlanSharpenTest::RunTest(const FString& Parameters)
+{
+	const FFidelityFXCASPassDesc Desc = MakeFidelityFXCASPassDesc(FIntPoint(1920, 1080), FIntPoint(1920, 1080));
+	const FFidelityFXCASPermutation Permutation = GetFidelityFXCASPermutation(Desc);
+	TestTrue(TEXT("Sharpen only permutation"), Permutation.Kind == EFidelityFXCASPassKind::Uniform && Permutation.bSharpenOnly
+		&& Permutation.FixedRatio == EFidelityFXCASFixedRatio::None);
+	TestTrue(TEXT("FP16 falls back from Ultra to High"), Permutation.Quality == (FX_CAS_FP16_ENABLED ? EFidelityFXCASQuality::High : EFidelityFXCASQuality::Ultra));
+
+	// The output and the callback once, then the steady state
+	FFidelityFXCASRecordingPassBackend Backend;
+	for (int32 Frame = 0; Frame < 3; ++Frame)
+		RecordFidelityFXCASSSCASFrame(Backend, Desc, 100.0f);
+
+	TestFidelityFXCASBaseline(*this, Backend, {
+		MakeFidelityFXCASBaseline(1, 1, 8160, 1, 16588800, 0, 1),
+		MakeFidelityFXCASBaseline(1, 1, 8160, 0, 0, 0, 0),
+		MakeFidelityFXCASBaseline(1, 1, 8160, 0, 0, 0, 0),
+	});
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFidelityFXCASPassPlanUpscaleTest, "Plugins.FidelityFXCAS.PassPlan.Upscale",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFidelityFXCASPassPlanUpscaleTest::RunTest(const FString& Parameters)
+{
+	// Dynamic resolution: the input shrinks, the output, the callback and the thread group count stay
+	const FFidelityFXCASPassDesc Desc83 = MakeFidelityFXCASPassDesc(FIntPoint(1600, 900), FIntPoint(1920, 1080));
+	const FFidelityFXCASPassDesc Desc70 = MakeFidelityFXCASPassDesc(FIntPoint(1344, 756), FIntPoint(1920, 1080));
+	for (const FFidelityFXCASPassDesc* Desc : { &Desc83, &Desc70 })
+	{
+		const FFidelityFXCASPermutation Permutation = GetFidelityFXCASPermutation(*Desc);
+		TestTrue(TEXT("Generic scaling permutation"), Permutation.Kind == EFidelityFXCASPassKind::Uniform && !Permutation.bSharpenOnly
+			&& Permutation.FixedRatio == EFidelityFXCASFixedRatio::None);
+	}
+
+	FFidelityFXCASRecordingPassBackend Backend;
+	RecordFidelityFXCASSSCASFrame(Backend, Desc83, 83.3f);
+	RecordFidelityFXCASSSCASFrame(Backend, Desc70, 70.0f);
+	RecordFidelityFXCASSSCASFrame(Backend, Desc70, 70.0f);
+
+	TestFidelityFXCASBaseline(*this, Backend, {
+		MakeFidelityFXCASBaseline(1, 1, 8160, 1, 16588800, 0, 1),
+		MakeFidelityFXCASBaseline(1, 1, 8160, 0, 0, 0, 0),
+		MakeFidelityFXCASBaseline(1, 1, 8160, 0, 0, 0, 0),
+	});
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFidelityFXCASPassPlanFixedRatioTest, "Plugins.FidelityFXCAS.PassPlan.FixedRatio",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFidelityFXCASPassPlanFixedRatioTest::RunTest(const FString& Parameters)
+{
+	const FFidelityFXCASPassDesc Desc2x = MakeFidelityFXCASPassDesc(FIntPoint(1280, 720), FIntPoint(2560, 1440));
+	const FFidelityFXCASPassDesc Desc3_2 = MakeFidelityFXCASPassDesc(FIntPoint(1280, 720), FIntPoint(1920, 1080));
+	const FFidelityFXCASPassDesc Desc4_3 = MakeFidelityFXCASPassDesc(FIntPoint(1440, 810), FIntPoint(1920, 1080));
+	const FFidelityFXCASPassDesc DescPrefiltered = MakeFidelityFXCASPassDesc(FIntPoint(3840, 2160), FIntPoint(1280, 720));
+	TestTrue(TEXT("2x permutation"), GetFidelityFXCASPermutation(Desc2x).FixedRatio == EFidelityFXCASFixedRatio::Upscale2x);
+	TestTrue(TEXT("3:2 permutation"), GetFidelityFXCASPermutation(Desc3_2).FixedRatio == EFidelityFXCASFixedRatio::Upscale3_2);
+	TestTrue(TEXT("4:3 permutation"), GetFidelityFXCASPermutation(Desc4_3).FixedRatio == EFidelityFXCASFixedRatio::Upscale4_3);
+	TestTrue(TEXT("Prefiltered downscale permutation"), GetFidelityFXCASPermutation(DescPrefiltered).FixedRatio == EFidelityFXCASFixedRatio::DownscalePrefiltered);
+
+	// A new output size replaces the CS output. The downscale leaves the upscale callback of patched engines.
+	FFidelityFXCASRecordingPassBackend Backend;
+	RecordFidelityFXCASSSCASFrame(Backend, Desc2x, 50.0f);
+	RecordFidelityFXCASSSCASFrame(Backend, Desc3_2, 66.7f);
+	RecordFidelityFXCASSSCASFrame(Backend, Desc4_3, 75.0f);
+	RecordFidelityFXCASSSCASFrame(Backend, DescPrefiltered, 300.0f);
+
+	TestFidelityFXCASBaseline(*this, Backend, {
+		MakeFidelityFXCASBaseline(1, 1, 14400, 1, 29491200, 0, 1),
+		MakeFidelityFXCASBaseline(1, 1, 8160, 1, 16588800, 0, 0),
+		MakeFidelityFXCASBaseline(1, 1, 8160, 0, 0, 0, 0),
+		MakeFidelityFXCASBaseline(1, 1, 3600, 1, 7372800, 0, FX_CAS_CUSTOM_UPSCALE_CALLBACK ? 1 : 0),
+	});
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFidelityFXCASPassPlanDirtyRectsTest, "Plugins.FidelityFXCAS.PassPlan.DirtyRects",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFidelityFXCASPassPlanDirtyRectsTest::RunTest(const FString& Parameters)
+{
+	FFidelityFXCASPassDesc Desc = MakeFidelityFXCASPassDesc(FIntPoint(1920, 1080), FIntPoint(1920, 1080));
+	FFidelityFXCASRecordingPassBackend Backend;
+	RecordFidelityFXCASPass(Backend, Desc);
+	Backend.EndFrame();
+
+	// One dispatch per region over the thread groups it touches: 7x4 groups, then 2x2 for a rect straddling group borders
+	Desc.DirtyRects = { FIntRect(0, 0, 100, 50), FIntRect(500, 500, 516, 516) };
+	RecordFidelityFXCASPass(Backend, Desc);
+	const TArray<FFidelityFXCASDispatch>& Dispatches = Backend.GetFrameDispatches();
+	TestEqual(TEXT("Dispatches per dirty rect"), Dispatches.Num(), 2);
+	if (Dispatches.Num() == 2)
+	{
+		TestTrue(TEXT("First region group offset"), Dispatches[0].GroupOffset == FIntPoint(0, 0));
+		TestTrue(TEXT("Second region group offset"), Dispatches[1].GroupOffset == FIntPoint(31, 31));
+	}
+	Backend.EndFrame();
+
+	Desc.DirtyRects = { FIntRect(40, 40, 41, 41) };
+	RecordFidelityFXCASPass(Backend, Desc);
+	Backend.EndFrame();
+
+	TestFidelityFXCASBaseline(*this, Backend, {
+		MakeFidelityFXCASBaseline(1, 1, 8160, 1, 16588800, 0, 0),
+		MakeFidelityFXCASBaseline(1, 2, 32, 0, 0, 0, 0),
+		MakeFidelityFXCASBaseline(1, 1, 1, 0, 0, 0, 0),
+	});
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFidelityFXCASPassPlanMaskedTest, "Plugins.FidelityFXCAS.PassPlan.Masked",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFidelityFXCASPassPlanMaskedTest::RunTest(const FString& Parameters)
+{
+	FFidelityFXCASPassDesc Desc = MakeFidelityFXCASPassDesc(FIntPoint(1920, 1080), FIntPoint(1920, 1080));
+	Desc.bHasSharpnessMask = true;
+	FFidelityFXCASPassDesc DescPrefiltered = MakeFidelityFXCASPassDesc(FIntPoint(3840, 2160), FIntPoint(1280, 720));
+	DescPrefiltered.bHasSharpnessMask = true;
+	TestTrue(TEXT("Masked permutation"), GetFidelityFXCASPermutation(Desc).Kind == EFidelityFXCASPassKind::Masked);
+	TestTrue(TEXT("Prefiltered downscales ignore the mask"), GetFidelityFXCASPermutation(DescPrefiltered).Kind == EFidelityFXCASPassKind::Uniform);
+
+	FFidelityFXCASRecordingPassBackend Backend;
+	RecordFidelityFXCASPass(Backend, Desc);
+	Backend.EndFrame();
+	RecordFidelityFXCASPass(Backend, Desc);
+	Backend.EndFrame();
+	RecordFidelityFXCASPass(Backend, DescPrefiltered);
+	Backend.EndFrame();
+
+	TestFidelityFXCASBaseline(*this, Backend, {
+		MakeFidelityFXCASBaseline(1, 1, 8160, 1, 16588800, 0, 0),
+		MakeFidelityFXCASBaseline(1, 1, 8160, 0, 0, 0, 0),
+		MakeFidelityFXCASBaseline(1, 1, 3600, 1, 7372800, 0, 0),
+	});
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFidelityFXCASPassPlanFoveatedTest, "Plugins.FidelityFXCAS.PassPlan.Foveated",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFidelityFXCASPassPlanFoveatedTest::RunTest(const FString& Parameters)
+{
+	// Every tile of the output is in one of the three lists, so one dispatch per class and one upload of all the tiles
+	FFidelityFXCASTileClassification Classification;
+	FFidelityFXCASPassDesc Desc = MakeFidelityFXCASPassDesc(FIntPoint(1920, 1080), FIntPoint(1920, 1080));
+	Desc.Foveation = FFidelityFXCASFoveation::MakeFixed(1, 0.5f, 1.0f);
+	Desc.TileClassification = &Classification;
+	FFidelityFXCASPassDesc DescStereo = MakeFidelityFXCASPassDesc(FIntPoint(2560, 1440), FIntPoint(2560, 1440));
+	DescStereo.Foveation = FFidelityFXCASFoveation::MakeFixed(2, 0.4f, 0.8f);
+	DescStereo.TileClassification = &Classification;
+	TestTrue(TEXT("Foveated permutation"), GetFidelityFXCASPermutation(Desc).Kind == EFidelityFXCASPassKind::Foveated);
+
+	FFidelityFXCASRecordingPassBackend Backend;
+	RecordFidelityFXCASPass(Backend, Desc);
+	const TArray<FFidelityFXCASDispatch>& Dispatches = Backend.GetFrameDispatches();
+	TestEqual(TEXT("Dispatches per tile class"), Dispatches.Num(), 3);
+	if (Dispatches.Num() == 3)
+	{
+		TestTrue(TEXT("Reduced tiles at Low quality"), Dispatches[1].Permutation.Quality == EFidelityFXCASQuality::Low);
+		TestTrue(TEXT("Periphery tiles bilinear"), Dispatches[2].Permutation.bBilinear);
+	}
+	Backend.EndFrame();
+	RecordFidelityFXCASPass(Backend, Desc);
+	Backend.EndFrame();
+
+	// Dirty regions take the uniform pass
+	Desc.DirtyRects = { FIntRect(0, 0, 16, 16) };
+	RecordFidelityFXCASPass(Backend, Desc);
+	Backend.EndFrame();
+
+	RecordFidelityFXCASPass(Backend, DescStereo);
+	Backend.EndFrame();
+
+	TestFidelityFXCASBaseline(*this, Backend, {
+		MakeFidelityFXCASBaseline(1, 3, 8160, 1, 16588800, 32640, 0),
+		MakeFidelityFXCASBaseline(1, 3, 8160, 0, 0, 32640, 0),
+		MakeFidelityFXCASBaseline(1, 1, 1, 0, 0, 0, 0),
+		MakeFidelityFXCASBaseline(1, 3, 14400, 1, 29491200, 57600, 0),
+	});
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFidelityFXCASPassPlanViewExtensionTest, "Plugins.FidelityFXCAS.PassPlan.ViewExtension",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFidelityFXCASPassPlanViewExtensionTest::RunTest(const FString& Parameters)
+{
+	using ESSCASCallback = FFidelityFXCASModule::ESSCASCallback;
+
+	// Foveation and the mask only have RHI dispatches: without upscaling they move the default view extension route to the resolved
+	// scene color callback, upscaling keeps its callback and runs the whole frame
+	const ESSCASCallback ViewExtensionCallback = FX_CAS_VIEW_EXTENSION ? ESSCASCallback::ViewExtension : ESSCASCallback::ResolvedSceneColor;
+	TestTrue(TEXT("View extension route"), FFidelityFXCASModule::ChooseSSCASCallback(true, true, 100.0f) == ViewExtensionCallback);
+	TestTrue(TEXT("Foveation or mask take the resolved scene color callback"),
+		FFidelityFXCASModule::ChooseSSCASCallback(true, true, 100.0f, true) == ESSCASCallback::ResolvedSceneColor);
+	TestTrue(TEXT("Upscaling keeps its callback"), FFidelityFXCASModule::ChooseSSCASCallback(true, true, 70.0f, true)
+		== (FX_CAS_CUSTOM_UPSCALE_CALLBACK ? ESSCASCallback::CustomUpscale : ViewExtensionCallback));
+
+	FFidelityFXCASTileClassification Classification;
+	const FFidelityFXCASPassDesc Desc = MakeFidelityFXCASPassDesc(FIntPoint(1920, 1080), FIntPoint(1920, 1080));
+	FFidelityFXCASPassDesc DescFoveated = Desc;
+	DescFoveated.Foveation = FFidelityFXCASFoveation::MakeFixed(1, 0.5f, 1.0f);
+	DescFoveated.TileClassification = &Classification;
+	FFidelityFXCASPassDesc DescMasked = Desc;
+	DescMasked.bHasSharpnessMask = true;
+
+	// Plain, foveated, masked and plain again, as UpdateSSCASEnabled() binds the callbacks for them
+	FFidelityFXCASRecordingPassBackend Backend;
+	for (const FFidelityFXCASPassDesc* FrameDesc : { &Desc, &DescFoveated, &DescMasked, &Desc })
+	{
+		const bool bNeedsRHIPass = FrameDesc->Foveation.IsEnabled() || FrameDesc->bHasSharpnessMask;
+		Backend.BindSSCASCallback(FFidelityFXCASModule::ChooseSSCASCallback(true, true, 100.0f, bNeedsRHIPass));
+		RecordFidelityFXCASPass(Backend, *FrameDesc);
+		Backend.EndFrame();
+	}
+
+	const int32 NumFallbackRebinds = FX_CAS_VIEW_EXTENSION ? 1 : 0;
+	TestFidelityFXCASBaseline(*this, Backend, {
+		MakeFidelityFXCASBaseline(1, 1, 8160, 1, 16588800, 0, 1),
+		MakeFidelityFXCASBaseline(1, 3, 8160, 0, 0, 32640, NumFallbackRebinds),
+		MakeFidelityFXCASBaseline(1, 1, 8160, 0, 0, 0, 0),
+		MakeFidelityFXCASBaseline(1, 1, 8160, 0, 0, 0, NumFallbackRebinds),
+	});
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFidelityFXCASPassPlanArrayTest, "Plugins.FidelityFXCAS.PassPlan.Array",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFidelityFXCASPassPlanArrayTest::RunTest(const FString& Parameters)
+{
+	// All the slices in one dispatch, the slice count sets the array size of the CS output
+	FFidelityFXCASPassDesc Desc = MakeFidelityFXCASPassDesc(FIntPoint(512, 512), FIntPoint(512, 512));
+	Desc.bArray = true;
+	Desc.NumSlices = 6;
+	FFidelityFXCASPassDesc DescVolume = Desc;
+	DescVolume.bInputVolume = true;
+	DescVolume.NumSlices = 4;
+	TestTrue(TEXT("Array permutation"), GetFidelityFXCASPermutation(Desc).Kind == EFidelityFXCASPassKind::Array && !GetFidelityFXCASPermutation(Desc).bVolume);
+	TestTrue(TEXT("Volume permutation"), GetFidelityFXCASPermutation(DescVolume).bVolume);
+
+	FFidelityFXCASRecordingPassBackend Backend;
+	RecordFidelityFXCASPass(Backend, Desc);
+	Backend.EndFrame();
+	RecordFidelityFXCASPass(Backend, Desc);
+	Backend.EndFrame();
+	RecordFidelityFXCASPass(Backend, DescVolume);
+	Backend.EndFrame();
+
+	TestFidelityFXCASBaseline(*this, Backend, {
+		MakeFidelityFXCASBaseline(1, 1, 6144, 1, 12582912, 0, 0),
+		MakeFidelityFXCASBaseline(1, 1, 6144, 0, 0, 0, 0),
+		MakeFidelityFXCASBaseline(1, 1, 4096, 1, 8388608, 0, 0),
+	});
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,219 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#include "FidelityFXCASResolutionController.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Simulated GPU: the frame time of a scene scales with the rendered pixel count
+struct FFidelityFXCASSimulatedScene
+{
+	float FrameTimeAtFullResolution = 16.0f;
+
+	float GetFrameTime(float ScreenPercentage) const { return FrameTimeAtFullResolution * FMath::Square(ScreenPercentage / 100.0f); }
+};
+
+// What a trace did to the controller
+struct FFidelityFXCASTraceResult
+{
+	int32 NumChanges = 0;
+	int32 LastChangeFrame = -1;
+	float LargestStep = 0.0f;
+	float MinScreenPercentage = MAX_flt;
+	float MaxScreenPercentage = 0.0f;
+	int32 ShortestCooldown = MAX_int32;		// Frames between two changes
+};
+
+// Feeds one frame time per frame, FrameTime(Frame, ScreenPercentage)
+template <typename FrameTimeFunctionType>
+static FFidelityFXCASTraceResult RunFidelityFXCASTrace(FFidelityFXCASResolutionController& Controller, int32 NumFrames, FrameTimeFunctionType FrameTime)
+{
+	FFidelityFXCASTraceResult Result;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		const float Previous = Controller.GetScreenPercentage();
+		if (Controller.Update(FrameTime(Frame, Previous)))
+		{
+			if (Result.LastChangeFrame >= 0)
+				Result.ShortestCooldown = FMath::Min(Result.ShortestCooldown, Frame - Result.LastChangeFrame - 1);
+			Result.LargestStep = FMath::Max(Result.LargestStep, FMath::Abs(Controller.GetScreenPercentage() - Previous));
+			Result.LastChangeFrame = Frame;
+			++Result.NumChanges;
+		}
+		Result.MinScreenPercentage = FMath::Min(Result.MinScreenPercentage, Controller.GetScreenPercentage());
+		Result.MaxScreenPercentage = FMath::Max(Result.MaxScreenPercentage, Controller.GetScreenPercentage());
+	}
+	return Result;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFidelityFXCASResolutionControllerSteadyTest, "Plugins.FidelityFXCAS.ResolutionController.Steady",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFidelityFXCASResolutionControllerSteadyTest::RunTest(const FString& Parameters)
+{
+	const FFidelityFXCASResolutionControllerSettings Settings;
+	const float UpperBound = Settings.TargetFrameTime * Settings.UpperThreshold;
+	const float LowerBound = Settings.TargetFrameTime * Settings.LowerThreshold;
+
+	// Inside the hysteresis band: holds
+	{
+		FFidelityFXCASResolutionController Controller(Settings);
+		const FFidelityFXCASTraceResult Result = RunFidelityFXCASTrace(Controller, 600, [](int32, float) { return 15.0f; });
+		TestEqual(TEXT("In band: no change"), Result.NumChanges, 0);
+		TestEqual(TEXT("In band: full resolution"), Controller.GetScreenPercentage(), Settings.MaxScreenPercentage);
+	}
+
+	// Over budget: settles inside the band, in steps no larger than MaxStep and at most one change per cooldown
+	{
+		FFidelityFXCASResolutionController Controller(Settings);
+		const FFidelityFXCASSimulatedScene Scene{ 25.0f };
+		const FFidelityFXCASTraceResult Result = RunFidelityFXCASTrace(Controller, 600, [&Scene](int32, float ScreenPercentage) { return Scene.GetFrameTime(ScreenPercentage); });
+		const float SettledFrameTime = Scene.GetFrameTime(Controller.GetScreenPercentage());
+		TestTrue(TEXT("Over budget: resolution dropped"), Result.NumChanges > 0 && Controller.GetScreenPercentage() < Settings.MaxScreenPercentage);
+		TestTrue(TEXT("Over budget: steps clamped to MaxStep"), Result.LargestStep <= Settings.MaxStep + KINDA_SMALL_NUMBER);
+		TestTrue(TEXT("Over budget: cooldown between changes"), Result.NumChanges < 2 || Result.ShortestCooldown >= Settings.CooldownFrames);
+		TestTrue(TEXT("Over budget: settled inside the band"), SettledFrameTime <= UpperBound && SettledFrameTime >= LowerBound);
+		TestTrue(TEXT("Over budget: settled early"), Result.LastChangeFrame < 300);
+	}
+
+	// Far over budget: stops at the lower bound
+	{
+		FFidelityFXCASResolutionController Controller(Settings);
+		const FFidelityFXCASSimulatedScene Scene{ 100.0f };
+		const FFidelityFXCASTraceResult Result = RunFidelityFXCASTrace(Controller, 600, [&Scene](int32, float ScreenPercentage) { return Scene.GetFrameTime(ScreenPercentage); });
+		TestEqual(TEXT("Far over budget: lower bound"), Controller.GetScreenPercentage(), Settings.MinScreenPercentage);
+		TestTrue(TEXT("Far over budget: never below the bound"), Result.MinScreenPercentage >= Settings.MinScreenPercentage);
+		TestTrue(TEXT("Far over budget: steps clamped to MaxStep"), Result.LargestStep <= Settings.MaxStep + KINDA_SMALL_NUMBER);
+	}
+
+	// Far under budget from the lower bound: climbs back to the upper bound and not beyond
+	{
+		FFidelityFXCASResolutionController Controller(Settings);
+		Controller.Reset(Settings.MinScreenPercentage);
+		const FFidelityFXCASSimulatedScene Scene{ 5.0f };
+		const FFidelityFXCASTraceResult Result = RunFidelityFXCASTrace(Controller, 600, [&Scene](int32, float ScreenPercentage) { return Scene.GetFrameTime(ScreenPercentage); });
+		TestEqual(TEXT("Under budget: upper bound"), Controller.GetScreenPercentage(), Settings.MaxScreenPercentage);
+		TestTrue(TEXT("Under budget: never above the bound"), Result.MaxScreenPercentage <= Settings.MaxScreenPercentage);
+		TestTrue(TEXT("Under budget: steps clamped to MaxStep"), Result.LargestStep <= Settings.MaxStep + KINDA_SMALL_NUMBER);
+	}
+
+	// Tighter MaxStep
+	{
+		FFidelityFXCASResolutionControllerSettings SmallSteps = Settings;
+		SmallSteps.MaxStep = 2.0f;
+		FFidelityFXCASResolutionController Controller(SmallSteps);
+		const FFidelityFXCASSimulatedScene Scene{ 40.0f };
+		const FFidelityFXCASTraceResult Result = RunFidelityFXCASTrace(Controller, 300, [&Scene](int32, float ScreenPercentage) { return Scene.GetFrameTime(ScreenPercentage); });
+		TestTrue(TEXT("MaxStep 2: steps clamped"), Result.NumChanges > 0 && Result.LargestStep <= SmallSteps.MaxStep + KINDA_SMALL_NUMBER);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFidelityFXCASResolutionControllerSpikeTest, "Plugins.FidelityFXCAS.ResolutionController.Spikes",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFidelityFXCASResolutionControllerSpikeTest::RunTest(const FString& Parameters)
+{
+	const FFidelityFXCASResolutionControllerSettings Settings;
+
+	// Single frame hitches inside an in-band trace are smoothed out
+	{
+		FFidelityFXCASResolutionController Controller(Settings);
+		const FFidelityFXCASTraceResult Result = RunFidelityFXCASTrace(Controller, 600, [](int32 Frame, float) { return Frame % 30 == 29 ? 25.0f : 15.0f; });
+		TestEqual(TEXT("Hitches: no change"), Result.NumChanges, 0);
+	}
+
+	// A sustained load spike drops the resolution, which recovers once the spike is over
+	{
+		FFidelityFXCASResolutionController Controller(Settings);
+		const FFidelityFXCASSimulatedScene Light{ 13.0f }, Heavy{ 30.0f };
+		const FFidelityFXCASTraceResult During = RunFidelityFXCASTrace(Controller, 300, [&Light, &Heavy](int32 Frame, float ScreenPercentage)
+		{
+			return (Frame < 100 ? Light : Heavy).GetFrameTime(ScreenPercentage);
+		});
+		TestTrue(TEXT("Load spike: resolution dropped"), During.NumChanges > 0 && Controller.GetScreenPercentage() < Settings.MaxScreenPercentage);
+		TestTrue(TEXT("Load spike: steps clamped to MaxStep"), During.LargestStep <= Settings.MaxStep + KINDA_SMALL_NUMBER);
+
+		RunFidelityFXCASTrace(Controller, 600, [&Light](int32, float ScreenPercentage) { return Light.GetFrameTime(ScreenPercentage); });
+		TestEqual(TEXT("Load spike: recovered"), Controller.GetScreenPercentage(), Settings.MaxScreenPercentage);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFidelityFXCASResolutionControllerOscillationTest, "Plugins.FidelityFXCAS.ResolutionController.Oscillation",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFidelityFXCASResolutionControllerOscillationTest::RunTest(const FString& Parameters)
+{
+	const FFidelityFXCASResolutionControllerSettings Settings;
+
+	// Frame to frame jitter around an in-band average holds
+	{
+		FFidelityFXCASResolutionController Controller(Settings);
+		const FFidelityFXCASTraceResult Result = RunFidelityFXCASTrace(Controller, 600, [](int32 Frame, float) { return Frame % 2 ? 12.0f : 19.0f; });
+		TestEqual(TEXT("Jitter: no change"), Result.NumChanges, 0);
+	}
+
+	// A scene just over budget at one step and under the band one step lower settles instead of flip-flopping
+	{
+		FFidelityFXCASResolutionController Controller(Settings);
+		const FFidelityFXCASSimulatedScene Scene{ 17.5f };
+		const FFidelityFXCASTraceResult Result = RunFidelityFXCASTrace(Controller, 1200, [&Scene](int32, float ScreenPercentage) { return Scene.GetFrameTime(ScreenPercentage); });
+		TestTrue(TEXT("Near the band: few changes"), Result.NumChanges > 0 && Result.NumChanges <= 2);
+		TestTrue(TEXT("Near the band: settled early"), Result.LastChangeFrame < 300);
+	}
+
+	// Load alternating between light and heavy scenes: every change respects the bounds, MaxStep and the cooldown
+	{
+		FFidelityFXCASResolutionController Controller(Settings);
+		const FFidelityFXCASSimulatedScene Light{ 10.0f }, Heavy{ 28.0f };
+		const FFidelityFXCASTraceResult Result = RunFidelityFXCASTrace(Controller, 2000, [&Light, &Heavy](int32 Frame, float ScreenPercentage)
+		{
+			return ((Frame / 200) % 2 ? Heavy : Light).GetFrameTime(ScreenPercentage);
+		});
+		TestTrue(TEXT("Alternating load: follows the load"), Result.NumChanges >= 4);
+		TestTrue(TEXT("Alternating load: bounds"), Result.MinScreenPercentage >= Settings.MinScreenPercentage && Result.MaxScreenPercentage <= Settings.MaxScreenPercentage);
+		TestTrue(TEXT("Alternating load: steps clamped to MaxStep"), Result.LargestStep <= Settings.MaxStep + KINDA_SMALL_NUMBER);
+		TestTrue(TEXT("Alternating load: cooldown between changes"), Result.ShortestCooldown >= Settings.CooldownFrames);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFidelityFXCASResolutionControllerSharpnessTest, "Plugins.FidelityFXCAS.ResolutionController.Sharpness",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFidelityFXCASResolutionControllerSharpnessTest::RunTest(const FString& Parameters)
+{
+	const FFidelityFXCASResolutionControllerSettings Settings;
+	FFidelityFXCASResolutionController Controller(Settings);
+
+	// Sharper at lower resolution, linear in between
+	Controller.Reset(Settings.MinScreenPercentage);
+	TestEqual(TEXT("Sharpness at the lower bound"), Controller.GetSharpness(), Settings.SharpnessAtMinScreenPercentage, KINDA_SMALL_NUMBER);
+	Controller.Reset(Settings.MaxScreenPercentage);
+	TestEqual(TEXT("Sharpness at the upper bound"), Controller.GetSharpness(), Settings.SharpnessAtMaxScreenPercentage, KINDA_SMALL_NUMBER);
+	Controller.Reset(0.5f * (Settings.MinScreenPercentage + Settings.MaxScreenPercentage));
+	TestEqual(TEXT("Sharpness half way"), Controller.GetSharpness(), 0.5f * (Settings.SharpnessAtMinScreenPercentage + Settings.SharpnessAtMaxScreenPercentage), KINDA_SMALL_NUMBER);
+
+	// Follows the resolution while the controller drops it
+	const FFidelityFXCASSimulatedScene Scene{ 30.0f };
+	float PreviousSharpness = Controller.GetSharpness();
+	bool bMonotonic = true;
+	RunFidelityFXCASTrace(Controller, 300, [&](int32, float ScreenPercentage)
+	{
+		bMonotonic &= Controller.GetSharpness() >= PreviousSharpness - KINDA_SMALL_NUMBER;
+		PreviousSharpness = Controller.GetSharpness();
+		return Scene.GetFrameTime(ScreenPercentage);
+	});
+	TestTrue(TEXT("Sharpness rises as the resolution drops"), bMonotonic && Controller.GetSharpness() > Settings.SharpnessAtMaxScreenPercentage);
+
+	// Out of range settings are clamped to [0, 1]
+	FFidelityFXCASResolutionControllerSettings OutOfRange = Settings;
+	OutOfRange.SharpnessAtMinScreenPercentage = 2.0f;
+	Controller.SetSettings(OutOfRange);
+	Controller.Reset(OutOfRange.MinScreenPercentage);
+	TestEqual(TEXT("Sharpness clamped"), Controller.GetSharpness(), 1.0f, KINDA_SMALL_NUMBER);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
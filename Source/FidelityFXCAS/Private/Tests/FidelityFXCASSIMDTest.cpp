@@ -0,0 +1,101 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#include "FidelityFXCASCPU.h"
+#include "FidelityFXCASTestImage.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// CPU engine only, runs without a GPU. The CPU engine has a single CAS quality (the GPU Low tier), so the kernels are compared at every
+// format, channel order and a range of sharpness values instead. Without AVX2 + F16C both runs take the scalar kernels and trivially match.
+
+static const EFidelityFXCASChannelOrder GFidelityFXCASChannelOrders[] = { EFidelityFXCASChannelOrder::RGBA, EFidelityFXCASChannelOrder::BGRA };
+static const float GFidelityFXCASSharpnessValues[] = { 0.0f, 0.35f, 0.8f, 1.0f };
+// Widths around the 8 and 16 pixel SIMD blocks, so the remainder columns and single pixel rows are covered
+static const FIntPoint GFidelityFXCASSIMDTestSizes[] = { FIntPoint(131, 67), FIntPoint(16, 9), FIntPoint(17, 1), FIntPoint(1, 5), FIntPoint(7, 7) };
+
+// Sharpens a noise image of Format with and without SIMD at every channel order, sharpness and size, the results must match bit for bit
+static void TestFidelityFXCASSIMDMatchesScalar(FAutomationTestBase& Test, EFidelityFXCASPixelFormat Format, FRandomStream& Random)
+{
+	const FFidelityFXCASCPUModule& CPU = FFidelityFXCASCPUModule::Get();
+	for (const FIntPoint& Size : GFidelityFXCASSIMDTestSizes)
+	{
+		for (EFidelityFXCASChannelOrder InputOrder : GFidelityFXCASChannelOrders)
+		{
+			for (EFidelityFXCASChannelOrder OutputOrder : GFidelityFXCASChannelOrders)
+			{
+				FFidelityFXCASTestImage Input(Size.X, Size.Y, Format, InputOrder);
+				Input.FillNoise(Random);
+				for (float Sharpness : GFidelityFXCASSharpnessValues)
+				{
+					const FString Name = FString::Printf(TEXT("format %d, %dx%d, channel orders %d -> %d, sharpness %.2f"), static_cast<int32>(Format),
+						Size.X, Size.Y, static_cast<int32>(InputOrder), static_cast<int32>(OutputOrder), Sharpness);
+					FFidelityFXCASTestImage SIMD(Size.X, Size.Y, Format, OutputOrder);
+					FFidelityFXCASTestImage Scalar(Size.X, Size.Y, Format, OutputOrder);
+					FFidelityFXCASCPUSettings Settings;
+					Settings.Sharpness = Sharpness;
+					Settings.bMultithreaded = false;
+					Settings.bAllowSIMD = true;
+					Test.TestTrue(*FString::Printf(TEXT("SIMD pass %s"), *Name), CPU.Process(Input.View, SIMD.View, Settings));
+					Settings.bAllowSIMD = false;
+					Test.TestTrue(*FString::Printf(TEXT("Scalar pass %s"), *Name), CPU.Process(Input.View, Scalar.View, Settings));
+					if (!SIMD.IsIdentical(Scalar))
+						Test.AddError(FString::Printf(TEXT("SIMD differs from scalar (%s): %s"), *Name, *SIMD.DescribeDifferences(Scalar)));
+				}
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFidelityFXCASSIMDRGBA16FTest, "Plugins.FidelityFXCAS.CPU.SIMD.RGBA16F",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFidelityFXCASSIMDRGBA16FTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(0xf16c);
+	TestFidelityFXCASSIMDMatchesScalar(*this, EFidelityFXCASPixelFormat::RGBA16F, Random);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFidelityFXCASSIMDGamma2Test, "Plugins.FidelityFXCAS.CPU.SIMD.Gamma2",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFidelityFXCASSIMDGamma2Test::RunTest(const FString& Parameters)
+{
+	FRandomStream Random(0x6a2);
+	TestFidelityFXCASSIMDMatchesScalar(*this, EFidelityFXCASPixelFormat::RGBA8_SRGB, Random);
+	return true;
+}
+
+// The error bounds the README states for the fixed point RGBA8_SRGB kernel, measured against the scalar FP32 reference
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFidelityFXCASGamma2ErrorTest, "Plugins.FidelityFXCAS.CPU.SIMD.Gamma2Error",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFidelityFXCASGamma2ErrorTest::RunTest(const FString& Parameters)
+{
+	const FFidelityFXCASCPUModule& CPU = FFidelityFXCASCPUModule::Get();
+	FRandomStream Random(0x54db);
+	FFidelityFXCASTestImage Input(256, 256, EFidelityFXCASPixelFormat::RGBA8_SRGB);
+	Input.FillNoise(Random);
+	for (float Sharpness : GFidelityFXCASSharpnessValues)
+	{
+		FFidelityFXCASTestImage Output(256, 256, EFidelityFXCASPixelFormat::RGBA8_SRGB);
+		FFidelityFXCASCPUSettings Settings;
+		Settings.Sharpness = Sharpness;
+		FFidelityFXCASImageDifference Difference;
+		if (!TestTrue(TEXT("Gamma2 pass"), CPU.Process(Input.View, Output.View, Settings))
+			|| !TestTrue(TEXT("Reference pass"), CPU.MeasureErrorToReference(Input.View, Output.View, Settings, Difference)))
+		{
+			continue;
+		}
+		// The gamma 2.0 curve departs from sRGB, single pixels of full range noise end up several steps off, the image as a whole stays close
+		TestTrue(*FString::Printf(TEXT("Mean error below half a step at sharpness %.2f (%.2f steps)"), Sharpness, Difference.MeanAbsError * 255.0f),
+			Difference.MeanAbsError <= 0.5f / 255.0f);
+		TestTrue(*FString::Printf(TEXT("Max error within 16 steps at sharpness %.2f (%.2f steps)"), Sharpness, Difference.MaxAbsError * 255.0f),
+			Difference.MaxAbsError <= 16.0f / 255.0f);
+		TestTrue(*FString::Printf(TEXT("PSNR above 52 dB at sharpness %.2f (%.1f dB)"), Sharpness, Difference.PSNR), Difference.PSNR >= 52.0f);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+#include "FidelityFXCASCPUTypes.h"
+
+// Image owning its pixels for the automation tests, tightly packed
+struct FFidelityFXCASTestImage
+{
+	TArray64<uint8> Pixels;
+	FFidelityFXCASImageView View;
+
+	FFidelityFXCASTestImage(int32 Width, int32 Height, EFidelityFXCASPixelFormat Format, EFidelityFXCASChannelOrder ChannelOrder = EFidelityFXCASChannelOrder::RGBA)
+	{
+		const int64 RowPitch = static_cast<int64>(Width) * GetFidelityFXCASBytesPerPixel(Format);
+		Pixels.SetNumZeroed(RowPitch * Height);
+		View = FFidelityFXCASImageView(Pixels.GetData(), Width, Height, RowPitch, Format, ChannelOrder);
+	}
+
+	// Noise over the whole [0, 1] range of every channel, with flat blocks so the CAS weights see both extremes
+	void FillNoise(FRandomStream& Random, const FIntRect& Rect)
+	{
+		const int32 BytesPerPixel = View.GetBytesPerPixel();
+		for (int32 Y = Rect.Min.Y; Y < Rect.Max.Y; ++Y)
+		{
+			uint8* Row = View.GetRow(Y);
+			for (int32 X = Rect.Min.X; X < Rect.Max.X; ++X)
+			{
+				uint8* Pixel = Row + static_cast<int64>(X) * BytesPerPixel;
+				if (((X / 8) + (Y / 8)) % 5 == 0)
+				{
+					// Flat block, the same value as the block's first pixel when the rect holds it
+					const FIntPoint Block(X - X % 8, Y - Y % 8);
+					if (Block != FIntPoint(X, Y) && Rect.Contains(Block))
+					{
+						FMemory::Memcpy(Pixel, View.GetRow(Block.Y) + static_cast<int64>(Block.X) * BytesPerPixel, BytesPerPixel);
+						continue;
+					}
+				}
+				FillPixel(Random, Pixel);
+			}
+		}
+	}
+
+	void FillNoise(FRandomStream& Random)
+	{
+		FillNoise(Random, FIntRect(FIntPoint::ZeroValue, View.GetSize()));
+	}
+
+	bool IsIdentical(const FFidelityFXCASTestImage& Other) const
+	{
+		return View.GetSize() == Other.View.GetSize() && View.Format == Other.View.Format && Pixels == Other.Pixels;
+	}
+
+	// Pixels that differ, at most MaxReported of them listed
+	FString DescribeDifferences(const FFidelityFXCASTestImage& Other, int32 MaxReported = 4) const
+	{
+		FString Report;
+		int32 NumDifferent = 0;
+		const int32 BytesPerPixel = View.GetBytesPerPixel();
+		for (int32 Y = 0; Y < View.Height; ++Y)
+		{
+			for (int32 X = 0; X < View.Width; ++X)
+			{
+				const int64 Offset = static_cast<int64>(X) * BytesPerPixel;
+				if (FMemory::Memcmp(View.GetRow(Y) + Offset, Other.View.GetRow(Y) + Offset, BytesPerPixel) != 0 && NumDifferent++ < MaxReported)
+					Report += FString::Printf(TEXT(" [%d, %d]"), X, Y);
+			}
+		}
+		return FString::Printf(TEXT("%d pixels differ:%s"), NumDifferent, *Report);
+	}
+
+protected:
+	void FillPixel(FRandomStream& Random, uint8* Pixel) const
+	{
+		switch (View.Format)
+		{
+		case EFidelityFXCASPixelFormat::RGBA32F:
+		case EFidelityFXCASPixelFormat::RGB32F:
+		case EFidelityFXCASPixelFormat::R32F:
+			for (int32 Channel = 0; Channel < View.GetBytesPerPixel() / 4; ++Channel)
+				reinterpret_cast<float*>(Pixel)[Channel] = Random.GetFraction();
+			break;
+		case EFidelityFXCASPixelFormat::RGBA16F:
+			// Halfs in [0, 1]: any exponent below 15, and 1.0 itself
+			for (int32 Channel = 0; Channel < 4; ++Channel)
+				reinterpret_cast<uint16*>(Pixel)[Channel] = static_cast<uint16>(Random.RandRange(0, 0x3c00));
+			break;
+		default:
+			for (int32 Channel = 0; Channel < View.GetBytesPerPixel(); ++Channel)
+				Pixel[Channel] = static_cast<uint8>(Random.RandRange(0, 255));
+			break;
+		}
+	}
+};
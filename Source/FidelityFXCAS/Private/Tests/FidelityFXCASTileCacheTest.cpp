@@ -0,0 +1,107 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#include "FidelityFXCASCPU.h"
+#include "FidelityFXCASCPUContext.h"
+#include "FidelityFXCASTestImage.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// CPU engine only, runs without a GPU. Frame sequences through a context with the tile cache, every frame compared with an uncached Process()
+// of the same input: unchanged frames, partly changed frames, a resize and back, a sharpness change, an eviction heavy budget and the frames
+// after the cache was freed.
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFidelityFXCASTileCacheTest, "Plugins.FidelityFXCAS.CPU.TileCache",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFidelityFXCASTileCacheTest::RunTest(const FString& Parameters)
+{
+	struct FCase
+	{
+		FIntPoint InputSize;
+		FIntPoint OutputSize;
+		EFidelityFXCASPixelFormat Format;
+	};
+	// Sizes that are no multiple of the 64 pixel tiles
+	const FCase Cases[] =
+	{
+		{ FIntPoint(300, 200), FIntPoint(300, 200), EFidelityFXCASPixelFormat::RGBA8 },
+		{ FIntPoint(200, 130), FIntPoint(300, 195), EFidelityFXCASPixelFormat::RGBA32F },
+		{ FIntPoint(130, 100), FIntPoint(300, 210), EFidelityFXCASPixelFormat::RGBA16F },
+	};
+
+	const FFidelityFXCASCPUModule& CPU = FFidelityFXCASCPUModule::Get();
+	FRandomStream Random(0xcac4e);
+	for (const FCase& Case : Cases)
+	{
+		FFidelityFXCASCPUContext Context(4);
+		FFidelityFXCASCPUSettings Settings;
+		Settings.Sharpness = 0.6f;
+		Settings.bUseTileCache = true;
+
+		FFidelityFXCASTestImage Input(Case.InputSize.X, Case.InputSize.Y, Case.Format);
+		FFidelityFXCASTestImage ResizedInput(Case.InputSize.X - 37, Case.InputSize.Y + 21, Case.Format);
+		Input.FillNoise(Random);
+		ResizedInput.FillNoise(Random);
+
+		// Runs one frame through the cache and without it, returns the cache counters of the frame
+		const auto RunFrame = [&](const TCHAR* Frame, const FFidelityFXCASTestImage& FrameInput, const FIntPoint& OutputSize)
+		{
+			const FString Name = FString::Printf(TEXT("%s, %dx%d -> %dx%d, format %d"), Frame, FrameInput.View.Width, FrameInput.View.Height,
+				OutputSize.X, OutputSize.Y, static_cast<int32>(Case.Format));
+			FFidelityFXCASTestImage Cached(OutputSize.X, OutputSize.Y, Case.Format);
+			FFidelityFXCASTestImage Uncached(OutputSize.X, OutputSize.Y, Case.Format);
+			FFidelityFXCASCPUSettings UncachedSettings = Settings;
+			UncachedSettings.bUseTileCache = false;
+
+			Context.ResetTileCacheStats();
+			TestTrue(*FString::Printf(TEXT("Cached pass %s"), *Name), CPU.Process(Context, FrameInput.View, Cached.View, Settings));
+			const FFidelityFXCASTileCacheStats Stats = Context.GetTileCacheStats();
+			TestTrue(*FString::Printf(TEXT("Uncached pass %s"), *Name), CPU.Process(FrameInput.View, Uncached.View, UncachedSettings));
+			if (!Cached.IsIdentical(Uncached))
+				AddError(FString::Printf(TEXT("Cached pass differs from an uncached pass (%s): %s"), *Name, *Cached.DescribeDifferences(Uncached)));
+			return Stats;
+		};
+
+		// First frame computes every tile, an unchanged frame copies all of them
+		FFidelityFXCASTileCacheStats Stats = RunFrame(TEXT("First frame"), Input, Case.OutputSize);
+		TestTrue(TEXT("First frame has no hits"), Stats.NumTiles > 0 && Stats.NumHits == 0);
+		Stats = RunFrame(TEXT("Unchanged frame"), Input, Case.OutputSize);
+		TestTrue(TEXT("Unchanged frame only has hits"), Stats.NumTiles > 0 && Stats.NumHits == Stats.NumTiles);
+
+		// A changed region, its apron neighbours must be recomputed too
+		Input.FillNoise(Random, FIntRect(60, 40, 75, 47));
+		Stats = RunFrame(TEXT("Partly changed frame"), Input, Case.OutputSize);
+		TestTrue(TEXT("Partly changed frame has hits and misses"), Stats.NumHits > 0 && Stats.NumHits < Stats.NumTiles);
+		Stats = RunFrame(TEXT("Frame after the change"), Input, Case.OutputSize);
+		TestTrue(TEXT("Frame after the change only has hits"), Stats.NumHits == Stats.NumTiles);
+
+		// Resized and back, the tiles of the first size may still be cached
+		const FIntPoint ResizedOutputSize = Case.InputSize == Case.OutputSize ? ResizedInput.View.GetSize() : ResizedInput.View.GetSize() * 2;
+		RunFrame(TEXT("Resized frame"), ResizedInput, ResizedOutputSize);
+		RunFrame(TEXT("Resized frame, unchanged"), ResizedInput, ResizedOutputSize);
+		RunFrame(TEXT("Frame back at the first size"), Input, Case.OutputSize);
+
+		// Other settings must never hit the tiles of the previous ones
+		Settings.Sharpness = 0.2f;
+		Stats = RunFrame(TEXT("Sharpness change"), Input, Case.OutputSize);
+		TestTrue(TEXT("Sharpness change has no hits"), Stats.NumHits == 0);
+
+		// A budget of a few tiles, most lookups evict
+		Context.SetTileCacheBudget(256 * 1024);
+		Input.FillNoise(Random, FIntRect(0, 0, 30, 30));
+		RunFrame(TEXT("Small budget"), Input, Case.OutputSize);
+		RunFrame(TEXT("Small budget, unchanged"), Input, Case.OutputSize);
+
+		// Freed and recreated, nothing survives the invalidation
+		Context.SetTileCacheBudget(0);
+		Context.SetTileCacheBudget(256 * 1024 * 1024);
+		Stats = RunFrame(TEXT("Frame after the invalidation"), Input, Case.OutputSize);
+		TestTrue(TEXT("Frame after the invalidation has no hits"), Stats.NumHits == 0);
+		Input.FillNoise(Random, FIntRect(Case.InputSize.X - 10, Case.InputSize.Y - 10, Case.InputSize.X, Case.InputSize.Y));
+		RunFrame(TEXT("Partly changed frame after the invalidation"), Input, Case.OutputSize);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
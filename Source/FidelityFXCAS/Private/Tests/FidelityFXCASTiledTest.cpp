@@ -0,0 +1,63 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/App.h"
+
+#include "FidelityFXCAS.h"
+#include "FidelityFXCASCPU.h"
+#include "FidelityFXCASTestImage.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFidelityFXCASTiledSeamsTest, "Plugins.FidelityFXCAS.Tiled.Seams",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FFidelityFXCASTiledSeamsTest::RunTest(const FString& Parameters)
+{
+	if (!FApp::CanEverRender())
+	{
+		AddInfo(TEXT("No GPU, ProcessImageTiled runs on the CPU engine and the tile seams are not exercised."));
+		return true;
+	}
+
+	// 48 pixel tiles divide none of the sizes, so every image has partial tiles on its right and bottom edges.
+	// Sharpen only, the fixed ratio upscales, a generic scale and a prefiltered downscale.
+	const FIntPoint InputSize(200, 130);
+	const FIntPoint OutputSizes[] = { InputSize, InputSize * 2, FIntPoint(300, 195), FIntPoint(237, 151), FIntPoint(60, 40) };
+	const int32 TileSize = 48;
+
+	FRandomStream Random(0x5eed);
+	FFidelityFXCASTestImage Input(InputSize.X, InputSize.Y, EFidelityFXCASPixelFormat::RGBA32F);
+	Input.FillNoise(Random);
+
+	FFidelityFXCASModule& Module = FFidelityFXCASModule::Get();
+	for (const FIntPoint& OutputSize : OutputSizes)
+	{
+		const FString Case = FString::Printf(TEXT("%dx%d -> %dx%d"), InputSize.X, InputSize.Y, OutputSize.X, OutputSize.Y);
+		FFidelityFXCASTestImage Tiled(OutputSize.X, OutputSize.Y, EFidelityFXCASPixelFormat::RGBA32F);
+		FFidelityFXCASTestImage SingleTile(OutputSize.X, OutputSize.Y, EFidelityFXCASPixelFormat::RGBA32F);
+		FFidelityFXCASTestImage Reference(OutputSize.X, OutputSize.Y, EFidelityFXCASPixelFormat::RGBA32F);
+
+		// FP32 Low quality runs the kernel of the CPU engine
+		if (!TestTrue(*FString::Printf(TEXT("Tiled pass %s"), *Case), Module.ProcessImageTiled(Input.View, Tiled.View, 0.5f, false, EFidelityFXCASQuality::Low, TileSize))
+			|| !TestTrue(*FString::Printf(TEXT("Single tile pass %s"), *Case), Module.ProcessImageTiled(Input.View, SingleTile.View, 0.5f, false, EFidelityFXCASQuality::Low, 1 << 16)))
+		{
+			continue;
+		}
+		FFidelityFXCASCPUSettings Settings;
+		Settings.Sharpness = 0.5f;
+		Settings.bAllowSIMD = false;
+		TestTrue(*FString::Printf(TEXT("CPU pass %s"), *Case), FFidelityFXCASCPUModule::Get().Process(Input.View, Reference.View, Settings));
+
+		// The same shader on the same gathered pixels, the seams must not show at all
+		if (!Tiled.IsIdentical(SingleTile))
+			AddError(FString::Printf(TEXT("Tiles differ from a single tile %s: %s"), *Case, *Tiled.DescribeDifferences(SingleTile)));
+
+		// The edge clamp of the gather matches the CPU engine, only the GPU float math and the CPU fixed ratio kernels differ
+		FFidelityFXCASImageDifference Difference;
+		FFidelityFXCASCPUModule::Get().ComputeDifference(Tiled.View, Reference.View, Difference);
+		TestTrue(*FString::Printf(TEXT("Tiled pass close to the CPU engine %s (max error %f)"), *Case, Difference.MaxAbsError), Difference.MaxAbsError <= 1.0f / 255.0f);
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -4,6 +4,35 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/ThreadSafeCounter64.h"
+#include "FidelityFXCASTypes.h"
+#include "FidelityFXCASCPUTypes.h"
+#include "FidelityFXCASResolutionController.h"
+
+struct FFidelityFXCASDispatch;
+
+// Texture, duration in milliseconds (see UFidelityFXCASTopMipProviderFactory)
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnFidelityFXCASTopMipRebuilt, class UTexture*, float);
+
+// Pixels of an asynchronous readback, delivered on a worker thread (see FFidelityFXCASModule::RequestReadback)
+struct FFidelityFXCASReadbackResult
+{
+	TArray64<uint8> Pixels;					// Rows of Size.X pixels without padding, top-down
+	FIntPoint Size = FIntPoint::ZeroValue;
+	EPixelFormat Format = PF_Unknown;		// Format of the render target, or PF_R8G8B8A8 for a compressed copy
+	FIntRect SourceRect;					// Region of the render target
+	bool bSuccess = false;					// False if the render target was gone or had no RHI texture, the pixels are empty
+};
+DECLARE_DELEGATE_OneParam(FOnFidelityFXCASReadback, const FFidelityFXCASReadbackResult&);
+
+// What is copied by a readback
+struct FFidelityFXCASReadbackSettings
+{
+	FIntRect SourceRect;					// Region of the render target, empty for all of it
+	bool bCompressToRGBA8 = false;			// Converts wider formats (i.e. RGBA16f) to RGBA8 on the GPU before the copy, 2-4x less to transfer
+};
 
 class FIDELITYFXCAS_API FFidelityFXCASModule : public IModuleInterface
 {
@@ -25,19 +54,241 @@ public:
 	FORCEINLINE void EnableSSCAS()  { SetIsSSCASEnabled(true); }
 	FORCEINLINE void DisableSSCAS() { SetIsSSCASEnabled(false); }
 	void UpdateSSCASEnabled();
+	// Renderer callback running SS CAS for the settings, the engine features compiled in decide between them. Foveation and the
+	// sharpness mask (bNeedsRHIPass) only run on the RHI pass of the resolved scene color callback, which then replaces the view extension.
+	enum class ESSCASCallback : uint8 { None, ResolvedSceneColor, CustomUpscale, ViewExtension };
+	static ESSCASCallback ChooseSSCASCallback(bool bEnabled, bool bUseViewExtension, float ScreenPercentage, bool bNeedsRHIPass = false);
+	// Rebinds through the backend when Callback differs from BoundCallback, which is then updated. True on a rebind.
+	// UpdateSSCASEnabled() binds the renderer callbacks with it, the recording backend counts the rebinds.
+	static bool BindSSCASCallback(ESSCASCallback Callback, ESSCASCallback& BoundCallback, class IFidelityFXCASPassBackend& Backend);
 protected:
+	friend class FFidelityFXCASSSCASCallbackBackend;
 	bool bIsSSCASEnabled;
+	// Renderer callback currently bound, so resolution changes only rebind when the upscale mode changes
+	ESSCASCallback BoundSSCASCallback = ESSCASCallback::None;
+
+	// Post tonemap scene view extension (FidelityFXCASViewExtension.cpp, r.fxcas.ViewExtension): CAS on the display referred colors,
+	// and CAS upscaling as the primary spatial upscaler from UE v4.27, without engine changes. Replaces the resolved scene color callback.
+public:
+	bool GetUseViewExtension() const { return bUseViewExtension; }
+	void SetUseViewExtension(bool UseViewExtension);
+protected:
+	bool bUseViewExtension = true;
+#if FX_CAS_PLUGIN_ENABLED && FX_CAS_VIEW_EXTENSION
+	friend class FFidelityFXCASViewExtension;
+	friend class FFidelityFXCASSpatialUpscaler;
+	TSharedPtr<class FFidelityFXCASViewExtension, ESPMode::ThreadSafe> ViewExtension;	// Registered when first bound, inactive while not bound
+#endif // FX_CAS_PLUGIN_ENABLED && FX_CAS_VIEW_EXTENSION
 
 	// Screen space shader params
 public:
 	float GetSSCASSharpness() const { return SSCASSharpness; }
 	void SetSSCASSharpness(float Sharpness);
+	EFidelityFXCASQuality GetSSCASQuality() const { return SSCASQuality; }
+	void SetSSCASQuality(EFidelityFXCASQuality Quality);
 	bool GetUseFP16() const { return bUseFP16; }
 	void SetUseFP16(bool UseFP16);
 protected:
 	float SSCASSharpness = 0.5f;
+	EFidelityFXCASQuality SSCASQuality = EFidelityFXCASQuality::Low;
 	bool bUseFP16 = false;
 
+	// CAS-aware dynamic resolution, drives r.ScreenPercentage from the GPU frame time (r.fxcas.DRS)
+public:
+	bool GetIsDRSEnabled() const { return bIsDRSEnabled; }
+	void SetIsDRSEnabled(bool Enabled);
+	FFidelityFXCASResolutionController& GetResolutionController() { return ResolutionController; }
+	// Sharpness used by the SS CAS passes, follows the upscale ratio while DRS is enabled
+	float GetSSCASEffectiveSharpness() const { return bIsDRSEnabled ? ResolutionController.GetSharpness() : SSCASSharpness; }
+protected:
+	bool bIsDRSEnabled = false;
+	FFidelityFXCASResolutionController ResolutionController;
+	FDelegateHandle DRSTickerHandle;
+	bool TickDRS(float DeltaTime);
+
+	// Startup auto-tuner, times the FP32 and FP16 shaders of every quality tier and keeps the faster precision (r.fxcas.AutoTune)
+public:
+	void SetAutoTune(int32 Mode);	// 0: off, 1: apply the saved result or calibrate once, 2: calibrate again
+	bool LoadAutoTuneResult();		// Applies the result saved for the current GPU, false if there is none
+	// Measured GPU time of one pass of a quality tier at the calibration resolution, in milliseconds. 0 if not measured (yet).
+	float GetQualityTierMilliseconds(EFidelityFXCASQuality Quality, bool bFP16) const;
+protected:
+	FThreadSafeBool bAutoTunePending;
+	float AutoTuneTierMilliseconds[2][FX_CAS_NUM_QUALITY_TIERS] = {};	// [FP32, FP16][Quality], game thread
+#if FX_CAS_PLUGIN_ENABLED
+	void RunAutoTune_RenderThread(FRHICommandListImmediate& RHICmdList, const FIntPoint& InputSize, const FIntPoint& OutputSize, EFidelityFXCASQuality Quality);
+#endif // FX_CAS_PLUGIN_ENABLED
+
+	// Async compute scheduling of the screen space CAS pass with upscaling (RDG, r.fxcas.AsyncCompute)
+public:
+	bool GetUseAsyncCompute() const { return bUseAsyncCompute; }
+	void SetUseAsyncCompute(bool UseAsyncCompute);
+	// Pipe the SS CAS compute pass runs on with the current settings, falls back to the graphics pipe where async compute is unsupported
+	EFidelityFXCASComputePipe GetSSCASComputePipe() const;
+protected:
+	bool bUseAsyncCompute = false;
+
+	// Foveated screen space CAS without upscaling (FidelityFXCASFoveated.cpp, r.fxcas.Foveation): full CAS around the focus regions,
+	// the Low tier up to their outer ellipses and a plain copy beyond, chosen per 16x16 tile with FFidelityFXCASCPUModule::ClassifyTiles()
+	// Only the RHI pass of the resolved scene color callback is foveated, it replaces the view extension while foveation is on. The upscale
+	// pass runs the whole frame.
+public:
+	// Eye tracking updates the regions every frame, from any thread. No regions: the whole frame runs full CAS.
+	void SetSSCASFoveation(const FFidelityFXCASFoveation& Foveation);
+	FFidelityFXCASFoveation GetSSCASFoveation() const;
+protected:
+	mutable FCriticalSection FoveationCS;
+	FFidelityFXCASFoveation SSCASFoveation;
+#if FX_CAS_PLUGIN_ENABLED
+	// One dispatch per tile class over the uploaded tile lists, called by RunComputeShader_RHI_RenderThread()
+	void RunComputeShaderFoveated_RHI_RenderThread(FRHICommandListImmediate& RHICmdList, const class FFidelityFXCASPassParams_RHI& CASPassParams,
+		const TArray<FFidelityFXCASDispatch>& Dispatches);
+	// Storage of the tile classification, the pass plan classifies into it and the upload reads it
+	FFidelityFXCASTileClassification& GetFoveatedTileClassification_RenderThread();
+	void UploadFoveatedTileLists_RenderThread(const FFidelityFXCASTileClassification& Classification);
+#endif // FX_CAS_PLUGIN_ENABLED
+
+	// Per pixel sharpness mask (FidelityFXCASSharpnessMask.cpp): scales the CAS peak inside the kernel, so UI overlays, text or depth of field
+	// regions are left unsharpened without a blend pass and without keeping the unsharpened image
+public:
+	// Any texture (red channel in [0, 1], typically a low resolution render target), null to sharpen the whole frame uniformly.
+	// The current RHI resource of the texture is used, set it again after the texture was recreated or resized. Game thread.
+	void SetSSCASSharpnessMask(class UTexture* Mask);
+	bool HasSSCASSharpnessMask() const { return bHasSSCASSharpnessMask; }
+protected:
+	bool bHasSSCASSharpnessMask = false;
+#if FX_CAS_PLUGIN_ENABLED
+public:
+	void SetSSCASSharpnessMask_RenderThread(const FTextureRHIRef& Mask) { SSCASSharpnessMask = Mask; }
+protected:
+	FTextureRHIRef SSCASSharpnessMask;
+	// Masked permutations of the RHI pass, called by RunComputeShader_RHI_RenderThread()
+	void RunComputeShaderMasked_RHI_RenderThread(FRHICommandListImmediate& RHICmdList, const class FFidelityFXCASPassParams_RHI& CASPassParams,
+		const TArray<FFidelityFXCASDispatch>& Dispatches);
+#endif // FX_CAS_PLUGIN_ENABLED
+
+	// Sharpened mip chain generation (FidelityFXCASMipChain.cpp)
+#if FX_CAS_PLUGIN_ENABLED
+public:
+	// Replaces mips 1..N of a RGBA16f texture with box downsampled and CAS sharpened levels of mip 0, all levels in one dispatch
+	void GenerateSharpenedMips_RenderThread(FRHICommandListImmediate& RHICmdList, const FTextureRHIRef& Texture, float Sharpness, EFidelityFXCASQuality Quality);
+protected:
+	TRefCountPtr<IPooledRenderTarget> MipChainAtlas;		// Sharpened levels, copied to the mips after the dispatch
+	TRefCountPtr<IPooledRenderTarget> MipChainBoxAtlas;		// Unsharpened levels the next ones are downsampled from
+#endif // FX_CAS_PLUGIN_ENABLED
+
+	// Top mip rebuild (FidelityFXCASMipRebuild.cpp, r.fxcas.MipRebuildBudget): textures carrying a UFidelityFXCASTopMipProviderFactory get the
+	// top mip the streamer requests without a shipped payload as a 2x CAS upscale of the mip below, written into the streamer's memory of mip 0.
+	// The rebuilds are queued by the provider and started on worker threads as many per frame as the budget allows.
+public:
+	const FFidelityFXCASMipRebuildStats& GetMipRebuildStats() const { return MipRebuildStats; }
+	// Estimated rebuild time started per frame, in milliseconds. At least one rebuild is started every frame.
+	float GetMipRebuildBudget() const { return MipRebuildBudget; }
+	void SetMipRebuildBudget(float Milliseconds);
+	// Broadcast on the game thread after every rebuild with its CPU engine time
+	FOnFidelityFXCASTopMipRebuilt OnTopMipRebuilt;
+protected:
+	friend class FFidelityFXCASTopMipDataProvider;
+	// Called by the mip data provider from the streamer's threads
+	void QueueTopMipRebuild(const TSharedRef<struct FFidelityFXCASTopMipRebuild, ESPMode::ThreadSafe>& Rebuild);
+	FCriticalSection MipRebuildQueueCS;
+	TArray<TSharedRef<struct FFidelityFXCASTopMipRebuild, ESPMode::ThreadSafe>> MipRebuildQueue;
+	FFidelityFXCASMipRebuildStats MipRebuildStats;
+	float MipRebuildBudget = 1.0f;
+	FDelegateHandle MipRebuildTickerHandle;
+	bool TickMipRebuild(float DeltaTime);
+	void CancelTopMipRebuilds();	// Fails the queued rebuilds and stops the ticker
+	void OnTopMipRebuildDone(const TWeakObjectPtr<class UTexture>& Texture, float Megapixels, float Milliseconds, bool bRebuilt);
+
+	// Asynchronous readback (FidelityFXCASReadback.cpp, r.fxcas.ReadbackRingSize): copies to a ring of staging textures, polls
+	// their fences on the render thread in later frames and delivers the pixels to the callback on a worker thread, no flush or stall
+public:
+	// Reads back the render target as it is after the render commands enqueued so far (i.e. after DrawToRenderTarget). Game thread.
+	bool RequestReadback(class UTextureRenderTarget2D* RenderTarget, const FFidelityFXCASReadbackSettings& Settings, FOnFidelityFXCASReadback Callback);
+	// Snapshot of the counters, any thread (they are updated on the render thread)
+	FFidelityFXCASReadbackStats GetReadbackStats() const;
+	// Staging textures in flight at most, a request beyond waits for the oldest copy. Game thread, the render thread gets the size in order with the requests.
+	int32 GetReadbackRingSize() const { return ReadbackRingSize; }
+	void SetReadbackRingSize(int32 Size);
+#if FX_CAS_PLUGIN_ENABLED
+	void RequestReadback_RenderThread(FRHICommandListImmediate& RHICmdList, const FTextureRHIRef& Texture, const FFidelityFXCASReadbackSettings& Settings,
+		FOnFidelityFXCASReadback Callback);
+#endif // FX_CAS_PLUGIN_ENABLED
+protected:
+	int32 ReadbackRingSize = 4;
+	int32 ReadbackRingSize_RenderThread = 4;	// Set from SetReadbackRingSize() with a render command
+	FThreadSafeCounter NumReadbacksInFlight;	// Keeps the ticker polling, the ring itself is only touched on the render thread
+	FThreadSafeCounter NumReadbacksCompleted;
+	FThreadSafeCounter NumReadbackStalls;
+	FThreadSafeCounter64 NumReadbackBytes;
+	FDelegateHandle ReadbackTickerHandle;
+	bool TickReadback(float DeltaTime);
+#if FX_CAS_PLUGIN_ENABLED
+	struct FReadbackSlot
+	{
+		FTexture2DRHIRef StagingTexture;	// Reused while the size and the format stay the same
+		FGPUFenceRHIRef Fence;
+		FOnFidelityFXCASReadback Callback;
+		FIntRect SourceRect;
+		bool bInFlight = false;
+		uint64 Sequence = 0;				// Issue order, the oldest slot is waited for when the ring is full
+	};
+	TArray<FReadbackSlot> ReadbackRing;
+	uint64 ReadbackSequence = 0;
+	TRefCountPtr<IPooledRenderTarget> ReadbackConversion;	// RGBA8 copy of the render target for compressed readbacks
+	void PollReadbacks_RenderThread(FRHICommandListImmediate& RHICmdList);
+	void CompleteReadback_RenderThread(FRHICommandListImmediate& RHICmdList, FReadbackSlot& Slot);
+#endif // FX_CAS_PLUGIN_ENABLED
+
+	// Tiled processing of images larger than the GPU texture limits (FidelityFXCASTiled.cpp)
+public:
+	// Runs CAS on CPU memory images of any size on the GPU, one output tile (and the input pixels it reads) at a time, blocking the game thread.
+	// Seamless, same result as a single dispatch inside the image, the image edges are clamped like the CPU engine does. Falls back to the CPU engine without a GPU
+	// or for formats the shader can't load as they are (sRGB, RGB32F, BGRA). Input and Output must not overlap.
+	// OutGPUMilliseconds gets the GPU time of the tile dispatches alone (timestamp queries, without the uploads and the readbacks),
+	// or -1 when the images were processed on the CPU or the RHI has no timestamp queries.
+	bool ProcessImageTiled(const struct FFidelityFXCASImageView& Input, const struct FFidelityFXCASImageView& Output, float Sharpness,
+		bool bInUseFP16 = false, EFidelityFXCASQuality Quality = EFidelityFXCASQuality::Low, int32 TileSize = 4096, float* OutGPUMilliseconds = nullptr);
+	// True if ProcessImageTiled runs these views on the GPU instead of falling back to the CPU engine
+	static bool CanProcessImageTiledOnGPU(const struct FFidelityFXCASImageView& Input, const struct FFidelityFXCASImageView& Output);
+#if FX_CAS_PLUGIN_ENABLED
+protected:
+	// Ring of tiles in flight (render thread): a tile is uploaded and dispatched while the previous ones are copied to their staging
+	// textures, a slot is read back once its fence passed or when the ring is full
+	struct FTileSlot
+	{
+		FTexture2DRHIRef SourceTexture;				// Sized for the largest tile of the call
+		TRefCountPtr<IPooledRenderTarget> Output;
+		FTexture2DRHIRef StagingTexture;
+		FGPUFenceRHIRef Fence;
+		FIntRect TileRect;							// Output pixels of the tile in the image
+		FRenderQueryRHIRef BeginQuery;				// Timestamps around the dispatch, only when the GPU time is requested
+		FRenderQueryRHIRef EndQuery;
+		bool bInFlight = false;
+		uint64 Sequence = 0;
+	};
+	TArray<FTileSlot> TileRing;
+	uint64 TileSequence = 0;
+	uint64 TileGPUMicroseconds = 0;					// Sum of the timed dispatches of the call
+	bool bTileGPUTimeValid = false;
+	void PollTiles_RenderThread(FRHICommandListImmediate& RHICmdList, const struct FFidelityFXCASImageView& Output);
+	void CompleteTile_RenderThread(FRHICommandListImmediate& RHICmdList, FTileSlot& Slot, const struct FFidelityFXCASImageView& Output);
+#endif // FX_CAS_PLUGIN_ENABLED
+
+	// Luma only CAS for planar YUV video frames
+#if FX_CAS_PLUGIN_ENABLED
+public:
+	// Sharpens (or scales) a single channel luma plane texture (i.e. PF_G8 for NV12 / I420) without any color conversion.
+	// OutputLuma must be a single channel texture (its size sets the scale), the CS output is copied to it.
+	void ProcessLuma_RenderThread(FRHICommandListImmediate& RHICmdList, const FTextureRHIRef& InputLuma, const FTextureRHIRef& OutputLuma,
+		float Sharpness, bool bInUseFP16 = false, EFidelityFXCASQuality Quality = EFidelityFXCASQuality::Low);
+	// Passes a chroma plane (U, V or the interleaved UV of NV12) through to the output, bilinearly resampled if the sizes differ.
+	// OutputChroma must be a render target of the same format.
+	void ResampleChroma_RenderThread(FRHICommandListImmediate& RHICmdList, const FTextureRHIRef& InputChroma, const FTextureRHIRef& OutputChroma);
+protected:
+	TRefCountPtr<IPooledRenderTarget> LumaOutput;
+#endif // FX_CAS_PLUGIN_ENABLED
+
 #if FX_CAS_PLUGIN_ENABLED
 	// SSCAS callbacks management
 	void BindResolvedSceneColorCallback(IRendererModule* RendererModule);   // No upscale
@@ -52,8 +303,9 @@ protected:
 #if FX_CAS_CUSTOM_UPSCALE_CALLBACK
 	TRefCountPtr<IPooledRenderTarget> ComputeShaderOutput_RDG;
 #endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK
+	// ArraySize > 0 creates a texture array output for RunComputeShaderArray_RHI_RenderThread
 	void PrepareComputeShaderOutput_RenderThread(FRHICommandListImmediate& RHICmdList, const FIntPoint& OutputSize,
-		TRefCountPtr<IPooledRenderTarget>& CSOutput, const TCHAR* InDebugName = nullptr);
+		TRefCountPtr<IPooledRenderTarget>& CSOutput, const TCHAR* InDebugName = nullptr, int32 ArraySize = 0, EPixelFormat Format = PF_FloatRGBA);
 #endif // FX_CAS_PLUGIN_ENABLED
 public:
 	// Allows early initialization of compute shader outputs (i.e. during loading)
@@ -71,20 +323,43 @@ protected:
 	void OnAddUpscalePass_RenderThread(class FRDGBuilder& GraphBuilder, const FIntRect& InInputViewRect, class FRDGTexture* SceneColor, const FRenderTargetBinding& RTBinding);
 #endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK
 
-	// Compute shader call
+#if FX_CAS_VIEW_EXTENSION
+	// SSCAS (post tonemap, with or without upscale) from the scene view extension (RDG), the CS writes OutputViewRect of Output
+	void OnViewExtensionPass_RenderThread(class FRDGBuilder& GraphBuilder, const FIntRect& InInputViewRect, class FRDGTexture* SceneColor, const FIntRect& OutputViewRect, class FRDGTexture* Output);
+#endif // FX_CAS_VIEW_EXTENSION
+
+	// Compute shader call, the pass plan (FidelityFXCASPassBackend.h) chooses the permutation and the dispatches
 	void RunComputeShader_RHI_RenderThread(FRHICommandListImmediate& RHICmdList, const class FFidelityFXCASPassParams_RHI& CASPassParams);
-#if FX_CAS_CUSTOM_UPSCALE_CALLBACK
-	void RunComputeShader_RDG_RenderThread(FRDGBuilder& GraphBuilder, const class FFidelityFXCASPassParams_RDG& CASPassParams);
-#endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK
-	static FIntVector GetDispatchGroupCount(FIntPoint OutputSize);
+	// Texture array or volume input, all slices in one dispatch into the texture array CS output
+	void RunComputeShaderArray_RHI_RenderThread(FRHICommandListImmediate& RHICmdList, const class FFidelityFXCASPassParams_RHI& CASPassParams);
+	// Issue the planned dispatches of the uniform and the array passes
+	void DispatchComputeShader_RHI_RenderThread(FRHICommandListImmediate& RHICmdList, const class FFidelityFXCASPassParams_RHI& CASPassParams,
+		const TArray<FFidelityFXCASDispatch>& Dispatches);
+	void DispatchComputeShaderArray_RHI_RenderThread(FRHICommandListImmediate& RHICmdList, const class FFidelityFXCASPassParams_RHI& CASPassParams,
+		const TArray<FFidelityFXCASDispatch>& Dispatches);
+	friend class FFidelityFXCASRHIPassBackend;
+#if FX_CAS_CUSTOM_UPSCALE_CALLBACK || FX_CAS_VIEW_EXTENSION
+	void RunComputeShader_RDG_RenderThread(class FRDGBuilder& GraphBuilder, const class FFidelityFXCASPassParams_RDG& CASPassParams);
+#endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK || FX_CAS_VIEW_EXTENSION
 
 	// Pixel shader draw
 	void DrawToRenderTarget_RHI_RenderThread(FRHICommandListImmediate& RHICmdList, const class FFidelityFXCASPassParams_RHI& CASPassParams);
+	// Point sampled full target draw of a texture (a format conversion at the same size), only inside ScissorRects if there are any
+	void DrawTextureToRenderTarget_RHI_RenderThread(FRHICommandListImmediate& RHICmdList, const FTextureRHIRef& Texture, const FTextureRHIRef& RenderTarget,
+		const TArray<FIntRect>& ScissorRects = TArray<FIntRect>());
+	// Copies all slices of the texture array CS output to the render target array, which must have the same format
+	void CopyToRenderTargetArray_RHI_RenderThread(FRHICommandListImmediate& RHICmdList, const class FFidelityFXCASPassParams_RHI& CASPassParams);
 #if FX_CAS_CUSTOM_UPSCALE_CALLBACK
 	void DrawToRenderTarget_RDG_RenderThread(FRDGBuilder& GraphBuilder, const class FFidelityFXCASPassParams_RDG& CASPassParams);
 #endif // FX_CAS_CUSTOM_UPSCALE_CALLBACK
 #endif // FX_CAS_PLUGIN_ENABLED
 
+public:
+	// Thread groups of the CAS compute shaders, shared with the pass plans (FidelityFXCASPassBackend.cpp)
+	static FIntVector GetDispatchGroupCount(FIntPoint OutputSize);
+	static FIntRect GetDispatchGroupRect(const FIntRect& OutputRect);	// Thread groups covering an output region
+protected:
+
 	// Resolution info
 	mutable FCriticalSection ResolutionInfoCS;
 	FIntPoint InputResolution;
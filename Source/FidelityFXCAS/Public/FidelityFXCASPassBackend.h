@@ -0,0 +1,181 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PixelFormat.h"
+#include "FidelityFXCAS.h"
+#include "FidelityFXCASTypes.h"
+#include "FidelityFXCASCPUTypes.h"
+
+// Pass plans: the choices of the compute passes (permutation, barrier, dispatches, tile lists and CS output reallocation) are made
+// here without any RHI object, the RHI and RDG backends issue them and the recording backend counts them. Compiled on every platform, so the
+// render thread logic can be checked on machines without a GPU and where the plugin is disabled.
+
+// Scale ratios with a dedicated compute shader permutation (CAS_SAMPLE_FIXED_RATIO): the upscales have the scale constants compiled in,
+// the downscales beyond 2x box filter the input in CasLoad() (CAS_SAMPLE_PREFILTER)
+enum class EFidelityFXCASFixedRatio : int32
+{
+	None = 0,
+	Upscale2x = 1,				// i.e. 1920x1080 -> 3840x2160
+	Upscale3_2 = 2,				// 1.5x, i.e. 1280x720 -> 1920x1080
+	Upscale4_3 = 3,				// i.e. 1920x1080 -> 2560x1440
+	DownscalePrefiltered = 4,	// More than 2x smaller on an axis, i.e. 3840x2160 -> 256x144, see FFidelityFXCASCPUModule::GetPrefilterSize()
+};
+
+FORCEINLINE EFidelityFXCASFixedRatio GetFidelityFXCASFixedRatio(const FIntPoint& InputSize, const FIntPoint& OutputSize)
+{
+	if (InputSize.X > OutputSize.X * 2 || InputSize.Y > OutputSize.Y * 2)
+		return EFidelityFXCASFixedRatio::DownscalePrefiltered;
+	if (InputSize * 2 == OutputSize)
+		return EFidelityFXCASFixedRatio::Upscale2x;
+	if (InputSize * 3 == OutputSize * 2)
+		return EFidelityFXCASFixedRatio::Upscale3_2;
+	if (InputSize * 4 == OutputSize * 3)
+		return EFidelityFXCASFixedRatio::Upscale4_3;
+	return EFidelityFXCASFixedRatio::None;
+}
+
+// The FP16 shaders always use exact math on HLSL (ffx_cas.ush forces CAS_GO_SLOWER), so Ultra is the same as High
+FORCEINLINE EFidelityFXCASQuality GetFidelityFXCASShaderQuality(EFidelityFXCASQuality Quality, bool bFP16)
+{
+	return (bFP16 && Quality > EFidelityFXCASQuality::High) ? EFidelityFXCASQuality::High : Quality;
+}
+
+// RHI compute pass variants, see FFidelityFXCASModule::RunComputeShader_RHI_RenderThread()
+enum class EFidelityFXCASPassKind : uint8
+{
+	Uniform,	// Whole output or dirty regions
+	Masked,		// Per pixel sharpness mask
+	Foveated,	// One dispatch per tile class over the uploaded tile lists
+	Array,		// Texture array or volume input, all slices in one dispatch
+};
+
+// Compute shader permutation of a dispatch
+struct FIDELITYFXCAS_API FFidelityFXCASPermutation
+{
+	EFidelityFXCASPassKind Kind = EFidelityFXCASPassKind::Uniform;
+	bool bFP16 = false;
+	bool bSharpenOnly = false;
+	bool bVolume = false;				// Array passes with a volume input
+	bool bBilinear = false;				// Foveated periphery tiles, a plain resample
+	EFidelityFXCASFixedRatio FixedRatio = EFidelityFXCASFixedRatio::None;
+	EFidelityFXCASQuality Quality = EFidelityFXCASQuality::Low;	// Shader quality, after the FP16 fallback
+
+	bool operator==(const FFidelityFXCASPermutation& Other) const;
+	bool operator!=(const FFidelityFXCASPermutation& Other) const { return !(*this == Other); }
+	FString ToString() const;
+};
+
+// One dispatch of a pass, the dispatches of a pass share the shader parameters
+struct FFidelityFXCASDispatch
+{
+	FFidelityFXCASPermutation Permutation;
+	FIntPoint GroupOffset = FIntPoint::ZeroValue;	// First thread group, dirty regions only
+	FIntVector GroupCount = FIntVector(0, 0, 1);
+	uint32 TileListOffset = 0;						// Foveated passes: first tile of the dispatch in the uploaded lists
+};
+
+// What a compute pass is asked to do, without the RHI resources (FFidelityFXCASPassParams_RHI / _RDG::GetPassDesc)
+struct FFidelityFXCASPassDesc
+{
+	FIntPoint InputSize = FIntPoint::ZeroValue;
+	FIntPoint OutputSize = FIntPoint::ZeroValue;
+	bool bUseFP16 = false;
+	EFidelityFXCASQuality Quality = EFidelityFXCASQuality::Low;
+	TArray<FIntRect> DirtyRects;
+	bool bHasSharpnessMask = false;
+	FFidelityFXCASFoveation Foveation;
+	bool bArray = false;					// RunComputeShaderArray_RHI_RenderThread()
+	bool bInputVolume = false;
+	int32 NumSlices = 1;
+	FFidelityFXCASTileClassification* TileClassification = nullptr;	// Kept by the caller so steady state foveation does not allocate, optional
+};
+
+// Size and format of a pooled CS output, a different one replaces it (see PrepareComputeShaderOutput_RenderThread)
+struct FIDELITYFXCAS_API FFidelityFXCASOutputDesc
+{
+	FIntPoint Size = FIntPoint::ZeroValue;
+	int32 ArraySize = 0;					// > 0 for a texture array
+	EPixelFormat Format = PF_FloatRGBA;
+
+	FFidelityFXCASOutputDesc() { }
+	FFidelityFXCASOutputDesc(const FIntPoint& InSize, int32 InArraySize, EPixelFormat InFormat) : Size(InSize), ArraySize(InArraySize), Format(InFormat) { }
+
+	bool operator==(const FFidelityFXCASOutputDesc& Other) const { return Size == Other.Size && ArraySize == Other.ArraySize && Format == Other.Format; }
+	bool operator!=(const FFidelityFXCASOutputDesc& Other) const { return !(*this == Other); }
+	int64 GetBytes() const;
+	// Current is null while there is no output. Shared by PrepareComputeShaderOutput_RenderThread and the recording backend.
+	static bool NeedsRecreate(const FFidelityFXCASOutputDesc* Current, const FFidelityFXCASOutputDesc& Wanted) { return !Current || *Current != Wanted; }
+};
+
+// Receives the plan of a compute pass
+class FIDELITYFXCAS_API IFidelityFXCASPassBackend
+{
+public:
+	virtual ~IFidelityFXCASPassBackend() { }
+
+	// UAV barrier on the CS output before the pass writes it (graphics to compute)
+	virtual void OutputBarrier() = 0;
+	// Tile lists of a foveated pass, 4 bytes per tile, before its dispatches
+	virtual void UploadTileLists(const FFidelityFXCASTileClassification& Classification) = 0;
+	// All the dispatches of a pass
+	virtual void DispatchPass(const TArray<FFidelityFXCASDispatch>& Dispatches) = 0;
+	// Renderer callback change of the screen space CAS, see FFidelityFXCASModule::BindSSCASCallback(). The pass backends ignore it.
+	virtual void RebindSSCASCallback(FFidelityFXCASModule::ESSCASCallback From, FFidelityFXCASModule::ESSCASCallback To) { }
+};
+
+// Permutation chosen for a pass (the first class of a foveated pass), same rules as the shaders compiled for the platform (FX_CAS_FP16_ENABLED)
+FIDELITYFXCAS_API FFidelityFXCASPermutation GetFidelityFXCASPermutation(const FFidelityFXCASPassDesc& Desc);
+// Plans a compute pass into the backend
+FIDELITYFXCAS_API void BuildFidelityFXCASComputePass(const FFidelityFXCASPassDesc& Desc, IFidelityFXCASPassBackend& Backend);
+
+// Counts of a recorded frame
+struct FIDELITYFXCAS_API FFidelityFXCASPassCounters
+{
+	int32 NumPasses = 0;
+	int32 NumDispatches = 0;
+	int64 NumThreadGroups = 0;
+	int32 NumBarriers = 0;
+	int32 NumAllocations = 0;				// CS outputs created, replacements included
+	int64 AllocatedBytes = 0;
+	int64 UploadedBytes = 0;				// Foveated tile lists
+	int32 NumCallbackRebinds = 0;			// Renderer callback changes of the screen space CAS
+
+	bool operator==(const FFidelityFXCASPassCounters& Other) const;
+	bool operator!=(const FFidelityFXCASPassCounters& Other) const { return !(*this == Other); }
+	FString ToString() const;
+};
+
+// Stand-in backend: records the plans instead of issuing them, so the dispatch, barrier, allocation and byte counts of a scenario can be
+// compared with a baseline without a GPU. Also replays the CS output reallocation and the SS CAS callback rebinding of the module.
+class FIDELITYFXCAS_API FFidelityFXCASRecordingPassBackend : public IFidelityFXCASPassBackend
+{
+public:
+	// IFidelityFXCASPassBackend
+	virtual void OutputBarrier() override;
+	virtual void UploadTileLists(const FFidelityFXCASTileClassification& Classification) override;
+	virtual void DispatchPass(const TArray<FFidelityFXCASDispatch>& Dispatches) override;
+	virtual void RebindSSCASCallback(FFidelityFXCASModule::ESSCASCallback From, FFidelityFXCASModule::ESSCASCallback To) override;
+
+	// Same decision as PrepareComputeShaderOutput_RenderThread for the output of that name
+	void PrepareOutput(const FName& Name, const FFidelityFXCASOutputDesc& Desc);
+	// Callback chosen by FFidelityFXCASModule::ChooseSSCASCallback(), through the same FFidelityFXCASModule::BindSSCASCallback() as the module
+	void BindSSCASCallback(FFidelityFXCASModule::ESSCASCallback Callback);
+
+	// Ends the current frame, its counters are added to the recorded frames
+	void EndFrame();
+	const FFidelityFXCASPassCounters& GetFrameCounters() const { return FrameCounters; }
+	const TArray<FFidelityFXCASDispatch>& GetFrameDispatches() const { return FrameDispatches; }
+	const TArray<FFidelityFXCASPassCounters>& GetRecordedFrames() const { return RecordedFrames; }
+	// Forgets the frames, the outputs and the bound callback
+	void Reset();
+
+	// Lists the frames whose counters differ from the baseline (a different number of frames too), true if none does
+	static bool CompareFrames(const TArray<FFidelityFXCASPassCounters>& Baseline, const TArray<FFidelityFXCASPassCounters>& Frames, FString& OutReport);
+
+protected:
+	FFidelityFXCASPassCounters FrameCounters;
+	TArray<FFidelityFXCASDispatch> FrameDispatches;
+	TArray<FFidelityFXCASPassCounters> RecordedFrames;
+	TMap<FName, FFidelityFXCASOutputDesc> Outputs;
+	FFidelityFXCASModule::ESSCASCallback BoundCallback = FFidelityFXCASModule::ESSCASCallback::None;
+};
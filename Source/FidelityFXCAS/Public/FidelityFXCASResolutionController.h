@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FFidelityFXCASResolutionControllerSettings
+{
+	// GPU frame time budget in milliseconds
+	float TargetFrameTime = 16.67f;
+	// Bounds of the render resolution (r.ScreenPercentage)
+	float MinScreenPercentage = 50.0f;
+	float MaxScreenPercentage = 100.0f;
+	// Hysteresis band as fractions of the budget: the resolution drops above the upper bound, rises below the lower one and holds in between
+	float UpperThreshold = 1.0f;
+	float LowerThreshold = 0.85f;
+	// Weight of the newest frame in the smoothed frame time (exponential moving average)
+	float Smoothing = 0.1f;
+	// Frames to hold after a change, so the frame time settles at the new resolution before the next decision
+	int32 CooldownFrames = 15;
+	// Largest change of the screen percentage in one step, and changes smaller than the minimum are skipped
+	float MaxStep = 10.0f;
+	float MinStep = 1.0f;
+	// CAS sharpness at the bounds, interpolated in between (sharper at lower resolution)
+	float SharpnessAtMinScreenPercentage = 0.8f;
+	float SharpnessAtMaxScreenPercentage = 0.4f;
+};
+
+// Dynamic resolution controller driving the CAS upscale: watches the GPU frame time against a budget, moves the screen percentage
+// within the configured bounds and maps the CAS sharpness to the resulting upscale ratio.
+// Engine independent, so it can be driven by simulated frame time traces.
+class FIDELITYFXCAS_API FFidelityFXCASResolutionController
+{
+public:
+	explicit FFidelityFXCASResolutionController(const FFidelityFXCASResolutionControllerSettings& InSettings = FFidelityFXCASResolutionControllerSettings());
+
+	const FFidelityFXCASResolutionControllerSettings& GetSettings() const { return Settings; }
+	void SetSettings(const FFidelityFXCASResolutionControllerSettings& InSettings);
+
+	// Starts over from the given screen percentage (clamped to the bounds) and forgets the frame time history
+	void Reset(float ScreenPercentage);
+
+	// Feeds the GPU time of one frame in milliseconds, returns true if the screen percentage changed
+	bool Update(float GPUFrameTime);
+
+	float GetScreenPercentage() const   { return ScreenPercentage; }
+	float GetSmoothedFrameTime() const  { return SmoothedFrameTime; }
+	// CAS sharpness for the current screen percentage
+	float GetSharpness() const;
+
+private:
+	FFidelityFXCASResolutionControllerSettings Settings;
+	float ScreenPercentage = 100.0f;
+	float SmoothedFrameTime = 0.0f;
+	int32 CooldownFramesLeft = 0;
+};
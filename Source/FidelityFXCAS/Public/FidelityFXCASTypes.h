@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FidelityFXCASTypes.generated.h"
+
+// CAS quality tiers, each one is a separate compute shader permutation selected at runtime (r.fxcas.Quality)
+UENUM(BlueprintType)
+enum class EFidelityFXCASQuality : uint8
+{
+	Low = 0		UMETA(DisplayName = "Low (default CAS)"),
+	Medium = 1	UMETA(DisplayName = "Medium (better diagonals)"),
+	High = 2	UMETA(DisplayName = "High (better diagonals, per channel weights)"),
+	Ultra = 3	UMETA(DisplayName = "Ultra (better diagonals, per channel weights, exact math)"),
+};
+#define FX_CAS_NUM_QUALITY_TIERS 4
+
+FORCEINLINE const TCHAR* GetFidelityFXCASQualityName(EFidelityFXCASQuality Quality)
+{
+	switch (Quality)
+	{
+	case EFidelityFXCASQuality::Low:    return TEXT("Low");
+	case EFidelityFXCASQuality::Medium: return TEXT("Medium");
+	case EFidelityFXCASQuality::High:   return TEXT("High");
+	case EFidelityFXCASQuality::Ultra:  return TEXT("Ultra");
+	default:                            return TEXT("Unknown");
+	}
+}
+
+// Pipe the screen space CAS compute pass is scheduled on (r.fxcas.AsyncCompute)
+enum class EFidelityFXCASComputePipe : uint8
+{
+	Graphics,			// Async compute not requested
+	AsyncCompute,		// Overlaps with the graphics work around it, RDG fences the PS pass reading the result
+	GraphicsFallback,	// Async compute requested, but not supported by the RHI or the engine version
+};
+
+FORCEINLINE const TCHAR* GetFidelityFXCASComputePipeName(EFidelityFXCASComputePipe Pipe)
+{
+	switch (Pipe)
+	{
+	case EFidelityFXCASComputePipe::Graphics:         return TEXT("Graphics");
+	case EFidelityFXCASComputePipe::AsyncCompute:     return TEXT("Async compute");
+	case EFidelityFXCASComputePipe::GraphicsFallback: return TEXT("Graphics (async compute unsupported)");
+	default:                                          return TEXT("Unknown");
+	}
+}
+
+// Top mip rebuild counters and cost estimates (FFidelityFXCASModule::GetMipRebuildStats)
+struct FFidelityFXCASMipRebuildStats
+{
+	int32 NumPending = 0;					// Requested by the streamer, waiting for the frame budget
+	int32 NumInFlight = 0;					// Running on a worker thread
+	int32 NumRebuilt = 0;
+	int32 NumFailed = 0;					// Failed reads or aborted stream-ins, the streamer cancels their update
+	float LastMilliseconds = 0.0f;			// CPU engine time of the last rebuild, without the read of the shipped mip
+	float TotalMilliseconds = 0.0f;
+	float CPUMillisecondsPerMegapixel = 15.0f;	// Output megapixel cost estimate the frame budget is spent with, updated from the measured times
+};
+
+// Asynchronous readback counters (FFidelityFXCASModule::GetReadbackStats), a snapshot of counters updated on the render thread
+struct FFidelityFXCASReadbackStats
+{
+	int32 NumInFlight = 0;		// Copied to a staging buffer, waiting for the GPU fence
+	int32 NumCompleted = 0;		// Delivered to their callback
+	int32 NumStalls = 0;		// Requests that found the ring full and waited for the oldest copy, grow the ring if this increases
+	int64 NumBytes = 0;			// Read back in total
+};
@@ -0,0 +1,36 @@
+using System.IO;
+using UnrealBuildTool;
+
+public class FidelityFXCASCPU : ModuleRules
+{
+    public FidelityFXCASCPU(ReadOnlyTargetRules Target) : base(Target)
+    {
+        PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+        // The CPU engine only depends on Core, so it can be used by commandlets, servers and tools without a GPU
+        PublicDependencyModuleNames.AddRange(
+            new string[]
+            {
+                "Core"
+            });
+
+        // The CPU kernels share CasSetup() and the constants layout with the shaders
+        PrivateIncludePaths.AddRange(
+            new string[]
+            {
+                Path.Combine(ModuleDirectory, "..", "..", "Shaders", "Private")
+            });
+
+        // SIMD kernels (AVX2 + F16C, selected at runtime) on x64 platforms
+        if (Target.Platform == UnrealTargetPlatform.Win64
+            || Target.Platform == UnrealTargetPlatform.Linux
+            || Target.Platform == UnrealTargetPlatform.Mac)
+        {
+            PrivateDefinitions.Add("FX_CAS_CPU_SIMD=1");
+        }
+        else
+        {
+            PrivateDefinitions.Add("FX_CAS_CPU_SIMD=0");
+        }
+    }
+}
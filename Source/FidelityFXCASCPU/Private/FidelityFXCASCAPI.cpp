@@ -0,0 +1,105 @@
+#include "FidelityFXCASCAPI.h"
+
+#include "FidelityFXCASCPU.h"
+#include "FidelityFXCASCPUContext.h"
+
+// The opaque C handle is the engine context
+struct FfxCasContext
+{
+	FFidelityFXCASCPUContext Context;
+
+	explicit FfxCasContext(int32 NumThreads)
+		: Context(NumThreads) { }
+};
+
+static bool ToImageView(const FfxCasImageView* View, const FfxCasRect* Rect, FFidelityFXCASImageView& OutView)
+{
+	if (!View || View->StructSize < sizeof(FfxCasImageView))
+		return false;
+
+	switch (View->Format)
+	{
+	case FFXCAS_PIXEL_FORMAT_RGBA32F: OutView.Format = EFidelityFXCASPixelFormat::RGBA32F; break;
+	case FFXCAS_PIXEL_FORMAT_RGB32F:  OutView.Format = EFidelityFXCASPixelFormat::RGB32F; break;
+	case FFXCAS_PIXEL_FORMAT_RGBA8:   OutView.Format = EFidelityFXCASPixelFormat::RGBA8; break;
+	case FFXCAS_PIXEL_FORMAT_RGBA16F: OutView.Format = EFidelityFXCASPixelFormat::RGBA16F; break;
+	case FFXCAS_PIXEL_FORMAT_RGBA8_SRGB: OutView.Format = EFidelityFXCASPixelFormat::RGBA8_SRGB; break;
+	default:                          return false;
+	}
+	switch (View->ChannelOrder)
+	{
+	case FFXCAS_CHANNEL_ORDER_RGBA: OutView.ChannelOrder = EFidelityFXCASChannelOrder::RGBA; break;
+	case FFXCAS_CHANNEL_ORDER_BGRA: OutView.ChannelOrder = EFidelityFXCASChannelOrder::BGRA; break;
+	default:                        return false;
+	}
+	OutView.Data = static_cast<uint8*>(View->Data);
+	OutView.Width = View->Width;
+	OutView.Height = View->Height;
+	OutView.RowPitch = View->RowStride;
+	if (!OutView.IsValid())
+		return false;
+
+	if (Rect)
+	{
+		const FIntRect SubRect(Rect->X, Rect->Y, Rect->X + Rect->Width, Rect->Y + Rect->Height);
+		if (SubRect.Min.X < 0 || SubRect.Min.Y < 0 || SubRect.Max.X > OutView.Width || SubRect.Max.Y > OutView.Height || SubRect.IsEmpty())
+			return false;
+		OutView = OutView.GetSubView(SubRect);
+	}
+	return true;
+}
+
+uint32_t ffxCasGetApiVersion(void)
+{
+	return FFXCAS_API_VERSION;
+}
+
+FfxCasResult ffxCasCheckApiVersion(uint32_t HeaderVersion)
+{
+	const uint32 Major = HeaderVersion >> 16;
+	const uint32 Minor = HeaderVersion & 0xFFFF;
+	return Major == FFXCAS_API_VERSION_MAJOR && Minor <= FFXCAS_API_VERSION_MINOR ? FFXCAS_OK : FFXCAS_ERROR_INCOMPATIBLE_VERSION;
+}
+
+FfxCasResult ffxCasCreateContext(const FfxCasContextDesc* Desc, FfxCasContext** OutContext)
+{
+	if (!OutContext || (Desc && Desc->StructSize < sizeof(FfxCasContextDesc)))
+		return FFXCAS_ERROR_INVALID_ARGUMENT;
+	if (!FFidelityFXCASCPUModule::IsAvailable())
+		return FFXCAS_ERROR_NOT_INITIALIZED;
+
+	FfxCasContext* Context = new FfxCasContext(Desc ? Desc->NumThreads : 0);
+	if (Desc && Desc->ScratchReserveSize > 0)
+		Context->Context.GetScratch(Desc->ScratchReserveSize);
+	*OutContext = Context;
+	return FFXCAS_OK;
+}
+
+void ffxCasDestroyContext(FfxCasContext* Context)
+{
+	delete Context;
+}
+
+FfxCasResult ffxCasProcess(FfxCasContext* Context,
+	const FfxCasImageView* Input, const FfxCasRect* InputRect,
+	const FfxCasImageView* Output, const FfxCasRect* OutputRect,
+	const FfxCasSettings* Settings)
+{
+	if (!Context || !Settings || Settings->StructSize < sizeof(FfxCasSettings))
+		return FFXCAS_ERROR_INVALID_ARGUMENT;
+	if (!FFidelityFXCASCPUModule::IsAvailable())
+		return FFXCAS_ERROR_NOT_INITIALIZED;
+
+	if (Input && Output && Input->StructSize >= sizeof(FfxCasImageView) && Output->StructSize >= sizeof(FfxCasImageView)
+		&& (static_cast<uint32>(Input->Format) > FFXCAS_PIXEL_FORMAT_RGBA8_SRGB || static_cast<uint32>(Output->Format) > FFXCAS_PIXEL_FORMAT_RGBA8_SRGB))
+		return FFXCAS_ERROR_UNSUPPORTED_FORMAT;
+
+	FFidelityFXCASImageView InputView, OutputView;
+	if (!ToImageView(Input, InputRect, InputView) || !ToImageView(Output, OutputRect, OutputView))
+		return FFXCAS_ERROR_INVALID_ARGUMENT;
+
+	FFidelityFXCASCPUSettings CPUSettings;
+	CPUSettings.Sharpness = Settings->Sharpness;
+
+	return FFidelityFXCASCPUModule::Get().Process(Context->Context, InputView, OutputView, CPUSettings) ? FFXCAS_OK : FFXCAS_ERROR_UNSUPPORTED_FORMAT;
+}
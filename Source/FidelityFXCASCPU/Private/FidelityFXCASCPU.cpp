@@ -0,0 +1,986 @@
+#include "FidelityFXCASCPU.h"
+#include "FidelityFXCASCPUKernel.h"
+#include "FidelityFXCASCPUIncludes.h"
+#include "FidelityFXCASCPUContext.h"
+#include "FidelityFXCASCPUTileCache.h"
+
+#include "Async/ParallelFor.h"
+
+DEFINE_LOG_CATEGORY(LogFidelityFXCASCPU);
+
+#define LOCTEXT_NAMESPACE "FFidelityFXCASCPUModule"
+
+//-------------------------------------------------------------------------------------------------
+// Kernel setup and dispatch
+//-------------------------------------------------------------------------------------------------
+
+void FidelityFXCASCPU::Setup(FConstants& OutConstants, float Sharpness, const FIntPoint& InputSize, const FIntPoint& OutputSize)
+{
+	varAU4(Const0);
+	varAU4(Const1);
+	CasSetup(Const0, Const1, Sharpness,
+		static_cast<AF1>(InputSize.X), static_cast<AF1>(InputSize.Y),
+		static_cast<AF1>(OutputSize.X), static_cast<AF1>(OutputSize.Y));
+
+	OutConstants.ScaleX = AsFloat(Const0[0]);
+	OutConstants.ScaleY = AsFloat(Const0[1]);
+	OutConstants.OffsetX = AsFloat(Const0[2]);
+	OutConstants.OffsetY = AsFloat(Const0[3]);
+	OutConstants.Peak = AsFloat(Const1[0]);
+}
+
+void FidelityFXCASCPU::SetupScaleTaps(FScaleTaps* OutTaps, int32 OutputSize, int32 InputSize, float Scale, float Offset)
+{
+	const int32 Last = InputSize - 1;
+	for (int32 Index = 0; Index < OutputSize; ++Index)
+	{
+		const float P = static_cast<float>(Index) * Scale + Offset;
+		const float F = FMath::FloorToFloat(P);
+		const int32 S = static_cast<int32>(F);
+
+		FScaleTaps& Taps = OutTaps[Index];
+		Taps.Index[0] = FMath::Clamp(S - 1, 0, Last);
+		Taps.Index[1] = FMath::Clamp(S, 0, Last);
+		Taps.Index[2] = FMath::Clamp(S + 1, 0, Last);
+		Taps.Index[3] = FMath::Clamp(S + 2, 0, Last);
+		Taps.Phase = P - F;
+	}
+}
+
+namespace FidelityFXCASCPU
+{
+	// Default rows processed by one task, same as the height of the 16x16 region of one GPU thread group
+	static const int32 DefaultRowsPerTask = 16;
+
+	// Generic row kernels, picked by the select functions below for every format combination
+	enum class ERowsKernel : uint8
+	{
+		Sharpen,
+		Scale,
+		Bilinear	// Foveated periphery
+	};
+
+	template<typename FIn, typename FOut>
+	static FRowsFunction GetRowsFunction(ERowsKernel Kernel)
+	{
+		switch (Kernel)
+		{
+		case ERowsKernel::Sharpen:               return &SharpenRows<FIn, FOut>;
+		case ERowsKernel::Scale:                 return &ScaleRows<FIn, FOut>;
+		default:                                 return &ResampleRows<FIn, FOut>;
+		}
+	}
+
+	template<typename FIn, EFidelityFXCASPixelFormat OutFormat>
+	static FRowsFunction SelectRowsFunction(EFidelityFXCASChannelOrder OutOrder, ERowsKernel Kernel)
+	{
+		return (OutOrder == EFidelityFXCASChannelOrder::BGRA)
+			? GetRowsFunction<FIn, TPixel<OutFormat, EFidelityFXCASChannelOrder::BGRA>>(Kernel)
+			: GetRowsFunction<FIn, TPixel<OutFormat, EFidelityFXCASChannelOrder::RGBA>>(Kernel);
+	}
+
+	template<typename FIn>
+	static FRowsFunction SelectRowsFunction(const FFidelityFXCASImageView& Output, ERowsKernel Kernel)
+	{
+		switch (Output.Format)
+		{
+		case EFidelityFXCASPixelFormat::RGBA32F: return SelectRowsFunction<FIn, EFidelityFXCASPixelFormat::RGBA32F>(Output.ChannelOrder, Kernel);
+		case EFidelityFXCASPixelFormat::RGB32F:  return SelectRowsFunction<FIn, EFidelityFXCASPixelFormat::RGB32F>(Output.ChannelOrder, Kernel);
+		case EFidelityFXCASPixelFormat::RGBA8:   return SelectRowsFunction<FIn, EFidelityFXCASPixelFormat::RGBA8>(Output.ChannelOrder, Kernel);
+		case EFidelityFXCASPixelFormat::RGBA16F: return SelectRowsFunction<FIn, EFidelityFXCASPixelFormat::RGBA16F>(Output.ChannelOrder, Kernel);
+		case EFidelityFXCASPixelFormat::RGBA8_SRGB: return SelectRowsFunction<FIn, EFidelityFXCASPixelFormat::RGBA8_SRGB>(Output.ChannelOrder, Kernel);
+		default:                                 return nullptr;
+		}
+	}
+
+	template<EFidelityFXCASPixelFormat InFormat>
+	static FRowsFunction SelectRowsFunction(EFidelityFXCASChannelOrder InOrder, const FFidelityFXCASImageView& Output, ERowsKernel Kernel)
+	{
+		return (InOrder == EFidelityFXCASChannelOrder::BGRA)
+			? SelectRowsFunction<TPixel<InFormat, EFidelityFXCASChannelOrder::BGRA>>(Output, Kernel)
+			: SelectRowsFunction<TPixel<InFormat, EFidelityFXCASChannelOrder::RGBA>>(Output, Kernel);
+	}
+
+	static FRowsFunction SelectRowsFunction(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, ERowsKernel Kernel)
+	{
+		switch (Input.Format)
+		{
+		case EFidelityFXCASPixelFormat::RGBA32F: return SelectRowsFunction<EFidelityFXCASPixelFormat::RGBA32F>(Input.ChannelOrder, Output, Kernel);
+		case EFidelityFXCASPixelFormat::RGB32F:  return SelectRowsFunction<EFidelityFXCASPixelFormat::RGB32F>(Input.ChannelOrder, Output, Kernel);
+		case EFidelityFXCASPixelFormat::RGBA8:   return SelectRowsFunction<EFidelityFXCASPixelFormat::RGBA8>(Input.ChannelOrder, Output, Kernel);
+		case EFidelityFXCASPixelFormat::RGBA16F: return SelectRowsFunction<EFidelityFXCASPixelFormat::RGBA16F>(Input.ChannelOrder, Output, Kernel);
+		case EFidelityFXCASPixelFormat::RGBA8_SRGB: return SelectRowsFunction<EFidelityFXCASPixelFormat::RGBA8_SRGB>(Input.ChannelOrder, Output, Kernel);
+		default:                                 return nullptr;
+		}
+	}
+
+	// Single channel luma formats only combine with each other, the channel order does not apply
+	template<typename FIn>
+	static FRowsFunction SelectLumaRowsFunction(const FFidelityFXCASImageView& Output, ERowsKernel Kernel)
+	{
+		switch (Output.Format)
+		{
+		case EFidelityFXCASPixelFormat::R8:      return GetRowsFunction<FIn, TPixel<EFidelityFXCASPixelFormat::R8, EFidelityFXCASChannelOrder::RGBA>>(Kernel);
+		case EFidelityFXCASPixelFormat::R32F:    return GetRowsFunction<FIn, TPixel<EFidelityFXCASPixelFormat::R32F, EFidelityFXCASChannelOrder::RGBA>>(Kernel);
+		default:                                 return nullptr;
+		}
+	}
+
+	static FRowsFunction SelectLumaRowsFunction(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, ERowsKernel Kernel)
+	{
+		switch (Input.Format)
+		{
+		case EFidelityFXCASPixelFormat::R8:      return SelectLumaRowsFunction<TPixel<EFidelityFXCASPixelFormat::R8, EFidelityFXCASChannelOrder::RGBA>>(Output, Kernel);
+		case EFidelityFXCASPixelFormat::R32F:    return SelectLumaRowsFunction<TPixel<EFidelityFXCASPixelFormat::R32F, EFidelityFXCASChannelOrder::RGBA>>(Output, Kernel);
+		default:                                 return nullptr;
+		}
+	}
+
+	// RGBA8_SRGB to RGBA8_SRGB sharpening runs on the fixed point kernel
+	static FRowsFunction SelectGamma2RowsFunction(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output)
+	{
+		const bool bInBGRA = (Input.ChannelOrder == EFidelityFXCASChannelOrder::BGRA);
+		const bool bOutBGRA = (Output.ChannelOrder == EFidelityFXCASChannelOrder::BGRA);
+		if (bInBGRA)
+		{
+			return bOutBGRA
+				? &SharpenRowsGamma2<EFidelityFXCASChannelOrder::BGRA, EFidelityFXCASChannelOrder::BGRA>
+				: &SharpenRowsGamma2<EFidelityFXCASChannelOrder::BGRA, EFidelityFXCASChannelOrder::RGBA>;
+		}
+		return bOutBGRA
+			? &SharpenRowsGamma2<EFidelityFXCASChannelOrder::RGBA, EFidelityFXCASChannelOrder::BGRA>
+			: &SharpenRowsGamma2<EFidelityFXCASChannelOrder::RGBA, EFidelityFXCASChannelOrder::RGBA>;
+	}
+
+	// Upscale ratios shipped by the games (2x, 1.5x and 4/3) have kernels with compile time phases. They are only
+	// instantiated for the same input and output format to keep the number of kernels down.
+	template<EFidelityFXCASPixelFormat Format, int32 RatioIn, int32 RatioOut>
+	static FRowsFunction SelectFixedRatioRowsFunction(EFidelityFXCASChannelOrder InOrder, EFidelityFXCASChannelOrder OutOrder)
+	{
+		typedef TPixel<Format, EFidelityFXCASChannelOrder::RGBA> FRGBA;
+		typedef TPixel<Format, EFidelityFXCASChannelOrder::BGRA> FBGRA;
+		if (InOrder == EFidelityFXCASChannelOrder::BGRA)
+		{
+			return (OutOrder == EFidelityFXCASChannelOrder::BGRA)
+				? &ScaleRowsFixedRatio<FBGRA, FBGRA, RatioIn, RatioOut>
+				: &ScaleRowsFixedRatio<FBGRA, FRGBA, RatioIn, RatioOut>;
+		}
+		return (OutOrder == EFidelityFXCASChannelOrder::BGRA)
+			? &ScaleRowsFixedRatio<FRGBA, FBGRA, RatioIn, RatioOut>
+			: &ScaleRowsFixedRatio<FRGBA, FRGBA, RatioIn, RatioOut>;
+	}
+
+	template<int32 RatioIn, int32 RatioOut>
+	static FRowsFunction SelectFixedRatioRowsFunction(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output)
+	{
+		if (Input.Format != Output.Format)
+			return nullptr;
+
+		switch (Input.Format)
+		{
+		case EFidelityFXCASPixelFormat::RGBA32F: return SelectFixedRatioRowsFunction<EFidelityFXCASPixelFormat::RGBA32F, RatioIn, RatioOut>(Input.ChannelOrder, Output.ChannelOrder);
+		case EFidelityFXCASPixelFormat::RGB32F:  return SelectFixedRatioRowsFunction<EFidelityFXCASPixelFormat::RGB32F, RatioIn, RatioOut>(Input.ChannelOrder, Output.ChannelOrder);
+		case EFidelityFXCASPixelFormat::RGBA8:   return SelectFixedRatioRowsFunction<EFidelityFXCASPixelFormat::RGBA8, RatioIn, RatioOut>(Input.ChannelOrder, Output.ChannelOrder);
+		case EFidelityFXCASPixelFormat::RGBA16F: return SelectFixedRatioRowsFunction<EFidelityFXCASPixelFormat::RGBA16F, RatioIn, RatioOut>(Input.ChannelOrder, Output.ChannelOrder);
+		case EFidelityFXCASPixelFormat::RGBA8_SRGB: return SelectFixedRatioRowsFunction<EFidelityFXCASPixelFormat::RGBA8_SRGB, RatioIn, RatioOut>(Input.ChannelOrder, Output.ChannelOrder);
+		case EFidelityFXCASPixelFormat::R8:      return SelectFixedRatioRowsFunction<EFidelityFXCASPixelFormat::R8, RatioIn, RatioOut>(Input.ChannelOrder, Output.ChannelOrder);
+		case EFidelityFXCASPixelFormat::R32F:    return SelectFixedRatioRowsFunction<EFidelityFXCASPixelFormat::R32F, RatioIn, RatioOut>(Input.ChannelOrder, Output.ChannelOrder);
+		default:                                 return nullptr;
+		}
+	}
+
+	template<EFidelityFXCASPixelFormat Format>
+	static FReduceRowsFunction SelectReduceRowsFunction(EFidelityFXCASChannelOrder Order)
+	{
+		return (Order == EFidelityFXCASChannelOrder::BGRA)
+			? &BoxReduceRows<TPixel<Format, EFidelityFXCASChannelOrder::BGRA>>
+			: &BoxReduceRows<TPixel<Format, EFidelityFXCASChannelOrder::RGBA>>;
+	}
+
+	static FReduceRowsFunction SelectReduceRowsFunction(const FFidelityFXCASImageView& Input)
+	{
+		switch (Input.Format)
+		{
+		case EFidelityFXCASPixelFormat::RGBA32F: return SelectReduceRowsFunction<EFidelityFXCASPixelFormat::RGBA32F>(Input.ChannelOrder);
+		case EFidelityFXCASPixelFormat::RGB32F:  return SelectReduceRowsFunction<EFidelityFXCASPixelFormat::RGB32F>(Input.ChannelOrder);
+		case EFidelityFXCASPixelFormat::RGBA8:   return SelectReduceRowsFunction<EFidelityFXCASPixelFormat::RGBA8>(Input.ChannelOrder);
+		case EFidelityFXCASPixelFormat::RGBA16F: return SelectReduceRowsFunction<EFidelityFXCASPixelFormat::RGBA16F>(Input.ChannelOrder);
+		case EFidelityFXCASPixelFormat::RGBA8_SRGB: return SelectReduceRowsFunction<EFidelityFXCASPixelFormat::RGBA8_SRGB>(Input.ChannelOrder);
+		case EFidelityFXCASPixelFormat::R8:      return &BoxReduceRowsLuma<TPixel<EFidelityFXCASPixelFormat::R8, EFidelityFXCASChannelOrder::RGBA>>;
+		case EFidelityFXCASPixelFormat::R32F:    return &BoxReduceRowsLuma<TPixel<EFidelityFXCASPixelFormat::R32F, EFidelityFXCASChannelOrder::RGBA>>;
+		default:                                 return nullptr;
+		}
+	}
+
+	static FORCEINLINE bool IsScaleRatio(const FIntPoint& InputSize, const FIntPoint& OutputSize, int32 RatioIn, int32 RatioOut)
+	{
+		return InputSize * RatioOut == OutputSize * RatioIn;
+	}
+
+	static FRowsFunction SelectFixedRatioRowsFunction(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output)
+	{
+		if (IsScaleRatio(Input.GetSize(), Output.GetSize(), 1, 2))
+			return SelectFixedRatioRowsFunction<1, 2>(Input, Output);
+		if (IsScaleRatio(Input.GetSize(), Output.GetSize(), 2, 3))
+			return SelectFixedRatioRowsFunction<2, 3>(Input, Output);
+		if (IsScaleRatio(Input.GetSize(), Output.GetSize(), 3, 4))
+			return SelectFixedRatioRowsFunction<3, 4>(Input, Output);
+		return nullptr;
+	}
+}
+
+FidelityFXCASCPU::FRowsFunction FidelityFXCASCPU::SelectKernel(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output,
+	const FFidelityFXCASCPUSettings& Settings)
+{
+	const bool bSharpenOnly = (Input.GetSize() == Output.GetSize());
+	const bool bGamma2 = bSharpenOnly && Input.Format == EFidelityFXCASPixelFormat::RGBA8_SRGB && Output.Format == EFidelityFXCASPixelFormat::RGBA8_SRGB;
+	const ERowsKernel Kernel = bSharpenOnly ? ERowsKernel::Sharpen : ERowsKernel::Scale;
+	FRowsFunction RowsFunction = IsFidelityFXCASLumaFormat(Input.Format) ? SelectLumaRowsFunction(Input, Output, Kernel)
+		: bGamma2 ? SelectGamma2RowsFunction(Input, Output)
+		: SelectRowsFunction(Input, Output, Kernel);
+#if FX_CAS_CPU_SIMD
+	if (Settings.bAllowSIMD && bSharpenOnly && Input.Format == EFidelityFXCASPixelFormat::RGBA16F && Output.Format == EFidelityFXCASPixelFormat::RGBA16F
+		&& HasAVX2F16C())
+	{
+		RowsFunction = &SharpenRowsRGBA16F_AVX2;
+	}
+	if (Settings.bAllowSIMD && bGamma2 && HasAVX2F16C())
+	{
+		RowsFunction = &SharpenRowsGamma2_AVX2;
+	}
+#endif // FX_CAS_CPU_SIMD
+	if (!bSharpenOnly)
+	{
+		if (FRowsFunction FixedRatioRowsFunction = SelectFixedRatioRowsFunction(Input, Output))
+			RowsFunction = FixedRatioRowsFunction;
+	}
+	return RowsFunction;
+}
+
+FidelityFXCASCPU::FRowsFunction FidelityFXCASCPU::SelectBilinearKernel(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output)
+{
+	return IsFidelityFXCASLumaFormat(Input.Format) ? SelectLumaRowsFunction(Input, Output, ERowsKernel::Bilinear)
+		: SelectRowsFunction(Input, Output, ERowsKernel::Bilinear);
+}
+
+namespace FidelityFXCASCPU
+{
+	// Copies the input to Scratch when it shares memory with the output, as the kernels read neighbours of pixels
+	// that may already have been written. Returns the view the kernels should read from.
+	static FFidelityFXCASImageView ResolveInPlaceInput(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, uint8* Scratch)
+	{
+		if (!Scratch)
+			return Input;
+
+		const int64 RowSize = static_cast<int64>(Input.Width) * Input.GetBytesPerPixel();
+		FFidelityFXCASImageView Copy = Input;
+		Copy.Data = Scratch;
+		Copy.RowPitch = RowSize;
+		for (int32 Y = 0; Y < Input.Height; ++Y)
+			FMemory::Memcpy(Copy.GetRow(Y), Input.GetRow(Y), RowSize);
+		return Copy;
+	}
+
+	static FORCEINLINE int64 GetInPlaceScratchSize(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output)
+	{
+		return Input.Overlaps(Output) ? Align(static_cast<int64>(Input.Width) * Input.GetBytesPerPixel() * Input.Height, 16) : 0;
+	}
+
+	static FORCEINLINE int64 GetScaleTapsScratchSize(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output)
+	{
+		return (Input.GetSize() != Output.GetSize()) ? static_cast<int64>(Output.Width + Output.Height) * sizeof(FScaleTaps) : 0;
+	}
+
+	// Format of the box filtered image, full precision with the channels of the input
+	static FORCEINLINE EFidelityFXCASPixelFormat GetPrefilterFormat(EFidelityFXCASPixelFormat InputFormat)
+	{
+		return IsFidelityFXCASLumaFormat(InputFormat) ? EFidelityFXCASPixelFormat::R32F : EFidelityFXCASPixelFormat::RGBA32F;
+	}
+
+	// RGBA32F (R32F for luma) image of the downscale prefilter, 0 if the input is used as is
+	static FORCEINLINE int64 GetPrefilterScratchSize(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output)
+	{
+		const FIntPoint PrefilterSize = FFidelityFXCASCPUModule::GetPrefilterSize(Input.GetSize(), Output.GetSize());
+		if (PrefilterSize == FIntPoint(1, 1))
+			return 0;
+		const FIntPoint ReducedSize = FFidelityFXCASCPUModule::GetPrefilteredSize(Input.GetSize(), PrefilterSize);
+		return static_cast<int64>(ReducedSize.X) * ReducedSize.Y * GetFidelityFXCASBytesPerPixel(GetPrefilterFormat(Input.Format));
+	}
+
+	// Scratch memory layout: in place copy of the input (if the views overlap), then the column and row taps (if scaling).
+	// The prefiltered image replaces the in place copy, the reduction reads the whole input before the output is written.
+	static FORCEINLINE int64 GetScratchSize(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output)
+	{
+		const int64 PrefilterScratchSize = GetPrefilterScratchSize(Input, Output);
+		return (PrefilterScratchSize > 0 ? PrefilterScratchSize : GetInPlaceScratchSize(Input, Output)) + GetScaleTapsScratchSize(Input, Output);
+	}
+
+	// Shared by the module and the context entry points, ParallelForFunction runs the row bands
+	template<typename FParallelFor>
+	static bool Process(const FFidelityFXCASImageView& InInput, const FFidelityFXCASImageView& Output, const FFidelityFXCASCPUSettings& Settings,
+		uint8* Scratch, FParallelFor ParallelForFunction)
+	{
+		// Downscales beyond the reach of the CAS window scale from the box filtered input, the reduction runs in row bands like the kernels
+		const FIntPoint PrefilterSize = FFidelityFXCASCPUModule::GetPrefilterSize(InInput.GetSize(), Output.GetSize());
+		if (PrefilterSize != FIntPoint(1, 1))
+		{
+			FReduceRowsFunction ReduceRowsFunction = SelectReduceRowsFunction(InInput);
+			if (!ReduceRowsFunction)
+			{
+				UE_LOG(LogFidelityFXCASCPU, Error, TEXT("Process: unsupported pixel format combination."));
+				return false;
+			}
+
+			const FIntPoint ReducedSize = FFidelityFXCASCPUModule::GetPrefilteredSize(InInput.GetSize(), PrefilterSize);
+			const EFidelityFXCASPixelFormat ReducedFormat = GetPrefilterFormat(InInput.Format);
+			const FFidelityFXCASImageView Reduced(Scratch, ReducedSize.X, ReducedSize.Y,
+				static_cast<int64>(ReducedSize.X) * GetFidelityFXCASBytesPerPixel(ReducedFormat), ReducedFormat);
+			{
+				QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASCPU_Prefilter); // Used to gather CPU profiling data for the UE4 session frontend
+
+				const int32 RowsPerTask = Settings.RowsPerTask > 0 ? Settings.RowsPerTask : DefaultRowsPerTask;
+				ParallelForFunction(FMath::DivideAndRoundUp(Reduced.Height, RowsPerTask), [&](int32 TaskIndex)
+				{
+					const int32 RowBegin = TaskIndex * RowsPerTask;
+					ReduceRowsFunction(InInput, Reduced, PrefilterSize, RowBegin, FMath::Min(RowBegin + RowsPerTask, Reduced.Height));
+				});
+			}
+			return Process(Reduced, Output, Settings, Scratch + GetPrefilterScratchSize(InInput, Output), ParallelForFunction);
+		}
+
+		const bool bSharpenOnly = (InInput.GetSize() == Output.GetSize());
+		FRowsFunction RowsFunction = SelectKernel(InInput, Output, Settings);
+		if (!RowsFunction)
+		{
+			UE_LOG(LogFidelityFXCASCPU, Error, TEXT("Process: unsupported pixel format combination."));
+			return false;
+		}
+
+		QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASCPU_Process); // Used to gather CPU profiling data for the UE4 session frontend
+
+		FConstants Constants;
+		Setup(Constants, FMath::Clamp(Settings.Sharpness, 0.0f, 1.0f), InInput.GetSize(), Output.GetSize());
+
+		const int64 InPlaceScratchSize = GetInPlaceScratchSize(InInput, Output);
+		if (!bSharpenOnly)
+		{
+			FScaleTaps* ScaleTaps = reinterpret_cast<FScaleTaps*>(Scratch + InPlaceScratchSize);
+			SetupScaleTaps(ScaleTaps, Output.Width, InInput.Width, Constants.ScaleX, Constants.OffsetX);
+			SetupScaleTaps(ScaleTaps + Output.Width, Output.Height, InInput.Height, Constants.ScaleY, Constants.OffsetY);
+			Constants.ColumnTaps = ScaleTaps;
+			Constants.RowTaps = ScaleTaps + Output.Width;
+		}
+
+		const FFidelityFXCASImageView Input = ResolveInPlaceInput(InInput, Output, InPlaceScratchSize > 0 ? Scratch : nullptr);
+		const int32 RowsPerTask = Settings.RowsPerTask > 0 ? Settings.RowsPerTask : DefaultRowsPerTask;
+		const int32 NumTasks = FMath::DivideAndRoundUp(Output.Height, RowsPerTask);
+		ParallelForFunction(NumTasks, [&](int32 TaskIndex)
+		{
+			const int32 RowBegin = TaskIndex * RowsPerTask;
+			const int32 RowEnd = FMath::Min(RowBegin + RowsPerTask, Output.Height);
+			RowsFunction(Input, Output, Constants, RowBegin, RowEnd);
+		});
+
+		return true;
+	}
+
+	// Sharpen only: every dirty region runs on a sub-view grown by the 1 pixel apron into Scratch, and only the inner
+	// part is copied to the output. The apron outputs see clamped neighbours and are dropped, so the copied pixels
+	// are bit identical to a full pass with the same kernel.
+	template<typename FParallelFor>
+	static bool SharpenDirtyRects(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FFidelityFXCASCPUSettings& Settings,
+		const TArray<FIntRect>& OutputRects, uint8* Scratch, FParallelFor ParallelForFunction)
+	{
+		const FIntRect Bounds(FIntPoint::ZeroValue, Output.GetSize());
+		const int32 BytesPerPixel = Output.GetBytesPerPixel();
+		for (const FIntRect& Rect : OutputRects)
+		{
+			FIntRect ApronRect(Rect.Min - FIntPoint(1, 1), Rect.Max + FIntPoint(1, 1));
+			ApronRect.Clip(Bounds);
+
+			FFidelityFXCASImageView ApronOutput = Output;
+			ApronOutput.Data = Scratch;
+			ApronOutput.Width = ApronRect.Width();
+			ApronOutput.Height = ApronRect.Height();
+			ApronOutput.RowPitch = static_cast<int64>(ApronRect.Width()) * BytesPerPixel;
+			if (!Process(Input.GetSubView(ApronRect), ApronOutput, Settings, nullptr, ParallelForFunction))
+				return false;
+
+			const FIntPoint Offset = Rect.Min - ApronRect.Min;
+			for (int32 Y = 0; Y < Rect.Height(); ++Y)
+			{
+				FMemory::Memcpy(Output.GetRow(Rect.Min.Y + Y) + static_cast<int64>(Rect.Min.X) * BytesPerPixel,
+					ApronOutput.GetRow(Offset.Y + Y) + static_cast<int64>(Offset.X) * BytesPerPixel, static_cast<int64>(Rect.Width()) * BytesPerPixel);
+			}
+		}
+		return true;
+	}
+
+	// Scaling: the taps hold absolute source positions, so each dirty region is an output sub-view with the taps
+	// shifted to its origin and the full input, run on the kernel of the full pass.
+	template<typename FParallelFor>
+	static bool ScaleDirtyRects(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FFidelityFXCASCPUSettings& Settings,
+		const TArray<FIntRect>& OutputRects, uint8* Scratch, FParallelFor ParallelForFunction)
+	{
+		FRowsFunction RowsFunction = SelectKernel(Input, Output, Settings);
+		if (!RowsFunction)
+		{
+			UE_LOG(LogFidelityFXCASCPU, Error, TEXT("ProcessDirtyRects: unsupported pixel format combination."));
+			return false;
+		}
+
+		FConstants Constants;
+		Setup(Constants, FMath::Clamp(Settings.Sharpness, 0.0f, 1.0f), Input.GetSize(), Output.GetSize());
+		FScaleTaps* ScaleTaps = reinterpret_cast<FScaleTaps*>(Scratch);
+		SetupScaleTaps(ScaleTaps, Output.Width, Input.Width, Constants.ScaleX, Constants.OffsetX);
+		SetupScaleTaps(ScaleTaps + Output.Width, Output.Height, Input.Height, Constants.ScaleY, Constants.OffsetY);
+
+		const int32 RowsPerTask = Settings.RowsPerTask > 0 ? Settings.RowsPerTask : DefaultRowsPerTask;
+		for (const FIntRect& Rect : OutputRects)
+		{
+			FConstants RectConstants = Constants;
+			RectConstants.ColumnTaps = ScaleTaps + Rect.Min.X;
+			RectConstants.RowTaps = ScaleTaps + Output.Width + Rect.Min.Y;
+			RectConstants.ColumnBegin = Rect.Min.X;
+			const FFidelityFXCASImageView RectOutput = Output.GetSubView(Rect);
+
+			ParallelForFunction(FMath::DivideAndRoundUp(Rect.Height(), RowsPerTask), [&](int32 TaskIndex)
+			{
+				const int32 RowBegin = TaskIndex * RowsPerTask;
+				const int32 RowEnd = FMath::Min(RowBegin + RowsPerTask, Rect.Height());
+				RowsFunction(Input, RectOutput, RectConstants, RowBegin, RowEnd);
+			});
+		}
+		return true;
+	}
+
+	static int64 GetDirtyRectsScratchSize(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const TArray<FIntRect>& OutputRects)
+	{
+		if (GetPrefilterScratchSize(Input, Output) > 0)
+			return GetScratchSize(Input, Output);
+		if (Input.GetSize() != Output.GetSize())
+			return GetScaleTapsScratchSize(Input, Output);
+
+		int64 MaxApronArea = 0;
+		for (const FIntRect& Rect : OutputRects)
+			MaxApronArea = FMath::Max(MaxApronArea, static_cast<int64>(Rect.Width() + 2) * (Rect.Height() + 2));
+		return MaxApronArea * Output.GetBytesPerPixel();
+	}
+
+	template<typename FParallelFor>
+	static bool ProcessDirtyRects(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FFidelityFXCASCPUSettings& Settings,
+		const TArray<FIntRect>& OutputRects, uint8* Scratch, FParallelFor ParallelForFunction)
+	{
+		QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASCPU_ProcessDirtyRects); // Used to gather CPU profiling data for the UE4 session frontend
+
+		// Prefiltered downscales rebuild the reduced input anyway, and the scaling of the at most 2x larger reduced image is cheap next to it
+		if (FFidelityFXCASCPUModule::GetPrefilterSize(Input.GetSize(), Output.GetSize()) != FIntPoint(1, 1))
+			return Process(Input, Output, Settings, Scratch, ParallelForFunction);
+
+		return (Input.GetSize() == Output.GetSize())
+			? SharpenDirtyRects(Input, Output, Settings, OutputRects, Scratch, ParallelForFunction)
+			: ScaleDirtyRects(Input, Output, Settings, OutputRects, Scratch, ParallelForFunction);
+	}
+
+	// Foveated pass, one task per tile row. Neighbouring tiles of the same kernel are merged into runs: CAS runs go through the same
+	// kernels as the dirty rectangle paths, so they match a full pass, bilinear runs through ResampleRows(). The CPU has a single CAS
+	// quality, the GPU Low tier the reduced tiles run there, so full and reduced tiles both take the CAS kernel.
+	template<typename FParallelFor>
+	static bool ProcessFoveated(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FFidelityFXCASCPUSettings& Settings,
+		const FFidelityFXCASTileClassification& Classification, uint8* Scratch, FParallelFor ParallelForFunction)
+	{
+		const FRowsFunction CASRowsFunction = SelectKernel(Input, Output, Settings);
+		const FRowsFunction BilinearRowsFunction = SelectBilinearKernel(Input, Output);
+		if (!CASRowsFunction || !BilinearRowsFunction)
+		{
+			UE_LOG(LogFidelityFXCASCPU, Error, TEXT("ProcessFoveated: unsupported pixel format combination."));
+			return false;
+		}
+
+		QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASCPU_ProcessFoveated); // Used to gather CPU profiling data for the UE4 session frontend
+
+		const bool bSharpenOnly = (Input.GetSize() == Output.GetSize());
+		FConstants Constants;
+		Setup(Constants, FMath::Clamp(Settings.Sharpness, 0.0f, 1.0f), Input.GetSize(), Output.GetSize());
+		FScaleTaps* ScaleTaps = reinterpret_cast<FScaleTaps*>(Scratch);
+		if (!bSharpenOnly)
+		{
+			SetupScaleTaps(ScaleTaps, Output.Width, Input.Width, Constants.ScaleX, Constants.OffsetX);
+			SetupScaleTaps(ScaleTaps + Output.Width, Output.Height, Input.Height, Constants.ScaleY, Constants.OffsetY);
+		}
+
+		const auto UsesCASKernel = [](EFidelityFXCASTileClass Class)
+		{
+			return Class != EFidelityFXCASTileClass::Bilinear;
+		};
+
+		const int32 TileSize = FFidelityFXCASTileClassification::TileSize;
+		const int32 BytesPerPixel = Output.GetBytesPerPixel();
+		ParallelForFunction(Classification.NumTiles.Y, [&](int32 TileY)
+		{
+			TArray64<uint8> ApronScratch;
+			for (int32 TileX = 0; TileX < Classification.NumTiles.X; )
+			{
+				const bool bCAS = UsesCASKernel(Classification.GetClass(TileX, TileY));
+				int32 RunEnd = TileX + 1;
+				while (RunEnd < Classification.NumTiles.X && UsesCASKernel(Classification.GetClass(RunEnd, TileY)) == bCAS)
+					++RunEnd;
+				const FIntRect Rect(TileX * TileSize, TileY * TileSize, FMath::Min(RunEnd * TileSize, Output.Width), FMath::Min((TileY + 1) * TileSize, Output.Height));
+				TileX = RunEnd;
+
+				if (!bSharpenOnly)
+				{
+					// The taps hold absolute source positions, shifted to the origin of the run
+					FConstants RunConstants = Constants;
+					RunConstants.ColumnTaps = ScaleTaps + Rect.Min.X;
+					RunConstants.RowTaps = ScaleTaps + Output.Width + Rect.Min.Y;
+					RunConstants.ColumnBegin = Rect.Min.X;
+					(bCAS ? CASRowsFunction : BilinearRowsFunction)(Input, Output.GetSubView(Rect), RunConstants, 0, Rect.Height());
+				}
+				else if (!bCAS)
+				{
+					BilinearRowsFunction(Input.GetSubView(Rect), Output.GetSubView(Rect), Constants, 0, Rect.Height());
+				}
+				else
+				{
+					// Same as SharpenDirtyRects(): the run grown by the 1 pixel apron, only the inner part is copied
+					FIntRect ApronRect(Rect.Min - FIntPoint(1, 1), Rect.Max + FIntPoint(1, 1));
+					ApronRect.Clip(FIntRect(FIntPoint::ZeroValue, Output.GetSize()));
+					ApronScratch.SetNumUninitialized(static_cast<int64>(ApronRect.Width()) * ApronRect.Height() * BytesPerPixel, false);
+
+					FFidelityFXCASImageView ApronOutput = Output;
+					ApronOutput.Data = ApronScratch.GetData();
+					ApronOutput.Width = ApronRect.Width();
+					ApronOutput.Height = ApronRect.Height();
+					ApronOutput.RowPitch = static_cast<int64>(ApronRect.Width()) * BytesPerPixel;
+					CASRowsFunction(Input.GetSubView(ApronRect), ApronOutput, Constants, 0, ApronRect.Height());
+
+					const FIntPoint Offset = Rect.Min - ApronRect.Min;
+					for (int32 Y = 0; Y < Rect.Height(); ++Y)
+					{
+						FMemory::Memcpy(Output.GetRow(Rect.Min.Y + Y) + static_cast<int64>(Rect.Min.X) * BytesPerPixel,
+							ApronOutput.GetRow(Offset.Y + Y) + static_cast<int64>(Offset.X) * BytesPerPixel, static_cast<int64>(Rect.Width()) * BytesPerPixel);
+					}
+				}
+			}
+		});
+		return true;
+	}
+
+	static bool ValidateViews(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output)
+	{
+		if (!Input.IsValid() || !Output.IsValid())
+		{
+			UE_LOG(LogFidelityFXCASCPU, Error, TEXT("Process: invalid image view (input %dx%d, output %dx%d)."), Input.Width, Input.Height, Output.Width, Output.Height);
+			return false;
+		}
+		return true;
+	}
+
+	// Chroma plane of ProcessLuma(): copied when the sizes match, bilinearly resampled otherwise.
+	// Nothing to do without output data or when the output is the input plane.
+	template<typename FParallelFor>
+	static bool ResampleChroma(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FFidelityFXCASCPUSettings& Settings,
+		FParallelFor ParallelForFunction)
+	{
+		if (!Output.Data || (Input.Data == Output.Data && Input.RowPitch == Output.RowPitch && Input.GetSize() == Output.GetSize()))
+			return true;
+		if (!ValidateViews(Input, Output))
+			return false;
+		if (Input.Format != Output.Format || (Input.Format != EFidelityFXCASPixelFormat::R8 && Input.Format != EFidelityFXCASPixelFormat::RG8) || Input.Overlaps(Output))
+		{
+			UE_LOG(LogFidelityFXCASCPU, Error, TEXT("ProcessLuma: the chroma planes must be R8 or RG8, have the same format in the input and the output and must not overlap."));
+			return false;
+		}
+
+		QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASCPU_ResampleChroma); // Used to gather CPU profiling data for the UE4 session frontend
+
+		if (Input.GetSize() == Output.GetSize())
+		{
+			const int64 RowSize = static_cast<int64>(Output.Width) * Output.GetBytesPerPixel();
+			for (int32 Y = 0; Y < Output.Height; ++Y)
+				FMemory::Memcpy(Output.GetRow(Y), Input.GetRow(Y), RowSize);
+			return true;
+		}
+
+		typedef void (*FBilinearRowsFunction)(const FFidelityFXCASImageView&, const FFidelityFXCASImageView&, int32, int32);
+		const FBilinearRowsFunction RowsFunction = (Input.Format == EFidelityFXCASPixelFormat::RG8) ? &BilinearRows<2> : &BilinearRows<1>;
+		const int32 RowsPerTask = Settings.RowsPerTask > 0 ? Settings.RowsPerTask : DefaultRowsPerTask;
+		ParallelForFunction(FMath::DivideAndRoundUp(Output.Height, RowsPerTask), [&](int32 TaskIndex)
+		{
+			const int32 RowBegin = TaskIndex * RowsPerTask;
+			RowsFunction(Input, Output, RowBegin, FMath::Min(RowBegin + RowsPerTask, Output.Height));
+		});
+		return true;
+	}
+
+	// Plane formats shared by both ProcessLuma() overloads
+	static bool ValidateYUVFrames(const FFidelityFXCASYUVFrameView& Input, const FFidelityFXCASYUVFrameView& Output)
+	{
+		if (!IsFidelityFXCASLumaFormat(Input.Luma.Format) || !IsFidelityFXCASLumaFormat(Output.Luma.Format))
+		{
+			UE_LOG(LogFidelityFXCASCPU, Error, TEXT("ProcessLuma: the luma planes must be R8 or R32F."));
+			return false;
+		}
+		if (Input.IsNV12() != Output.IsNV12() && Output.ChromaU.Data)
+		{
+			UE_LOG(LogFidelityFXCASCPU, Error, TEXT("ProcessLuma: the input and output chroma layouts differ (NV12 / I420)."));
+			return false;
+		}
+		return true;
+	}
+}
+
+bool FidelityFXCASCPU::ProcessScheduled(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FFidelityFXCASCPUSettings& Settings,
+	TArray64<uint8>& Scratch, TFunctionRef<void(int32, TFunctionRef<void(int32)>)> ParallelForFunction)
+{
+	if (!ValidateViews(Input, Output))
+		return false;
+
+	const int64 ScratchSize = GetScratchSize(Input, Output);
+	if (Scratch.Num() < ScratchSize)
+	{
+		Scratch.Empty(ScratchSize);
+		Scratch.AddUninitialized(ScratchSize);
+	}
+	return Process(Input, Output, Settings, ScratchSize > 0 ? Scratch.GetData() : nullptr, ParallelForFunction);
+}
+
+//-------------------------------------------------------------------------------------------------
+// FFidelityFXCASCPUModule class implementation
+//-------------------------------------------------------------------------------------------------
+
+FFidelityFXCASCPUModule& FFidelityFXCASCPUModule::Get()
+{
+	static FFidelityFXCASCPUModule* CachedModule = NULL;
+	if (!CachedModule)
+		CachedModule = &FModuleManager::LoadModuleChecked<FFidelityFXCASCPUModule>("FidelityFXCASCPU");
+	return *CachedModule;
+}
+
+void FFidelityFXCASCPUModule::StartupModule()
+{
+}
+
+void FFidelityFXCASCPUModule::ShutdownModule()
+{
+}
+
+bool FFidelityFXCASCPUModule::Process(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FFidelityFXCASCPUSettings& Settings) const
+{
+	if (!FidelityFXCASCPU::ValidateViews(Input, Output))
+		return false;
+
+	TArray64<uint8> Scratch;
+	Scratch.AddUninitialized(FidelityFXCASCPU::GetScratchSize(Input, Output));
+
+	return FidelityFXCASCPU::Process(Input, Output, Settings, Scratch.GetData(),
+		[&Settings](int32 Num, TFunctionRef<void(int32)> Function)
+		{
+			ParallelFor(Num, Function, !Settings.bMultithreaded);
+		});
+}
+
+bool FFidelityFXCASCPUModule::Process(FFidelityFXCASCPUContext& Context, const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output,
+	const FFidelityFXCASCPUSettings& Settings) const
+{
+	if (!FidelityFXCASCPU::ValidateViews(Input, Output))
+		return false;
+
+	// In place processing bypasses the cache, the input tiles would be overwritten while they are hashed.
+	// So do prefiltered downscales, the cache keys are hashes of the input pixels of the CAS window.
+	if (Settings.bUseTileCache && !Input.Overlaps(Output) && GetPrefilterSize(Input.GetSize(), Output.GetSize()) == FIntPoint(1, 1))
+		return FidelityFXCASCPU::ProcessTileCached(Context, Input, Output, Settings);
+
+	const int64 ScratchSize = FidelityFXCASCPU::GetScratchSize(Input, Output);
+	return FidelityFXCASCPU::Process(Input, Output, Settings, ScratchSize > 0 ? Context.GetScratch(ScratchSize) : nullptr,
+		[&Context, &Settings](int32 Num, TFunctionRef<void(int32)> Function)
+		{
+			if (Settings.bMultithreaded)
+			{
+				Context.ParallelFor(Num, Function);
+			}
+			else
+			{
+				for (int32 Index = 0; Index < Num; ++Index)
+					Function(Index);
+			}
+		});
+}
+
+bool FFidelityFXCASCPUModule::ProcessLuma(const FFidelityFXCASYUVFrameView& Input, const FFidelityFXCASYUVFrameView& Output,
+	const FFidelityFXCASCPUSettings& Settings) const
+{
+	if (!FidelityFXCASCPU::ValidateYUVFrames(Input, Output))
+		return false;
+
+	auto RunParallel = [&Settings](int32 Num, TFunctionRef<void(int32)> Function)
+	{
+		ParallelFor(Num, Function, !Settings.bMultithreaded);
+	};
+	return Process(Input.Luma, Output.Luma, Settings)
+		&& FidelityFXCASCPU::ResampleChroma(Input.ChromaU, Output.ChromaU, Settings, RunParallel)
+		&& FidelityFXCASCPU::ResampleChroma(Input.ChromaV, Output.ChromaV, Settings, RunParallel);
+}
+
+bool FFidelityFXCASCPUModule::ProcessLuma(FFidelityFXCASCPUContext& Context, const FFidelityFXCASYUVFrameView& Input, const FFidelityFXCASYUVFrameView& Output,
+	const FFidelityFXCASCPUSettings& Settings) const
+{
+	if (!FidelityFXCASCPU::ValidateYUVFrames(Input, Output))
+		return false;
+
+	// The chroma planes run on the context's threads too
+	auto RunParallel = [&Context, &Settings](int32 Num, TFunctionRef<void(int32)> Function)
+	{
+		if (Settings.bMultithreaded)
+		{
+			Context.ParallelFor(Num, Function);
+		}
+		else
+		{
+			for (int32 Index = 0; Index < Num; ++Index)
+				Function(Index);
+		}
+	};
+	return Process(Context, Input.Luma, Output.Luma, Settings)
+		&& FidelityFXCASCPU::ResampleChroma(Input.ChromaU, Output.ChromaU, Settings, RunParallel)
+		&& FidelityFXCASCPU::ResampleChroma(Input.ChromaV, Output.ChromaV, Settings, RunParallel);
+}
+
+FIntPoint FFidelityFXCASCPUModule::GetPrefilterSize(const FIntPoint& InputSize, const FIntPoint& OutputSize)
+{
+	if (OutputSize.X <= 0 || OutputSize.Y <= 0)
+		return FIntPoint(1, 1);
+
+	// Smallest box that brings the input within 2x of the output, CasSupportScaling() only covers upscales (CAS_AREA_LIMIT)
+	return FIntPoint(
+		FMath::Max(FMath::DivideAndRoundUp(InputSize.X, 2 * OutputSize.X), 1),
+		FMath::Max(FMath::DivideAndRoundUp(InputSize.Y, 2 * OutputSize.Y), 1));
+}
+
+void FFidelityFXCASCPUModule::GetDirtyOutputRects(const FIntPoint& InInputSize, const FIntPoint& OutputSize, const TArray<FIntRect>& InInputDirtyRects,
+	TArray<FIntRect>& OutRects)
+{
+	OutRects.Reset();
+	if (InInputSize.X <= 0 || InInputSize.Y <= 0 || OutputSize.X <= 0 || OutputSize.Y <= 0)
+		return;
+
+	// Prefiltered downscales: the rectangles are mapped to the reduced input CAS runs on
+	const FIntPoint PrefilterSize = GetPrefilterSize(InInputSize, OutputSize);
+	const FIntPoint InputSize = GetPrefilteredSize(InInputSize, PrefilterSize);
+	TArray<FIntRect> ReducedDirtyRects;
+	if (PrefilterSize != FIntPoint(1, 1))
+	{
+		ReducedDirtyRects.Reserve(InInputDirtyRects.Num());
+		for (const FIntRect& InputRect : InInputDirtyRects)
+			ReducedDirtyRects.Add(FIntRect(InputRect.Min / PrefilterSize, FIntPoint::DivideAndRoundUp(InputRect.Max, PrefilterSize)));
+	}
+	const TArray<FIntRect>& InputDirtyRects = (PrefilterSize != FIntPoint(1, 1)) ? ReducedDirtyRects : InInputDirtyRects;
+
+	const FIntRect Bounds(FIntPoint::ZeroValue, OutputSize);
+	const bool bSharpenOnly = (InputSize == OutputSize);
+	for (const FIntRect& InputRect : InputDirtyRects)
+	{
+		if (InputRect.Width() <= 0 || InputRect.Height() <= 0)
+			continue;
+
+		FIntRect Rect;
+		if (bSharpenOnly)
+		{
+			// 3x3 cross around every output pixel
+			Rect = FIntRect(InputRect.Min - FIntPoint(1, 1), InputRect.Max + FIntPoint(1, 1));
+		}
+		else
+		{
+			// Output pixel X reads the source columns floor(P) - 1 .. floor(P) + 2 with P = (X + 0.5) * In / Out - 0.5,
+			// so it depends on [Min, Max) if floor(P) is in [Min - 2, Max]
+			const float ScaleX = static_cast<float>(OutputSize.X) / InputSize.X;
+			const float ScaleY = static_cast<float>(OutputSize.Y) / InputSize.Y;
+			Rect.Min.X = FMath::FloorToInt((InputRect.Min.X - 1.5f) * ScaleX - 0.5f);
+			Rect.Min.Y = FMath::FloorToInt((InputRect.Min.Y - 1.5f) * ScaleY - 0.5f);
+			Rect.Max.X = FMath::CeilToInt((InputRect.Max.X + 1.5f) * ScaleX - 0.5f) + 1;
+			Rect.Max.Y = FMath::CeilToInt((InputRect.Max.Y + 1.5f) * ScaleY - 0.5f) + 1;
+		}
+		Rect.Clip(Bounds);
+		if (Rect.Width() > 0 && Rect.Height() > 0)
+			OutRects.Add(Rect);
+	}
+
+	// Merge overlapping regions, so no output pixel is processed twice
+	for (bool bMerged = true; bMerged; )
+	{
+		bMerged = false;
+		for (int32 Index = 0; Index < OutRects.Num() && !bMerged; ++Index)
+		{
+			for (int32 OtherIndex = Index + 1; OtherIndex < OutRects.Num(); ++OtherIndex)
+			{
+				if (OutRects[Index].Intersect(OutRects[OtherIndex]))
+				{
+					OutRects[Index].Union(OutRects[OtherIndex]);
+					OutRects.RemoveAtSwap(OtherIndex);
+					bMerged = true;
+					break;
+				}
+			}
+		}
+	}
+}
+
+bool FFidelityFXCASCPUModule::ProcessDirtyRects(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FFidelityFXCASCPUSettings& Settings,
+	const TArray<FIntRect>& InputDirtyRects) const
+{
+	if (!FidelityFXCASCPU::ValidateViews(Input, Output))
+		return false;
+	if (Input.Overlaps(Output))
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("ProcessDirtyRects: input and output views overlap."));
+		return false;
+	}
+
+	TArray<FIntRect> OutputRects;
+	GetDirtyOutputRects(Input.GetSize(), Output.GetSize(), InputDirtyRects, OutputRects);
+	if (OutputRects.Num() == 0)
+		return true;
+
+	TArray64<uint8> Scratch;
+	Scratch.AddUninitialized(FidelityFXCASCPU::GetDirtyRectsScratchSize(Input, Output, OutputRects));
+
+	return FidelityFXCASCPU::ProcessDirtyRects(Input, Output, Settings, OutputRects, Scratch.GetData(),
+		[&Settings](int32 Num, TFunctionRef<void(int32)> Function)
+		{
+			ParallelFor(Num, Function, !Settings.bMultithreaded);
+		});
+}
+
+bool FFidelityFXCASCPUModule::ProcessDirtyRects(FFidelityFXCASCPUContext& Context, const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output,
+	const FFidelityFXCASCPUSettings& Settings, const TArray<FIntRect>& InputDirtyRects) const
+{
+	if (!FidelityFXCASCPU::ValidateViews(Input, Output))
+		return false;
+	if (Input.Overlaps(Output))
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("ProcessDirtyRects: input and output views overlap."));
+		return false;
+	}
+
+	TArray<FIntRect> OutputRects;
+	GetDirtyOutputRects(Input.GetSize(), Output.GetSize(), InputDirtyRects, OutputRects);
+	if (OutputRects.Num() == 0)
+		return true;
+
+	return FidelityFXCASCPU::ProcessDirtyRects(Input, Output, Settings, OutputRects, Context.GetScratch(FidelityFXCASCPU::GetDirtyRectsScratchSize(Input, Output, OutputRects)),
+		[&Context, &Settings](int32 Num, TFunctionRef<void(int32)> Function)
+		{
+			if (Settings.bMultithreaded)
+			{
+				Context.ParallelFor(Num, Function);
+			}
+			else
+			{
+				for (int32 Index = 0; Index < Num; ++Index)
+					Function(Index);
+			}
+		});
+}
+
+bool FFidelityFXCASCPUModule::ProcessFoveated(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output,
+	const FFidelityFXCASCPUSettings& Settings, const FFidelityFXCASFoveation& Foveation) const
+{
+	if (!FidelityFXCASCPU::ValidateViews(Input, Output))
+		return false;
+	if (Input.Overlaps(Output))
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("ProcessFoveated: input and output views overlap."));
+		return false;
+	}
+	if (!Foveation.IsEnabled() || GetPrefilterSize(Input.GetSize(), Output.GetSize()) != FIntPoint(1, 1))
+		return Process(Input, Output, Settings);
+
+	FFidelityFXCASTileClassification Classification;
+	ClassifyTiles(Output.GetSize(), Foveation, Classification);
+
+	TArray64<uint8> Scratch;
+	Scratch.AddUninitialized(FidelityFXCASCPU::GetScaleTapsScratchSize(Input, Output));
+
+	return FidelityFXCASCPU::ProcessFoveated(Input, Output, Settings, Classification, Scratch.GetData(),
+		[&Settings](int32 Num, TFunctionRef<void(int32)> Function)
+		{
+			ParallelFor(Num, Function, !Settings.bMultithreaded);
+		});
+}
+
+bool FFidelityFXCASCPUModule::Resample(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FFidelityFXCASCPUSettings& Settings) const
+{
+	if (!FidelityFXCASCPU::ValidateViews(Input, Output))
+		return false;
+	if (Input.Overlaps(Output))
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("Resample: input and output views overlap."));
+		return false;
+	}
+	if (GetPrefilterSize(Input.GetSize(), Output.GetSize()) != FIntPoint(1, 1))
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("Resample: downscales beyond 2x are not supported (%dx%d -> %dx%d)."), Input.Width, Input.Height, Output.Width, Output.Height);
+		return false;
+	}
+
+	// A focus region without radii leaves every tile bilinear
+	FFidelityFXCASTileClassification Classification;
+	ClassifyTiles(Output.GetSize(), FFidelityFXCASFoveation::MakeFixed(1, 0.0f, 0.0f), Classification);
+
+	TArray64<uint8> Scratch;
+	Scratch.AddUninitialized(FidelityFXCASCPU::GetScaleTapsScratchSize(Input, Output));
+
+	return FidelityFXCASCPU::ProcessFoveated(Input, Output, Settings, Classification, Scratch.GetData(),
+		[&Settings](int32 Num, TFunctionRef<void(int32)> Function)
+		{
+			ParallelFor(Num, Function, !Settings.bMultithreaded);
+		});
+}
+
+void FFidelityFXCASCPUModule::ClassifyTiles(const FIntPoint& OutputSize, const FFidelityFXCASFoveation& Foveation, FFidelityFXCASTileClassification& OutClassification)
+{
+	const int32 TileSize = FFidelityFXCASTileClassification::TileSize;
+	OutClassification.NumTiles = FIntPoint::DivideAndRoundUp(FIntPoint(FMath::Max(OutputSize.X, 0), FMath::Max(OutputSize.Y, 0)), TileSize);
+	OutClassification.Classes.SetNumUninitialized(OutClassification.NumTiles.X * OutClassification.NumTiles.Y, false);
+	for (TArray<uint32>& TileList : OutClassification.TileLists)
+		TileList.Reset();
+
+	// Squared distance of the tile to the center in units of the radius, <= 1 inside the ellipse
+	auto GetEllipseDistance = [](const FVector2D& Delta, const FVector2D& Radius)
+	{
+		if (Radius.X <= 0.0f || Radius.Y <= 0.0f)
+			return MAX_flt;
+		return FMath::Square(Delta.X / Radius.X) + FMath::Square(Delta.Y / Radius.Y);
+	};
+
+	const FVector2D Size(OutputSize);
+	for (int32 TileY = 0; TileY < OutClassification.NumTiles.Y; ++TileY)
+	{
+		for (int32 TileX = 0; TileX < OutClassification.NumTiles.X; ++TileX)
+		{
+			// Pixel centers of the tile
+			const FVector2D Min(TileX * TileSize + 0.5f, TileY * TileSize + 0.5f);
+			const FVector2D Max(FMath::Min((TileX + 1) * TileSize, OutputSize.X) - 0.5f, FMath::Min((TileY + 1) * TileSize, OutputSize.Y) - 0.5f);
+
+			EFidelityFXCASTileClass Class = EFidelityFXCASTileClass::Bilinear;
+			for (const FFidelityFXCASFocusRegion& Region : Foveation.Regions)
+			{
+				const FVector2D Center = Region.Center * Size;
+				const FVector2D Nearest(FMath::Clamp(Center.X, Min.X, Max.X), FMath::Clamp(Center.Y, Min.Y, Max.Y));
+				const FVector2D Delta = Nearest - Center;
+				if (GetEllipseDistance(Delta, Region.InnerRadius * Size) <= 1.0f)
+					Class = EFidelityFXCASTileClass::Full;
+				else if (GetEllipseDistance(Delta, Region.OuterRadius * Size) <= 1.0f && Class == EFidelityFXCASTileClass::Bilinear)
+					Class = EFidelityFXCASTileClass::Reduced;
+			}
+
+			OutClassification.Classes[TileY * OutClassification.NumTiles.X + TileX] = Class;
+			OutClassification.TileLists[static_cast<int32>(Class)].Add(FFidelityFXCASTileClassification::PackTile(TileX, TileY));
+		}
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
+
+IMPLEMENT_MODULE(FFidelityFXCASCPUModule, FidelityFXCASCPU)
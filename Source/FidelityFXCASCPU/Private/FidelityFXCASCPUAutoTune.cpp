@@ -0,0 +1,211 @@
+#include "FidelityFXCASCPU.h"
+#include "FidelityFXCASCPUKernel.h"
+#include "FidelityFXCASCPUContext.h"
+
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/ConfigCacheIni.h"
+
+namespace FidelityFXCASCPU
+{
+	// Timed runs per candidate, the fastest one counts
+	static const int32 NumTuningRuns = 3;
+
+	// Fills the view with noise. The kernels have no data dependent branches, so noise costs the same as real frames.
+	static void FillSyntheticFrame(const FFidelityFXCASImageView& View)
+	{
+		FRandomStream Stream(0x43415321);
+		for (int32 Y = 0; Y < View.Height; ++Y)
+		{
+			uint8* Row = View.GetRow(Y);
+			switch (View.Format)
+			{
+			case EFidelityFXCASPixelFormat::RGBA32F:
+			case EFidelityFXCASPixelFormat::RGB32F:
+				for (int32 Index = 0; Index < View.Width * View.GetBytesPerPixel() / 4; ++Index)
+					reinterpret_cast<float*>(Row)[Index] = Stream.GetFraction();
+				break;
+			case EFidelityFXCASPixelFormat::RGBA16F:
+				for (int32 Index = 0; Index < View.Width * 4; ++Index)
+					reinterpret_cast<uint16*>(Row)[Index] = FloatToHalf(Stream.GetFraction());
+				break;
+			default:
+				for (int32 Index = 0; Index < View.Width * View.GetBytesPerPixel(); ++Index)
+					Row[Index] = static_cast<uint8>(Stream.RandHelper(256));
+				break;
+			}
+		}
+	}
+
+	static float MeasureMilliseconds(FFidelityFXCASCPUContext& Context, const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output,
+		const FFidelityFXCASCPUSettings& Settings)
+	{
+		const FFidelityFXCASCPUModule& Module = FFidelityFXCASCPUModule::Get();
+
+		// Warm up: grows the scratch arena and touches the pages
+		if (!Module.Process(Context, Input, Output, Settings))
+			return MAX_flt;
+
+		double BestTime = MAX_dbl;
+		for (int32 Run = 0; Run < NumTuningRuns; ++Run)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			Module.Process(Context, Input, Output, Settings);
+			BestTime = FMath::Min(BestTime, FPlatformTime::Seconds() - StartTime);
+		}
+		return static_cast<float>(BestTime * 1000.0);
+	}
+
+	static FString GetTuningSection(const FIntPoint& InputSize, const FIntPoint& OutputSize, EFidelityFXCASPixelFormat Format)
+	{
+		return FString::Printf(TEXT("FidelityFXCASCPU %dx%d %dx%d %d"), InputSize.X, InputSize.Y, OutputSize.X, OutputSize.Y, static_cast<int32>(Format));
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+// FFidelityFXCASCPUModule auto-tuning
+//-------------------------------------------------------------------------------------------------
+
+bool FFidelityFXCASCPUModule::AutoTune(const FIntPoint& InputSize, const FIntPoint& OutputSize, EFidelityFXCASPixelFormat Format,
+	FFidelityFXCASCPUTuning& OutTuning) const
+{
+	using namespace FidelityFXCASCPU;
+
+	if (InputSize.X <= 0 || InputSize.Y <= 0 || OutputSize.X <= 0 || OutputSize.Y <= 0 || GetFidelityFXCASBytesPerPixel(Format) == 0)
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("AutoTune: invalid workload (input %dx%d, output %dx%d)."), InputSize.X, InputSize.Y, OutputSize.X, OutputSize.Y);
+		return false;
+	}
+
+	// Synthetic frame
+	const int32 BytesPerPixel = GetFidelityFXCASBytesPerPixel(Format);
+	TArray64<uint8> InputData, OutputData;
+	InputData.AddUninitialized(static_cast<int64>(InputSize.X) * InputSize.Y * BytesPerPixel);
+	OutputData.AddUninitialized(static_cast<int64>(OutputSize.X) * OutputSize.Y * BytesPerPixel);
+	const FFidelityFXCASImageView Input(InputData.GetData(), InputSize.X, InputSize.Y, static_cast<int64>(InputSize.X) * BytesPerPixel, Format);
+	const FFidelityFXCASImageView Output(OutputData.GetData(), OutputSize.X, OutputSize.Y, static_cast<int64>(OutputSize.X) * BytesPerPixel, Format);
+	FillSyntheticFrame(Input);
+
+	// Candidates
+	TArray<bool> SIMDCandidates = { false };
+#if FX_CAS_CPU_SIMD
+	if (HasAVX2F16C())
+		SIMDCandidates.Add(true);
+#endif // FX_CAS_CPU_SIMD
+	const TArray<int32> RowsPerTaskCandidates = { 4, 8, 16, 32, 64 };
+	TArray<int32> NumThreadsCandidates;
+	NumThreadsCandidates.AddUnique(FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+	NumThreadsCandidates.AddUnique(FPlatformMisc::NumberOfCores());
+	NumThreadsCandidates.AddUnique(FMath::Max(FPlatformMisc::NumberOfCores() / 2, 1));
+	NumThreadsCandidates.AddUnique(1);
+
+	// The dimensions barely interact, so they are tuned one after another instead of timing every combination:
+	// ISA on all threads, then the band height, then the thread count
+	FFidelityFXCASCPUSettings Settings;
+	int32 NumThreads = NumThreadsCandidates[0];
+	float BestTime = MAX_flt;
+	{
+		FFidelityFXCASCPUContext Context(NumThreads);
+		bool bBestSIMD = false;
+		for (bool bAllowSIMD : SIMDCandidates)
+		{
+			Settings.bAllowSIMD = bAllowSIMD;
+			const float Time = MeasureMilliseconds(Context, Input, Output, Settings);
+			UE_LOG(LogFidelityFXCASCPU, Verbose, TEXT("AutoTune: SIMD %d: %.3f ms."), bAllowSIMD ? 1 : 0, Time);
+			if (Time < BestTime)
+			{
+				BestTime = Time;
+				bBestSIMD = bAllowSIMD;
+			}
+		}
+		Settings.bAllowSIMD = bBestSIMD;
+
+		int32 BestRowsPerTask = Settings.RowsPerTask;
+		for (int32 RowsPerTask : RowsPerTaskCandidates)
+		{
+			Settings.RowsPerTask = RowsPerTask;
+			const float Time = MeasureMilliseconds(Context, Input, Output, Settings);
+			UE_LOG(LogFidelityFXCASCPU, Verbose, TEXT("AutoTune: %d rows per task: %.3f ms."), RowsPerTask, Time);
+			if (Time < BestTime)
+			{
+				BestTime = Time;
+				BestRowsPerTask = RowsPerTask;
+			}
+		}
+		Settings.RowsPerTask = BestRowsPerTask;
+	}
+	for (int32 CandidateIndex = 1; CandidateIndex < NumThreadsCandidates.Num(); ++CandidateIndex)
+	{
+		FFidelityFXCASCPUContext Context(NumThreadsCandidates[CandidateIndex]);
+		const float Time = MeasureMilliseconds(Context, Input, Output, Settings);
+		UE_LOG(LogFidelityFXCASCPU, Verbose, TEXT("AutoTune: %d threads: %.3f ms."), NumThreadsCandidates[CandidateIndex], Time);
+		if (Time < BestTime)
+		{
+			BestTime = Time;
+			NumThreads = NumThreadsCandidates[CandidateIndex];
+		}
+	}
+	if (BestTime == MAX_flt)
+		return false;
+
+	OutTuning.CPUBrand = FPlatformMisc::GetCPUBrand().TrimStartAndEnd();
+	OutTuning.InputSize = InputSize;
+	OutTuning.OutputSize = OutputSize;
+	OutTuning.Format = Format;
+	OutTuning.bAllowSIMD = Settings.bAllowSIMD;
+	OutTuning.RowsPerTask = Settings.RowsPerTask;
+	OutTuning.NumThreads = NumThreads;
+	OutTuning.MillisecondsPerImage = BestTime;
+
+	UE_LOG(LogFidelityFXCASCPU, Display, TEXT("AutoTune %dx%d -> %dx%d: SIMD %s, %d rows per task, %d threads, %.3f ms per image."),
+		InputSize.X, InputSize.Y, OutputSize.X, OutputSize.Y, OutTuning.bAllowSIMD ? TEXT("ON") : TEXT("OFF"), OutTuning.RowsPerTask, OutTuning.NumThreads, BestTime);
+	return true;
+}
+
+bool FFidelityFXCASCPUModule::SaveTuning(const FString& Filename, const FFidelityFXCASCPUTuning& Tuning)
+{
+	// One section per workload, so a profile can hold the results of several resolutions and formats
+	FConfigFile Profile;
+	Profile.Read(Filename);
+
+	const FString Section = FidelityFXCASCPU::GetTuningSection(Tuning.InputSize, Tuning.OutputSize, Tuning.Format);
+	Profile.SetString(*Section, TEXT("CPUBrand"), *Tuning.CPUBrand);
+	Profile.SetString(*Section, TEXT("bAllowSIMD"), Tuning.bAllowSIMD ? TEXT("True") : TEXT("False"));
+	Profile.SetString(*Section, TEXT("RowsPerTask"), *FString::FromInt(Tuning.RowsPerTask));
+	Profile.SetString(*Section, TEXT("NumThreads"), *FString::FromInt(Tuning.NumThreads));
+	Profile.SetString(*Section, TEXT("MillisecondsPerImage"), *FString::SanitizeFloat(Tuning.MillisecondsPerImage));
+
+	if (!Profile.Write(Filename))
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("SaveTuning: failed to write %s."), *Filename);
+		return false;
+	}
+	return true;
+}
+
+bool FFidelityFXCASCPUModule::LoadTuning(const FString& Filename, const FIntPoint& InputSize, const FIntPoint& OutputSize, EFidelityFXCASPixelFormat Format,
+	FFidelityFXCASCPUTuning& OutTuning)
+{
+	FConfigFile Profile;
+	Profile.Read(Filename);
+
+	// Results measured on another CPU do not apply
+	const FString Section = FidelityFXCASCPU::GetTuningSection(InputSize, OutputSize, Format);
+	FString CPUBrand, Value;
+	if (!Profile.GetString(*Section, TEXT("CPUBrand"), CPUBrand) || CPUBrand != FPlatformMisc::GetCPUBrand().TrimStartAndEnd())
+		return false;
+
+	OutTuning.CPUBrand = CPUBrand;
+	OutTuning.InputSize = InputSize;
+	OutTuning.OutputSize = OutputSize;
+	OutTuning.Format = Format;
+	if (Profile.GetString(*Section, TEXT("bAllowSIMD"), Value))
+		OutTuning.bAllowSIMD = Value.ToBool();
+	if (Profile.GetString(*Section, TEXT("RowsPerTask"), Value))
+		OutTuning.RowsPerTask = FCString::Atoi(*Value);
+	if (Profile.GetString(*Section, TEXT("NumThreads"), Value))
+		OutTuning.NumThreads = FCString::Atoi(*Value);
+	if (Profile.GetString(*Section, TEXT("MillisecondsPerImage"), Value))
+		OutTuning.MillisecondsPerImage = FCString::Atof(*Value);
+	return true;
+}
@@ -0,0 +1,153 @@
+#include "FidelityFXCASCPUContext.h"
+#include "FidelityFXCASCPUTileCache.h"
+
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/QueuedThreadPool.h"
+
+//-------------------------------------------------------------------------------------------------
+// Work item
+//-------------------------------------------------------------------------------------------------
+
+// State of one ParallelFor call shared by all work items
+struct FFidelityFXCASCPUJob
+{
+	TFunctionRef<void(int32)>* Function = nullptr;
+	int32 Num = 0;
+	FThreadSafeCounter NextIndex;
+	FThreadSafeCounter NumPendingWorkers;
+	FEvent* DoneEvent = nullptr;
+
+	// Pulls indices until the job is drained, so uneven bands balance themselves
+	void Drain()
+	{
+		for (int32 Index = NextIndex.Increment() - 1; Index < Num; Index = NextIndex.Increment() - 1)
+			(*Function)(Index);
+	}
+};
+
+class FFidelityFXCASCPUWork : public IQueuedWork
+{
+public:
+	FFidelityFXCASCPUJob* Job = nullptr;
+
+	virtual void DoThreadedWork() override
+	{
+		FFidelityFXCASCPUJob* CurrentJob = Job;
+		CurrentJob->Drain();
+		if (CurrentJob->NumPendingWorkers.Decrement() == 0)
+			CurrentJob->DoneEvent->Trigger();
+	}
+
+	virtual void Abandon() override
+	{
+		FFidelityFXCASCPUJob* CurrentJob = Job;
+		if (CurrentJob->NumPendingWorkers.Decrement() == 0)
+			CurrentJob->DoneEvent->Trigger();
+	}
+};
+
+//-------------------------------------------------------------------------------------------------
+// FFidelityFXCASCPUContext class implementation
+//-------------------------------------------------------------------------------------------------
+
+FFidelityFXCASCPUContext::FFidelityFXCASCPUContext(int32 NumThreads)
+{
+	if (NumThreads <= 0)
+		NumThreads = FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+	NumWorkers = FMath::Max(NumThreads - 1, 0);
+
+	if (NumWorkers > 0)
+	{
+		ThreadPool = FQueuedThreadPool::Allocate();
+		if (ThreadPool->Create(NumWorkers, 128 * 1024, TPri_Normal, TEXT("FidelityFXCASCPU")))
+		{
+			for (int32 WorkerIndex = 0; WorkerIndex < NumWorkers; ++WorkerIndex)
+				Work.Add(new FFidelityFXCASCPUWork());
+			DoneEvent = FPlatformProcess::GetSynchEventFromPool(false);
+		}
+		else
+		{
+			delete ThreadPool;
+			ThreadPool = nullptr;
+			NumWorkers = 0;
+		}
+	}
+}
+
+FFidelityFXCASCPUContext::~FFidelityFXCASCPUContext()
+{
+	if (ThreadPool)
+	{
+		ThreadPool->Destroy();
+		delete ThreadPool;
+	}
+	for (FFidelityFXCASCPUWork* WorkItem : Work)
+		delete WorkItem;
+	if (DoneEvent)
+		FPlatformProcess::ReturnSynchEventToPool(DoneEvent);
+}
+
+void FFidelityFXCASCPUContext::ParallelFor(int32 Num, TFunctionRef<void(int32)> Function)
+{
+	FFidelityFXCASCPUJob Job;
+	Job.Function = &Function;
+	Job.Num = Num;
+	Job.DoneEvent = DoneEvent;
+
+	// The calling thread takes one share of the work itself
+	const int32 NumJobWorkers = FMath::Min(NumWorkers, Num - 1);
+	if (NumJobWorkers <= 0)
+	{
+		Job.Drain();
+		return;
+	}
+
+	Job.NumPendingWorkers.Set(NumJobWorkers);
+	for (int32 WorkerIndex = 0; WorkerIndex < NumJobWorkers; ++WorkerIndex)
+	{
+		Work[WorkerIndex]->Job = &Job;
+		ThreadPool->AddQueuedWork(Work[WorkerIndex]);
+	}
+	Job.Drain();
+	DoneEvent->Wait();
+}
+
+uint8* FFidelityFXCASCPUContext::GetScratch(int64 Size)
+{
+	if (Scratch.Num() < Size)
+	{
+		Scratch.Empty(Size);
+		Scratch.AddUninitialized(Size);
+	}
+	return Scratch.GetData();
+}
+
+void FFidelityFXCASCPUContext::SetTileCacheBudget(int64 Bytes)
+{
+	if (Bytes <= 0)
+	{
+		TileCache.Reset();
+		return;
+	}
+	GetTileCache().SetBudget(Bytes);
+}
+
+FFidelityFXCASTileCacheStats FFidelityFXCASCPUContext::GetTileCacheStats() const
+{
+	return TileCache.IsValid() ? TileCache->GetStats() : FFidelityFXCASTileCacheStats();
+}
+
+void FFidelityFXCASCPUContext::ResetTileCacheStats()
+{
+	if (TileCache.IsValid())
+		TileCache->ResetStats();
+}
+
+FFidelityFXCASCPUTileCache& FFidelityFXCASCPUContext::GetTileCache()
+{
+	if (!TileCache.IsValid())
+		TileCache = MakeUnique<FFidelityFXCASCPUTileCache>();
+	return *TileCache;
+}
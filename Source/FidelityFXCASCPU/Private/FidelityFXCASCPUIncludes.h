@@ -0,0 +1,9 @@
+#pragma once
+
+// Since ffx_*.ush files don't have #pragma once we wrap those includes in a separate header file
+// Only the A_CPU parts (CasSetup) are compiled here, the filter itself is ported in FidelityFXCASCPUKernel.h
+
+#include <stdint.h>
+#define A_CPU 1
+#include "ffx_a.ush"
+#include "ffx_cas.ush"
@@ -0,0 +1,505 @@
+#include "FidelityFXCASCPUJobQueue.h"
+#include "FidelityFXCASCPU.h"
+#include "FidelityFXCASCPUKernel.h"
+
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Misc/QueuedThreadPool.h"
+#include "Misc/ScopeLock.h"
+
+//-------------------------------------------------------------------------------------------------
+// Jobs and work items
+//-------------------------------------------------------------------------------------------------
+
+struct FFidelityFXCASCPUJobQueue::FJob
+{
+	uint64 Id = 0;
+	FFidelityFXCASCPUJobDesc Desc;
+	TPromise<FFidelityFXCASCPUJobResult> Promise;
+	double SubmitTime = 0.0;
+	double StartTime = 0.0;			// 0 while queued
+	double Deadline = 0.0;			// FPlatformTime::Seconds(), 0 = none
+	FThreadSafeBool bCancelled;
+	FThreadSafeBool bStopped;		// Bands were skipped after a cancel or the deadline
+	// Kept for all phases of the job, so the scratch of a preempted job is not shared with the preempting one
+	TArray64<uint8> Scratch;
+	// Triggered by the last thread leaving a phase of the job
+	FEvent* PhaseDoneEvent = nullptr;
+
+	FORCEINLINE bool IsExpired() const   { return Deadline > 0.0 && FPlatformTime::Seconds() > Deadline; }
+	FORCEINLINE bool ShouldStop() const  { return bCancelled || IsExpired(); }
+	FORCEINLINE double GetDeadlineOrder() const { return Deadline > 0.0 ? Deadline : MAX_dbl; }
+};
+
+// Bands of one ParallelForFunction call of a running job
+struct FFidelityFXCASCPUJobQueue::FPhase
+{
+	FJob* Job = nullptr;
+	TFunctionRef<void(int32)>* Function = nullptr;
+	int32 Num = 0;
+	FThreadSafeCounter NextIndex;
+	// The job's thread and the helping threads, the phase lives until the last one left
+	FThreadSafeCounter NumUsers;
+	// Open phases of the priority while the phase has bands left, nullptr if the bands aren't shared
+	FThreadSafeCounter* NumOpenPhases = nullptr;
+	FThreadSafeCounter NumClosed;
+
+	FORCEINLINE bool HasBands() const { return NextIndex.GetValue() < Num; }
+
+	// Called by every thread finding no band left, the first one closes the phase
+	FORCEINLINE void Close()
+	{
+		if (NumOpenPhases && NumClosed.Increment() == 1)
+			NumOpenPhases->Decrement();
+	}
+
+	FORCEINLINE void RunBand(int32 Index)
+	{
+		// A stopped job drains its bands without running them
+		if (Job->ShouldStop())
+		{
+			Job->bStopped = true;
+			NextIndex.Set(Num);
+			return;
+		}
+		(*Function)(Index);
+	}
+};
+
+// One per queue thread, queued to the pool when the thread is woken for new work
+class FFidelityFXCASCPUJobWorker : public IQueuedWork
+{
+public:
+	FFidelityFXCASCPUJobQueue* Queue = nullptr;
+
+	virtual void DoThreadedWork() override
+	{
+		Queue->RunWorker(this);
+	}
+
+	virtual void Abandon() override
+	{
+		FScopeLock ScopeLock(&Queue->Lock);
+		Queue->IdleWorkers.Add(this);
+	}
+};
+
+//-------------------------------------------------------------------------------------------------
+// FFidelityFXCASCPUJobQueue class implementation
+//-------------------------------------------------------------------------------------------------
+
+FFidelityFXCASCPUJobQueue::FFidelityFXCASCPUJobQueue(int32 InNumThreads)
+{
+	NumThreads = InNumThreads > 0 ? InNumThreads : FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+
+	ThreadPool = FQueuedThreadPool::Allocate();
+	if (ThreadPool->Create(NumThreads, 128 * 1024, TPri_Normal, TEXT("FidelityFXCASCPUJobQueue")))
+	{
+		for (int32 WorkerIndex = 0; WorkerIndex < NumThreads; ++WorkerIndex)
+		{
+			FFidelityFXCASCPUJobWorker* Worker = new FFidelityFXCASCPUJobWorker();
+			Worker->Queue = this;
+			Workers.Add(Worker);
+			IdleWorkers.Add(Worker);
+		}
+	}
+	else
+	{
+		// Jobs run on the submitting thread
+		UE_LOG(LogFidelityFXCASCPU, Warning, TEXT("FFidelityFXCASCPUJobQueue: couldn't create the queue threads, jobs will run in Submit()."));
+		delete ThreadPool;
+		ThreadPool = nullptr;
+		NumThreads = 0;
+	}
+}
+
+FFidelityFXCASCPUJobQueue::~FFidelityFXCASCPUJobQueue()
+{
+	TArray<FJob*> CancelledJobs;
+	{
+		FScopeLock ScopeLock(&Lock);
+		bShuttingDown = true;
+		for (int32 PriorityIndex = 0; PriorityIndex < static_cast<int32>(EFidelityFXCASJobPriority::Num); ++PriorityIndex)
+		{
+			while (FJob* Job = PopQueuedJob(static_cast<EFidelityFXCASJobPriority>(PriorityIndex)))
+				CancelledJobs.Add(Job);
+		}
+		for (FJob* Job : RunningJobs)
+			Job->bCancelled = true;
+	}
+	for (FJob* Job : CancelledJobs)
+	{
+		Job->bCancelled = true;
+		EndJob(Job, EFidelityFXCASJobStatus::Cancelled);
+	}
+
+	// Running jobs stop at their next band
+	for (;;)
+	{
+		{
+			FScopeLock ScopeLock(&Lock);
+			if (IdleWorkers.Num() == Workers.Num())
+				break;
+		}
+		FPlatformProcess::Sleep(0.001f);
+	}
+
+	if (ThreadPool)
+	{
+		ThreadPool->Destroy();
+		delete ThreadPool;
+	}
+	for (FFidelityFXCASCPUJobWorker* Worker : Workers)
+		delete Worker;
+}
+
+FFidelityFXCASCPUJobHandle FFidelityFXCASCPUJobQueue::Submit(FFidelityFXCASCPUJobDesc&& Desc)
+{
+	FFidelityFXCASCPUJobHandle Handle;
+	if (Desc.Priority >= EFidelityFXCASJobPriority::Num)
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("FFidelityFXCASCPUJobQueue::Submit: invalid priority %d."), static_cast<int32>(Desc.Priority));
+		return Handle;
+	}
+
+	FJob* Job = new FJob();
+	Job->Desc = MoveTemp(Desc);
+	Job->SubmitTime = FPlatformTime::Seconds();
+	Job->Deadline = Job->Desc.DeadlineSeconds > 0.0 ? Job->SubmitTime + Job->Desc.DeadlineSeconds : 0.0;
+	Handle.Future = Job->Promise.GetFuture();
+
+	const int32 PriorityIndex = static_cast<int32>(Job->Desc.Priority);
+	{
+		FScopeLock ScopeLock(&Lock);
+		check(!bShuttingDown);
+		// The job may end and be deleted as soon as the lock is released
+		Job->Id = NextJobId++;
+		Handle.JobId = Job->Id;
+		QueuedJobs[PriorityIndex].Add(Job);
+		NumQueuedJobs[PriorityIndex].Increment();
+		++Stats.Priorities[PriorityIndex].NumQueued;
+		WakeWorkers(1);
+	}
+
+	if (!ThreadPool)
+		RunWorker(nullptr);
+	return Handle;
+}
+
+bool FFidelityFXCASCPUJobQueue::Cancel(uint64 JobId)
+{
+	FJob* QueuedJob = nullptr;
+	{
+		FScopeLock ScopeLock(&Lock);
+		for (int32 PriorityIndex = 0; PriorityIndex < static_cast<int32>(EFidelityFXCASJobPriority::Num) && !QueuedJob; ++PriorityIndex)
+		{
+			const int32 Index = QueuedJobs[PriorityIndex].IndexOfByPredicate([JobId](const FJob* Job) { return Job->Id == JobId; });
+			if (Index != INDEX_NONE)
+			{
+				QueuedJob = QueuedJobs[PriorityIndex][Index];
+				QueuedJobs[PriorityIndex].RemoveAt(Index);
+				NumQueuedJobs[PriorityIndex].Decrement();
+				--Stats.Priorities[PriorityIndex].NumQueued;
+			}
+		}
+
+		if (!QueuedJob)
+		{
+			// Running jobs end at their next band
+			const int32 Index = RunningJobs.IndexOfByPredicate([JobId](const FJob* Job) { return Job->Id == JobId; });
+			if (Index == INDEX_NONE)
+				return false;
+			RunningJobs[Index]->bCancelled = true;
+			return true;
+		}
+	}
+
+	QueuedJob->bCancelled = true;
+	EndJob(QueuedJob, EFidelityFXCASJobStatus::Cancelled);
+	return true;
+}
+
+FFidelityFXCASCPUJobQueueStats FFidelityFXCASCPUJobQueue::GetStats() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Stats;
+}
+
+void FFidelityFXCASCPUJobQueue::ResetStats()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	// Queue depth and running jobs are state, not counters
+	for (FFidelityFXCASCPUJobPriorityStats& PriorityStats : Stats.Priorities)
+	{
+		const int32 NumQueued = PriorityStats.NumQueued;
+		const int32 NumRunning = PriorityStats.NumRunning;
+		PriorityStats = FFidelityFXCASCPUJobPriorityStats();
+		PriorityStats.NumQueued = NumQueued;
+		PriorityStats.NumRunning = NumRunning;
+	}
+}
+
+void FFidelityFXCASCPUJobQueue::RunWorker(FFidelityFXCASCPUJobWorker* Worker)
+{
+	// Priority of the phase this thread left last, running higher priority work next counts as a preemption
+	EFidelityFXCASJobPriority LeftPriority = EFidelityFXCASJobPriority::Num;
+	for (;;)
+	{
+		FJob* Job = nullptr;
+		FPhase* Phase = nullptr;
+		{
+			FScopeLock ScopeLock(&Lock);
+			if (!PickWork(Job, Phase))
+			{
+				if (Worker)
+					IdleWorkers.Add(Worker);
+				return;
+			}
+
+			const EFidelityFXCASJobPriority Priority = Job ? Job->Desc.Priority : Phase->Job->Desc.Priority;
+			if (Priority < LeftPriority && LeftPriority != EFidelityFXCASJobPriority::Num)
+				++Stats.Get(LeftPriority).NumPreempted;
+			if (Phase)
+				Phase->NumUsers.Increment();
+		}
+
+		LeftPriority = EFidelityFXCASJobPriority::Num;
+		if (Job)
+		{
+			RunJob(Job);
+		}
+		else
+		{
+			const EFidelityFXCASJobPriority Priority = Phase->Job->Desc.Priority;
+			if (!HelpPhase(Phase))
+				LeftPriority = Priority;
+		}
+	}
+}
+
+bool FFidelityFXCASCPUJobQueue::PickWork(FJob*& OutJob, FPhase*& OutPhase, EFidelityFXCASJobPriority Limit)
+{
+	for (int32 PriorityIndex = 0; PriorityIndex < static_cast<int32>(Limit); ++PriorityIndex)
+	{
+		const EFidelityFXCASJobPriority Priority = static_cast<EFidelityFXCASJobPriority>(PriorityIndex);
+
+		// Started jobs finish first, they hold their scratch memory and their caller waits the longest
+		for (FPhase* Phase : Phases)
+		{
+			if (Phase->Job->Desc.Priority == Priority && Phase->HasBands())
+			{
+				OutPhase = Phase;
+				return true;
+			}
+		}
+
+		OutJob = PopQueuedJob(Priority);
+		if (OutJob)
+		{
+			const double Now = FPlatformTime::Seconds();
+			FFidelityFXCASCPUJobPriorityStats& PriorityStats = Stats.Get(Priority);
+			++PriorityStats.NumRunning;
+			if (!OutJob->ShouldStop())
+			{
+				++PriorityStats.NumStarted;
+				PriorityStats.TotalWaitSeconds += Now - OutJob->SubmitTime;
+				PriorityStats.MaxWaitSeconds = FMath::Max(PriorityStats.MaxWaitSeconds, Now - OutJob->SubmitTime);
+			}
+			OutJob->StartTime = Now;
+			RunningJobs.Add(OutJob);
+			return true;
+		}
+	}
+	return false;
+}
+
+FFidelityFXCASCPUJobQueue::FJob* FFidelityFXCASCPUJobQueue::PopQueuedJob(EFidelityFXCASJobPriority Priority)
+{
+	const int32 PriorityIndex = static_cast<int32>(Priority);
+	TArray<FJob*>& Queue = QueuedJobs[PriorityIndex];
+	if (Queue.Num() == 0)
+		return nullptr;
+
+	int32 BestIndex = 0;
+	for (int32 Index = 1; Index < Queue.Num(); ++Index)
+	{
+		if (Queue[Index]->GetDeadlineOrder() < Queue[BestIndex]->GetDeadlineOrder())
+			BestIndex = Index;
+	}
+
+	FJob* Job = Queue[BestIndex];
+	Queue.RemoveAt(BestIndex);
+	NumQueuedJobs[PriorityIndex].Decrement();
+	--Stats.Priorities[PriorityIndex].NumQueued;
+	return Job;
+}
+
+void FFidelityFXCASCPUJobQueue::RunJob(FJob* Job)
+{
+	// Expired while queued, or cancelled at shutdown
+	if (Job->ShouldStop())
+	{
+		EndJob(Job, Job->bCancelled ? EFidelityFXCASJobStatus::Cancelled : EFidelityFXCASJobStatus::Expired);
+		return;
+	}
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASCPUJobQueue_RunJob); // Used to gather CPU profiling data for the UE4 session frontend
+
+	Job->PhaseDoneEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	const bool bProcessed = FidelityFXCASCPU::ProcessScheduled(Job->Desc.Input, Job->Desc.Output, Job->Desc.Settings, Job->Scratch,
+		[this, Job](int32 Num, TFunctionRef<void(int32)> Function)
+		{
+			RunPhase(Job, Num, Function);
+		});
+	FPlatformProcess::ReturnSynchEventToPool(Job->PhaseDoneEvent);
+	Job->PhaseDoneEvent = nullptr;
+
+	if (!bProcessed)
+		EndJob(Job, EFidelityFXCASJobStatus::Failed);
+	else if (Job->bStopped)
+		EndJob(Job, Job->bCancelled ? EFidelityFXCASJobStatus::Cancelled : EFidelityFXCASJobStatus::Expired);
+	else
+		EndJob(Job, EFidelityFXCASJobStatus::Completed);
+}
+
+void FFidelityFXCASCPUJobQueue::RunPhase(FJob* Job, int32 Num, TFunctionRef<void(int32)> Function)
+{
+	FPhase Phase;
+	Phase.Job = Job;
+	Phase.Function = &Function;
+	Phase.Num = Num;
+	Phase.NumUsers.Set(1);
+
+	// Single threaded jobs keep their bands, they still give way to higher priorities between them
+	const bool bShared = Job->Desc.Settings.bMultithreaded && Num > 1 && NumThreads > 1;
+	if (bShared)
+	{
+		FScopeLock ScopeLock(&Lock);
+		Phase.NumOpenPhases = &NumOpenPhases[static_cast<int32>(Job->Desc.Priority)];
+		Phase.NumOpenPhases->Increment();
+		Phases.Add(&Phase);
+		WakeWorkers(Num - 1);
+	}
+
+	for (;;)
+	{
+		RunPreemptingJobs(Job);
+		const int32 Index = Phase.NextIndex.Increment() - 1;
+		if (Index >= Num)
+			break;
+		Phase.RunBand(Index);
+	}
+	Phase.Close();
+
+	if (bShared)
+	{
+		{
+			FScopeLock ScopeLock(&Lock);
+			Phases.Remove(&Phase);
+		}
+		// Helpers still running their last band
+		if (Phase.NumUsers.Decrement() != 0)
+			Job->PhaseDoneEvent->Wait();
+	}
+}
+
+bool FFidelityFXCASCPUJobQueue::HelpPhase(FPhase* Phase)
+{
+	bool bDrained = true;
+	const EFidelityFXCASJobPriority Priority = Phase->Job->Desc.Priority;
+	for (;;)
+	{
+		if (HasWorkAbove(Priority))
+		{
+			bDrained = false;
+			break;
+		}
+		const int32 Index = Phase->NextIndex.Increment() - 1;
+		if (Index >= Phase->Num)
+		{
+			Phase->Close();
+			break;
+		}
+		Phase->RunBand(Index);
+	}
+
+	// The phase is gone once the last user left, the event belongs to the job
+	FEvent* PhaseDoneEvent = Phase->Job->PhaseDoneEvent;
+	if (Phase->NumUsers.Decrement() == 0)
+		PhaseDoneEvent->Trigger();
+	return bDrained;
+}
+
+void FFidelityFXCASCPUJobQueue::RunPreemptingJobs(FJob* Job)
+{
+	const EFidelityFXCASJobPriority Priority = Job->Desc.Priority;
+	while (HasWorkAbove(Priority))
+	{
+		FJob* PreemptingJob = nullptr;
+		FPhase* Phase = nullptr;
+		{
+			FScopeLock ScopeLock(&Lock);
+			if (!PickWork(PreemptingJob, Phase, Priority))
+				return;
+			++Stats.Get(Priority).NumPreempted;
+			if (Phase)
+				Phase->NumUsers.Increment();
+		}
+
+		// Nested on this thread, Job continues when the higher priority work is done or has enough threads
+		if (PreemptingJob)
+			RunJob(PreemptingJob);
+		else
+			HelpPhase(Phase);
+	}
+}
+
+bool FFidelityFXCASCPUJobQueue::HasWorkAbove(EFidelityFXCASJobPriority Priority) const
+{
+	for (int32 PriorityIndex = 0; PriorityIndex < static_cast<int32>(Priority); ++PriorityIndex)
+	{
+		if (NumQueuedJobs[PriorityIndex].GetValue() > 0 || NumOpenPhases[PriorityIndex].GetValue() > 0)
+			return true;
+	}
+	return false;
+}
+
+void FFidelityFXCASCPUJobQueue::WakeWorkers(int32 Num)
+{
+	for (; Num > 0 && IdleWorkers.Num() > 0; --Num)
+		ThreadPool->AddQueuedWork(IdleWorkers.Pop());
+}
+
+void FFidelityFXCASCPUJobQueue::EndJob(FJob* Job, EFidelityFXCASJobStatus Status)
+{
+	FFidelityFXCASCPUJobResult Result;
+	Result.Status = Status;
+	const double Now = FPlatformTime::Seconds();
+	Result.WaitSeconds = (Job->StartTime > 0.0 ? Job->StartTime : Now) - Job->SubmitTime;
+	Result.LatencySeconds = Now - Job->SubmitTime;
+
+	{
+		FScopeLock ScopeLock(&Lock);
+		FFidelityFXCASCPUJobPriorityStats& PriorityStats = Stats.Get(Job->Desc.Priority);
+		if (RunningJobs.Remove(Job) > 0)
+			--PriorityStats.NumRunning;
+		switch (Status)
+		{
+		case EFidelityFXCASJobStatus::Completed:
+			++PriorityStats.NumCompleted;
+			PriorityStats.TotalLatencySeconds += Result.LatencySeconds;
+			PriorityStats.MaxLatencySeconds = FMath::Max(PriorityStats.MaxLatencySeconds, Result.LatencySeconds);
+			break;
+		case EFidelityFXCASJobStatus::Failed:    ++PriorityStats.NumFailed; break;
+		case EFidelityFXCASJobStatus::Cancelled: ++PriorityStats.NumCancelled; break;
+		case EFidelityFXCASJobStatus::Expired:   ++PriorityStats.NumExpired; break;
+		}
+	}
+
+	if (Job->Desc.OnComplete)
+		Job->Desc.OnComplete(Result);
+	Job->Promise.SetValue(Result);
+	delete Job;
+}
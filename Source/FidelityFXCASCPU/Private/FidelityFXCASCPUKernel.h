@@ -0,0 +1,786 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include "FidelityFXCASCPUTypes.h"
+
+// CPU port of CasFilter() from ffx_cas.ush (default quality: no CAS_BETTER_DIAGONALS, no CAS_SLOW, no CAS_GO_SLOWER).
+// The kernels read the input and write the output through the image views directly, so they can run over
+// mapped files without any intermediate full frame copy or format conversion.
+// Pixels outside the input are clamped to the edge.
+
+namespace FidelityFXCASCPU
+{
+	//-------------------------------------------------------------------------------------------------
+	// Constants
+	//-------------------------------------------------------------------------------------------------
+
+	// Source taps of one output column or row of the scaling path
+	struct FScaleTaps
+	{
+		int32 Index[4];	// Source indices of the taps at -1, 0, +1 and +2, clamped to the input
+		float Phase;	// Bilinear phase between the taps 0 and +1
+	};
+
+	// Constants generated by CasSetup(), unpacked to floats
+	struct FConstants
+	{
+		float ScaleX = 1.0f;	// const0.x
+		float ScaleY = 1.0f;	// const0.y
+		float OffsetX = 0.0f;	// const0.z
+		float OffsetY = 0.0f;	// const0.w
+		float Peak = 0.0f;		// const1.x
+
+		// Scaling only, one entry per output column / row, see SetupScaleTaps()
+		const FScaleTaps* ColumnTaps = nullptr;
+		const FScaleTaps* RowTaps = nullptr;
+		// Scaling only, image column of the first output column when the output is a sub-view (the taps are shifted to it)
+		int32 ColumnBegin = 0;
+	};
+
+	// Calls CasSetup() so the CPU and GPU paths always share the same constants
+	void Setup(FConstants& OutConstants, float Sharpness, const FIntPoint& InputSize, const FIntPoint& OutputSize);
+
+	// Row kernel, processes the output rows [RowBegin, RowEnd)
+	typedef void (*FRowsFunction)(const FFidelityFXCASImageView&, const FFidelityFXCASImageView&, const FConstants&, int32, int32);
+
+	// Picks the row kernel for the view formats and the settings, nullptr for unsupported combinations.
+	// Output is the whole output image, sub-views of it are passed to the kernel with the taps and ColumnBegin shifted.
+	FRowsFunction SelectKernel(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FFidelityFXCASCPUSettings& Settings);
+
+	// Bilinear kernel of the foveated periphery for the view formats, nullptr for unsupported combinations
+	FRowsFunction SelectBilinearKernel(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output);
+
+	// Fills the taps of OutputSize columns or rows once per image, with the same position math as the shader
+	// (ip * const0.xy + const0.zw), so the scaling kernels do not recompute it for every pixel
+	void SetupScaleTaps(FScaleTaps* OutTaps, int32 OutputSize, int32 InputSize, float Scale, float Offset);
+
+	// FFidelityFXCASCPUModule::Process() with the row bands run by ParallelForFunction (the jobs of FFidelityFXCASCPUJobQueue).
+	// Scratch grows to the size needed and is kept by the caller.
+	bool ProcessScheduled(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FFidelityFXCASCPUSettings& Settings,
+		TArray64<uint8>& Scratch, TFunctionRef<void(int32, TFunctionRef<void(int32)>)> ParallelForFunction);
+
+	//-------------------------------------------------------------------------------------------------
+	// Math helpers (same bit tricks as ffx_a.ush)
+	//-------------------------------------------------------------------------------------------------
+
+	struct FRGB
+	{
+		float R, G, B;
+	};
+
+	FORCEINLINE float AsFloat(uint32 U) { float F; FMemory::Memcpy(&F, &U, sizeof(F)); return F; }
+	FORCEINLINE uint32 AsUInt(float F)  { uint32 U; FMemory::Memcpy(&U, &F, sizeof(U)); return U; }
+
+	FORCEINLINE float Sat(float A)                      { return FMath::Clamp(A, 0.0f, 1.0f); }
+	FORCEINLINE float Min3(float A, float B, float C)   { return FMath::Min(FMath::Min(A, B), C); }
+	FORCEINLINE float Max3(float A, float B, float C)   { return FMath::Max(FMath::Max(A, B), C); }
+	FORCEINLINE float PrxLoRcp(float A)                 { return AsFloat(0x7ef07ebbu - AsUInt(A)); }                  // APrxLoRcpF1
+	FORCEINLINE float PrxMedRcp(float A)                { float B = AsFloat(0x7ef19fffu - AsUInt(A)); return B * (-B * A + 2.0f); } // APrxMedRcpF1
+	FORCEINLINE float PrxLoSqrt(float A)                { return AsFloat((AsUInt(A) >> 1) + 0x1fbc4639u); }          // APrxLoSqrtF1
+
+	// IEEE half conversions, round to nearest even like the F16C instructions
+	FORCEINLINE float HalfToFloat(uint16 H)
+	{
+		const uint32 Sign = static_cast<uint32>(H & 0x8000u) << 16;
+		const uint32 Exponent = (H >> 10) & 0x1fu;
+		const uint32 Mantissa = H & 0x3ffu;
+		if (Exponent == 0)
+			return AsFloat(Sign | AsUInt(static_cast<float>(Mantissa) * (1.0f / 16777216.0f)));	// Zero and denormals
+		if (Exponent == 31)
+			return AsFloat(Sign | 0x7f800000u | (Mantissa << 13));									// Inf and NaN
+		return AsFloat(Sign | ((Exponent + 112) << 23) | (Mantissa << 13));
+	}
+
+	FORCEINLINE uint16 FloatToHalf(float F)
+	{
+		uint32 U = AsUInt(F);
+		const uint32 Sign = (U >> 16) & 0x8000u;
+		U &= 0x7fffffffu;
+		uint32 H;
+		if (U >= (143u << 23))					// Too large for a half
+		{
+			H = (U > 0x7f800000u) ? 0x7e00u : 0x7c00u;
+		}
+		else if (U < (113u << 23))				// Denormal or zero, let the FPU round the mantissa
+		{
+			const uint32 DenormMagic = 126u << 23;
+			H = AsUInt(AsFloat(U) + AsFloat(DenormMagic)) - DenormMagic;
+		}
+		else
+		{
+			const uint32 MantissaOdd = (U >> 13) & 1u;
+			U += (static_cast<uint32>(15 - 127) << 23) + 0xfffu + MantissaOdd;
+			H = U >> 13;
+		}
+		return static_cast<uint16>(H | Sign);
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	// Pixel access
+	//-------------------------------------------------------------------------------------------------
+
+	// Index of the red and blue channels in memory
+	template<EFidelityFXCASChannelOrder Order>
+	struct TChannelOrder
+	{
+		static const int32 R = (Order == EFidelityFXCASChannelOrder::BGRA) ? 2 : 0;
+		static const int32 B = 2 - R;
+	};
+
+	template<EFidelityFXCASPixelFormat Format, EFidelityFXCASChannelOrder Order>
+	struct TPixel;
+
+	template<EFidelityFXCASChannelOrder Order>
+	struct TPixel<EFidelityFXCASPixelFormat::RGBA32F, Order>
+	{
+		static const int32 R = TChannelOrder<Order>::R;
+		static const int32 B = TChannelOrder<Order>::B;
+		typedef FRGB FValue;
+
+		static FORCEINLINE FRGB Load(const uint8* Row, int32 X)
+		{
+			const float* P = reinterpret_cast<const float*>(Row) + X * 4;
+			return FRGB{ P[R], P[1], P[B] };
+		}
+		static FORCEINLINE float LoadAlpha(const uint8* Row, int32 X)
+		{
+			return reinterpret_cast<const float*>(Row)[X * 4 + 3];
+		}
+		static FORCEINLINE void Store(uint8* Row, int32 X, const FRGB& C, float Alpha)
+		{
+			float* P = reinterpret_cast<float*>(Row) + X * 4;
+			P[R] = C.R; P[1] = C.G; P[B] = C.B; P[3] = Alpha;
+		}
+	};
+
+	template<EFidelityFXCASChannelOrder Order>
+	struct TPixel<EFidelityFXCASPixelFormat::RGB32F, Order>
+	{
+		static const int32 R = TChannelOrder<Order>::R;
+		static const int32 B = TChannelOrder<Order>::B;
+		typedef FRGB FValue;
+
+		static FORCEINLINE FRGB Load(const uint8* Row, int32 X)
+		{
+			const float* P = reinterpret_cast<const float*>(Row) + X * 3;
+			return FRGB{ P[R], P[1], P[B] };
+		}
+		static FORCEINLINE float LoadAlpha(const uint8* Row, int32 X)
+		{
+			return 1.0f;
+		}
+		static FORCEINLINE void Store(uint8* Row, int32 X, const FRGB& C, float Alpha)
+		{
+			float* P = reinterpret_cast<float*>(Row) + X * 3;
+			P[R] = C.R; P[1] = C.G; P[B] = C.B;
+		}
+	};
+
+	template<EFidelityFXCASChannelOrder Order>
+	struct TPixel<EFidelityFXCASPixelFormat::RGBA8, Order>
+	{
+		static const int32 R = TChannelOrder<Order>::R;
+		static const int32 B = TChannelOrder<Order>::B;
+		typedef FRGB FValue;
+
+		static FORCEINLINE float ToFloat(uint8 V)   { return static_cast<float>(V) * (1.0f / 255.0f); }
+		static FORCEINLINE uint8 ToUNorm(float V)   { return static_cast<uint8>(V * 255.0f + 0.5f); }	// V is already saturated
+
+		static FORCEINLINE FRGB Load(const uint8* Row, int32 X)
+		{
+			const uint8* P = Row + X * 4;
+			return FRGB{ ToFloat(P[R]), ToFloat(P[1]), ToFloat(P[B]) };
+		}
+		static FORCEINLINE float LoadAlpha(const uint8* Row, int32 X)
+		{
+			return ToFloat(Row[X * 4 + 3]);
+		}
+		static FORCEINLINE void Store(uint8* Row, int32 X, const FRGB& C, float Alpha)
+		{
+			uint8* P = Row + X * 4;
+			P[R] = ToUNorm(C.R); P[1] = ToUNorm(C.G); P[B] = ToUNorm(C.B); P[3] = ToUNorm(Sat(Alpha));
+		}
+	};
+
+	template<EFidelityFXCASChannelOrder Order>
+	struct TPixel<EFidelityFXCASPixelFormat::RGBA16F, Order>
+	{
+		static const int32 R = TChannelOrder<Order>::R;
+		static const int32 B = TChannelOrder<Order>::B;
+		typedef FRGB FValue;
+
+		static FORCEINLINE FRGB Load(const uint8* Row, int32 X)
+		{
+			const uint16* P = reinterpret_cast<const uint16*>(Row) + X * 4;
+			return FRGB{ HalfToFloat(P[R]), HalfToFloat(P[1]), HalfToFloat(P[B]) };
+		}
+		static FORCEINLINE float LoadAlpha(const uint8* Row, int32 X)
+		{
+			return HalfToFloat(reinterpret_cast<const uint16*>(Row)[X * 4 + 3]);
+		}
+		static FORCEINLINE void Store(uint8* Row, int32 X, const FRGB& C, float Alpha)
+		{
+			uint16* P = reinterpret_cast<uint16*>(Row) + X * 4;
+			P[R] = FloatToHalf(C.R); P[1] = FloatToHalf(C.G); P[B] = FloatToHalf(C.B); P[3] = FloatToHalf(Alpha);
+		}
+	};
+
+	// Gamma 2.0 linear conversion approximation, CasInput() { c = c * c } on load and sqrt() before the store
+	template<EFidelityFXCASChannelOrder Order>
+	struct TPixel<EFidelityFXCASPixelFormat::RGBA8_SRGB, Order>
+	{
+		static const int32 R = TChannelOrder<Order>::R;
+		static const int32 B = TChannelOrder<Order>::B;
+		typedef FRGB FValue;
+
+		static FORCEINLINE float ToLinear(uint8 V)   { const float F = static_cast<float>(V) * (1.0f / 255.0f); return F * F; }
+		static FORCEINLINE uint8 ToGamma(float V)    { return static_cast<uint8>(FMath::Sqrt(V) * 255.0f + 0.5f); }	// V is already saturated
+
+		static FORCEINLINE FRGB Load(const uint8* Row, int32 X)
+		{
+			const uint8* P = Row + X * 4;
+			return FRGB{ ToLinear(P[R]), ToLinear(P[1]), ToLinear(P[B]) };
+		}
+		static FORCEINLINE float LoadAlpha(const uint8* Row, int32 X)
+		{
+			return static_cast<float>(Row[X * 4 + 3]) * (1.0f / 255.0f);	// Alpha is not gamma encoded
+		}
+		static FORCEINLINE void Store(uint8* Row, int32 X, const FRGB& C, float Alpha)
+		{
+			uint8* P = Row + X * 4;
+			P[R] = ToGamma(C.R); P[1] = ToGamma(C.G); P[B] = ToGamma(C.B); P[3] = static_cast<uint8>(Sat(Alpha) * 255.0f + 0.5f);
+		}
+	};
+
+	// Single channel luma, the channel order does not apply. There is no alpha, LoadAlpha() only fills the kernel signature.
+	template<EFidelityFXCASChannelOrder Order>
+	struct TPixel<EFidelityFXCASPixelFormat::R8, Order>
+	{
+		typedef float FValue;
+
+		static FORCEINLINE float Load(const uint8* Row, int32 X)                { return static_cast<float>(Row[X]) * (1.0f / 255.0f); }
+		static FORCEINLINE float LoadAlpha(const uint8* Row, int32 X)           { return 1.0f; }
+		static FORCEINLINE void Store(uint8* Row, int32 X, float C, float Alpha) { Row[X] = static_cast<uint8>(C * 255.0f + 0.5f); }	// C is already saturated
+	};
+
+	template<EFidelityFXCASChannelOrder Order>
+	struct TPixel<EFidelityFXCASPixelFormat::R32F, Order>
+	{
+		typedef float FValue;
+
+		static FORCEINLINE float Load(const uint8* Row, int32 X)                { return reinterpret_cast<const float*>(Row)[X]; }
+		static FORCEINLINE float LoadAlpha(const uint8* Row, int32 X)           { return 1.0f; }
+		static FORCEINLINE void Store(uint8* Row, int32 X, float C, float Alpha) { reinterpret_cast<float*>(Row)[X] = C; }
+	};
+
+	//-------------------------------------------------------------------------------------------------
+	// Filters
+	//-------------------------------------------------------------------------------------------------
+
+	// No scaling path of CasFilter()
+	//  b
+	// d e f
+	//  h
+	// Without CAS_SLOW only the green channel drives the weights, so red and blue min/max are never computed
+	FORCEINLINE FRGB FilterSharpen(const FRGB& b, const FRGB& d, const FRGB& e, const FRGB& f, const FRGB& h, float Peak)
+	{
+		const float mnG = Min3(Min3(d.G, e.G, f.G), b.G, h.G);
+		const float mxG = Max3(Max3(d.G, e.G, f.G), b.G, h.G);
+		const float ampG = PrxLoSqrt(Sat(FMath::Min(mnG, 1.0f - mxG) * PrxLoRcp(mxG)));
+		const float wG = ampG * Peak;
+		const float rcpWeight = PrxMedRcp(1.0f + 4.0f * wG);
+		return FRGB{
+			Sat((b.R * wG + d.R * wG + f.R * wG + h.R * wG + e.R) * rcpWeight),
+			Sat((b.G * wG + d.G * wG + f.G * wG + h.G * wG + e.G) * rcpWeight),
+			Sat((b.B * wG + d.B * wG + f.B * wG + h.B * wG + e.B) * rcpWeight) };
+	}
+
+	// Scaling path of CasFilter(), PPX / PPY is the bilinear phase between f, g, j and k
+	//    b c
+	//  e f g h
+	//  i j k l
+	//    n o
+	FORCEINLINE FRGB FilterScale(
+		const FRGB& b, const FRGB& c,
+		const FRGB& e, const FRGB& f, const FRGB& g, const FRGB& h,
+		const FRGB& i, const FRGB& j, const FRGB& k, const FRGB& l,
+		const FRGB& n, const FRGB& o,
+		float PPX, float PPY, float Peak)
+	{
+		// Soft min and max of the 4 nearest results
+		const float mnfG = Min3(Min3(b.G, e.G, f.G), g.G, j.G);
+		const float mxfG = Max3(Max3(b.G, e.G, f.G), g.G, j.G);
+		const float mngG = Min3(Min3(c.G, f.G, g.G), h.G, k.G);
+		const float mxgG = Max3(Max3(c.G, f.G, g.G), h.G, k.G);
+		const float mnjG = Min3(Min3(f.G, i.G, j.G), k.G, n.G);
+		const float mxjG = Max3(Max3(f.G, i.G, j.G), k.G, n.G);
+		const float mnkG = Min3(Min3(g.G, j.G, k.G), l.G, o.G);
+		const float mxkG = Max3(Max3(g.G, j.G, k.G), l.G, o.G);
+
+		// Shaped amount of sharpening, turned into the negative lobe weight
+		const float wfG = PrxLoSqrt(Sat(FMath::Min(mnfG, 1.0f - mxfG) * PrxLoRcp(mxfG))) * Peak;
+		const float wgG = PrxLoSqrt(Sat(FMath::Min(mngG, 1.0f - mxgG) * PrxLoRcp(mxgG))) * Peak;
+		const float wjG = PrxLoSqrt(Sat(FMath::Min(mnjG, 1.0f - mxjG) * PrxLoRcp(mxjG))) * Peak;
+		const float wkG = PrxLoSqrt(Sat(FMath::Min(mnkG, 1.0f - mxkG) * PrxLoRcp(mxkG))) * Peak;
+
+		// Bilinear weights, thinned on edges to hide the interpolation
+		const float ThinB = 1.0f / 32.0f;
+		const float s = (1.0f - PPX) * (1.0f - PPY) * PrxLoRcp(ThinB + (mxfG - mnfG));
+		const float t = PPX * (1.0f - PPY) * PrxLoRcp(ThinB + (mxgG - mngG));
+		const float u = (1.0f - PPX) * PPY * PrxLoRcp(ThinB + (mxjG - mnjG));
+		const float v = PPX * PPY * PrxLoRcp(ThinB + (mxkG - mnkG));
+
+		// Final weighting
+		const float qbe = wfG * s;
+		const float qch = wgG * t;
+		const float qf = wgG * t + wjG * u + s;
+		const float qg = wfG * s + wkG * v + t;
+		const float qj = wfG * s + wkG * v + u;
+		const float qk = wgG * t + wjG * u + v;
+		const float qin = wjG * u;
+		const float qlo = wkG * v;
+		const float rcpW = PrxMedRcp(2.0f * qbe + 2.0f * qch + 2.0f * qin + 2.0f * qlo + qf + qg + qj + qk);
+		return FRGB{
+			Sat((b.R * qbe + e.R * qbe + c.R * qch + h.R * qch + i.R * qin + n.R * qin + l.R * qlo + o.R * qlo + f.R * qf + g.R * qg + j.R * qj + k.R * qk) * rcpW),
+			Sat((b.G * qbe + e.G * qbe + c.G * qch + h.G * qch + i.G * qin + n.G * qin + l.G * qlo + o.G * qlo + f.G * qf + g.G * qg + j.G * qj + k.G * qk) * rcpW),
+			Sat((b.B * qbe + e.B * qbe + c.B * qch + h.B * qch + i.B * qin + n.B * qin + l.B * qlo + o.B * qlo + f.B * qf + g.B * qg + j.B * qj + k.B * qk) * rcpW) };
+	}
+
+	// Single channel versions for luma, the same math as the green channel above
+	FORCEINLINE float FilterSharpen(float b, float d, float e, float f, float h, float Peak)
+	{
+		const float mn = Min3(Min3(d, e, f), b, h);
+		const float mx = Max3(Max3(d, e, f), b, h);
+		const float w = PrxLoSqrt(Sat(FMath::Min(mn, 1.0f - mx) * PrxLoRcp(mx))) * Peak;
+		return Sat((b * w + d * w + f * w + h * w + e) * PrxMedRcp(1.0f + 4.0f * w));
+	}
+
+	// Luma goes through the green channel, the red and blue math is dead code once inlined
+	FORCEINLINE float FilterScale(
+		float b, float c,
+		float e, float f, float g, float h,
+		float i, float j, float k, float l,
+		float n, float o,
+		float PPX, float PPY, float Peak)
+	{
+		const FRGB Result = FilterScale(
+			FRGB{ 0.0f, b, 0.0f }, FRGB{ 0.0f, c, 0.0f },
+			FRGB{ 0.0f, e, 0.0f }, FRGB{ 0.0f, f, 0.0f }, FRGB{ 0.0f, g, 0.0f }, FRGB{ 0.0f, h, 0.0f },
+			FRGB{ 0.0f, i, 0.0f }, FRGB{ 0.0f, j, 0.0f }, FRGB{ 0.0f, k, 0.0f }, FRGB{ 0.0f, l, 0.0f },
+			FRGB{ 0.0f, n, 0.0f }, FRGB{ 0.0f, o, 0.0f },
+			PPX, PPY, Peak);
+		return Result.G;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	// Row kernels
+	//-------------------------------------------------------------------------------------------------
+
+	// Sharpen only, output rows [RowBegin, RowEnd)
+	template<typename FIn, typename FOut>
+	void SharpenRows(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FConstants& Constants, int32 RowBegin, int32 RowEnd)
+	{
+		const int32 LastX = Input.Width - 1;
+		const int32 LastY = Input.Height - 1;
+		for (int32 Y = RowBegin; Y < RowEnd; ++Y)
+		{
+			const uint8* RowUp = Input.GetRow(FMath::Max(Y - 1, 0));
+			const uint8* RowMid = Input.GetRow(Y);
+			const uint8* RowDown = Input.GetRow(FMath::Min(Y + 1, LastY));
+			uint8* RowOut = Output.GetRow(Y);
+
+			// Slide the d e f window along the row
+			typename FIn::FValue d = FIn::Load(RowMid, 0);
+			typename FIn::FValue e = d;
+			typename FIn::FValue f = FIn::Load(RowMid, FMath::Min(1, LastX));
+			for (int32 X = 0; X <= LastX; ++X)
+			{
+				const typename FIn::FValue b = FIn::Load(RowUp, X);
+				const typename FIn::FValue h = FIn::Load(RowDown, X);
+				FOut::Store(RowOut, X, FilterSharpen(b, d, e, f, h, Constants.Peak), FIn::LoadAlpha(RowMid, X));
+
+				d = e;
+				e = f;
+				f = FIn::Load(RowMid, FMath::Min(X + 2, LastX));
+			}
+		}
+	}
+
+	// Scales one output pixel from the 4 source rows and columns around it
+	template<typename FIn, typename FOut>
+	FORCEINLINE void ScalePixel(const uint8* Row0, const uint8* Row1, const uint8* Row2, const uint8* Row3, uint8* RowOut, int32 X,
+		int32 X0, int32 X1, int32 X2, int32 X3, float PPX, float PPY, float Peak)
+	{
+		const typename FIn::FValue Result = FilterScale(
+			FIn::Load(Row0, X1), FIn::Load(Row0, X2),
+			FIn::Load(Row1, X0), FIn::Load(Row1, X1), FIn::Load(Row1, X2), FIn::Load(Row1, X3),
+			FIn::Load(Row2, X0), FIn::Load(Row2, X1), FIn::Load(Row2, X2), FIn::Load(Row2, X3),
+			FIn::Load(Row3, X1), FIn::Load(Row3, X2),
+			PPX, PPY, Peak);
+		FOut::Store(RowOut, X, Result, FIn::LoadAlpha(Row1, X1));
+	}
+
+	template<typename FIn, typename FOut>
+	FORCEINLINE void ScalePixel(const uint8* Row0, const uint8* Row1, const uint8* Row2, const uint8* Row3, uint8* RowOut, int32 X,
+		const FScaleTaps& Column, float PPY, float Peak)
+	{
+		ScalePixel<FIn, FOut>(Row0, Row1, Row2, Row3, RowOut, X, Column.Index[0], Column.Index[1], Column.Index[2], Column.Index[3], Column.Phase, PPY, Peak);
+	}
+
+	// Sharpen and scale, output rows [RowBegin, RowEnd)
+	template<typename FIn, typename FOut>
+	void ScaleRows(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FConstants& Constants, int32 RowBegin, int32 RowEnd)
+	{
+		for (int32 Y = RowBegin; Y < RowEnd; ++Y)
+		{
+			const FScaleTaps& Row = Constants.RowTaps[Y];
+			const uint8* Row0 = Input.GetRow(Row.Index[0]);
+			const uint8* Row1 = Input.GetRow(Row.Index[1]);
+			const uint8* Row2 = Input.GetRow(Row.Index[2]);
+			const uint8* Row3 = Input.GetRow(Row.Index[3]);
+			uint8* RowOut = Output.GetRow(Y);
+
+			for (int32 X = 0; X < Output.Width; ++X)
+				ScalePixel<FIn, FOut>(Row0, Row1, Row2, Row3, RowOut, X, Constants.ColumnTaps[X], Row.Phase, Constants.Peak);
+		}
+	}
+
+	// Scale ratio Out / In with the phases known at compile time. Every period of Out output pixels starts
+	// at a multiple of In source pixels, output pixel K of a period samples the source at (K + 0.5) * In / Out - 0.5.
+	template<int32 RatioIn, int32 RatioOut>
+	struct TScaleRatio
+	{
+		static constexpr int32 Numerator(int32 K)   { return (2 * K + 1) * RatioIn - RatioOut; }		// Source position * 2 * Out
+		static constexpr int32 Offset(int32 K)      { return Numerator(K) >= 0 ? Numerator(K) / (2 * RatioOut) : -((2 * RatioOut - 1 - Numerator(K)) / (2 * RatioOut)); }
+		static constexpr float Phase(int32 K)       { return static_cast<float>(Numerator(K) - Offset(K) * 2 * RatioOut) / static_cast<float>(2 * RatioOut); }
+	};
+
+	// Unrolls the Out pixels of one period, K counts down so the recursion ends with the K = 0 specialization
+	template<typename FIn, typename FOut, int32 RatioIn, int32 RatioOut, int32 K>
+	struct TScaleRatioPeriod
+	{
+		static FORCEINLINE void Filter(const uint8* Row0, const uint8* Row1, const uint8* Row2, const uint8* Row3, uint8* RowOut, int32 X, int32 SX, float PPY, float Peak)
+		{
+			TScaleRatioPeriod<FIn, FOut, RatioIn, RatioOut, K - 1>::Filter(Row0, Row1, Row2, Row3, RowOut, X, SX, PPY, Peak);
+
+			constexpr int32 Offset = TScaleRatio<RatioIn, RatioOut>::Offset(K - 1);
+			constexpr float PPX = TScaleRatio<RatioIn, RatioOut>::Phase(K - 1);
+			ScalePixel<FIn, FOut>(Row0, Row1, Row2, Row3, RowOut, X + K - 1, SX + Offset - 1, SX + Offset, SX + Offset + 1, SX + Offset + 2, PPX, PPY, Peak);
+		}
+	};
+
+	template<typename FIn, typename FOut, int32 RatioIn, int32 RatioOut>
+	struct TScaleRatioPeriod<FIn, FOut, RatioIn, RatioOut, 0>
+	{
+		static FORCEINLINE void Filter(const uint8*, const uint8*, const uint8*, const uint8*, uint8*, int32, int32, float, float) { }
+	};
+
+	// ScaleRows() for an output exactly Out / In times the input size. The periods whose taps are all inside the
+	// input run with compile time phases and offsets, only the edge columns go through the clamped column taps.
+	// Sub-views (Constants.ColumnBegin) compute every column the way the whole row does, partial periods one pixel at a time.
+	template<typename FIn, typename FOut, int32 RatioIn, int32 RatioOut>
+	void ScaleRowsFixedRatio(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FConstants& Constants, int32 RowBegin, int32 RowEnd)
+	{
+		typedef TScaleRatio<RatioIn, RatioOut> FRatio;
+		const int32 LastX = Input.Width - 1;
+		const int32 NumPeriods = Input.Width / RatioIn;
+		const int32 FirstPeriod = FMath::Min(FMath::DivideAndRoundUp(1 - FRatio::Offset(0), RatioIn), NumPeriods);
+		const int32 EndPeriod = FMath::Clamp((LastX - FRatio::Offset(RatioOut - 1) - 2) / RatioIn + 1, FirstPeriod, NumPeriods);
+
+		// Image columns of the output, and the whole periods inside them
+		const int32 ColumnBegin = Constants.ColumnBegin;
+		const int32 ColumnEnd = ColumnBegin + Output.Width;
+		const int32 PeriodBegin = FMath::Clamp(FMath::DivideAndRoundUp(ColumnBegin, RatioOut), FirstPeriod, EndPeriod);
+		const int32 PeriodEnd = FMath::Max(FMath::Clamp(ColumnEnd / RatioOut, FirstPeriod, EndPeriod), PeriodBegin);
+		const int32 HeadEnd = FMath::Clamp(PeriodBegin * RatioOut, ColumnBegin, ColumnEnd);
+		const int32 TailBegin = FMath::Clamp(PeriodEnd * RatioOut, HeadEnd, ColumnEnd);
+
+		for (int32 Y = RowBegin; Y < RowEnd; ++Y)
+		{
+			const FScaleTaps& Row = Constants.RowTaps[Y];
+			const uint8* Row0 = Input.GetRow(Row.Index[0]);
+			const uint8* Row1 = Input.GetRow(Row.Index[1]);
+			const uint8* Row2 = Input.GetRow(Row.Index[2]);
+			const uint8* Row3 = Input.GetRow(Row.Index[3]);
+			uint8* RowOut = Output.GetRow(Y);
+
+			// Image column X, with the phase of its period when a whole row runs it inside one
+			const auto Pixel = [&](int32 X)
+			{
+				const int32 Period = X / RatioOut;
+				if (Period >= FirstPeriod && Period < EndPeriod)
+				{
+					const int32 K = X - Period * RatioOut;
+					const int32 SX = Period * RatioIn + FRatio::Offset(K);
+					ScalePixel<FIn, FOut>(Row0, Row1, Row2, Row3, RowOut, X - ColumnBegin, SX - 1, SX, SX + 1, SX + 2, FRatio::Phase(K), Row.Phase, Constants.Peak);
+				}
+				else
+				{
+					ScalePixel<FIn, FOut>(Row0, Row1, Row2, Row3, RowOut, X - ColumnBegin, Constants.ColumnTaps[X - ColumnBegin], Row.Phase, Constants.Peak);
+				}
+			};
+
+			for (int32 X = ColumnBegin; X < HeadEnd; ++X)
+				Pixel(X);
+			for (int32 Period = PeriodBegin; Period < PeriodEnd; ++Period)
+				TScaleRatioPeriod<FIn, FOut, RatioIn, RatioOut, RatioOut>::Filter(Row0, Row1, Row2, Row3, RowOut, Period * RatioOut - ColumnBegin, Period * RatioIn, Row.Phase, Constants.Peak);
+			for (int32 X = TailBegin; X < ColumnEnd; ++X)
+				Pixel(X);
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	// Fixed point kernel for RGBA8_SRGB
+	//-------------------------------------------------------------------------------------------------
+
+	// Sharpen only, RGBA8_SRGB to RGBA8_SRGB, without any per channel float math:
+	//  - min / max run on the 8 bit gamma values (squaring is monotonic, so they select the same taps as in linear).
+	//  - With the gamma 2.0 linearization the CAS amount sqrt(min(mn, 1 - mx) / mx) simplifies to
+	//    min(mn', sqrt(1 - mx'^2)) / mx' on the gamma values, so only one sqrt and one division per pixel remain.
+	//    The weight is then turned into a single Q15 factor k = w / (1 + 4w), as
+	//    (e + w * (b + d + f + h)) / (1 + 4w) == e + k * (b + d + f + h - 4e).
+	//  - Colors are linearized to Q15 (v^2 / 2) and blended in 16 bit integers, then converted back with a sqrt.
+	// The helpers are written to match the 16 bit SIMD instructions exactly, so the SIMD kernel and this scalar
+	// version produce bit identical results.
+
+	static const int32 Gamma2MaxLinear = 32513;	// (255 * 255 + 1) >> 1
+
+	// Q15 weight, always computed with the same IEEE operations (exact sqrt and division, truncation to integer)
+	FORCEINLINE int32 Gamma2Weight(uint8 Min, uint8 Max, float Peak)
+	{
+		const float MaxF = static_cast<float>(Max);
+		const float Amount = FMath::Min(static_cast<float>(Min), FMath::Sqrt(65025.0f - MaxF * MaxF)) / FMath::Max(MaxF, 1.0f);
+		const float W = Amount * Peak;
+		return static_cast<int32>(W / (1.0f + 4.0f * W) * 32768.0f);
+	}
+
+	FORCEINLINE int32 Gamma2ToLinear(uint8 V)               { return (static_cast<int32>(V) * V + 1) >> 1; }	// Rounded up, so flat areas return the exact input
+	FORCEINLINE int32 Gamma2Avg(int32 A, int32 B)           { return (A + B + 1) >> 1; }						// _mm256_avg_epu16
+	FORCEINLINE int32 Gamma2MulQ15(int32 A, int32 B)        { return (A * B + 0x4000) >> 15; }					// _mm256_mulhrs_epi16
+	FORCEINLINE int32 Gamma2AddSat(int32 A, int32 B)        { return FMath::Clamp(A + B, -32768, 32767); }		// _mm256_adds_epi16
+	FORCEINLINE uint8 Gamma2FromLinear(int32 L)             { return static_cast<uint8>(FMath::FloorToInt(FMath::Sqrt(static_cast<float>(L * 2)) + 0.5f)); }
+
+	FORCEINLINE uint8 Gamma2Blend(uint8 b, uint8 d, uint8 e, uint8 f, uint8 h, int32 K)
+	{
+		const int32 Le = Gamma2ToLinear(e);
+		const int32 Average = Gamma2Avg(Gamma2Avg(Gamma2ToLinear(b), Gamma2ToLinear(d)), Gamma2Avg(Gamma2ToLinear(f), Gamma2ToLinear(h)));
+		const int32 T = Gamma2MulQ15(Average - Le, K);
+		// e + 4 * k * (average - e), accumulated with saturation so the result never wraps
+		int32 L = Le;
+		L = Gamma2AddSat(L, T);
+		L = Gamma2AddSat(L, T);
+		L = Gamma2AddSat(L, T);
+		L = Gamma2AddSat(L, T);
+		return Gamma2FromLinear(FMath::Clamp(L, 0, Gamma2MaxLinear));
+	}
+
+	template<EFidelityFXCASChannelOrder InOrder, EFidelityFXCASChannelOrder OutOrder>
+	FORCEINLINE void Gamma2Pixel(const uint8* RowUp, const uint8* RowMid, const uint8* RowDown, uint8* RowOut, int32 X, int32 LastX, float Peak)
+	{
+		const int32 InR = TChannelOrder<InOrder>::R;
+		const int32 InB = TChannelOrder<InOrder>::B;
+		const int32 OutR = TChannelOrder<OutOrder>::R;
+		const int32 OutB = TChannelOrder<OutOrder>::B;
+
+		const uint8* b = RowUp + X * 4;
+		const uint8* d = RowMid + FMath::Max(X - 1, 0) * 4;
+		const uint8* e = RowMid + X * 4;
+		const uint8* f = RowMid + FMath::Min(X + 1, LastX) * 4;
+		const uint8* h = RowDown + X * 4;
+
+		const uint8 MinG = FMath::Min(FMath::Min(FMath::Min(FMath::Min(d[1], e[1]), f[1]), b[1]), h[1]);
+		const uint8 MaxG = FMath::Max(FMath::Max(FMath::Max(FMath::Max(d[1], e[1]), f[1]), b[1]), h[1]);
+		const int32 K = Gamma2Weight(MinG, MaxG, Peak);
+
+		uint8* P = RowOut + X * 4;
+		P[OutR] = Gamma2Blend(b[InR], d[InR], e[InR], f[InR], h[InR], K);
+		P[1] = Gamma2Blend(b[1], d[1], e[1], f[1], h[1], K);
+		P[OutB] = Gamma2Blend(b[InB], d[InB], e[InB], f[InB], h[InB], K);
+		P[3] = e[3];
+	}
+
+	template<EFidelityFXCASChannelOrder InOrder, EFidelityFXCASChannelOrder OutOrder>
+	void SharpenRowsGamma2(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FConstants& Constants, int32 RowBegin, int32 RowEnd)
+	{
+		const int32 LastX = Input.Width - 1;
+		const int32 LastY = Input.Height - 1;
+		for (int32 Y = RowBegin; Y < RowEnd; ++Y)
+		{
+			const uint8* RowUp = Input.GetRow(FMath::Max(Y - 1, 0));
+			const uint8* RowMid = Input.GetRow(Y);
+			const uint8* RowDown = Input.GetRow(FMath::Min(Y + 1, LastY));
+			uint8* RowOut = Output.GetRow(Y);
+			for (int32 X = 0; X <= LastX; ++X)
+				Gamma2Pixel<InOrder, OutOrder>(RowUp, RowMid, RowDown, RowOut, X, LastX, Constants.Peak);
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	// Foveated periphery
+	//-------------------------------------------------------------------------------------------------
+
+	FORCEINLINE float LerpValue(float A, float B, float T) { return FMath::Lerp(A, B, T); }
+	FORCEINLINE FRGB LerpValue(const FRGB& A, const FRGB& B, float T)
+	{
+		return FRGB{ FMath::Lerp(A.R, B.R, T), FMath::Lerp(A.G, B.G, T), FMath::Lerp(A.B, B.B, T) };
+	}
+	FORCEINLINE float SatValue(float A)       { return Sat(A); }
+	FORCEINLINE FRGB SatValue(const FRGB& A)  { return FRGB{ Sat(A.R), Sat(A.G), Sat(A.B) }; }
+
+	// Bilinear tiles of the foveated path, output rows [RowBegin, RowEnd). Scaling blends the taps 0 and +1 of the CAS window
+	// with its phases, so the periphery samples the same positions as the CAS tiles. Without taps (sharpening only) it is a copy.
+	// Results are saturated like the CAS output, except for the raw copy between identical formats.
+	template<typename FIn, typename FOut>
+	void ResampleRows(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FConstants& Constants, int32 RowBegin, int32 RowEnd)
+	{
+		if (!Constants.ColumnTaps)
+		{
+			for (int32 Y = RowBegin; Y < RowEnd; ++Y)
+			{
+				const uint8* RowIn = Input.GetRow(Y);
+				uint8* RowOut = Output.GetRow(Y);
+				if (TIsSame<FIn, FOut>::Value)
+				{
+					FMemory::Memcpy(RowOut, RowIn, static_cast<int64>(Output.Width) * Output.GetBytesPerPixel());
+					continue;
+				}
+				for (int32 X = 0; X < Output.Width; ++X)
+					FOut::Store(RowOut, X, SatValue(FIn::Load(RowIn, X)), FIn::LoadAlpha(RowIn, X));
+			}
+			return;
+		}
+
+		for (int32 Y = RowBegin; Y < RowEnd; ++Y)
+		{
+			const FScaleTaps& Row = Constants.RowTaps[Y];
+			const uint8* Row1 = Input.GetRow(Row.Index[1]);
+			const uint8* Row2 = Input.GetRow(Row.Index[2]);
+			uint8* RowOut = Output.GetRow(Y);
+			for (int32 X = 0; X < Output.Width; ++X)
+			{
+				const FScaleTaps& Column = Constants.ColumnTaps[X];
+				const typename FIn::FValue Top = LerpValue(FIn::Load(Row1, Column.Index[1]), FIn::Load(Row1, Column.Index[2]), Column.Phase);
+				const typename FIn::FValue Bottom = LerpValue(FIn::Load(Row2, Column.Index[1]), FIn::Load(Row2, Column.Index[2]), Column.Phase);
+				FOut::Store(RowOut, X, SatValue(LerpValue(Top, Bottom, Row.Phase)), FIn::LoadAlpha(Row1, Column.Index[1]));
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	// Downscale prefilter
+	//-------------------------------------------------------------------------------------------------
+
+	// Reduced image row kernel, processes the reduced rows [RowBegin, RowEnd)
+	typedef void (*FReduceRowsFunction)(const FFidelityFXCASImageView&, const FFidelityFXCASImageView&, const FIntPoint&, int32, int32);
+
+	// Box filter of the downscale prefilter into a RGBA32F image (R32F for luma, see BoxReduceRowsLuma). Every reduced pixel averages BoxSize input pixels, clamped
+	// to the input like CasLoad() of the GPU prefilter permutation. The sums are accumulated in the reduced row, one input
+	// row at a time, so the input is read in memory order.
+	template<typename FIn>
+	void BoxReduceRows(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Reduced, const FIntPoint& BoxSize, int32 RowBegin, int32 RowEnd)
+	{
+		const int32 LastX = Input.Width - 1;
+		const int32 LastY = Input.Height - 1;
+		const float Count = static_cast<float>(BoxSize.X * BoxSize.Y);
+		for (int32 Y = RowBegin; Y < RowEnd; ++Y)
+		{
+			float* RowOut = reinterpret_cast<float*>(Reduced.GetRow(Y));
+			FMemory::Memzero(RowOut, static_cast<int64>(Reduced.Width) * 4 * sizeof(float));
+			for (int32 BY = 0; BY < BoxSize.Y; ++BY)
+			{
+				const uint8* Row = Input.GetRow(FMath::Min(Y * BoxSize.Y + BY, LastY));
+				for (int32 X = 0; X < Reduced.Width; ++X)
+				{
+					float* P = RowOut + X * 4;
+					for (int32 BX = 0; BX < BoxSize.X; ++BX)
+					{
+						const int32 SX = FMath::Min(X * BoxSize.X + BX, LastX);
+						const FRGB C = FIn::Load(Row, SX);
+						P[0] += C.R; P[1] += C.G; P[2] += C.B; P[3] += FIn::LoadAlpha(Row, SX);
+					}
+				}
+			}
+			for (int32 Index = 0; Index < Reduced.Width * 4; ++Index)
+				RowOut[Index] /= Count;
+		}
+	}
+
+	// Same for the single channel luma formats, into a R32F image
+	template<typename FIn>
+	void BoxReduceRowsLuma(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Reduced, const FIntPoint& BoxSize, int32 RowBegin, int32 RowEnd)
+	{
+		const int32 LastX = Input.Width - 1;
+		const int32 LastY = Input.Height - 1;
+		const float Count = static_cast<float>(BoxSize.X * BoxSize.Y);
+		for (int32 Y = RowBegin; Y < RowEnd; ++Y)
+		{
+			float* RowOut = reinterpret_cast<float*>(Reduced.GetRow(Y));
+			FMemory::Memzero(RowOut, static_cast<int64>(Reduced.Width) * sizeof(float));
+			for (int32 BY = 0; BY < BoxSize.Y; ++BY)
+			{
+				const uint8* Row = Input.GetRow(FMath::Min(Y * BoxSize.Y + BY, LastY));
+				for (int32 X = 0; X < Reduced.Width; ++X)
+				{
+					for (int32 BX = 0; BX < BoxSize.X; ++BX)
+						RowOut[X] += FIn::Load(Row, FMath::Min(X * BoxSize.X + BX, LastX));
+				}
+			}
+			for (int32 X = 0; X < Reduced.Width; ++X)
+				RowOut[X] /= Count;
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	// Chroma planes
+	//-------------------------------------------------------------------------------------------------
+
+	// Bilinear resample of 8 bit chroma planes (NumChannels = 1 for I420 U / V, 2 for NV12 UV), output rows [RowBegin, RowEnd).
+	// Same pixel center mapping as the CAS scaling path, taps clamped to the input.
+	template<int32 NumChannels>
+	void BilinearRows(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, int32 RowBegin, int32 RowEnd)
+	{
+		const float ScaleX = static_cast<float>(Input.Width) / static_cast<float>(Output.Width);
+		const float ScaleY = static_cast<float>(Input.Height) / static_cast<float>(Output.Height);
+		for (int32 Y = RowBegin; Y < RowEnd; ++Y)
+		{
+			const float PY = FMath::Max((static_cast<float>(Y) + 0.5f) * ScaleY - 0.5f, 0.0f);
+			const int32 Y0 = FMath::Min(static_cast<int32>(PY), Input.Height - 1);
+			const int32 Y1 = FMath::Min(Y0 + 1, Input.Height - 1);
+			const float FY = PY - static_cast<float>(Y0);
+			const uint8* Row0 = Input.GetRow(Y0);
+			const uint8* Row1 = Input.GetRow(Y1);
+			uint8* RowOut = Output.GetRow(Y);
+			for (int32 X = 0; X < Output.Width; ++X)
+			{
+				const float PX = FMath::Max((static_cast<float>(X) + 0.5f) * ScaleX - 0.5f, 0.0f);
+				const int32 X0 = FMath::Min(static_cast<int32>(PX), Input.Width - 1);
+				const int32 X1 = FMath::Min(X0 + 1, Input.Width - 1);
+				const float FX = PX - static_cast<float>(X0);
+				for (int32 C = 0; C < NumChannels; ++C)
+				{
+					const float Top = FMath::Lerp(static_cast<float>(Row0[X0 * NumChannels + C]), static_cast<float>(Row0[X1 * NumChannels + C]), FX);
+					const float Bottom = FMath::Lerp(static_cast<float>(Row1[X0 * NumChannels + C]), static_cast<float>(Row1[X1 * NumChannels + C]), FX);
+					RowOut[X * NumChannels + C] = static_cast<uint8>(FMath::Lerp(Top, Bottom, FY) + 0.5f);
+				}
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	// SIMD kernels
+	//-------------------------------------------------------------------------------------------------
+
+#if FX_CAS_CPU_SIMD
+	// True if the CPU and the OS support AVX2 and F16C
+	bool HasAVX2F16C();
+
+	// Sharpen only, RGBA16F to RGBA16F (any channel order), 8 pixels per iteration.
+	// Halfs are converted with F16C on load and store, the math runs in 8 float lanes.
+	void SharpenRowsRGBA16F_AVX2(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FConstants& Constants, int32 RowBegin, int32 RowEnd);
+
+	// Sharpen only, RGBA8_SRGB to RGBA8_SRGB (any channel order), 16 pixels per iteration in 16 bit lanes.
+	// Bit identical to SharpenRowsGamma2(), checked by the Plugins.FidelityFXCAS.CPU.SIMD.Gamma2 test.
+	void SharpenRowsGamma2_AVX2(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FConstants& Constants, int32 RowBegin, int32 RowEnd);
+#endif // FX_CAS_CPU_SIMD
+}
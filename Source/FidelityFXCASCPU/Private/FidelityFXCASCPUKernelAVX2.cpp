@@ -0,0 +1,408 @@
+#include "FidelityFXCASCPUKernel.h"
+
+#if FX_CAS_CPU_SIMD
+
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// The module is compiled for the baseline ISA, only the functions below are compiled for AVX2 + F16C.
+// They are called only after HasAVX2F16C() succeeded.
+#if defined(_MSC_VER) && !defined(__clang__)
+	#define FX_CAS_TARGET_AVX2
+#else
+	#define FX_CAS_TARGET_AVX2 __attribute__((target("avx2,f16c")))
+#endif
+
+namespace FidelityFXCASCPU
+{
+	//-------------------------------------------------------------------------------------------------
+	// CPU feature detection
+	//-------------------------------------------------------------------------------------------------
+
+	static void CpuId(int32 Leaf, int32 SubLeaf, uint32 OutRegs[4])
+	{
+#if defined(_MSC_VER)
+		int Regs[4];
+		__cpuidex(Regs, Leaf, SubLeaf);
+		for (int32 Index = 0; Index < 4; ++Index)
+			OutRegs[Index] = static_cast<uint32>(Regs[Index]);
+#else
+		__asm__ __volatile__("cpuid" : "=a"(OutRegs[0]), "=b"(OutRegs[1]), "=c"(OutRegs[2]), "=d"(OutRegs[3]) : "a"(Leaf), "c"(SubLeaf));
+#endif
+	}
+
+	static uint64 GetXCR0()
+	{
+#if defined(_MSC_VER)
+		return _xgetbv(0);
+#else
+		uint32 Low, High;
+		__asm__ __volatile__("xgetbv" : "=a"(Low), "=d"(High) : "c"(0));
+		return (static_cast<uint64>(High) << 32) | Low;
+#endif
+	}
+
+	static bool DetectAVX2F16C()
+	{
+		uint32 Regs[4];
+		CpuId(0, 0, Regs);
+		if (Regs[0] < 7)
+			return false;
+
+		CpuId(1, 0, Regs);
+		const bool bOSXSAVE = (Regs[2] & (1u << 27)) != 0;
+		const bool bAVX = (Regs[2] & (1u << 28)) != 0;
+		const bool bF16C = (Regs[2] & (1u << 29)) != 0;
+		if (!bOSXSAVE || !bAVX || !bF16C)
+			return false;
+
+		// The OS has to save the YMM registers on context switches
+		if ((GetXCR0() & 0x6) != 0x6)
+			return false;
+
+		CpuId(7, 0, Regs);
+		return (Regs[1] & (1u << 5)) != 0;
+	}
+
+	bool HasAVX2F16C()
+	{
+		static const bool bHasAVX2F16C = DetectAVX2F16C();
+		return bHasAVX2F16C;
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	// 8 wide math helpers (same bit tricks and the same operand order as the scalar kernel)
+	//-------------------------------------------------------------------------------------------------
+
+	// FMath::Min / Max return the first operand on ties, _mm256_min_ps / _mm256_max_ps the second one
+	FX_CAS_TARGET_AVX2 static FORCEINLINE __m256 Min8(__m256 A, __m256 B) { return _mm256_min_ps(B, A); }
+	FX_CAS_TARGET_AVX2 static FORCEINLINE __m256 Max8(__m256 A, __m256 B) { return _mm256_max_ps(B, A); }
+	FX_CAS_TARGET_AVX2 static FORCEINLINE __m256 Sat8(__m256 A)           { return _mm256_min_ps(_mm256_max_ps(_mm256_setzero_ps(), A), _mm256_set1_ps(1.0f)); }
+
+	FX_CAS_TARGET_AVX2 static FORCEINLINE __m256 PrxLoRcp8(__m256 A)
+	{
+		return _mm256_castsi256_ps(_mm256_sub_epi32(_mm256_set1_epi32(0x7ef07ebb), _mm256_castps_si256(A)));
+	}
+
+	FX_CAS_TARGET_AVX2 static FORCEINLINE __m256 PrxMedRcp8(__m256 A)
+	{
+		const __m256 B = _mm256_castsi256_ps(_mm256_sub_epi32(_mm256_set1_epi32(0x7ef19fff), _mm256_castps_si256(A)));
+		const __m256 NegB = _mm256_xor_ps(B, _mm256_set1_ps(-0.0f));
+		return _mm256_mul_ps(B, _mm256_add_ps(_mm256_mul_ps(NegB, A), _mm256_set1_ps(2.0f)));
+	}
+
+	FX_CAS_TARGET_AVX2 static FORCEINLINE __m256 PrxLoSqrt8(__m256 A)
+	{
+		return _mm256_castsi256_ps(_mm256_add_epi32(_mm256_srli_epi32(_mm256_castps_si256(A), 1), _mm256_set1_epi32(0x1fbc4639)));
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	// RGBA16F load / store
+	//-------------------------------------------------------------------------------------------------
+
+	// 8 pixels in planar form. Channels are in memory order, lanes hold the pixels 0 2 4 6 | 1 3 5 7.
+	// All math is per lane, so the lane order only has to match between loads and stores.
+	struct FPixels8
+	{
+		__m256 C0, C1, C2, C3;
+	};
+
+	FX_CAS_TARGET_AVX2 static FORCEINLINE FPixels8 LoadRGBA16F(const uint16* P)
+	{
+		// Every 128 bit load holds 2 pixels, converted to 8 floats: p0 | p1
+		const __m256 V0 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(P + 0)));
+		const __m256 V1 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(P + 8)));
+		const __m256 V2 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(P + 16)));
+		const __m256 V3 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(P + 24)));
+
+		// 4x4 transpose in each 128 bit lane
+		const __m256 T0 = _mm256_unpacklo_ps(V0, V1);
+		const __m256 T1 = _mm256_unpackhi_ps(V0, V1);
+		const __m256 T2 = _mm256_unpacklo_ps(V2, V3);
+		const __m256 T3 = _mm256_unpackhi_ps(V2, V3);
+		FPixels8 Pixels;
+		Pixels.C0 = _mm256_shuffle_ps(T0, T2, _MM_SHUFFLE(1, 0, 1, 0));
+		Pixels.C1 = _mm256_shuffle_ps(T0, T2, _MM_SHUFFLE(3, 2, 3, 2));
+		Pixels.C2 = _mm256_shuffle_ps(T1, T3, _MM_SHUFFLE(1, 0, 1, 0));
+		Pixels.C3 = _mm256_shuffle_ps(T1, T3, _MM_SHUFFLE(3, 2, 3, 2));
+		return Pixels;
+	}
+
+	FX_CAS_TARGET_AVX2 static FORCEINLINE void StoreRGBA16F(uint16* P, const FPixels8& Pixels)
+	{
+		const __m256 T0 = _mm256_unpacklo_ps(Pixels.C0, Pixels.C1);
+		const __m256 T1 = _mm256_unpackhi_ps(Pixels.C0, Pixels.C1);
+		const __m256 T2 = _mm256_unpacklo_ps(Pixels.C2, Pixels.C3);
+		const __m256 T3 = _mm256_unpackhi_ps(Pixels.C2, Pixels.C3);
+		const __m256 V0 = _mm256_shuffle_ps(T0, T2, _MM_SHUFFLE(1, 0, 1, 0));
+		const __m256 V1 = _mm256_shuffle_ps(T0, T2, _MM_SHUFFLE(3, 2, 3, 2));
+		const __m256 V2 = _mm256_shuffle_ps(T1, T3, _MM_SHUFFLE(1, 0, 1, 0));
+		const __m256 V3 = _mm256_shuffle_ps(T1, T3, _MM_SHUFFLE(3, 2, 3, 2));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(P + 0), _mm256_cvtps_ph(V0, _MM_FROUND_TO_NEAREST_INT));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(P + 8), _mm256_cvtps_ph(V1, _MM_FROUND_TO_NEAREST_INT));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(P + 16), _mm256_cvtps_ph(V2, _MM_FROUND_TO_NEAREST_INT));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(P + 24), _mm256_cvtps_ph(V3, _MM_FROUND_TO_NEAREST_INT));
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	// Sharpen kernel
+	//-------------------------------------------------------------------------------------------------
+
+	// (b * w + d * w + f * w + h * w + e) * rcpWeight, summed in the same order as the scalar kernel
+	FX_CAS_TARGET_AVX2 static FORCEINLINE __m256 SharpenChannel8(__m256 b, __m256 d, __m256 e, __m256 f, __m256 h, __m256 w, __m256 rcpWeight)
+	{
+		__m256 Sum = _mm256_add_ps(_mm256_mul_ps(b, w), _mm256_mul_ps(d, w));
+		Sum = _mm256_add_ps(Sum, _mm256_mul_ps(f, w));
+		Sum = _mm256_add_ps(Sum, _mm256_mul_ps(h, w));
+		Sum = _mm256_add_ps(Sum, e);
+		return Sat8(_mm256_mul_ps(Sum, rcpWeight));
+	}
+
+	// 8 pixel version of FilterSharpen(), R and B are the channels that don't drive the weights
+	FX_CAS_TARGET_AVX2 static FORCEINLINE void FilterSharpen8(const FPixels8& b, const FPixels8& d, const FPixels8& e, const FPixels8& f, const FPixels8& h,
+		__m256 Peak, __m256& OutRB0, __m256& OutG, __m256& OutRB2)
+	{
+		const __m256 One = _mm256_set1_ps(1.0f);
+		const __m256 mnG = Min8(Min8(Min8(Min8(d.C1, e.C1), f.C1), b.C1), h.C1);
+		const __m256 mxG = Max8(Max8(Max8(Max8(d.C1, e.C1), f.C1), b.C1), h.C1);
+		const __m256 ampG = PrxLoSqrt8(Sat8(_mm256_mul_ps(Min8(mnG, _mm256_sub_ps(One, mxG)), PrxLoRcp8(mxG))));
+		const __m256 wG = _mm256_mul_ps(ampG, Peak);
+		const __m256 rcpWeight = PrxMedRcp8(_mm256_add_ps(One, _mm256_mul_ps(_mm256_set1_ps(4.0f), wG)));
+
+		OutRB0 = SharpenChannel8(b.C0, d.C0, e.C0, f.C0, h.C0, wG, rcpWeight);
+		OutG = SharpenChannel8(b.C1, d.C1, e.C1, f.C1, h.C1, wG, rcpWeight);
+		OutRB2 = SharpenChannel8(b.C2, d.C2, e.C2, f.C2, h.C2, wG, rcpWeight);
+	}
+
+	template<EFidelityFXCASChannelOrder InOrder, EFidelityFXCASChannelOrder OutOrder>
+	FX_CAS_TARGET_AVX2 static void SharpenRowsRGBA16F_AVX2(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FConstants& Constants, int32 RowBegin, int32 RowEnd)
+	{
+		typedef TPixel<EFidelityFXCASPixelFormat::RGBA16F, InOrder> FIn;
+		typedef TPixel<EFidelityFXCASPixelFormat::RGBA16F, OutOrder> FOut;
+		// R and B are filtered the same way, so a different output order only swaps them on store
+		const bool bSwapRB = (InOrder != OutOrder);
+
+		const int32 LastX = Input.Width - 1;
+		const int32 LastY = Input.Height - 1;
+		const __m256 Peak = _mm256_set1_ps(Constants.Peak);
+		for (int32 Y = RowBegin; Y < RowEnd; ++Y)
+		{
+			const uint8* RowUp = Input.GetRow(FMath::Max(Y - 1, 0));
+			const uint8* RowMid = Input.GetRow(Y);
+			const uint8* RowDown = Input.GetRow(FMath::Min(Y + 1, LastY));
+			uint8* RowOut = Output.GetRow(Y);
+
+			auto ScalarPixel = [&](int32 X)
+			{
+				const FRGB Result = FilterSharpen(FIn::Load(RowUp, X),
+					FIn::Load(RowMid, FMath::Max(X - 1, 0)), FIn::Load(RowMid, X), FIn::Load(RowMid, FMath::Min(X + 1, LastX)),
+					FIn::Load(RowDown, X), Constants.Peak);
+				FOut::Store(RowOut, X, Result, FIn::LoadAlpha(RowMid, X));
+			};
+
+			// The vector loop reads X - 1 .. X + 8, so the first and the last pixels (clamped taps) are scalar
+			ScalarPixel(0);
+			int32 X = 1;
+			for (; X + 8 <= LastX; X += 8)
+			{
+				const uint16* Up = reinterpret_cast<const uint16*>(RowUp) + X * 4;
+				const uint16* Mid = reinterpret_cast<const uint16*>(RowMid) + X * 4;
+				const uint16* Down = reinterpret_cast<const uint16*>(RowDown) + X * 4;
+
+				const FPixels8 b = LoadRGBA16F(Up);
+				const FPixels8 d = LoadRGBA16F(Mid - 4);
+				const FPixels8 e = LoadRGBA16F(Mid);
+				const FPixels8 f = LoadRGBA16F(Mid + 4);
+				const FPixels8 h = LoadRGBA16F(Down);
+
+				FPixels8 Result;
+				FilterSharpen8(b, d, e, f, h, Peak, Result.C0, Result.C1, Result.C2);
+				if (bSwapRB)
+					Swap(Result.C0, Result.C2);
+				Result.C3 = e.C3;
+				StoreRGBA16F(reinterpret_cast<uint16*>(RowOut) + X * 4, Result);
+			}
+			for (; X <= LastX; ++X)
+				ScalarPixel(X);
+		}
+	}
+
+	void SharpenRowsRGBA16F_AVX2(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FConstants& Constants, int32 RowBegin, int32 RowEnd)
+	{
+		const bool bInBGRA = (Input.ChannelOrder == EFidelityFXCASChannelOrder::BGRA);
+		const bool bOutBGRA = (Output.ChannelOrder == EFidelityFXCASChannelOrder::BGRA);
+		if (bInBGRA)
+		{
+			if (bOutBGRA)
+				SharpenRowsRGBA16F_AVX2<EFidelityFXCASChannelOrder::BGRA, EFidelityFXCASChannelOrder::BGRA>(Input, Output, Constants, RowBegin, RowEnd);
+			else
+				SharpenRowsRGBA16F_AVX2<EFidelityFXCASChannelOrder::BGRA, EFidelityFXCASChannelOrder::RGBA>(Input, Output, Constants, RowBegin, RowEnd);
+		}
+		else
+		{
+			if (bOutBGRA)
+				SharpenRowsRGBA16F_AVX2<EFidelityFXCASChannelOrder::RGBA, EFidelityFXCASChannelOrder::BGRA>(Input, Output, Constants, RowBegin, RowEnd);
+			else
+				SharpenRowsRGBA16F_AVX2<EFidelityFXCASChannelOrder::RGBA, EFidelityFXCASChannelOrder::RGBA>(Input, Output, Constants, RowBegin, RowEnd);
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------
+	// RGBA8_SRGB fixed point kernel
+	//-------------------------------------------------------------------------------------------------
+
+	// 16 pixels in planar form, one byte per channel. Pixel order in the bytes is 0-3 8-11 4-7 12-15.
+	struct FBytes16
+	{
+		__m128i C0, C1, C2, C3;
+	};
+
+	FX_CAS_TARGET_AVX2 static FORCEINLINE FBytes16 LoadRGBA8(const uint8* P)
+	{
+		// Group the bytes of every 4 pixels by channel, then interleave the 32 bit groups of both halves
+		const __m256i Shuffle = _mm256_setr_epi8(
+			0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15,
+			0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+		const __m256i X0 = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(P)), Shuffle);
+		const __m256i X1 = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(P + 32)), Shuffle);
+		const __m256i Lo = _mm256_permute4x64_epi64(_mm256_unpacklo_epi32(X0, X1), _MM_SHUFFLE(3, 1, 2, 0));
+		const __m256i Hi = _mm256_permute4x64_epi64(_mm256_unpackhi_epi32(X0, X1), _MM_SHUFFLE(3, 1, 2, 0));
+		FBytes16 Bytes;
+		Bytes.C0 = _mm256_castsi256_si128(Lo);
+		Bytes.C1 = _mm256_extracti128_si256(Lo, 1);
+		Bytes.C2 = _mm256_castsi256_si128(Hi);
+		Bytes.C3 = _mm256_extracti128_si256(Hi, 1);
+		return Bytes;
+	}
+
+	FX_CAS_TARGET_AVX2 static FORCEINLINE void StoreRGBA8(uint8* P, const FBytes16& Bytes)
+	{
+		const __m256i Lo = _mm256_permute4x64_epi64(_mm256_set_m128i(Bytes.C1, Bytes.C0), _MM_SHUFFLE(3, 1, 2, 0));
+		const __m256i Hi = _mm256_permute4x64_epi64(_mm256_set_m128i(Bytes.C3, Bytes.C2), _MM_SHUFFLE(3, 1, 2, 0));
+		const __m256i T0 = _mm256_unpacklo_epi32(Lo, Hi);
+		const __m256i T1 = _mm256_unpackhi_epi32(Lo, Hi);
+		// The 32 bit groups are now in the channel order 0 2 1 3
+		const __m256i Shuffle = _mm256_setr_epi8(
+			0, 8, 4, 12, 1, 9, 5, 13, 2, 10, 6, 14, 3, 11, 7, 15,
+			0, 8, 4, 12, 1, 9, 5, 13, 2, 10, 6, 14, 3, 11, 7, 15);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(P), _mm256_shuffle_epi8(_mm256_unpacklo_epi64(T0, T1), Shuffle));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(P + 32), _mm256_shuffle_epi8(_mm256_unpackhi_epi64(T0, T1), Shuffle));
+	}
+
+	// Gamma2Weight() for 8 pixels, bytes in the low half of the register
+	FX_CAS_TARGET_AVX2 static FORCEINLINE __m256i Gamma2Weight8(__m128i Min, __m128i Max, __m256 Peak)
+	{
+		const __m256 MinF = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(Min));
+		const __m256 MaxF = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(Max));
+		const __m256 Root = _mm256_sqrt_ps(_mm256_sub_ps(_mm256_set1_ps(65025.0f), _mm256_mul_ps(MaxF, MaxF)));
+		const __m256 Amount = _mm256_div_ps(Min8(MinF, Root), Max8(MaxF, _mm256_set1_ps(1.0f)));
+		const __m256 W = _mm256_mul_ps(Amount, Peak);
+		const __m256 K = _mm256_div_ps(W, _mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(_mm256_set1_ps(4.0f), W)));
+		return _mm256_cvttps_epi32(_mm256_mul_ps(K, _mm256_set1_ps(32768.0f)));
+	}
+
+	FX_CAS_TARGET_AVX2 static FORCEINLINE __m256i Gamma2ToLinear16(__m128i V)
+	{
+		const __m256i V16 = _mm256_cvtepu8_epi16(V);
+		return _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(V16, V16), _mm256_set1_epi16(1)), 1);
+	}
+
+	// sqrt(2 * L) for 8 pixels, rounded to nearest
+	FX_CAS_TARGET_AVX2 static FORCEINLINE __m256i Gamma2FromLinear8(__m128i L)
+	{
+		const __m256 L2 = _mm256_cvtepi32_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(L), 1));
+		return _mm256_cvtps_epi32(_mm256_sqrt_ps(L2));
+	}
+
+	// Gamma2Blend() for 16 pixels
+	FX_CAS_TARGET_AVX2 static FORCEINLINE __m128i Gamma2Blend16(__m128i b, __m128i d, __m128i e, __m128i f, __m128i h, __m256i K)
+	{
+		const __m256i Le = Gamma2ToLinear16(e);
+		const __m256i Average = _mm256_avg_epu16(
+			_mm256_avg_epu16(Gamma2ToLinear16(b), Gamma2ToLinear16(d)),
+			_mm256_avg_epu16(Gamma2ToLinear16(f), Gamma2ToLinear16(h)));
+		const __m256i T = _mm256_mulhrs_epi16(_mm256_sub_epi16(Average, Le), K);
+		__m256i L = _mm256_adds_epi16(Le, T);
+		L = _mm256_adds_epi16(L, T);
+		L = _mm256_adds_epi16(L, T);
+		L = _mm256_adds_epi16(L, T);
+		L = _mm256_min_epi16(_mm256_max_epi16(L, _mm256_setzero_si256()), _mm256_set1_epi16(Gamma2MaxLinear));
+
+		// packus_epi32 interleaves the 128 bit halves, the permute restores the pixel order
+		const __m256i Result = _mm256_permute4x64_epi64(_mm256_packus_epi32(
+			Gamma2FromLinear8(_mm256_castsi256_si128(L)),
+			Gamma2FromLinear8(_mm256_extracti128_si256(L, 1))), _MM_SHUFFLE(3, 1, 2, 0));
+		return _mm_packus_epi16(_mm256_castsi256_si128(Result), _mm256_extracti128_si256(Result, 1));
+	}
+
+	template<EFidelityFXCASChannelOrder InOrder, EFidelityFXCASChannelOrder OutOrder>
+	FX_CAS_TARGET_AVX2 static void SharpenRowsGamma2_AVX2(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FConstants& Constants, int32 RowBegin, int32 RowEnd)
+	{
+		const bool bSwapRB = (InOrder != OutOrder);
+
+		const int32 LastX = Input.Width - 1;
+		const int32 LastY = Input.Height - 1;
+		const __m256 Peak = _mm256_set1_ps(Constants.Peak);
+		for (int32 Y = RowBegin; Y < RowEnd; ++Y)
+		{
+			const uint8* RowUp = Input.GetRow(FMath::Max(Y - 1, 0));
+			const uint8* RowMid = Input.GetRow(Y);
+			const uint8* RowDown = Input.GetRow(FMath::Min(Y + 1, LastY));
+			uint8* RowOut = Output.GetRow(Y);
+
+			// The vector loop reads X - 1 .. X + 16, so the first and the last pixels (clamped taps) are scalar
+			Gamma2Pixel<InOrder, OutOrder>(RowUp, RowMid, RowDown, RowOut, 0, LastX, Constants.Peak);
+			int32 X = 1;
+			for (; X + 16 <= LastX; X += 16)
+			{
+				const FBytes16 b = LoadRGBA8(RowUp + X * 4);
+				const FBytes16 d = LoadRGBA8(RowMid + X * 4 - 4);
+				const FBytes16 e = LoadRGBA8(RowMid + X * 4);
+				const FBytes16 f = LoadRGBA8(RowMid + X * 4 + 4);
+				const FBytes16 h = LoadRGBA8(RowDown + X * 4);
+
+				// Min and max of the green channel on the gamma values
+				const __m128i MinG = _mm_min_epu8(_mm_min_epu8(_mm_min_epu8(_mm_min_epu8(d.C1, e.C1), f.C1), b.C1), h.C1);
+				const __m128i MaxG = _mm_max_epu8(_mm_max_epu8(_mm_max_epu8(_mm_max_epu8(d.C1, e.C1), f.C1), b.C1), h.C1);
+				const __m256i K = _mm256_permute4x64_epi64(_mm256_packs_epi32(
+					Gamma2Weight8(MinG, MaxG, Peak),
+					Gamma2Weight8(_mm_srli_si128(MinG, 8), _mm_srli_si128(MaxG, 8), Peak)), _MM_SHUFFLE(3, 1, 2, 0));
+
+				FBytes16 Result;
+				Result.C0 = Gamma2Blend16(b.C0, d.C0, e.C0, f.C0, h.C0, K);
+				Result.C1 = Gamma2Blend16(b.C1, d.C1, e.C1, f.C1, h.C1, K);
+				Result.C2 = Gamma2Blend16(b.C2, d.C2, e.C2, f.C2, h.C2, K);
+				if (bSwapRB)
+					Swap(Result.C0, Result.C2);
+				Result.C3 = e.C3;
+				StoreRGBA8(RowOut + X * 4, Result);
+			}
+			for (; X <= LastX; ++X)
+				Gamma2Pixel<InOrder, OutOrder>(RowUp, RowMid, RowDown, RowOut, X, LastX, Constants.Peak);
+		}
+	}
+
+	void SharpenRowsGamma2_AVX2(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FConstants& Constants, int32 RowBegin, int32 RowEnd)
+	{
+		const bool bInBGRA = (Input.ChannelOrder == EFidelityFXCASChannelOrder::BGRA);
+		const bool bOutBGRA = (Output.ChannelOrder == EFidelityFXCASChannelOrder::BGRA);
+		if (bInBGRA)
+		{
+			if (bOutBGRA)
+				SharpenRowsGamma2_AVX2<EFidelityFXCASChannelOrder::BGRA, EFidelityFXCASChannelOrder::BGRA>(Input, Output, Constants, RowBegin, RowEnd);
+			else
+				SharpenRowsGamma2_AVX2<EFidelityFXCASChannelOrder::BGRA, EFidelityFXCASChannelOrder::RGBA>(Input, Output, Constants, RowBegin, RowEnd);
+		}
+		else
+		{
+			if (bOutBGRA)
+				SharpenRowsGamma2_AVX2<EFidelityFXCASChannelOrder::RGBA, EFidelityFXCASChannelOrder::BGRA>(Input, Output, Constants, RowBegin, RowEnd);
+			else
+				SharpenRowsGamma2_AVX2<EFidelityFXCASChannelOrder::RGBA, EFidelityFXCASChannelOrder::RGBA>(Input, Output, Constants, RowBegin, RowEnd);
+		}
+	}
+}
+
+#endif // FX_CAS_CPU_SIMD
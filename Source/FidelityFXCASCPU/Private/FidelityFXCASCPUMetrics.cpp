@@ -0,0 +1,172 @@
+#include "FidelityFXCASCPU.h"
+#include "FidelityFXCASCPUKernel.h"
+
+namespace FidelityFXCASCPU
+{
+	typedef void (*FLoadRowFunction)(const FFidelityFXCASImageView&, int32, FRGB*);
+
+	// Luma is compared as gray
+	static FORCEINLINE FRGB ToRGB(const FRGB& C) { return C; }
+	static FORCEINLINE FRGB ToRGB(float L)       { return FRGB{ L, L, L }; }
+
+	template<typename FPixel>
+	static void LoadRow(const FFidelityFXCASImageView& View, int32 Y, FRGB* OutPixels)
+	{
+		const uint8* Row = View.GetRow(Y);
+		for (int32 X = 0; X < View.Width; ++X)
+			OutPixels[X] = ToRGB(FPixel::Load(Row, X));
+	}
+
+	template<EFidelityFXCASPixelFormat Format>
+	static FLoadRowFunction SelectLoadRowFunction(EFidelityFXCASChannelOrder Order)
+	{
+		return (Order == EFidelityFXCASChannelOrder::BGRA)
+			? &LoadRow<TPixel<Format, EFidelityFXCASChannelOrder::BGRA>>
+			: &LoadRow<TPixel<Format, EFidelityFXCASChannelOrder::RGBA>>;
+	}
+
+	// Rec. 709 luma of the linear colors, SSIM is computed on it
+	static FORCEINLINE float GetLuma(const FRGB& C) { return 0.2126f * C.R + 0.7152f * C.G + 0.0722f * C.B; }
+
+	// Mean SSIM over 8x8 windows with a stride of 4 (uniform weights), for a peak value of 1. Smaller images are a single window.
+	static float ComputeSSIM(const TArray64<float>& LumaA, const TArray64<float>& LumaB, int32 Width, int32 Height)
+	{
+		const int32 WindowSize = 8;
+		const int32 WindowStride = 4;
+		const double C1 = FMath::Square(0.01);
+		const double C2 = FMath::Square(0.03);
+		const FIntPoint Window(FMath::Min(WindowSize, Width), FMath::Min(WindowSize, Height));
+
+		double SumSSIM = 0.0;
+		int64 NumWindows = 0;
+		for (int32 WindowY = 0; WindowY + Window.Y <= Height; WindowY += WindowStride)
+		{
+			for (int32 WindowX = 0; WindowX + Window.X <= Width; WindowX += WindowStride)
+			{
+				double SumA = 0.0, SumB = 0.0, SumAA = 0.0, SumBB = 0.0, SumAB = 0.0;
+				for (int32 Y = WindowY; Y < WindowY + Window.Y; ++Y)
+				{
+					const int64 RowOffset = static_cast<int64>(Y) * Width;
+					for (int32 X = WindowX; X < WindowX + Window.X; ++X)
+					{
+						const double A = LumaA[RowOffset + X];
+						const double B = LumaB[RowOffset + X];
+						SumA += A;
+						SumB += B;
+						SumAA += A * A;
+						SumBB += B * B;
+						SumAB += A * B;
+					}
+				}
+				const double InvNum = 1.0 / (Window.X * Window.Y);
+				const double MeanA = SumA * InvNum;
+				const double MeanB = SumB * InvNum;
+				const double VarA = SumAA * InvNum - MeanA * MeanA;
+				const double VarB = SumBB * InvNum - MeanB * MeanB;
+				const double CovAB = SumAB * InvNum - MeanA * MeanB;
+				SumSSIM += ((2.0 * MeanA * MeanB + C1) * (2.0 * CovAB + C2)) / ((MeanA * MeanA + MeanB * MeanB + C1) * (VarA + VarB + C2));
+				++NumWindows;
+			}
+		}
+		return NumWindows > 0 ? static_cast<float>(SumSSIM / NumWindows) : 1.0f;
+	}
+
+	static FLoadRowFunction SelectLoadRowFunction(const FFidelityFXCASImageView& View)
+	{
+		switch (View.Format)
+		{
+		case EFidelityFXCASPixelFormat::RGBA32F: return SelectLoadRowFunction<EFidelityFXCASPixelFormat::RGBA32F>(View.ChannelOrder);
+		case EFidelityFXCASPixelFormat::RGB32F:  return SelectLoadRowFunction<EFidelityFXCASPixelFormat::RGB32F>(View.ChannelOrder);
+		case EFidelityFXCASPixelFormat::RGBA8:   return SelectLoadRowFunction<EFidelityFXCASPixelFormat::RGBA8>(View.ChannelOrder);
+		case EFidelityFXCASPixelFormat::RGBA16F: return SelectLoadRowFunction<EFidelityFXCASPixelFormat::RGBA16F>(View.ChannelOrder);
+		case EFidelityFXCASPixelFormat::RGBA8_SRGB: return SelectLoadRowFunction<EFidelityFXCASPixelFormat::RGBA8_SRGB>(View.ChannelOrder);
+		case EFidelityFXCASPixelFormat::R8:      return SelectLoadRowFunction<EFidelityFXCASPixelFormat::R8>(View.ChannelOrder);
+		case EFidelityFXCASPixelFormat::R32F:    return SelectLoadRowFunction<EFidelityFXCASPixelFormat::R32F>(View.ChannelOrder);
+		default:                                 return nullptr;
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+// FFidelityFXCASCPUModule accuracy report
+//-------------------------------------------------------------------------------------------------
+
+bool FFidelityFXCASCPUModule::ComputeDifference(const FFidelityFXCASImageView& A, const FFidelityFXCASImageView& B, FFidelityFXCASImageDifference& OutDifference) const
+{
+	using namespace FidelityFXCASCPU;
+
+	if (!A.IsValid() || !B.IsValid() || A.GetSize() != B.GetSize())
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("ComputeDifference: images must be valid and have the same size (%dx%d, %dx%d)."), A.Width, A.Height, B.Width, B.Height);
+		return false;
+	}
+	const FLoadRowFunction LoadRowA = SelectLoadRowFunction(A);
+	const FLoadRowFunction LoadRowB = SelectLoadRowFunction(B);
+	if (!LoadRowA || !LoadRowB)
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("ComputeDifference: unsupported pixel format."));
+		return false;
+	}
+
+	TArray<FRGB> RowA, RowB;
+	RowA.SetNumUninitialized(A.Width);
+	RowB.SetNumUninitialized(B.Width);
+	TArray64<float> LumaA, LumaB;
+	LumaA.SetNumUninitialized(static_cast<int64>(A.Width) * A.Height);
+	LumaB.SetNumUninitialized(static_cast<int64>(B.Width) * B.Height);
+
+	float MaxAbsError = 0.0f;
+	double SumAbsError = 0.0;
+	double SumSquaredError = 0.0;
+	for (int32 Y = 0; Y < A.Height; ++Y)
+	{
+		LoadRowA(A, Y, RowA.GetData());
+		LoadRowB(B, Y, RowB.GetData());
+		for (int32 X = 0; X < A.Width; ++X)
+		{
+			LumaA[static_cast<int64>(Y) * A.Width + X] = GetLuma(RowA[X]);
+			LumaB[static_cast<int64>(Y) * B.Width + X] = GetLuma(RowB[X]);
+			const float Errors[3] = { RowA[X].R - RowB[X].R, RowA[X].G - RowB[X].G, RowA[X].B - RowB[X].B };
+			for (float Error : Errors)
+			{
+				const float AbsError = FMath::Abs(Error);
+				MaxAbsError = FMath::Max(MaxAbsError, AbsError);
+				SumAbsError += AbsError;
+				SumSquaredError += static_cast<double>(Error) * Error;
+			}
+		}
+	}
+
+	OutDifference.NumValues = static_cast<int64>(A.Width) * A.Height * 3;
+	OutDifference.MaxAbsError = MaxAbsError;
+	OutDifference.MeanAbsError = static_cast<float>(SumAbsError / OutDifference.NumValues);
+	const double MeanSquaredError = SumSquaredError / OutDifference.NumValues;
+	OutDifference.PSNR = MeanSquaredError > 0.0 ? 10.0f * FMath::LogX(10.0f, static_cast<float>(1.0 / MeanSquaredError)) : MAX_flt;
+	OutDifference.SSIM = ComputeSSIM(LumaA, LumaB, A.Width, A.Height);
+	return true;
+}
+
+bool FFidelityFXCASCPUModule::MeasureErrorToReference(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Result,
+	const FFidelityFXCASCPUSettings& Settings, FFidelityFXCASImageDifference& OutDifference) const
+{
+	if (!Result.IsValid())
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("MeasureErrorToReference: invalid result image."));
+		return false;
+	}
+
+	// Full precision reference with the scalar kernels, single channel for luma
+	const EFidelityFXCASPixelFormat ReferenceFormat = IsFidelityFXCASLumaFormat(Input.Format) ? EFidelityFXCASPixelFormat::R32F : EFidelityFXCASPixelFormat::RGBA32F;
+	const int32 ReferenceChannels = GetFidelityFXCASBytesPerPixel(ReferenceFormat) / static_cast<int32>(sizeof(float));
+	TArray64<float> Reference;
+	Reference.AddUninitialized(static_cast<int64>(Result.Width) * Result.Height * ReferenceChannels);
+	const FFidelityFXCASImageView ReferenceView(Reference.GetData(), Result.Width, Result.Height,
+		static_cast<int64>(Result.Width) * GetFidelityFXCASBytesPerPixel(ReferenceFormat), ReferenceFormat);
+
+	FFidelityFXCASCPUSettings ReferenceSettings = Settings;
+	ReferenceSettings.bAllowSIMD = false;
+	if (!Process(Input, ReferenceView, ReferenceSettings))
+		return false;
+
+	return ComputeDifference(ReferenceView, Result, OutDifference);
+}
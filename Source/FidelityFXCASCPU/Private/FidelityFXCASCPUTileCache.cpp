@@ -0,0 +1,323 @@
+#include "FidelityFXCASCPUTileCache.h"
+#include "FidelityFXCASCPU.h"
+#include "FidelityFXCASCPUKernel.h"
+#include "FidelityFXCASCPUContext.h"
+
+#include "Hash/CityHash.h"
+#include "HAL/PlatformTime.h"
+
+//-------------------------------------------------------------------------------------------------
+// FFidelityFXCASCPUTileCache class implementation
+//-------------------------------------------------------------------------------------------------
+
+void FFidelityFXCASCPUTileCache::SetBudget(int64 Bytes)
+{
+	if (Bytes != Budget)
+	{
+		Budget = Bytes;
+		SlotSize = 0;	// Reallocated by the next BeginFrame()
+	}
+}
+
+void FFidelityFXCASCPUTileCache::Clear()
+{
+	SlotsByKey.Reset();
+	for (int32 Slot = 0; Slot < SlotFrames.Num(); ++Slot)
+		SlotFrames[Slot] = 0;
+	ClockHand = 0;
+}
+
+void FFidelityFXCASCPUTileCache::BeginFrame(uint64 InConfigHash, int64 InSlotSize)
+{
+	if (InSlotSize != SlotSize)
+	{
+		SlotSize = InSlotSize;
+		const int32 NumSlots = static_cast<int32>(FMath::Min<int64>(Budget / SlotSize, MAX_int32));
+		Memory.Empty(NumSlots * SlotSize);
+		Memory.AddUninitialized(NumSlots * SlotSize);
+		SlotKeys.SetNumZeroed(NumSlots);
+		SlotFrames.SetNumZeroed(NumSlots);
+		Clear();
+	}
+	else if (InConfigHash != ConfigHash)
+	{
+		Clear();
+	}
+	ConfigHash = InConfigHash;
+	++Frame;
+}
+
+uint8* FFidelityFXCASCPUTileCache::Find(uint64 Key)
+{
+	const int32* Slot = SlotsByKey.Find(Key);
+	if (!Slot)
+		return nullptr;
+
+	SlotFrames[*Slot] = Frame;
+	return Memory.GetData() + *Slot * SlotSize;
+}
+
+uint8* FFidelityFXCASCPUTileCache::Add(uint64 Key)
+{
+	// Next slot not used by the current frame
+	const int32 NumSlots = SlotFrames.Num();
+	for (int32 Step = 0; Step < NumSlots; ++Step)
+	{
+		const int32 Slot = ClockHand;
+		ClockHand = (ClockHand + 1) % NumSlots;
+		if (SlotFrames[Slot] == Frame)
+			continue;
+
+		if (SlotFrames[Slot] != 0)
+		{
+			SlotsByKey.Remove(SlotKeys[Slot]);
+			++Stats.NumEvictions;
+		}
+		SlotKeys[Slot] = Key;
+		SlotFrames[Slot] = Frame;
+		SlotsByKey.Add(Key, Slot);
+		return Memory.GetData() + Slot * SlotSize;
+	}
+	return nullptr;
+}
+
+uint8* FFidelityFXCASCPUTileCache::GetOverflow(int64 Size)
+{
+	if (Overflow.Num() < Size)
+	{
+		Overflow.Empty(Size);
+		Overflow.AddUninitialized(Size);
+	}
+	return Overflow.GetData();
+}
+
+//-------------------------------------------------------------------------------------------------
+// Cached processing
+//-------------------------------------------------------------------------------------------------
+
+namespace FidelityFXCASCPU
+{
+	static FORCEINLINE uint64 HashCombine64(uint64 Hash, uint64 Value)
+	{
+		return CityHash128to64(Uint128_64(Hash, Value));
+	}
+
+	static FORCEINLINE uint64 HashRect(uint64 Hash, const FIntRect& Rect)
+	{
+		Hash = HashCombine64(Hash, (static_cast<uint64>(static_cast<uint32>(Rect.Min.X)) << 32) | static_cast<uint32>(Rect.Min.Y));
+		return HashCombine64(Hash, (static_cast<uint64>(static_cast<uint32>(Rect.Max.X)) << 32) | static_cast<uint32>(Rect.Max.Y));
+	}
+
+	// Everything the cached pixels depend on besides the input content
+	static uint64 GetConfigHash(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FFidelityFXCASCPUSettings& Settings)
+	{
+		uint64 Hash = HashRect(0, FIntRect(Input.GetSize(), Output.GetSize()));
+		Hash = HashCombine64(Hash, (static_cast<uint64>(Input.Format) << 24) | (static_cast<uint64>(Input.ChannelOrder) << 16)
+			| (static_cast<uint64>(Output.Format) << 8) | static_cast<uint64>(Output.ChannelOrder));
+		Hash = HashCombine64(Hash, (static_cast<uint64>(FMath::Clamp(Settings.Sharpness, 0.0f, 1.0f) * 65536.0f) << 1) | (Settings.bAllowSIMD ? 1 : 0));
+		return Hash;
+	}
+
+	static void CopyRect(const FFidelityFXCASImageView& Source, const FIntPoint& SourceOffset, const FFidelityFXCASImageView& Dest, const FIntRect& DestRect)
+	{
+		const int32 BytesPerPixel = Dest.GetBytesPerPixel();
+		const int64 RowSize = static_cast<int64>(DestRect.Width()) * BytesPerPixel;
+		for (int32 Y = 0; Y < DestRect.Height(); ++Y)
+		{
+			FMemory::Memcpy(Dest.GetRow(DestRect.Min.Y + Y) + static_cast<int64>(DestRect.Min.X) * BytesPerPixel,
+				Source.GetRow(SourceOffset.Y + Y) + static_cast<int64>(SourceOffset.X) * BytesPerPixel, RowSize);
+		}
+	}
+}
+
+bool FidelityFXCASCPU::ProcessTileCached(FFidelityFXCASCPUContext& Context, const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output,
+	const FFidelityFXCASCPUSettings& Settings)
+{
+	typedef FFidelityFXCASCPUTileCache::FTile FTile;
+
+	// Tiles are output sub-views, computed by the kernel of the full pass
+	FRowsFunction RowsFunction = SelectKernel(Input, Output, Settings);
+	if (!RowsFunction)
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("Process: unsupported pixel format combination."));
+		return false;
+	}
+
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_FidelityFXCASCPU_ProcessTileCached); // Used to gather CPU profiling data for the UE4 session frontend
+
+	auto RunParallel = [&Context, &Settings](int32 Num, TFunctionRef<void(int32)> Function)
+	{
+		if (Settings.bMultithreaded)
+		{
+			Context.ParallelFor(Num, Function);
+		}
+		else
+		{
+			for (int32 Index = 0; Index < Num; ++Index)
+				Function(Index);
+		}
+	};
+
+	const bool bSharpenOnly = (Input.GetSize() == Output.GetSize());
+	const int32 TileSize = FFidelityFXCASCPUTileCache::TileSize;
+	const int32 InputBytesPerPixel = Input.GetBytesPerPixel();
+	const int32 OutputBytesPerPixel = Output.GetBytesPerPixel();
+
+	// Sharpen only tiles are computed with their 1 pixel apron, which is dropped when copying to the output
+	const int32 SlotDim = bSharpenOnly ? TileSize + 2 : TileSize;
+	const int64 SlotSize = Align(static_cast<int64>(SlotDim) * SlotDim * OutputBytesPerPixel, 16);
+
+	FConstants Constants;
+	Setup(Constants, FMath::Clamp(Settings.Sharpness, 0.0f, 1.0f), Input.GetSize(), Output.GetSize());
+	FScaleTaps* ScaleTaps = nullptr;
+	if (!bSharpenOnly)
+	{
+		ScaleTaps = reinterpret_cast<FScaleTaps*>(Context.GetScratch(static_cast<int64>(Output.Width + Output.Height) * sizeof(FScaleTaps)));
+		SetupScaleTaps(ScaleTaps, Output.Width, Input.Width, Constants.ScaleX, Constants.OffsetX);
+		SetupScaleTaps(ScaleTaps + Output.Width, Output.Height, Input.Height, Constants.ScaleY, Constants.OffsetY);
+	}
+
+	FFidelityFXCASCPUTileCache& Cache = Context.GetTileCache();
+	Cache.BeginFrame(GetConfigHash(Input, Output, Settings), SlotSize);
+	FFidelityFXCASTileCacheStats& Stats = Cache.GetStats();
+
+	const int32 NumTilesX = FMath::DivideAndRoundUp(Output.Width, TileSize);
+	const int32 NumTiles = NumTilesX * FMath::DivideAndRoundUp(Output.Height, TileSize);
+	TArray<FTile>& Tiles = Cache.GetTiles();
+	Tiles.SetNum(NumTiles, false);
+
+	// Hash the input of every tile
+	const double HashStartTime = FPlatformTime::Seconds();
+	const FIntRect OutputBounds(FIntPoint::ZeroValue, Output.GetSize());
+	RunParallel(NumTiles, [&](int32 TileIndex)
+	{
+		FTile& Tile = Tiles[TileIndex];
+		const FIntPoint TileMin((TileIndex % NumTilesX) * TileSize, (TileIndex / NumTilesX) * TileSize);
+		Tile.Rect = FIntRect(TileMin, TileMin + FIntPoint(TileSize, TileSize));
+		Tile.Rect.Clip(OutputBounds);
+
+		uint64 Hash;
+		if (bSharpenOnly)
+		{
+			// Same apron content and clipping give the same pixels anywhere in the image
+			Tile.SourceRect = FIntRect(Tile.Rect.Min - FIntPoint(1, 1), Tile.Rect.Max + FIntPoint(1, 1));
+			Tile.SourceRect.Clip(OutputBounds);
+			Hash = HashRect(0, FIntRect(Tile.Rect.Min - Tile.SourceRect.Min, Tile.SourceRect.Size()));
+			Hash = HashCombine64(Hash, (static_cast<uint64>(Tile.Rect.Width()) << 32) | static_cast<uint32>(Tile.Rect.Height()));
+		}
+		else
+		{
+			// The scale phases depend on the position, so scaled tiles only match at the same place
+			const FScaleTaps* RowTaps = ScaleTaps + Output.Width;
+			Tile.SourceRect = FIntRect(ScaleTaps[Tile.Rect.Min.X].Index[0], RowTaps[Tile.Rect.Min.Y].Index[0],
+				ScaleTaps[Tile.Rect.Max.X - 1].Index[3] + 1, RowTaps[Tile.Rect.Max.Y - 1].Index[3] + 1);
+			Hash = HashRect(0, Tile.Rect);
+		}
+
+		const int64 SourceRowSize = static_cast<int64>(Tile.SourceRect.Width()) * InputBytesPerPixel;
+		for (int32 Y = Tile.SourceRect.Min.Y; Y < Tile.SourceRect.Max.Y; ++Y)
+		{
+			const uint8* Row = Input.GetRow(Y) + static_cast<int64>(Tile.SourceRect.Min.X) * InputBytesPerPixel;
+			Hash = CityHash64WithSeed(reinterpret_cast<const char*>(Row), static_cast<uint32>(SourceRowSize), Hash);
+		}
+		Tile.Key = Hash;
+	});
+
+	// Look up the hits first, so the slots they use are not recycled for the misses
+	int32 NumHits = 0;
+	for (FTile& Tile : Tiles)
+	{
+		Tile.Data = Cache.Find(Tile.Key);
+		Tile.bHit = (Tile.Data != nullptr);
+		NumHits += Tile.bHit ? 1 : 0;
+	}
+
+	// Slots for the misses. A repeated tile of the same frame is computed once and copied after the misses.
+	TArray<FTile*, TInlineAllocator<256>> Misses;
+	int32 NumOverflow = 0;
+	for (FTile& Tile : Tiles)
+	{
+		if (Tile.bHit)
+			continue;
+		Tile.Data = Cache.Find(Tile.Key);
+		if (Tile.Data)
+		{
+			Tile.bHit = true;
+			++NumHits;
+			continue;
+		}
+		Tile.Data = Cache.Add(Tile.Key);
+		NumOverflow += Tile.Data ? 0 : 1;
+		Misses.Add(&Tile);
+	}
+	if (NumOverflow > 0)
+	{
+		// Over budget: the remaining misses are computed into overflow memory and not cached
+		uint8* OverflowData = Cache.GetOverflow(NumOverflow * SlotSize);
+		for (FTile* Tile : Misses)
+		{
+			if (!Tile->Data)
+			{
+				Tile->Data = OverflowData;
+				OverflowData += SlotSize;
+			}
+		}
+	}
+	const double HashTime = FPlatformTime::Seconds() - HashStartTime;
+
+	// Compute the misses
+	const double ComputeStartTime = FPlatformTime::Seconds();
+	RunParallel(Misses.Num(), [&](int32 MissIndex)
+	{
+		const FTile& Tile = *Misses[MissIndex];
+		const FIntRect& ComputedRect = bSharpenOnly ? Tile.SourceRect : Tile.Rect;
+
+		FFidelityFXCASImageView TileOutput = Output;
+		TileOutput.Data = Tile.Data;
+		TileOutput.Width = ComputedRect.Width();
+		TileOutput.Height = ComputedRect.Height();
+		TileOutput.RowPitch = static_cast<int64>(ComputedRect.Width()) * OutputBytesPerPixel;
+
+		if (bSharpenOnly)
+		{
+			RowsFunction(Input.GetSubView(Tile.SourceRect), TileOutput, Constants, 0, TileOutput.Height);
+		}
+		else
+		{
+			FConstants TileConstants = Constants;
+			TileConstants.ColumnTaps = ScaleTaps + Tile.Rect.Min.X;
+			TileConstants.RowTaps = ScaleTaps + Output.Width + Tile.Rect.Min.Y;
+			TileConstants.ColumnBegin = Tile.Rect.Min.X;
+			RowsFunction(Input, TileOutput, TileConstants, 0, TileOutput.Height);
+		}
+		CopyRect(TileOutput, Tile.Rect.Min - ComputedRect.Min, Output, Tile.Rect);
+	});
+	Stats.ComputeSeconds += FPlatformTime::Seconds() - ComputeStartTime;
+
+	// Copy the hits
+	const double CopyStartTime = FPlatformTime::Seconds();
+	RunParallel(NumTiles, [&](int32 TileIndex)
+	{
+		const FTile& Tile = Tiles[TileIndex];
+		if (!Tile.bHit)
+			return;
+
+		FFidelityFXCASImageView TileOutput = Output;
+		TileOutput.Data = Tile.Data;
+		if (bSharpenOnly)
+		{
+			TileOutput.RowPitch = static_cast<int64>(Tile.SourceRect.Width()) * OutputBytesPerPixel;
+			CopyRect(TileOutput, Tile.Rect.Min - Tile.SourceRect.Min, Output, Tile.Rect);
+		}
+		else
+		{
+			TileOutput.RowPitch = static_cast<int64>(Tile.Rect.Width()) * OutputBytesPerPixel;
+			CopyRect(TileOutput, FIntPoint::ZeroValue, Output, Tile.Rect);
+		}
+	});
+	Stats.OverheadSeconds += HashTime + (FPlatformTime::Seconds() - CopyStartTime);
+	Stats.NumTiles += NumTiles;
+	Stats.NumHits += NumHits;
+
+	return true;
+}
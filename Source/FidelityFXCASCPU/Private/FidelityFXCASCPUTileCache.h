@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FidelityFXCASCPUTypes.h"
+
+class FFidelityFXCASCPUContext;
+
+// Bounded store of output tiles keyed by a hash of the input pixels they were computed from.
+// Slots are recycled in clock order, skipping the slots used by the current frame.
+class FFidelityFXCASCPUTileCache
+{
+public:
+	// Output tile size of the cached path
+	static const int32 TileSize = 64;
+	// Budget of a cache created by Process() without SetTileCacheBudget()
+	static const int64 DefaultBudget = 256ll * 1024 * 1024;
+
+	// One output tile of the current frame
+	struct FTile
+	{
+		FIntRect Rect;			// Output pixels
+		FIntRect SourceRect;	// Input pixels the tile is computed from
+		uint64 Key = 0;
+		uint8* Data = nullptr;	// Cache slot (or overflow memory) holding the computed pixels
+		bool bHit = false;
+	};
+
+	FFidelityFXCASCPUTileCache() : Budget(DefaultBudget) { }
+
+	void SetBudget(int64 Bytes);
+
+	// Starts a frame. The cached tiles are dropped when the configuration (sizes, formats, settings) or the slot size changed.
+	void BeginFrame(uint64 InConfigHash, int64 InSlotSize);
+	// Slot holding the tile with the given key, nullptr if there is none
+	uint8* Find(uint64 Key);
+	// Slot for a new tile, nullptr if every slot is used by the current frame
+	uint8* Add(uint64 Key);
+	// Memory for the missed tiles that did not get a slot, valid until the next call
+	uint8* GetOverflow(int64 Size);
+
+	// Tiles of the current frame, kept so steady state processing does not allocate
+	TArray<FTile>& GetTiles() { return Tiles; }
+
+	FORCEINLINE const FFidelityFXCASTileCacheStats& GetStats() const { return Stats; }
+	FORCEINLINE FFidelityFXCASTileCacheStats& GetStats()             { return Stats; }
+	FORCEINLINE void ResetStats()                                    { Stats = FFidelityFXCASTileCacheStats(); }
+
+private:
+	void Clear();
+
+	int64 Budget = 0;
+	int64 SlotSize = 0;
+	uint64 ConfigHash = 0;
+	uint64 Frame = 0;
+	int32 ClockHand = 0;
+	TArray64<uint8> Memory;
+	TMap<uint64, int32> SlotsByKey;
+	TArray<uint64> SlotKeys;
+	TArray<uint64> SlotFrames;		// Frame of the last use of every slot, 0 = free
+	TArray64<uint8> Overflow;
+	TArray<FTile> Tiles;
+	FFidelityFXCASTileCacheStats Stats;
+};
+
+namespace FidelityFXCASCPU
+{
+	// Process() through the context's tile cache, Input and Output must not overlap
+	bool ProcessTileCached(FFidelityFXCASCPUContext& Context, const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output,
+		const FFidelityFXCASCPUSettings& Settings);
+}
@@ -0,0 +1,315 @@
+#include "FidelityFXCASMappedFrame.h"
+#include "FidelityFXCASCPU.h"
+
+#include "Misc/Paths.h"
+
+#if PLATFORM_WINDOWS
+	#include "Windows/AllowWindowsPlatformTypes.h"
+	#include "Windows/MinWindows.h"
+	#include "Windows/HideWindowsPlatformTypes.h"
+#elif PLATFORM_UNIX || PLATFORM_MAC
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#else
+	#include "Misc/FileHelper.h"
+#endif
+
+//-------------------------------------------------------------------------------------------------
+// FFidelityFXCASMappedFile class implementation
+//-------------------------------------------------------------------------------------------------
+
+#if PLATFORM_WINDOWS
+
+FFidelityFXCASMappedFile::~FFidelityFXCASMappedFile()
+{
+	if (Data)
+		UnmapViewOfFile(Data);
+	if (MappingHandle)
+		CloseHandle(MappingHandle);
+	if (FileHandle && FileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(FileHandle);
+}
+
+TUniquePtr<FFidelityFXCASMappedFile> FFidelityFXCASMappedFile::OpenRead(const FString& Filename, bool bSequential)
+{
+	TUniquePtr<FFidelityFXCASMappedFile> File(new FFidelityFXCASMappedFile());
+	File->FileHandle = CreateFileW(*Filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | (bSequential ? FILE_FLAG_SEQUENTIAL_SCAN : 0), nullptr);
+	LARGE_INTEGER FileSize;
+	if (File->FileHandle == INVALID_HANDLE_VALUE || !GetFileSizeEx(File->FileHandle, &FileSize) || FileSize.QuadPart <= 0)
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("Can't open %s for reading."), *Filename);
+		return nullptr;
+	}
+	File->Size = FileSize.QuadPart;
+	File->MappingHandle = CreateFileMappingW(File->FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	File->Data = File->MappingHandle ? static_cast<uint8*>(MapViewOfFile(File->MappingHandle, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+	if (!File->Data)
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("Can't map %s for reading."), *Filename);
+		return nullptr;
+	}
+	return File;
+}
+
+TUniquePtr<FFidelityFXCASMappedFile> FFidelityFXCASMappedFile::CreateWrite(const FString& Filename, int64 Size, bool bSequential)
+{
+	TUniquePtr<FFidelityFXCASMappedFile> File(new FFidelityFXCASMappedFile());
+	File->bWritable = true;
+	File->FileHandle = CreateFileW(*Filename, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+		FILE_ATTRIBUTE_NORMAL | (bSequential ? FILE_FLAG_SEQUENTIAL_SCAN : 0), nullptr);
+	if (File->FileHandle == INVALID_HANDLE_VALUE || Size <= 0)
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("Can't create %s."), *Filename);
+		return nullptr;
+	}
+	// Creating the mapping with the final size also pre-sizes the file
+	File->Size = Size;
+	File->MappingHandle = CreateFileMappingW(File->FileHandle, nullptr, PAGE_READWRITE, static_cast<DWORD>(Size >> 32), static_cast<DWORD>(Size & 0xffffffff), nullptr);
+	File->Data = File->MappingHandle ? static_cast<uint8*>(MapViewOfFile(File->MappingHandle, FILE_MAP_WRITE, 0, 0, 0)) : nullptr;
+	if (!File->Data)
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("Can't map %s for writing."), *Filename);
+		return nullptr;
+	}
+	return File;
+}
+
+#elif PLATFORM_UNIX || PLATFORM_MAC
+
+FFidelityFXCASMappedFile::~FFidelityFXCASMappedFile()
+{
+	if (Data)
+		munmap(Data, Size);
+	if (FileDescriptor >= 0)
+		close(FileDescriptor);
+}
+
+TUniquePtr<FFidelityFXCASMappedFile> FFidelityFXCASMappedFile::OpenRead(const FString& Filename, bool bSequential)
+{
+	TUniquePtr<FFidelityFXCASMappedFile> File(new FFidelityFXCASMappedFile());
+	File->FileDescriptor = open(TCHAR_TO_UTF8(*Filename), O_RDONLY);
+	struct stat FileStat;
+	if (File->FileDescriptor < 0 || fstat(File->FileDescriptor, &FileStat) != 0 || FileStat.st_size <= 0)
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("Can't open %s for reading."), *Filename);
+		return nullptr;
+	}
+	File->Size = FileStat.st_size;
+	void* Mapping = mmap(nullptr, File->Size, PROT_READ, MAP_SHARED, File->FileDescriptor, 0);
+	if (Mapping == MAP_FAILED)
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("Can't map %s for reading."), *Filename);
+		return nullptr;
+	}
+	File->Data = static_cast<uint8*>(Mapping);
+	if (bSequential)
+	{
+		// Aggressive read-ahead, pages behind the kernel can be dropped early
+		madvise(Mapping, File->Size, MADV_SEQUENTIAL);
+		madvise(Mapping, File->Size, MADV_WILLNEED);
+	}
+	return File;
+}
+
+TUniquePtr<FFidelityFXCASMappedFile> FFidelityFXCASMappedFile::CreateWrite(const FString& Filename, int64 Size, bool bSequential)
+{
+	TUniquePtr<FFidelityFXCASMappedFile> File(new FFidelityFXCASMappedFile());
+	File->bWritable = true;
+	File->FileDescriptor = open(TCHAR_TO_UTF8(*Filename), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (File->FileDescriptor < 0 || Size <= 0 || ftruncate(File->FileDescriptor, Size) != 0)
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("Can't create %s."), *Filename);
+		return nullptr;
+	}
+	File->Size = Size;
+	void* Mapping = mmap(nullptr, File->Size, PROT_READ | PROT_WRITE, MAP_SHARED, File->FileDescriptor, 0);
+	if (Mapping == MAP_FAILED)
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("Can't map %s for writing."), *Filename);
+		return nullptr;
+	}
+	File->Data = static_cast<uint8*>(Mapping);
+	if (bSequential)
+		madvise(Mapping, File->Size, MADV_SEQUENTIAL);
+	return File;
+}
+
+#else
+
+FFidelityFXCASMappedFile::~FFidelityFXCASMappedFile()
+{
+	if (bWritable && Buffer.Num() > 0)
+		FFileHelper::SaveArrayToFile(Buffer, *Filename);
+}
+
+TUniquePtr<FFidelityFXCASMappedFile> FFidelityFXCASMappedFile::OpenRead(const FString& Filename, bool bSequential)
+{
+	// No file mapping on this platform, fall back to a plain read
+	TUniquePtr<FFidelityFXCASMappedFile> File(new FFidelityFXCASMappedFile());
+	if (!FFileHelper::LoadFileToArray(File->Buffer, *Filename) || File->Buffer.Num() == 0)
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("Can't open %s for reading."), *Filename);
+		return nullptr;
+	}
+	File->Data = File->Buffer.GetData();
+	File->Size = File->Buffer.Num();
+	return File;
+}
+
+TUniquePtr<FFidelityFXCASMappedFile> FFidelityFXCASMappedFile::CreateWrite(const FString& Filename, int64 Size, bool bSequential)
+{
+	// No file mapping on this platform, the buffer is written when the file is released
+	TUniquePtr<FFidelityFXCASMappedFile> File(new FFidelityFXCASMappedFile());
+	if (Size <= 0 || Size > MAX_int32)
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("Can't create %s."), *Filename);
+		return nullptr;
+	}
+	File->bWritable = true;
+	File->Filename = Filename;
+	File->Buffer.SetNumZeroed(static_cast<int32>(Size));
+	File->Data = File->Buffer.GetData();
+	File->Size = Size;
+	return File;
+}
+
+#endif
+
+//-------------------------------------------------------------------------------------------------
+// PFM header
+//-------------------------------------------------------------------------------------------------
+
+namespace FidelityFXCASMappedFrame
+{
+	// "PF" (color) or "Pf" (grayscale), width, height and scale separated by whitespace,
+	// followed by exactly one whitespace character before the pixels. A negative scale means little endian.
+	static bool ParsePFMHeader(const uint8* Data, int64 Size, int32& OutWidth, int32& OutHeight, bool& bOutColor, bool& bOutLittleEndian, int64& OutHeaderSize)
+	{
+		int64 Pos = 0;
+		auto ReadToken = [Data, Size, &Pos](ANSICHAR* OutToken, int32 MaxLength)
+		{
+			while (Pos < Size && FCharAnsi::IsWhitespace(static_cast<ANSICHAR>(Data[Pos])))
+				++Pos;
+			int32 Length = 0;
+			while (Pos < Size && Length < MaxLength - 1 && !FCharAnsi::IsWhitespace(static_cast<ANSICHAR>(Data[Pos])))
+				OutToken[Length++] = static_cast<ANSICHAR>(Data[Pos++]);
+			OutToken[Length] = 0;
+			return Length > 0;
+		};
+
+		ANSICHAR Magic[4], Width[16], Height[16], Scale[32];
+		if (!ReadToken(Magic, 4) || !ReadToken(Width, 16) || !ReadToken(Height, 16) || !ReadToken(Scale, 32) || Pos >= Size)
+			return false;
+		if (Magic[0] != 'P' || (Magic[1] != 'F' && Magic[1] != 'f') || Magic[2] != 0)
+			return false;
+
+		bOutColor = (Magic[1] == 'F');
+		OutWidth = FCStringAnsi::Atoi(Width);
+		OutHeight = FCStringAnsi::Atoi(Height);
+		bOutLittleEndian = FCStringAnsi::Atof(Scale) < 0.0f;
+		OutHeaderSize = Pos + 1;
+		return OutWidth > 0 && OutHeight > 0;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+// FFidelityFXCASMappedFrame class implementation
+//-------------------------------------------------------------------------------------------------
+
+EFidelityFXCASFrameFileType FFidelityFXCASMappedFrame::GetFileType(const FString& Filename)
+{
+	return FPaths::GetExtension(Filename).Equals(TEXT("pfm"), ESearchCase::IgnoreCase) ? EFidelityFXCASFrameFileType::PFM : EFidelityFXCASFrameFileType::Raw;
+}
+
+TUniquePtr<FFidelityFXCASMappedFrame> FFidelityFXCASMappedFrame::OpenRead(const FString& Filename, const FFidelityFXCASRawFrameDesc* RawDesc, bool bStreaming)
+{
+	const EFidelityFXCASFrameFileType FileType = GetFileType(Filename);
+	if (FileType == EFidelityFXCASFrameFileType::Raw && !RawDesc)
+	{
+		UE_LOG(LogFidelityFXCASCPU, Error, TEXT("%s: raw frames need a frame description."), *Filename);
+		return nullptr;
+	}
+
+	TUniquePtr<FFidelityFXCASMappedFrame> Frame(new FFidelityFXCASMappedFrame());
+	Frame->File = FFidelityFXCASMappedFile::OpenRead(Filename, bStreaming);
+	if (!Frame->File.IsValid())
+		return nullptr;
+
+	uint8* FileData = Frame->File->GetData();
+	const int64 FileSize = Frame->File->GetSize();
+	FFidelityFXCASImageView& View = Frame->View;
+
+	if (FileType == EFidelityFXCASFrameFileType::PFM)
+	{
+		int32 Width, Height;
+		bool bColor, bLittleEndian;
+		int64 HeaderSize;
+		if (!FidelityFXCASMappedFrame::ParsePFMHeader(FileData, FileSize, Width, Height, bColor, bLittleEndian, HeaderSize))
+		{
+			UE_LOG(LogFidelityFXCASCPU, Error, TEXT("%s: invalid PFM header."), *Filename);
+			return nullptr;
+		}
+		// The pixels are used in place, so only the layout matching the CPU can be mapped
+		if (!bColor || bLittleEndian != !!PLATFORM_LITTLE_ENDIAN)
+		{
+			UE_LOG(LogFidelityFXCASCPU, Error, TEXT("%s: only %s endian color PFM frames are supported."), *Filename, PLATFORM_LITTLE_ENDIAN ? TEXT("little") : TEXT("big"));
+			return nullptr;
+		}
+
+		// PFM rows are stored bottom-up, the view walks them with a negative pitch
+		const int64 RowBytes = static_cast<int64>(Width) * GetFidelityFXCASBytesPerPixel(EFidelityFXCASPixelFormat::RGB32F);
+		if (FileSize < HeaderSize + RowBytes * Height)
+		{
+			UE_LOG(LogFidelityFXCASCPU, Error, TEXT("%s: file is truncated."), *Filename);
+			return nullptr;
+		}
+		View = FFidelityFXCASImageView(FileData + HeaderSize + RowBytes * (Height - 1), Width, Height, -RowBytes, EFidelityFXCASPixelFormat::RGB32F);
+	}
+	else
+	{
+		const int64 RowBytes = static_cast<int64>(RawDesc->Width) * GetFidelityFXCASBytesPerPixel(RawDesc->Format);
+		const int64 RowPitch = RawDesc->RowPitch > 0 ? RawDesc->RowPitch : RowBytes;
+		if (RawDesc->Width <= 0 || RawDesc->Height <= 0 || RowPitch < RowBytes
+			|| FileSize < RawDesc->HeaderSize + RowPitch * (RawDesc->Height - 1) + RowBytes)
+		{
+			UE_LOG(LogFidelityFXCASCPU, Error, TEXT("%s: file doesn't match the raw frame description (%dx%d)."), *Filename, RawDesc->Width, RawDesc->Height);
+			return nullptr;
+		}
+		View = FFidelityFXCASImageView(FileData + RawDesc->HeaderSize, RawDesc->Width, RawDesc->Height, RowPitch, RawDesc->Format, RawDesc->ChannelOrder);
+	}
+
+	return Frame;
+}
+
+TUniquePtr<FFidelityFXCASMappedFrame> FFidelityFXCASMappedFrame::CreateWrite(const FString& Filename, EFidelityFXCASFrameFileType FileType,
+	int32 Width, int32 Height, EFidelityFXCASPixelFormat Format, bool bStreaming)
+{
+	if (Width <= 0 || Height <= 0)
+		return nullptr;
+
+	if (FileType == EFidelityFXCASFrameFileType::PFM)
+		Format = EFidelityFXCASPixelFormat::RGB32F;
+
+	FTCHARToUTF8 Header(FileType == EFidelityFXCASFrameFileType::PFM
+		? *FString::Printf(TEXT("PF\n%d %d\n%s\n"), Width, Height, PLATFORM_LITTLE_ENDIAN ? TEXT("-1.0") : TEXT("1.0"))
+		: TEXT(""));
+	const int64 HeaderSize = Header.Length();
+	const int64 RowBytes = static_cast<int64>(Width) * GetFidelityFXCASBytesPerPixel(Format);
+
+	TUniquePtr<FFidelityFXCASMappedFrame> Frame(new FFidelityFXCASMappedFrame());
+	Frame->File = FFidelityFXCASMappedFile::CreateWrite(Filename, HeaderSize + RowBytes * Height, bStreaming);
+	if (!Frame->File.IsValid())
+		return nullptr;
+
+	uint8* FileData = Frame->File->GetData();
+	FMemory::Memcpy(FileData, Header.Get(), HeaderSize);
+	if (FileType == EFidelityFXCASFrameFileType::PFM)
+		Frame->View = FFidelityFXCASImageView(FileData + HeaderSize + RowBytes * (Height - 1), Width, Height, -RowBytes, Format);
+	else
+		Frame->View = FFidelityFXCASImageView(FileData, Width, Height, RowBytes, Format);
+
+	return Frame;
+}
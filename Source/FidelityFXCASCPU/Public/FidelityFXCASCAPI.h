@@ -0,0 +1,112 @@
+#pragma once
+
+// Stable C interface of the CPU CAS engine, for tools that are not built with UE (Python via ctypes / cffi,
+// video transcoder plugins, servers). Plain C, no UE headers, no C++ types cross the boundary.
+// Structs start with a StructSize field so they can grow in later versions without breaking existing callers.
+//
+// The functions are exported by the FidelityFXCASCPU module library, which links UE Core (allocator, thread pool):
+// they can only be called in a process that initialized Core and loaded the module - the editor, a commandlet,
+// a game or a UE Program target hosting the tool. Loading the library alone returns FFXCAS_ERROR_NOT_INITIALIZED.
+
+#include <stdint.h>
+
+#if defined(FIDELITYFXCASCPU_API)
+	#define FFXCAS_API FIDELITYFXCASCPU_API
+#elif defined(_WIN32)
+	#define FFXCAS_API __declspec(dllimport)
+#else
+	#define FFXCAS_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Minor is bumped when functions or struct fields are added, major when existing ones change.
+// Callers pass FFXCAS_API_VERSION to ffxCasCheckApiVersion() before any other call.
+#define FFXCAS_API_VERSION_MAJOR 1
+#define FFXCAS_API_VERSION_MINOR 1
+#define FFXCAS_API_VERSION ((FFXCAS_API_VERSION_MAJOR << 16) | FFXCAS_API_VERSION_MINOR)
+
+typedef enum FfxCasResult
+{
+	FFXCAS_OK = 0,
+	FFXCAS_ERROR_INVALID_ARGUMENT = 1,
+	FFXCAS_ERROR_UNSUPPORTED_FORMAT = 2,
+	FFXCAS_ERROR_INCOMPATIBLE_VERSION = 3,	// Library of another major version, or an older minor version than the header
+	FFXCAS_ERROR_NOT_INITIALIZED = 4,		// UE Core is not running or the module is not loaded in this process
+} FfxCasResult;
+
+typedef enum FfxCasPixelFormat
+{
+	FFXCAS_PIXEL_FORMAT_RGBA32F = 0,	// 4 x float, linear [0, 1]
+	FFXCAS_PIXEL_FORMAT_RGB32F = 1,		// 3 x float, linear [0, 1]
+	FFXCAS_PIXEL_FORMAT_RGBA8 = 2,		// 4 x uint8, unorm
+	FFXCAS_PIXEL_FORMAT_RGBA16F = 3,	// 4 x half, linear [0, 1]
+	FFXCAS_PIXEL_FORMAT_RGBA8_SRGB = 4,	// 4 x uint8, sRGB encoded (gamma 2.0 approximation)
+} FfxCasPixelFormat;
+
+typedef enum FfxCasChannelOrder
+{
+	FFXCAS_CHANNEL_ORDER_RGBA = 0,
+	FFXCAS_CHANNEL_ORDER_BGRA = 1,		// BGR for the 3 channel formats
+} FfxCasChannelOrder;
+
+// Strided image in caller owned memory
+typedef struct FfxCasImageView
+{
+	uint32_t StructSize;			// sizeof(FfxCasImageView)
+	void* Data;						// First byte of the top row
+	int32_t Width;
+	int32_t Height;
+	int64_t RowStride;				// Bytes between the starts of two rows, negative for bottom-up images
+	FfxCasPixelFormat Format;
+	FfxCasChannelOrder ChannelOrder;
+} FfxCasImageView;
+
+// Sub-rectangle of an image view in pixels
+typedef struct FfxCasRect
+{
+	int32_t X;
+	int32_t Y;
+	int32_t Width;
+	int32_t Height;
+} FfxCasRect;
+
+typedef struct FfxCasContextDesc
+{
+	uint32_t StructSize;			// sizeof(FfxCasContextDesc)
+	int32_t NumThreads;				// Threads working on one image including the calling one, 0 = one per core
+	int64_t ScratchReserveSize;		// Bytes to pre-allocate in the scratch arena, 0 = grow on demand
+} FfxCasContextDesc;
+
+typedef struct FfxCasSettings
+{
+	uint32_t StructSize;			// sizeof(FfxCasSettings)
+	float Sharpness;				// 0 = lower ringing, 1 = maximum sharpening
+} FfxCasSettings;
+
+// Context holding the thread pool and the scratch arena, reused across calls
+typedef struct FfxCasContext FfxCasContext;
+
+// FFXCAS_API_VERSION of the library
+FFXCAS_API uint32_t ffxCasGetApiVersion(void);
+// FFXCAS_OK if the library serves callers built with HeaderVersion (same major, library minor not older)
+FFXCAS_API FfxCasResult ffxCasCheckApiVersion(uint32_t HeaderVersion);
+
+// Desc may be NULL for the defaults
+FFXCAS_API FfxCasResult ffxCasCreateContext(const FfxCasContextDesc* Desc, FfxCasContext** OutContext);
+FFXCAS_API void ffxCasDestroyContext(FfxCasContext* Context);
+
+// Sharpens (same size) or sharpens and scales (different size) InputRect of Input into OutputRect of Output.
+// Rects may be NULL for the whole image. Input and output may be regions of the same buffer, also overlapping
+// ones (in place). Pixels outside InputRect are never read, the region edges are clamped.
+// A context must not be used by two threads at the same time.
+FFXCAS_API FfxCasResult ffxCasProcess(FfxCasContext* Context,
+	const FfxCasImageView* Input, const FfxCasRect* InputRect,
+	const FfxCasImageView* Output, const FfxCasRect* OutputRect,
+	const FfxCasSettings* Settings);
+
+#ifdef __cplusplus
+}
+#endif
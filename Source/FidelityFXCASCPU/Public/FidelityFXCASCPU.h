@@ -0,0 +1,78 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
+#include "FidelityFXCASCPUTypes.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogFidelityFXCASCPU, Log, All);
+
+class FIDELITYFXCASCPU_API FFidelityFXCASCPUModule : public IModuleInterface
+{
+public:
+	// Static accessors
+	static FORCEINLINE bool IsAvailable() { return FModuleManager::Get().IsModuleLoaded("FidelityFXCASCPU"); }
+	static FFidelityFXCASCPUModule& Get();
+
+	// IModuleInterface implementation
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+
+	// Runs CAS on the CPU, reading Input and writing Output in place (no intermediate copies).
+	// Sharpen only if both views have the same size, CAS scaling otherwise (box prefiltered beyond 2x downscales, see GetPrefilterSize()).
+	// Views may point to mapped files, may be bottom-up (negative pitch) and may use different pixel formats.
+	// Input and Output may also be overlapping sub-views of the same buffer (in place processing).
+	bool Process(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FFidelityFXCASCPUSettings& Settings) const;
+	// Same as above, but runs on the context's thread pool and takes temporary memory from its scratch arena
+	bool Process(class FFidelityFXCASCPUContext& Context, const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output,
+		const FFidelityFXCASCPUSettings& Settings) const;
+
+	// Luma only CAS for planar YUV frames (NV12 / I420): CAS runs on the luma plane with single channel loads and stores, the chroma
+	// planes are copied, or bilinearly resampled when the output chroma size differs. No color conversion in either direction.
+	// Output chroma views without data leave the chroma untouched (i.e. when it is shared with the input).
+	bool ProcessLuma(const FFidelityFXCASYUVFrameView& Input, const FFidelityFXCASYUVFrameView& Output, const FFidelityFXCASCPUSettings& Settings) const;
+	// Same as above on the context's thread pool and scratch arena, the chroma planes included
+	bool ProcessLuma(class FFidelityFXCASCPUContext& Context, const FFidelityFXCASYUVFrameView& Input, const FFidelityFXCASYUVFrameView& Output,
+		const FFidelityFXCASCPUSettings& Settings) const;
+
+	// Incremental update of a partially changed input: only the output regions affected by InputDirtyRects (input pixels) are
+	// processed, the rest of Output is left untouched. Output must hold the result of a previous Process() with the same settings
+	// for an input that only changed inside the rectangles. Input and Output must not overlap. Bit identical to a full Process().
+	bool ProcessDirtyRects(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FFidelityFXCASCPUSettings& Settings,
+		const TArray<FIntRect>& InputDirtyRects) const;
+	bool ProcessDirtyRects(class FFidelityFXCASCPUContext& Context, const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output,
+		const FFidelityFXCASCPUSettings& Settings, const TArray<FIntRect>& InputDirtyRects) const;
+	// Output regions affected by changes inside InputDirtyRects: grown by the kernel apron, mapped to output pixels,
+	// clipped to the output and merged where they overlap. Shared with the GPU dirty rectangle dispatch.
+	static void GetDirtyOutputRects(const FIntPoint& InputSize, const FIntPoint& OutputSize, const TArray<FIntRect>& InputDirtyRects, TArray<FIntRect>& OutRects);
+
+	// Foveated CAS: full CAS on the tiles inside the inner ellipse of a focus region, the reduced tier up to the outer ellipse and a
+	// bilinear resample beyond. The CPU only has the Low quality the GPU runs on the reduced tiles, so full and reduced tiles match.
+	// Prefiltered downscales and a disabled foveation run Process(). Input and Output must not overlap.
+	bool ProcessFoveated(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FFidelityFXCASCPUSettings& Settings,
+		const FFidelityFXCASFoveation& Foveation) const;
+	// A tile takes the best class of the regions its nearest pixel center falls into. Shared with the GPU tile lists.
+	static void ClassifyTiles(const FIntPoint& OutputSize, const FFidelityFXCASFoveation& Foveation, FFidelityFXCASTileClassification& OutClassification);
+
+	// Downscales by more than 2x on an axis are beyond the reach of the CAS window, the input is box filtered first: every CAS input pixel
+	// averages PrefilterSize input pixels, so CAS runs on an input at most 2x the output size. (1, 1) when no prefilter is needed.
+	// Shared with the GPU prefilter permutation, so both paths reduce the same way.
+	static FIntPoint GetPrefilterSize(const FIntPoint& InputSize, const FIntPoint& OutputSize);
+	static FORCEINLINE FIntPoint GetPrefilteredSize(const FIntPoint& InputSize, const FIntPoint& PrefilterSize) { return FIntPoint::DivideAndRoundUp(InputSize, PrefilterSize); }
+
+	// Plain bilinear resample without CAS (the kernel of the foveated periphery), a converting copy when both views have the same size.
+	// Upscales and downscales up to 2x only. Reference for quality comparisons, i.e. bilinear upscale vs CAS upscale.
+	bool Resample(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Output, const FFidelityFXCASCPUSettings& Settings) const;
+
+	// Compares two images of the same size (any pixel formats), PSNR over the colors and SSIM over the luma
+	bool ComputeDifference(const FFidelityFXCASImageView& A, const FFidelityFXCASImageView& B, FFidelityFXCASImageDifference& OutDifference) const;
+	// Runs the scalar FP32 path on Input and compares its result with Result, e.g. the output of the RGBA16F SIMD path
+	bool MeasureErrorToReference(const FFidelityFXCASImageView& Input, const FFidelityFXCASImageView& Result, const FFidelityFXCASCPUSettings& Settings,
+		FFidelityFXCASImageDifference& OutDifference) const;
+
+	// Times the ISA (scalar / SIMD), the row band height and the thread count on a synthetic frame and returns the fastest configuration
+	bool AutoTune(const FIntPoint& InputSize, const FIntPoint& OutputSize, EFidelityFXCASPixelFormat Format, FFidelityFXCASCPUTuning& OutTuning) const;
+	// Local tuning profile (ini file), one entry per workload. Load fails if there is no entry measured on this CPU.
+	static bool SaveTuning(const FString& Filename, const FFidelityFXCASCPUTuning& Tuning);
+	static bool LoadTuning(const FString& Filename, const FIntPoint& InputSize, const FIntPoint& OutputSize, EFidelityFXCASPixelFormat Format,
+		FFidelityFXCASCPUTuning& OutTuning);
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include "Templates/UniquePtr.h"
+#include "FidelityFXCASCPUTypes.h"
+
+class FQueuedThreadPool;
+class FEvent;
+
+// Long lived state of the CPU engine: a private thread pool and a scratch arena.
+// Create one per tool / pipeline stage and reuse it for every image, so threads and allocations are not
+// recreated per call. A context is not thread safe, calls using the same context must not overlap.
+class FIDELITYFXCASCPU_API FFidelityFXCASCPUContext
+{
+public:
+	// NumThreads is the total number of threads working on one image (including the calling thread), 0 = one per core
+	explicit FFidelityFXCASCPUContext(int32 NumThreads = 0);
+	~FFidelityFXCASCPUContext();
+
+	FORCEINLINE int32 GetNumThreads() const { return NumWorkers + 1; }
+
+	// Calls Function(Index) for every Index in [0, Num) on the pool threads and the calling thread, returns when all calls are done
+	void ParallelFor(int32 Num, TFunctionRef<void(int32)> Function);
+
+	// Returns at least Size bytes of scratch memory (16 byte aligned). The memory stays valid until the next call.
+	// The arena grows but never shrinks, so steady state processing does not allocate.
+	uint8* GetScratch(int64 Size);
+	FORCEINLINE int64 GetScratchSize() const { return Scratch.Num(); }
+
+	// Content-hash tile cache used by Process() with FFidelityFXCASCPUSettings::bUseTileCache, created on first use with a
+	// 256 MB budget. Bytes is the memory for cached output tiles, 0 frees the cache.
+	void SetTileCacheBudget(int64 Bytes);
+	FFidelityFXCASTileCacheStats GetTileCacheStats() const;
+	void ResetTileCacheStats();
+	class FFidelityFXCASCPUTileCache& GetTileCache();
+
+private:
+	FFidelityFXCASCPUContext(const FFidelityFXCASCPUContext&) = delete;
+	FFidelityFXCASCPUContext& operator=(const FFidelityFXCASCPUContext&) = delete;
+
+	int32 NumWorkers = 0;
+	FQueuedThreadPool* ThreadPool = nullptr;
+	// One queued work item per worker thread, reused by every ParallelFor call
+	TArray<class FFidelityFXCASCPUWork*> Work;
+	FEvent* DoneEvent = nullptr;
+	TArray64<uint8> Scratch;
+	TUniquePtr<class FFidelityFXCASCPUTileCache> TileCache;
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Templates/Function.h"
+#include "FidelityFXCASCPUTypes.h"
+
+class FQueuedThreadPool;
+
+// One image of FFidelityFXCASCPUJobQueue::Submit(), processed like FFidelityFXCASCPUModule::Process() (without the tile cache).
+// The views are not copied: their memory must stay valid until the job ended.
+struct FFidelityFXCASCPUJobDesc
+{
+	FFidelityFXCASImageView Input;
+	FFidelityFXCASImageView Output;
+	FFidelityFXCASCPUSettings Settings;
+	EFidelityFXCASJobPriority Priority = EFidelityFXCASJobPriority::Normal;
+	// Seconds after the submit the result is no longer wanted (<= 0: none). Queued jobs of the same priority run earliest deadline first.
+	double DeadlineSeconds = 0.0;
+	// Called on the thread that ended the job (a queue thread, or the caller of Cancel() for a queued job), before the future is set
+	TFunction<void(const FFidelityFXCASCPUJobResult&)> OnComplete;
+};
+
+struct FFidelityFXCASCPUJobHandle
+{
+	uint64 JobId = 0;	// 0 if the submit failed
+	TFuture<FFidelityFXCASCPUJobResult> Future;
+
+	FORCEINLINE bool IsValid() const { return JobId != 0; }
+};
+
+// Shared CPU engine for callers mixing interactive and batch work: jobs are queued by priority and split in row bands, the bands of
+// running jobs are shared by the queue threads. Between two bands a thread leaves a job for a queued job of a higher priority, so an
+// interactive job waits for a band, not for a whole batch frame. Cancelled and expired jobs stop at the next band. Thread safe.
+class FIDELITYFXCASCPU_API FFidelityFXCASCPUJobQueue
+{
+public:
+	// NumThreads is the number of queue threads, 0 = one per core
+	explicit FFidelityFXCASCPUJobQueue(int32 NumThreads = 0);
+	// Cancels the queued jobs and waits for the running ones to stop
+	~FFidelityFXCASCPUJobQueue();
+
+	FORCEINLINE int32 GetNumThreads() const { return NumThreads; }
+
+	FFidelityFXCASCPUJobHandle Submit(FFidelityFXCASCPUJobDesc&& Desc);
+	// False if the job already ended
+	bool Cancel(uint64 JobId);
+
+	// Queue depth, running jobs, wait times and latencies per priority
+	FFidelityFXCASCPUJobQueueStats GetStats() const;
+	void ResetStats();
+
+private:
+	FFidelityFXCASCPUJobQueue(const FFidelityFXCASCPUJobQueue&) = delete;
+	FFidelityFXCASCPUJobQueue& operator=(const FFidelityFXCASCPUJobQueue&) = delete;
+
+	friend class FFidelityFXCASCPUJobWorker;
+	struct FJob;
+	struct FPhase;
+
+	// Runs queued jobs and shares the bands of the running ones until there is nothing left to do
+	void RunWorker(class FFidelityFXCASCPUJobWorker* Worker);
+	// Open phase or queued job a thread takes next, of a priority above Limit: the highest priority, a phase before a job of the same
+	// priority. A job taken is started. Under the lock.
+	bool PickWork(FJob*& OutJob, FPhase*& OutPhase, EFidelityFXCASJobPriority Limit = EFidelityFXCASJobPriority::Num);
+	// Queued job of the priority with the earliest deadline (the oldest without deadlines), nullptr if none. Under the lock.
+	FJob* PopQueuedJob(EFidelityFXCASJobPriority Priority);
+	void RunJob(FJob* Job);
+	// ParallelForFunction of a job: the bands are open to the other threads until they are drained
+	void RunPhase(FJob* Job, int32 Num, TFunctionRef<void(int32)> Function);
+	// Bands of another thread's phase until it is drained, false when left for higher priority work
+	bool HelpPhase(FPhase* Phase);
+	// Runs the queued jobs and helps the open phases of a higher priority on this thread, between two bands of Job
+	void RunPreemptingJobs(FJob* Job);
+	// Queued jobs or open phases with bands left of a higher priority, without the lock
+	bool HasWorkAbove(EFidelityFXCASJobPriority Priority) const;
+	// Starts idle queue threads for new work, under the lock
+	void WakeWorkers(int32 Num);
+	void EndJob(FJob* Job, EFidelityFXCASJobStatus Status);
+
+	int32 NumThreads = 0;
+	FQueuedThreadPool* ThreadPool = nullptr;
+	mutable FCriticalSection Lock;
+	// Queued jobs of every priority in submit order
+	TArray<FJob*> QueuedJobs[static_cast<int32>(EFidelityFXCASJobPriority::Num)];
+	TArray<FJob*> RunningJobs;
+	// Band sets of the running jobs open to the other threads
+	TArray<FPhase*> Phases;
+	// Queued jobs and open phases of every priority, read between two bands without the lock
+	FThreadSafeCounter NumQueuedJobs[static_cast<int32>(EFidelityFXCASJobPriority::Num)];
+	FThreadSafeCounter NumOpenPhases[static_cast<int32>(EFidelityFXCASJobPriority::Num)];
+	// Work items of the threads not running, one per queue thread
+	TArray<class FFidelityFXCASCPUJobWorker*> IdleWorkers;
+	TArray<class FFidelityFXCASCPUJobWorker*> Workers;
+	uint64 NextJobId = 1;
+	bool bShuttingDown = false;
+	FFidelityFXCASCPUJobQueueStats Stats;
+};
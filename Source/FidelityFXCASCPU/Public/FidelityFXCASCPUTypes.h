@@ -0,0 +1,370 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+//-------------------------------------------------------------------------------------------------
+// Pixel formats understood by the CPU engine
+//-------------------------------------------------------------------------------------------------
+
+enum class EFidelityFXCASPixelFormat : uint8
+{
+	RGBA32F,	// 4 x float, linear [0, 1]
+	RGB32F,		// 3 x float, linear [0, 1] (PFM color layout)
+	RGBA8,		// 4 x uint8, unorm
+	RGBA16F,	// 4 x half, linear [0, 1] (PF_FloatRGBA)
+	RGBA8_SRGB,	// 4 x uint8, sRGB (or gamma 2.2) encoded, linearized with the gamma 2.0 approximation from ffx_cas.ush
+	R8,			// 1 x uint8, unorm, single channel luma (Y plane of NV12 / I420 frames)
+	R32F,		// 1 x float, single channel luma
+	RG8,		// 2 x uint8, unorm, interleaved U and V (chroma plane of NV12 frames), resampled only
+};
+
+// Single channel formats, CAS runs on them with single channel loads and stores and only between them
+FORCEINLINE bool IsFidelityFXCASLumaFormat(EFidelityFXCASPixelFormat Format)
+{
+	return Format == EFidelityFXCASPixelFormat::R8 || Format == EFidelityFXCASPixelFormat::R32F;
+}
+
+// Order of the color channels in memory. Alpha (if present) is always last.
+enum class EFidelityFXCASChannelOrder : uint8
+{
+	RGBA,
+	BGRA,	// BGR for the 3 channel formats
+};
+
+FORCEINLINE int32 GetFidelityFXCASBytesPerPixel(EFidelityFXCASPixelFormat Format)
+{
+	switch (Format)
+	{
+	case EFidelityFXCASPixelFormat::RGBA32F: return 16;
+	case EFidelityFXCASPixelFormat::RGB32F:  return 12;
+	case EFidelityFXCASPixelFormat::RGBA8:   return 4;
+	case EFidelityFXCASPixelFormat::RGBA16F: return 8;
+	case EFidelityFXCASPixelFormat::RGBA8_SRGB: return 4;
+	case EFidelityFXCASPixelFormat::R8:      return 1;
+	case EFidelityFXCASPixelFormat::R32F:    return 4;
+	case EFidelityFXCASPixelFormat::RG8:     return 2;
+	default:                                 return 0;
+	}
+}
+
+// Format from its name (i.e. a command line value), false for unknown names
+inline bool ParseFidelityFXCASPixelFormat(const FString& Name, EFidelityFXCASPixelFormat& OutFormat)
+{
+	if (Name.Equals(TEXT("RGBA32F"), ESearchCase::IgnoreCase))
+		OutFormat = EFidelityFXCASPixelFormat::RGBA32F;
+	else if (Name.Equals(TEXT("RGB32F"), ESearchCase::IgnoreCase))
+		OutFormat = EFidelityFXCASPixelFormat::RGB32F;
+	else if (Name.Equals(TEXT("RGBA8"), ESearchCase::IgnoreCase))
+		OutFormat = EFidelityFXCASPixelFormat::RGBA8;
+	else if (Name.Equals(TEXT("RGBA16F"), ESearchCase::IgnoreCase))
+		OutFormat = EFidelityFXCASPixelFormat::RGBA16F;
+	else if (Name.Equals(TEXT("RGBA8_SRGB"), ESearchCase::IgnoreCase))
+		OutFormat = EFidelityFXCASPixelFormat::RGBA8_SRGB;
+	else if (Name.Equals(TEXT("R8"), ESearchCase::IgnoreCase))
+		OutFormat = EFidelityFXCASPixelFormat::R8;
+	else if (Name.Equals(TEXT("R32F"), ESearchCase::IgnoreCase))
+		OutFormat = EFidelityFXCASPixelFormat::R32F;
+	else
+		return false;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Non-owning view of a strided image in memory
+//-------------------------------------------------------------------------------------------------
+
+struct FFidelityFXCASImageView
+{
+	// First byte of the top row
+	uint8* Data = nullptr;
+	int32 Width = 0;
+	int32 Height = 0;
+	// Distance in bytes between the starts of two consecutive rows. May be negative for bottom-up images.
+	int64 RowPitch = 0;
+	EFidelityFXCASPixelFormat Format = EFidelityFXCASPixelFormat::RGBA32F;
+	EFidelityFXCASChannelOrder ChannelOrder = EFidelityFXCASChannelOrder::RGBA;
+
+	FFidelityFXCASImageView() = default;
+	FFidelityFXCASImageView(void* InData, int32 InWidth, int32 InHeight, int64 InRowPitch, EFidelityFXCASPixelFormat InFormat,
+		EFidelityFXCASChannelOrder InChannelOrder = EFidelityFXCASChannelOrder::RGBA)
+		: Data(static_cast<uint8*>(InData)), Width(InWidth), Height(InHeight), RowPitch(InRowPitch), Format(InFormat), ChannelOrder(InChannelOrder) { }
+
+	FORCEINLINE int32 GetBytesPerPixel() const        { return GetFidelityFXCASBytesPerPixel(Format); }
+	FORCEINLINE FIntPoint GetSize() const             { return FIntPoint(Width, Height); }
+	FORCEINLINE uint8* GetRow(int32 Y) const          { return Data + static_cast<int64>(Y) * RowPitch; }
+	FORCEINLINE bool IsValid() const
+	{
+		return Data && Width > 0 && Height > 0 && FMath::Abs(RowPitch) >= static_cast<int64>(Width) * GetBytesPerPixel();
+	}
+
+	// View of a sub-rectangle sharing the same memory (no copy). Rect must lie inside the view.
+	FORCEINLINE FFidelityFXCASImageView GetSubView(const FIntRect& Rect) const
+	{
+		FFidelityFXCASImageView SubView = *this;
+		SubView.Data = GetRow(Rect.Min.Y) + static_cast<int64>(Rect.Min.X) * GetBytesPerPixel();
+		SubView.Width = Rect.Width();
+		SubView.Height = Rect.Height();
+		return SubView;
+	}
+
+	// Address range [Begin, End) touched by the view, used to detect in place processing
+	FORCEINLINE const uint8* GetMemoryBegin() const   { return RowPitch >= 0 ? Data : GetRow(Height - 1); }
+	FORCEINLINE const uint8* GetMemoryEnd() const     { return (RowPitch >= 0 ? GetRow(Height - 1) : Data) + static_cast<int64>(Width) * GetBytesPerPixel(); }
+	FORCEINLINE bool Overlaps(const FFidelityFXCASImageView& Other) const
+	{
+		return GetMemoryBegin() < Other.GetMemoryEnd() && Other.GetMemoryBegin() < GetMemoryEnd();
+	}
+};
+
+//-------------------------------------------------------------------------------------------------
+// Planar YUV frames
+//-------------------------------------------------------------------------------------------------
+
+// Full resolution luma plane and subsampled chroma planes, see FFidelityFXCASCPUModule::ProcessLuma()
+struct FFidelityFXCASYUVFrameView
+{
+	FFidelityFXCASImageView Luma;		// R8 or R32F
+	FFidelityFXCASImageView ChromaU;	// R8 (I420), or RG8 with interleaved U and V (NV12). No data: the chroma is left untouched.
+	FFidelityFXCASImageView ChromaV;	// R8 (I420), no data for NV12
+
+	FORCEINLINE bool IsNV12() const { return ChromaU.Format == EFidelityFXCASPixelFormat::RG8; }
+
+	// Contiguous NV12: the Y plane followed by the UV plane with the same pitch (even for odd widths)
+	static FFidelityFXCASYUVFrameView MakeNV12(void* Data, int32 Width, int32 Height, int64 RowPitch)
+	{
+		FFidelityFXCASYUVFrameView Frame;
+		Frame.Luma = FFidelityFXCASImageView(Data, Width, Height, RowPitch, EFidelityFXCASPixelFormat::R8);
+		Frame.ChromaU = FFidelityFXCASImageView(static_cast<uint8*>(Data) + RowPitch * Height, (Width + 1) / 2, (Height + 1) / 2, RowPitch,
+			EFidelityFXCASPixelFormat::RG8);
+		return Frame;
+	}
+
+	// Contiguous I420: the Y plane followed by the U and V planes with half the pitch
+	static FFidelityFXCASYUVFrameView MakeI420(void* Data, int32 Width, int32 Height, int64 RowPitch)
+	{
+		const int32 ChromaHeight = (Height + 1) / 2;
+		const int64 ChromaPitch = (RowPitch + 1) / 2;
+		uint8* ChromaData = static_cast<uint8*>(Data) + RowPitch * Height;
+		FFidelityFXCASYUVFrameView Frame;
+		Frame.Luma = FFidelityFXCASImageView(Data, Width, Height, RowPitch, EFidelityFXCASPixelFormat::R8);
+		Frame.ChromaU = FFidelityFXCASImageView(ChromaData, (Width + 1) / 2, ChromaHeight, ChromaPitch, EFidelityFXCASPixelFormat::R8);
+		Frame.ChromaV = FFidelityFXCASImageView(ChromaData + ChromaPitch * ChromaHeight, (Width + 1) / 2, ChromaHeight, ChromaPitch, EFidelityFXCASPixelFormat::R8);
+		return Frame;
+	}
+};
+
+//-------------------------------------------------------------------------------------------------
+// CPU pass settings
+//-------------------------------------------------------------------------------------------------
+
+struct FFidelityFXCASCPUSettings
+{
+	// Same meaning as the screen space sharpness: 0 = lower ringing, 1 = maximum sharpening
+	float Sharpness = 0.5f;
+	// Split the image in row bands and process them on the task graph
+	bool bMultithreaded = true;
+	// Use the SIMD kernels when the CPU supports them (results may differ from the scalar kernels in the last bit)
+	bool bAllowSIMD = true;
+	// Output rows processed by one task of the row band split (<= 0 for the default of 16)
+	int32 RowsPerTask = 16;
+	// Context entry point only: hash the input of every 64x64 output tile and copy the tiles seen before from the
+	// context's tile cache instead of computing them (see FFidelityFXCASCPUContext::SetTileCacheBudget)
+	bool bUseTileCache = false;
+};
+
+//-------------------------------------------------------------------------------------------------
+// Foveated processing
+//-------------------------------------------------------------------------------------------------
+
+// Work done on one tile of the foveated path
+enum class EFidelityFXCASTileClass : uint8
+{
+	Full,		// CAS at the requested quality
+	Reduced,	// Low CAS quality, the only one of the CPU engine
+	Bilinear,	// Plain bilinear resample (a copy when sharpening only)
+	Num
+};
+
+// Focus region in normalized output coordinates (0..1 on both axes). The radii are per axis, so the ellipses
+// follow the aspect ratio of the view. A fixed region stays centered, eye tracking moves it with the gaze.
+struct FFidelityFXCASFocusRegion
+{
+	FVector2D Center = FVector2D(0.5f, 0.5f);
+	FVector2D InnerRadius = FVector2D(0.25f, 0.25f);	// Full CAS inside
+	FVector2D OuterRadius = FVector2D(0.5f, 0.5f);		// Reduced CAS between the two ellipses, bilinear beyond
+};
+
+// Focus regions of a frame, i.e. one per eye of a side by side stereo render target. No regions: foveation is off.
+struct FFidelityFXCASFoveation
+{
+	TArray<FFidelityFXCASFocusRegion, TInlineAllocator<2>> Regions;
+
+	FORCEINLINE bool IsEnabled() const { return Regions.Num() > 0; }
+
+	// Fixed foveation of NumViews views side by side, Inner and Outer are fractions of the half size of every view
+	static FFidelityFXCASFoveation MakeFixed(int32 NumViews, float Inner, float Outer)
+	{
+		FFidelityFXCASFoveation Foveation;
+		const float ViewWidth = 1.0f / FMath::Max(NumViews, 1);
+		for (int32 ViewIndex = 0; ViewIndex < NumViews; ++ViewIndex)
+		{
+			FFidelityFXCASFocusRegion& Region = Foveation.Regions.AddDefaulted_GetRef();
+			Region.Center = FVector2D((ViewIndex + 0.5f) * ViewWidth, 0.5f);
+			Region.InnerRadius = FVector2D(0.5f * ViewWidth, 0.5f) * Inner;
+			Region.OuterRadius = FVector2D(0.5f * ViewWidth, 0.5f) * FMath::Max(Outer, Inner);
+		}
+		return Foveation;
+	}
+};
+
+// Class of every 16x16 output tile (the region of one GPU thread group) and the tiles of every class, packed X | Y << 16.
+// Built by FFidelityFXCASCPUModule::ClassifyTiles(), the GPU uploads the lists and dispatches one thread group per tile.
+struct FFidelityFXCASTileClassification
+{
+	static const int32 TileSize = 16;
+
+	FIntPoint NumTiles = FIntPoint::ZeroValue;
+	TArray<EFidelityFXCASTileClass> Classes;	// Row major, NumTiles.X * NumTiles.Y
+	TArray<uint32> TileLists[static_cast<int32>(EFidelityFXCASTileClass::Num)];
+
+	FORCEINLINE EFidelityFXCASTileClass GetClass(int32 TileX, int32 TileY) const { return Classes[TileY * NumTiles.X + TileX]; }
+	FORCEINLINE const TArray<uint32>& GetTileList(EFidelityFXCASTileClass Class) const { return TileLists[static_cast<int32>(Class)]; }
+
+	static FORCEINLINE uint32 PackTile(int32 TileX, int32 TileY) { return static_cast<uint32>(TileX) | (static_cast<uint32>(TileY) << 16); }
+	static FORCEINLINE FIntPoint UnpackTile(uint32 Tile)         { return FIntPoint(Tile & 0xffff, Tile >> 16); }
+};
+
+//-------------------------------------------------------------------------------------------------
+// Tile cache counters
+//-------------------------------------------------------------------------------------------------
+
+// Accumulated since the cache was created or the last FFidelityFXCASCPUContext::ResetTileCacheStats()
+struct FFidelityFXCASTileCacheStats
+{
+	int64 NumTiles = 0;				// Tiles looked up
+	int64 NumHits = 0;				// Tiles copied from the cache
+	int64 NumEvictions = 0;			// Cached tiles replaced by new ones
+	double OverheadSeconds = 0.0;	// Hashing the inputs and copying the hits, the cost of the cache
+	double ComputeSeconds = 0.0;	// Computing the missed tiles
+
+	FORCEINLINE int64 GetNumMisses() const   { return NumTiles - NumHits; }
+	FORCEINLINE float GetHitRate() const     { return NumTiles > 0 ? static_cast<float>(NumHits) / NumTiles : 0.0f; }
+	// Hits at the average cost of a computed tile minus the overhead, negative when the cache does not pay off
+	FORCEINLINE double GetSavedSeconds() const
+	{
+		const double SecondsPerTile = GetNumMisses() > 0 ? ComputeSeconds / GetNumMisses() : 0.0;
+		return NumHits * SecondsPerTile - OverheadSeconds;
+	}
+};
+
+//-------------------------------------------------------------------------------------------------
+// Job queue
+//-------------------------------------------------------------------------------------------------
+
+// Priority of a job of FFidelityFXCASCPUJobQueue, higher priorities take the threads from lower ones between two row bands
+enum class EFidelityFXCASJobPriority : uint8
+{
+	Interactive,	// Someone is waiting on it, i.e. an editor preview or a thumbnail
+	Normal,
+	Batch,			// Throughput work, i.e. sequence processing
+	Num
+};
+
+FORCEINLINE const TCHAR* GetFidelityFXCASJobPriorityName(EFidelityFXCASJobPriority Priority)
+{
+	switch (Priority)
+	{
+	case EFidelityFXCASJobPriority::Interactive: return TEXT("Interactive");
+	case EFidelityFXCASJobPriority::Normal:      return TEXT("Normal");
+	case EFidelityFXCASJobPriority::Batch:       return TEXT("Batch");
+	default:                                     return TEXT("Unknown");
+	}
+}
+
+// How a job ended. A cancelled or expired job that already started leaves the output partially written.
+enum class EFidelityFXCASJobStatus : uint8
+{
+	Completed,
+	Failed,		// Invalid views or unsupported formats, see the log
+	Cancelled,
+	Expired,	// Deadline passed before the job finished
+};
+
+struct FFidelityFXCASCPUJobResult
+{
+	EFidelityFXCASJobStatus Status = EFidelityFXCASJobStatus::Failed;
+	double WaitSeconds = 0.0;		// Queued before a thread started it
+	double LatencySeconds = 0.0;	// Submit to completion
+};
+
+// Counters of one priority, accumulated since the queue was created or the last FFidelityFXCASCPUJobQueue::ResetStats()
+struct FFidelityFXCASCPUJobPriorityStats
+{
+	int32 NumQueued = 0;			// Queue depth, waiting for a thread
+	int32 NumRunning = 0;
+	int64 NumStarted = 0;
+	int64 NumCompleted = 0;
+	int64 NumFailed = 0;
+	int64 NumCancelled = 0;
+	int64 NumExpired = 0;
+	int64 NumPreempted = 0;			// Row bands where a thread of a running job left it for a higher priority one
+	double TotalWaitSeconds = 0.0;	// Over the started jobs
+	double MaxWaitSeconds = 0.0;
+	double TotalLatencySeconds = 0.0;	// Over the completed jobs
+	double MaxLatencySeconds = 0.0;
+
+	FORCEINLINE double GetAverageWaitSeconds() const    { return NumStarted > 0 ? TotalWaitSeconds / NumStarted : 0.0; }
+	FORCEINLINE double GetAverageLatencySeconds() const { return NumCompleted > 0 ? TotalLatencySeconds / NumCompleted : 0.0; }
+};
+
+struct FFidelityFXCASCPUJobQueueStats
+{
+	FFidelityFXCASCPUJobPriorityStats Priorities[static_cast<int32>(EFidelityFXCASJobPriority::Num)];
+
+	FORCEINLINE const FFidelityFXCASCPUJobPriorityStats& Get(EFidelityFXCASJobPriority Priority) const { return Priorities[static_cast<int32>(Priority)]; }
+	FORCEINLINE FFidelityFXCASCPUJobPriorityStats& Get(EFidelityFXCASJobPriority Priority)             { return Priorities[static_cast<int32>(Priority)]; }
+};
+
+//-------------------------------------------------------------------------------------------------
+// Auto-tuning profile
+//-------------------------------------------------------------------------------------------------
+
+// Fastest engine configuration for one machine and workload, measured by FFidelityFXCASCPUModule::AutoTune
+struct FFidelityFXCASCPUTuning
+{
+	// Machine and workload of the measurement, a saved profile only applies to the same ones
+	FString CPUBrand;
+	FIntPoint InputSize = FIntPoint::ZeroValue;
+	FIntPoint OutputSize = FIntPoint::ZeroValue;
+	EFidelityFXCASPixelFormat Format = EFidelityFXCASPixelFormat::RGBA32F;
+
+	// Winning configuration
+	bool bAllowSIMD = true;
+	int32 RowsPerTask = 16;
+	// Threads for FFidelityFXCASCPUContext (including the calling thread)
+	int32 NumThreads = 0;
+	float MillisecondsPerImage = 0.0f;
+
+	FORCEINLINE void ApplyTo(FFidelityFXCASCPUSettings& Settings) const
+	{
+		Settings.bAllowSIMD = bAllowSIMD;
+		Settings.RowsPerTask = RowsPerTask;
+		Settings.bMultithreaded = NumThreads != 1;
+	}
+};
+
+//-------------------------------------------------------------------------------------------------
+// Accuracy report
+//-------------------------------------------------------------------------------------------------
+
+// Difference between two images over the RGB channels (alpha is ignored), compared as linear floats
+struct FFidelityFXCASImageDifference
+{
+	float MaxAbsError = 0.0f;
+	float MeanAbsError = 0.0f;
+	// Peak signal to noise ratio in dB for a peak value of 1, MAX_flt for identical images
+	float PSNR = 0.0f;
+	// Mean structural similarity of the luma over 8x8 windows, 1 for identical images
+	float SSIM = 0.0f;
+	int64 NumValues = 0;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+#include "FidelityFXCASCPUTypes.h"
+
+//-------------------------------------------------------------------------------------------------
+// Memory mapped file
+//-------------------------------------------------------------------------------------------------
+
+class FIDELITYFXCASCPU_API FFidelityFXCASMappedFile
+{
+public:
+	~FFidelityFXCASMappedFile();
+
+	// Maps an existing file for reading. bSequential hints the OS that the file will be streamed front to back.
+	static TUniquePtr<FFidelityFXCASMappedFile> OpenRead(const FString& Filename, bool bSequential);
+	// Creates (or truncates) a file of the given size and maps it for writing
+	static TUniquePtr<FFidelityFXCASMappedFile> CreateWrite(const FString& Filename, int64 Size, bool bSequential);
+
+	FORCEINLINE uint8* GetData() const { return Data; }
+	FORCEINLINE int64 GetSize() const  { return Size; }
+
+private:
+	FFidelityFXCASMappedFile() = default;
+	FFidelityFXCASMappedFile(const FFidelityFXCASMappedFile&) = delete;
+	FFidelityFXCASMappedFile& operator=(const FFidelityFXCASMappedFile&) = delete;
+
+	uint8* Data = nullptr;
+	int64 Size = 0;
+	bool bWritable = false;
+#if PLATFORM_WINDOWS
+	void* FileHandle = nullptr;
+	void* MappingHandle = nullptr;
+#elif PLATFORM_UNIX || PLATFORM_MAC
+	int32 FileDescriptor = -1;
+#else
+	// No mapping support, the file is read into / written from memory
+	FString Filename;
+	TArray<uint8> Buffer;
+#endif
+};
+
+//-------------------------------------------------------------------------------------------------
+// Mapped frame (raw or PFM) exposed as an image view over the mapped pixels
+//-------------------------------------------------------------------------------------------------
+
+enum class EFidelityFXCASFrameFileType : uint8
+{
+	Raw,	// Headerless pixels, layout described by FFidelityFXCASRawFrameDesc
+	PFM,	// Portable float map, little endian RGB32F, stored bottom-up
+};
+
+struct FFidelityFXCASRawFrameDesc
+{
+	int32 Width = 0;
+	int32 Height = 0;
+	EFidelityFXCASPixelFormat Format = EFidelityFXCASPixelFormat::RGBA32F;
+	EFidelityFXCASChannelOrder ChannelOrder = EFidelityFXCASChannelOrder::RGBA;
+	// Row pitch in bytes, 0 for tightly packed rows
+	int64 RowPitch = 0;
+	// Bytes to skip at the beginning of the file
+	int64 HeaderSize = 0;
+};
+
+class FIDELITYFXCASCPU_API FFidelityFXCASMappedFrame
+{
+public:
+	// Guesses the file type from the extension (.pfm or raw)
+	static EFidelityFXCASFrameFileType GetFileType(const FString& Filename);
+
+	// Maps a frame for reading. RawDesc is required for raw files and ignored for PFM.
+	static TUniquePtr<FFidelityFXCASMappedFrame> OpenRead(const FString& Filename, const FFidelityFXCASRawFrameDesc* RawDesc, bool bStreaming);
+	// Creates a pre-sized frame file and maps it for writing. PFM frames are always RGB32F.
+	static TUniquePtr<FFidelityFXCASMappedFrame> CreateWrite(const FString& Filename, EFidelityFXCASFrameFileType FileType,
+		int32 Width, int32 Height, EFidelityFXCASPixelFormat Format, bool bStreaming);
+
+	FORCEINLINE const FFidelityFXCASImageView& GetView() const { return View; }
+
+private:
+	TUniquePtr<FFidelityFXCASMappedFile> File;
+	FFidelityFXCASImageView View;
+};